@@ -0,0 +1,492 @@
+// CviCubeMX 性能基准
+//
+// 用法：
+//   cvicubemx_bench [--json results.json] [--baseline baseline.json] [--threshold 10]
+//                   [--filter 正则] [--quick]
+//
+// 输入数据全部在临时目录中合成（10k 节点设备树、大 defconfig、221 个引脚的配置），
+// 结果以 JSON 输出（每项的迭代次数、最小/中位/平均耗时，单位纳秒）。
+// 指定 --baseline 时按中位数与基线逐项比较，任一项变慢超过阈值（百分比）时返回非零退出码。
+
+#include "dtsconfig.h"
+#include "defconfigindex.h"
+#include "fileioservice.h"
+#include "artifactcache.h"
+#include "codegenerator.h"
+#include "chipconfig.h"
+#include "pinfunction.h"
+#include "pinwidget.h"
+#include "clockconfig.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+struct BenchResult {
+    QString name;
+    int iterations = 0;
+    qint64 minNs = 0;
+    qint64 medianNs = 0;
+    qint64 meanNs = 0;
+    qint64 items = 0;       // 每次迭代处理的元素数（节点、行、引脚等）
+};
+
+struct BenchOptions {
+    QRegularExpression filter;
+    int minIterations = 5;
+    qint64 minTimeMs = 500;
+};
+
+// 等待异步I/O及其界面线程上的续延完成
+template <typename T>
+T waitFor(QFuture<T> future)
+{
+    while (!future.isFinished()) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    // 续延中再次提交的任务（如解析缓存写入）也等它结束
+    while (FileIoService::instance()->isBusy()) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return future.result();
+}
+
+class BenchRunner
+{
+public:
+    explicit BenchRunner(const BenchOptions& options) : m_options(options) {}
+
+    // setup 在每次迭代前执行，不计入耗时；macro 基准迭代次数少、时间预算大
+    void run(const QString& name, qint64 items, const std::function<void()>& body,
+             const std::function<void()>& setup = {}, bool macro = false)
+    {
+        if (m_options.filter.isValid() && !m_options.filter.pattern().isEmpty()
+                && !m_options.filter.match(name).hasMatch()) {
+            return;
+        }
+
+        const int minIterations = macro ? qMax(1, m_options.minIterations / 2) : m_options.minIterations;
+        const qint64 minTimeNs = (macro ? m_options.minTimeMs * 4 : m_options.minTimeMs) * 1000000;
+
+        // 预热一次，排除首次分配和缓存建立
+        if (setup) {
+            setup();
+        }
+        body();
+
+        QList<qint64> samples;
+        qint64 total = 0;
+        while (samples.size() < minIterations || (total < minTimeNs && samples.size() < 100000)) {
+            if (setup) {
+                setup();
+            }
+            QElapsedTimer timer;
+            timer.start();
+            body();
+            qint64 elapsed = timer.nsecsElapsed();
+            samples.append(elapsed);
+            total += elapsed;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        BenchResult result;
+        result.name = name;
+        result.iterations = samples.size();
+        result.minNs = samples.first();
+        result.medianNs = samples.at(samples.size() / 2);
+        result.meanNs = total / samples.size();
+        result.items = items;
+        m_results.append(result);
+
+        QTextStream(stdout) << QString("%1 %2 次  中位 %3 ms  最小 %4 ms\n")
+                               .arg(name, -40)
+                               .arg(result.iterations, 7)
+                               .arg(result.medianNs / 1e6, 10, 'f', 3)
+                               .arg(result.minNs / 1e6, 10, 'f', 3);
+    }
+
+    const QList<BenchResult>& results() const { return m_results; }
+
+private:
+    BenchOptions m_options;
+    QList<BenchResult> m_results;
+};
+
+// ---- 合成输入 ----
+
+QString syntheticDts(int nodeCount)
+{
+    static const QStringList kinds = {"pwm", "i2c", "spi", "uart", "gpio"};
+    static const QStringList clocks = {"PWM", "I2C", "SPI", "UART0", "APB_GPIO"};
+
+    QString content;
+    content.reserve(nodeCount * 220);
+    content += "/dts-v1/;\n\n/ {\n";
+    for (int i = 0; i < nodeCount; ++i) {
+        const int kind = i % kinds.size();
+        content += QString("\t%1%2: %1@%3 {\n").arg(kinds[kind]).arg(i).arg(0x03000000 + i * 0x1000, 8, 16, QChar('0'));
+        content += QString("\t\tcompatible = \"cvitek,%1\";\n").arg(kinds[kind]);
+        content += QString("\t\treg = <0x0 0x%1 0x0 0x1000>;\n").arg(0x03000000 + i * 0x1000, 8, 16, QChar('0'));
+        content += QString("\t\tclocks = <&clk CV184X_CLK_%1>;\n").arg(clocks[kind]);
+        if (kinds[kind] == "pwm") {
+            content += "\t\t#pwm-cells = <1>;\n";
+        } else if (kinds[kind] == "uart") {
+            content += "\t\tcurrent-speed = <115200>;\n";
+        } else {
+            content += "\t\tclock-frequency = <100000>;\n";
+        }
+        content += QString("\t\tstatus = \"%1\";\n\t};\n\n").arg(i % 3 == 0 ? "okay" : "disabled");
+    }
+    content += "};\n";
+    return content;
+}
+
+QString syntheticDefconfig(int lineCount)
+{
+    QString content;
+    content.reserve(lineCount * 40);
+    for (int i = 0; i < lineCount; ++i) {
+        switch (i % 4) {
+        case 0:
+            content += QString("CONFIG_BENCH_OPTION_%1=y\n").arg(i);
+            break;
+        case 1:
+            content += QString("# CONFIG_BENCH_OPTION_%1 is not set\n").arg(i);
+            break;
+        case 2:
+            content += QString("CONFIG_BENCH_VALUE_%1=0x%2\n").arg(i).arg(i * 4096, 0, 16);
+            break;
+        default:
+            content += QString("CONFIG_BENCH_STRING_%1=\"value_%1\"\n").arg(i);
+            break;
+        }
+    }
+    return content;
+}
+
+// PinFunction 中已定义的引脚，不足时补齐到 BGA 封装的 221 个焊盘
+QStringList benchPadNames(const PinFunction& pinFunction, int padCount)
+{
+    QStringList pads = pinFunction.getPinNames();
+    for (int i = 0; pads.size() < padCount; ++i) {
+        pads.append(QString("PAD_BENCH_%1").arg(i));
+    }
+    return pads.mid(0, padCount);
+}
+
+bool writeFile(const QString& path, const QString& content)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    file.write(content.toUtf8());
+    return true;
+}
+
+void clearArtifactCache()
+{
+    QDir(ArtifactCache::cacheDirectory()).removeRecursively();
+}
+
+// ---- JSON 与基线 ----
+
+QJsonObject resultsToJson(const QList<BenchResult>& results, bool quick)
+{
+    QJsonArray array;
+    for (const BenchResult& result : results) {
+        QJsonObject item;
+        item["name"] = result.name;
+        item["iterations"] = result.iterations;
+        item["min_ns"] = result.minNs;
+        item["median_ns"] = result.medianNs;
+        item["mean_ns"] = result.meanNs;
+        item["items"] = result.items;
+        array.append(item);
+    }
+
+    QJsonObject root;
+    root["version"] = 1;
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["qt"] = QString(qVersion());
+    root["cpu"] = QSysInfo::currentCpuArchitecture();
+    root["os"] = QSysInfo::prettyProductName();
+    root["quick"] = quick;
+    root["results"] = array;
+    return root;
+}
+
+// 返回变慢超过阈值的项数，-1表示基线不可读
+int compareWithBaseline(const QList<BenchResult>& results, const QString& baselinePath, double thresholdPercent)
+{
+    QFile file(baselinePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        QTextStream(stderr) << "无法读取基线文件: " << baselinePath << "\n";
+        return -1;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+
+    QHash<QString, qint64> baseline;
+    for (const QJsonValue& value : root["results"].toArray()) {
+        const QJsonObject item = value.toObject();
+        baseline.insert(item["name"].toString(), item["median_ns"].toInteger());
+    }
+
+    QTextStream out(stdout);
+    out << QString("\n与基线比较（%1，阈值 %2%）\n").arg(baselinePath).arg(thresholdPercent);
+
+    int regressions = 0;
+    for (const BenchResult& result : results) {
+        if (!baseline.contains(result.name) || baseline.value(result.name) <= 0) {
+            out << QString("%1 %2\n").arg(result.name, -40).arg("（基线中没有）");
+            continue;
+        }
+        const double delta = (double(result.medianNs) / baseline.value(result.name) - 1.0) * 100.0;
+        const bool regressed = delta > thresholdPercent;
+        if (regressed) {
+            ++regressions;
+        }
+        out << QString("%1 %2 ms -> %3 ms  %4%5%\n")
+               .arg(result.name, -40)
+               .arg(baseline.value(result.name) / 1e6, 10, 'f', 3)
+               .arg(result.medianNs / 1e6, 10, 'f', 3)
+               .arg(delta >= 0 ? "+" : "")
+               .arg(delta, 0, 'f', 1)
+            << (regressed ? "  变慢" : "") << "\n";
+    }
+    return regressions;
+}
+
+void quietMessageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    // 被测代码的调试输出会干扰计时
+    if (type != QtDebugMsg && type != QtInfoMsg) {
+        QTextStream(stderr) << message << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 无显示环境下也能运行控件相关的基准
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cvicubemx_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CviCubeMX 性能基准");
+    parser.addHelpOption();
+    QCommandLineOption jsonOption("json", "结果写入JSON文件（默认只打印）", "file");
+    QCommandLineOption baselineOption("baseline", "与基线JSON比较", "file");
+    QCommandLineOption thresholdOption("threshold", "中位数变慢超过该百分比视为回退（默认10）", "percent", "10");
+    QCommandLineOption filterOption("filter", "只运行名称匹配该正则的基准", "regex");
+    QCommandLineOption quickOption("quick", "缩小输入规模和迭代次数，用于快速检查");
+    parser.addOptions({jsonOption, baselineOption, thresholdOption, filterOption, quickOption});
+    parser.process(app);
+
+    const bool quick = parser.isSet(quickOption);
+    qInstallMessageHandler(quietMessageHandler);
+
+    // 解析缓存写到测试目录，不影响用户的缓存
+    QStandardPaths::setTestModeEnabled(true);
+
+    BenchOptions options;
+    options.filter = QRegularExpression(parser.value(filterOption));
+    if (quick) {
+        options.minIterations = 3;
+        options.minTimeMs = 100;
+    }
+    BenchRunner runner(options);
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        QTextStream(stderr) << "无法创建临时目录\n";
+        return 2;
+    }
+    const QDir work(workDir.path());
+
+    const int dtsNodes = quick ? 1000 : 10000;
+    const int defconfigLines = quick ? 5000 : 50000;
+    const int padCount = 221;
+    const QString chipType = "cv1842hp_wevb_0014a_emmc";
+
+    // ---- 设备树 ----
+    const QString dtsPath = work.absoluteFilePath("bench.dtsi");
+    const QString dtsContent = syntheticDts(dtsNodes);
+    writeFile(dtsPath, dtsContent);
+
+    runner.run(QString("dts/load_%1_cold").arg(dtsNodes), dtsNodes, [&]() {
+        DtsConfig config;
+        waitFor(config.loadDtsFile(dtsPath));
+    }, clearArtifactCache, true);
+
+    runner.run(QString("dts/load_%1_cached").arg(dtsNodes), dtsNodes, [&]() {
+        DtsConfig config;
+        waitFor(config.loadDtsFile(dtsPath));
+    }, {}, true);
+
+    {
+        DtsConfig config;
+        waitFor(config.loadDtsFile(dtsPath));
+        int toggle = 0;
+        runner.run(QString("dts/save_%1").arg(dtsNodes), dtsNodes, [&]() {
+            config.setPeripheralStatus("uart3", (++toggle % 2) ? "okay" : "disabled");
+            waitFor(config.saveDtsFile());
+        }, {}, true);
+        runner.run(QString("dts/save_peripheral_%1").arg(dtsNodes), dtsNodes, [&]() {
+            config.setPeripheralStatus("i2c1", (++toggle % 2) ? "okay" : "disabled");
+            waitFor(config.savePeripheralConfig("i2c1"));
+        }, {}, true);
+    }
+
+    // ---- defconfig ----
+    const QString defconfigPath = work.absoluteFilePath("bench_defconfig");
+    const QString defconfigContent = syntheticDefconfig(defconfigLines);
+    writeFile(defconfigPath, defconfigContent);
+
+    runner.run(QString("defconfig/parse_%1").arg(defconfigLines), defconfigLines, [&]() {
+        DefconfigIndex index = DefconfigIndex::parse(defconfigContent);
+        Q_UNUSED(index);
+    });
+
+    runner.run(QString("defconfig/load_%1").arg(defconfigLines), defconfigLines, [&]() {
+        FileIoResult result = waitFor(FileIoService::instance()->readText(defconfigPath, "bench"));
+        DefconfigIndex index = DefconfigIndex::parse(result.content);
+        Q_UNUSED(index);
+    });
+
+    {
+        // 与导出分区/时钟/内存配置相同的逐行改写：替换一批键，其余行保持不变
+        int generation = 0;
+        runner.run(QString("defconfig/save_%1").arg(defconfigLines), defconfigLines, [&]() {
+            const QString suffix = QString::number(++generation);
+            waitFor(FileIoService::instance()->modifyLines(defconfigPath, [suffix](QStringList& lines, QString&) {
+                for (QString& line : lines) {
+                    if (line.startsWith("CONFIG_BENCH_STRING_")) {
+                        line = line.section('=', 0, 0) + "=\"value_" + suffix + "\"";
+                    }
+                }
+                return true;
+            }, "bench"));
+        }, {}, true);
+    }
+
+    // ---- 引脚功能与代码生成 ----
+    runner.run("pinfunction/construct", 1, []() {
+        PinFunction pinFunction;
+        Q_UNUSED(pinFunction);
+    });
+
+    PinFunction pinFunction;
+    const QStringList pads = benchPadNames(pinFunction, padCount);
+
+    ChipConfig chipConfig;
+    chipConfig.setChipType(chipType);
+    for (const QString& pad : pads) {
+        const QStringList functions = pinFunction.getSupportedFunctions(pad);
+        chipConfig.setPinFunction(pad, functions.last());
+    }
+
+    {
+        CodeGenerator generator;
+        runner.run(QString("codegen/generate_standalone_%1").arg(padCount), padCount, [&]() {
+            QString code = generator.generateCode(chipConfig);
+            Q_UNUSED(code);
+        });
+    }
+
+    {
+        // 模拟SDK中已有的 cvi_board_init.c，走读入-替换-写回路径
+        const QString sdkRoot = work.absoluteFilePath("sdk");
+        writeFile(QDir(sdkRoot).absoluteFilePath(
+                      QString("build/boards/cv184x/%1/u-boot/cvi_board_init.c").arg(chipType)),
+                  "#include \"cvi_board_init.h\"\n\nint cvi_board_init(void)\n{\n\treturn 0;\n}\n");
+
+        CodeGenerator generator;
+        generator.setSourcePath(sdkRoot);
+        runner.run(QString("codegen/update_existing_%1").arg(padCount), padCount, [&]() {
+            QString status = generator.generateCode(chipConfig);
+            Q_UNUSED(status);
+        });
+    }
+
+    // ---- 引脚搜索 ----
+    {
+        QList<PinWidget*> pinWidgets;
+        QStringList positions;
+        for (int i = 0; i < pads.size(); ++i) {
+            PinWidget *pinWidget = new PinWidget(pads[i], true);
+            pinWidget->setSupportedFunctions(pinFunction.getSupportedFunctions(pads[i]));
+            const QString position = QString("%1%2").arg(QChar('A' + i / 15)).arg(i % 15 + 1);
+            pinWidget->setDisplayName(position);
+            pinWidgets.append(pinWidget);
+            positions.append(position);
+        }
+
+        const QStringList queries = {"uart", "A1", "GPIO", "I2C3", "no_such_function"};
+        runner.run(QString("pins/search_%1").arg(pads.size()), pads.size() * queries.size(), [&]() {
+            int matched = 0;
+            for (const QString& query : queries) {
+                for (int i = 0; i < pinWidgets.size(); ++i) {
+                    if (pinWidgets[i]->matchesSearch(positions[i], query)) {
+                        ++matched;
+                    }
+                }
+            }
+            Q_UNUSED(matched);
+        });
+        qDeleteAll(pinWidgets);
+    }
+
+    // ---- 时钟树 ----
+    {
+        ClockConfigWidget clockWidget;
+        clockWidget.setChipType(chipType);
+        runner.run("clock/update_frequencies", 1, [&]() {
+            QMetaObject::invokeMethod(&clockWidget, "updateFrequencies", Qt::DirectConnection);
+        });
+    }
+
+    const QJsonObject json = resultsToJson(runner.results(), quick);
+    if (parser.isSet(jsonOption)) {
+        QFile output(parser.value(jsonOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "无法写入结果文件: " << parser.value(jsonOption) << "\n";
+            return 2;
+        }
+        output.write(QJsonDocument(json).toJson());
+    } else {
+        QTextStream(stdout) << QJsonDocument(json).toJson();
+    }
+
+    if (parser.isSet(baselineOption)) {
+        int regressions = compareWithBaseline(runner.results(), parser.value(baselineOption),
+                                              parser.value(thresholdOption).toDouble());
+        if (regressions < 0) {
+            return 2;
+        }
+        return regressions > 0 ? 1 : 0;
+    }
+    return 0;
+}
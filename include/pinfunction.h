@@ -44,6 +44,12 @@ public:
      */
     bool isPinFunctionSupported(const QString& pinName, const QString& function) const;
 
+    /**
+     * @brief 获取所有已定义功能的引脚名称
+     * @return 引脚名称列表（按名称排序）
+     */
+    QStringList getPinNames() const;
+
 private:
     void initializePinFunctions();
     
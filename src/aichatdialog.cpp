@@ -1,4 +1,6 @@
 #include "aichatdialog.h"
+#include "chatstreamrenderer.h"
+#include "airesponsecache.h"
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -13,6 +15,8 @@
 #include <QTimer>
 #include <QTextDocument>
 #include <QRegularExpression>
+#include <QSettings>
+#include <QPointer>
 
 AIChatDialog::AIChatDialog(QWidget *parent)
     : QDialog(parent)
@@ -26,22 +30,38 @@ AIChatDialog::AIChatDialog(QWidget *parent)
     , m_inputLineEdit(nullptr)
     , m_sendButton(nullptr)
     , m_clearButton(nullptr)
+    , m_cancelButton(nullptr)
     , m_networkManager(nullptr)
     , m_currentReply(nullptr)
     , m_isConnected(false)
-    , m_isFirstContentChunk(true)
+    , m_streamRenderer(nullptr)
+    , m_toolBridge(nullptr)
+    , m_toolRounds(0)
+    , m_cancelRequested(false)
     , m_isWaitingForResponse(false)
 {
     // 初始化AI API配置
-    m_apiKey = "your_api_key_here";
-    m_baseUrl = "https://www.sophnet.com/api/open-apis/v1";
-    m_model = "DeepSeek-V3.2-Exp:6P2FGzuj1EOFpP2DCX2miK";
+    // 可在设置中覆盖；环境变量 CVICUBEMX_AI_BASE_URL 优先，便于指向本地模拟服务器测试
+    QSettings settings("CviTek", "CviCubeMX");
+    m_apiKey = settings.value("aiApiKey", "your_api_key_here").toString();
+    m_baseUrl = settings.value("aiBaseUrl", "https://www.sophnet.com/api/open-apis/v1").toString();
+    m_baseUrl = qEnvironmentVariable("CVICUBEMX_AI_BASE_URL", m_baseUrl);
+    m_model = settings.value("aiModel", "DeepSeek-V3.2-Exp:6P2FGzuj1EOFpP2DCX2miK").toString();
     
     setupUI();
     setupStyles();
     
-    // 初始化网络管理器
+    // AI回复以追加方式流式写入聊天记录
+    m_streamRenderer = new ChatStreamRenderer(m_chatDisplay, this);
+    
+    // 初始化网络管理器：整个对话框共用，连接保持复用（允许HTTP/2），并提前完成握手
     m_networkManager = new QNetworkAccessManager(this);
+    QUrl baseUrl(m_baseUrl);
+    if (baseUrl.scheme() == "https") {
+        m_networkManager->connectToHostEncrypted(baseUrl.host(), baseUrl.port(443));
+    } else if (!baseUrl.host().isEmpty()) {
+        m_networkManager->connectToHost(baseUrl.host(), baseUrl.port(80));
+    }
     
     // 设置初始连接状态
     setConnectionStatus(true);
@@ -55,6 +75,16 @@ AIChatDialog::~AIChatDialog()
     }
 }
 
+void AIChatDialog::setContextProvider(const ContextProvider& provider)
+{
+    m_contextProvider = provider;
+}
+
+void AIChatDialog::setToolBridge(const AIToolBridge *toolBridge)
+{
+    m_toolBridge = toolBridge;
+}
+
 void AIChatDialog::setupUI()
 {
     setWindowTitle("AI 智能问答助手");
@@ -113,8 +143,15 @@ void AIChatDialog::setupUI()
     m_clearButton->setMinimumHeight(40);
     m_clearButton->setMinimumWidth(80);
     
+    m_cancelButton = new QPushButton("停止");
+    m_cancelButton->setObjectName("cancelButton");
+    m_cancelButton->setMinimumHeight(40);
+    m_cancelButton->setMinimumWidth(80);
+    m_cancelButton->setEnabled(false);
+    
     m_inputLayout->addWidget(m_inputLineEdit);
     m_inputLayout->addWidget(m_sendButton);
+    m_inputLayout->addWidget(m_cancelButton);
     m_inputLayout->addWidget(m_clearButton);
     
     // 添加到主布局
@@ -126,6 +163,7 @@ void AIChatDialog::setupUI()
     connect(m_sendButton, &QPushButton::clicked, this, &AIChatDialog::onSendMessage);
     connect(m_inputLineEdit, &QTextEdit::textChanged, this, &AIChatDialog::onTextChanged);
     connect(m_clearButton, &QPushButton::clicked, m_chatDisplay, &QTextEdit::clear);
+    connect(m_cancelButton, &QPushButton::clicked, this, &AIChatDialog::onCancelRequest);
     
     // 初始状态
     m_sendButton->setEnabled(false);
@@ -212,6 +250,22 @@ void AIChatDialog::setupStyles()
             background-color: #7f8c8d;
         }
         
+        #cancelButton {
+            background-color: #e74c3c;
+            color: white;
+            border: none;
+            border-radius: 8px;
+            font-size: 14px;
+        }
+        
+        #cancelButton:hover {
+            background-color: #c0392b;
+        }
+        
+        #cancelButton:disabled {
+            background-color: #bdc3c7;
+        }
+        
         #retryButton {
             background-color: #e67e22;
             color: white;
@@ -284,7 +338,73 @@ void AIChatDialog::sendMessageToAI(const QString& message)
     
     m_isWaitingForResponse = true;
     m_sendButton->setEnabled(false);
-    m_isFirstContentChunk = true; // 重置首次内容标记
+    m_toolRounds = 0;
+    
+    m_messages = QJsonArray();
+    // System message
+    QJsonObject systemMessage;
+    systemMessage["role"] = "system";
+    systemMessage["content"] = "你是SophNet智能助手, 尽量使用markdown格式回复问题。";
+    m_messages.append(systemMessage);
+    
+    // 工程上下文：当前配置摘要和本地知识库中与问题相关的片段
+    if (m_contextProvider) {
+        QString context = m_contextProvider(message);
+        if (!context.isEmpty()) {
+            QJsonObject contextMessage;
+            contextMessage["role"] = "system";
+            contextMessage["content"] = "以下是用户当前工程的相关信息，回答时优先参考：\n" + context;
+            m_messages.append(contextMessage);
+        }
+    }
+    
+    // User message
+    QJsonObject userMessage;
+    userMessage["role"] = "user";
+    userMessage["content"] = message;
+    m_messages.append(userMessage);
+    
+    m_cancelRequested = false;
+    m_cancelButton->setEnabled(true);
+    m_streamRenderer->begin("正在思考中...");
+    
+    // 先查缓存：相同模型、相同上下文和问题的回答直接重放
+    m_requestKey = AIResponseCache::requestKey(m_model, m_messages);
+    const QString key = m_requestKey;
+    AIResponseCache::instance()->lookup(key).then(this, [this, key](const QString& cached) {
+        if (key != m_requestKey || !m_isWaitingForResponse) {
+            return;     // 已取消
+        }
+        if (!cached.isEmpty()) {
+            replayResponse(cached, "（本地缓存的回答）");
+            return;
+        }
+        
+        AIResponseCache *cache = AIResponseCache::instance();
+        if (cache->beginRequest(key)) {
+            postChatRequest();
+            return;
+        }
+        // 相同请求正在进行，等待它的结果
+        cache->pending(key).then(this, [this, key](const QString& content) {
+            if (key != m_requestKey || !m_isWaitingForResponse) {
+                return;
+            }
+            if (content.isEmpty()) {
+                m_streamRenderer->discard();
+                showErrorMessage("相同的请求未能完成，请重试");
+                endRequest();
+                return;
+            }
+            replayResponse(content, "（与进行中的相同请求共用回答）");
+        });
+    });
+}
+
+void AIChatDialog::postChatRequest()
+{
+    m_sseDecoder.reset();
+    m_toolCalls.clear();
     
     // 创建请求
     QNetworkRequest request;
@@ -294,6 +414,7 @@ void AIChatDialog::sendMessageToAI(const QString& message)
     request.setRawHeader("Authorization", QString("Bearer %1").arg(m_apiKey).toUtf8());
     request.setRawHeader("Accept", "text/plain"); // 流式响应使用text/plain
     request.setRawHeader("User-Agent", "openai-python/1.0.0"); // 模拟OpenAI客户端
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
     
     // 添加调试信息
     qDebug() << "发送请求到:" << fullUrl;
@@ -303,21 +424,12 @@ void AIChatDialog::sendMessageToAI(const QString& message)
     QJsonObject json;
     json["model"] = m_model;
     json["stream"] = true; // 使用流式请求，与Python脚本保持一致
+    json["messages"] = m_messages;
     
-    QJsonArray messages;
-    // System message
-    QJsonObject systemMessage;
-    systemMessage["role"] = "system";
-    systemMessage["content"] = "你是SophNet智能助手, 尽量使用markdown格式回复问题。";
-    messages.append(systemMessage);
-    
-    // User message
-    QJsonObject userMessage;
-    userMessage["role"] = "user";
-    userMessage["content"] = message;
-    messages.append(userMessage);
-    
-    json["messages"] = messages;
+    // 本地工具：模型按需查询引脚/时钟/内存模型；达到轮数上限后不再提供，要求模型直接回答
+    if (m_toolBridge && !m_toolBridge->isEmpty() && m_toolRounds < kMaxToolRounds) {
+        json["tools"] = m_toolBridge->toolDefinitions();
+    }
     
     QJsonDocument doc(json);
     QByteArray requestData = doc.toJson(QJsonDocument::Compact);
@@ -330,16 +442,19 @@ void AIChatDialog::sendMessageToAI(const QString& message)
     connect(m_currentReply, &QNetworkReply::readyRead, this, &AIChatDialog::onNetworkReplyReadyRead);
     connect(m_currentReply, &QNetworkReply::finished, this, &AIChatDialog::onNetworkReplyFinished);
     
-    // 显示正在思考的消息
+    // 显示正在思考的消息（首轮在查缓存前已显示）
     m_currentAIResponse.clear();
-    appendAIMessage("正在思考中...");
+    if (!m_streamRenderer->isActive()) {
+        m_streamRenderer->begin("正在思考中...");
+    }
     
-    // 设置超时 (600秒)
-    QTimer::singleShot(600000, this, [this]() {
-        if (m_currentReply && m_currentReply->isRunning()) {
+    // 设置超时 (600秒)，只针对本次请求
+    QPointer<QNetworkReply> reply = m_currentReply;
+    QTimer::singleShot(600000, this, [this, reply]() {
+        if (reply && reply->isRunning()) {
             qDebug() << "请求超时，正在取消...";
-            m_currentReply->abort();
-            showErrorMessage("请求超时（60秒），请检查网络连接后重试");
+            reply->abort();
+            showErrorMessage("请求超时（600秒），请检查网络连接后重试");
         }
     });
 }
@@ -350,71 +465,56 @@ void AIChatDialog::onNetworkReplyReadyRead()
         return;
     }
     
-    QByteArray data = m_currentReply->readAll();
-    QString response = QString::fromUtf8(data);
-    
-    qDebug() << "收到流式数据块，长度:" << data.size();
-    qDebug() << "数据内容:" << response.left(200) << "...";
-    
-    // 处理SSE格式的流式响应
-    QStringList lines = response.split('\n');
-    for (const QString& line : lines) {
-        if (line.startsWith("data: ")) {
-            QString jsonStr = line.mid(6); // 移除 "data: " 前缀
-            jsonStr = jsonStr.trimmed();
-            
-            qDebug() << "处理JSON字符串:" << jsonStr;
-            
-            if (jsonStr == "[DONE]") {
-                qDebug() << "流式响应结束";
-                break;
+    // 不完整的行由解码器缓存到下一块数据
+    handleStreamEvents(m_sseDecoder.feed(m_currentReply->readAll()));
+}
+
+void AIChatDialog::handleStreamEvents(const QList<SseEvent>& events)
+{
+    for (const SseEvent& event : events) {
+        if (event.data == "[DONE]") {
+            qDebug() << "流式响应结束";
+            continue;
+        }
+        
+        QString content;
+        // 带工具调用的片段和非常见形式按完整JSON解析
+        if (event.data.contains("\"tool_calls\"") || !SseDecoder::extractDeltaContent(event.data, &content)) {
+            QJsonParseError error;
+            QJsonDocument doc = QJsonDocument::fromJson(event.data, &error);
+            if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+                qDebug() << "JSON解析错误:" << error.errorString() << "内容:" << event.data.left(200);
+                continue;
             }
-            
-            if (jsonStr.isEmpty()) {
+            QJsonArray choices = doc.object()["choices"].toArray();
+            if (choices.isEmpty()) {
                 continue;
             }
+            QJsonObject delta = choices[0].toObject()["delta"].toObject();
+            content = delta["content"].toString();
             
-            QJsonParseError error;
-            QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8(), &error);
-            if (error.error == QJsonParseError::NoError && doc.isObject()) {
-                QJsonObject obj = doc.object();
-                qDebug() << "成功解析JSON对象";
-                
-                if (obj.contains("choices")) {
-                    QJsonArray choices = obj["choices"].toArray();
-                    if (!choices.isEmpty()) {
-                        QJsonObject choice = choices[0].toObject();
-                        if (choice.contains("delta")) {
-                            QJsonObject delta = choice["delta"].toObject();
-                            if (delta.contains("content")) {
-                                QString content = delta["content"].toString();
-                                qDebug() << "提取到内容片段:" << content;
-                                
-                                if (!content.isEmpty()) {
-                                    m_currentAIResponse += content;
-                                    qDebug() << "累积响应内容长度:" << m_currentAIResponse.length();
-                                    
-                                    // 实时流式更新显示
-                                    updateAIResponseStreamContent(content);
-                                } else {
-                                    qDebug() << "内容片段为空，跳过";
-                                }
-                            } else {
-                                qDebug() << "Delta对象不包含content字段";
-                            }
-                        } else {
-                            qDebug() << "Choice对象不包含delta字段";
-                        }
-                    } else {
-                        qDebug() << "Choices数组为空";
-                    }
-                } else {
-                    qDebug() << "JSON对象不包含choices字段";
+            // 工具调用的参数分多个片段到达，按 index 累积
+            const QJsonArray toolCalls = delta["tool_calls"].toArray();
+            for (const QJsonValue& value : toolCalls) {
+                QJsonObject call = value.toObject();
+                int index = call["index"].toInt();
+                PendingToolCall& pending = m_toolCalls[index];
+                if (!call["id"].toString().isEmpty()) {
+                    pending.id = call["id"].toString();
                 }
-            } else {
-                qDebug() << "JSON解析错误:" << error.errorString() << "内容:" << jsonStr;
+                QJsonObject function = call["function"].toObject();
+                if (!function["name"].toString().isEmpty()) {
+                    pending.name = function["name"].toString();
+                }
+                pending.arguments += function["arguments"].toString();
             }
         }
+        
+        if (!content.isEmpty()) {
+            m_currentAIResponse += content;
+            // 实时流式更新显示
+            m_streamRenderer->append(content);
+        }
     }
 }
 
@@ -461,72 +561,150 @@ void AIChatDialog::onNetworkReplyFinished()
             }
         }
         
-        qDebug() << "流式请求错误:" << errorMessage;
-        showErrorMessage(errorMessage);
-        setConnectionStatus(false);
+        // 保留已收到的部分内容
+        m_streamRenderer->finish();
+        if (m_cancelRequested) {
+            appendToolNotice("已停止生成");
+        } else {
+            qDebug() << "流式请求错误:" << errorMessage;
+            showErrorMessage(errorMessage);
+            setConnectionStatus(false);
+        }
+        AIResponseCache::instance()->finishRequest(m_requestKey, QString(), false);
     } else {
-        // 流式请求成功完成
+        // 流式请求成功完成，处理末尾缺少空行的事件
+        handleStreamEvents(m_sseDecoder.finish());
         setConnectionStatus(true);
-        qDebug() << "流式响应完成，累积内容长度:" << m_currentAIResponse.length();
         
-        // 内容已经在流式输出中显示，这里只需检查是否收到了内容
-        if (m_currentAIResponse.isEmpty()) {
-            // 如果没有收到任何内容（第一个内容块都没有到达）
-            // 删除"正在思考中..."并显示错误
-            QString currentText = m_chatDisplay->toPlainText();
-            int lastThinkingIndex = currentText.lastIndexOf("正在思考中...");
-            
-            if (lastThinkingIndex != -1) {
-                QTextCursor cursor = m_chatDisplay->textCursor();
-                cursor.movePosition(QTextCursor::Start);
-                QTextDocument* doc = m_chatDisplay->document();
-                cursor = doc->find("正在思考中...", cursor);
-                
-                if (!cursor.isNull()) {
-                    cursor.movePosition(QTextCursor::StartOfBlock);
-                    cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
-                    cursor.removeSelectedText();
-                    cursor.deletePreviousChar();
-                }
+        const bool toolCallsRequested = !m_toolCalls.isEmpty() && m_toolBridge;
+        if (toolCallsRequested && m_toolRounds < kMaxToolRounds) {
+            // 模型请求调用本地工具：执行后带上结果再次请求
+            if (m_currentAIResponse.isEmpty()) {
+                m_streamRenderer->discard();
+            } else {
+                m_streamRenderer->finish();
             }
+            runToolCalls();
             
+            m_currentReply->deleteLater();
+            m_currentReply = nullptr;
+            postChatRequest();
+            return;
+        }
+        qDebug() << "流式响应完成，累积内容长度:" << m_currentAIResponse.length();
+        
+        // 内容已经在流式输出中显示，这里只需渲染剩余部分
+        if (toolCallsRequested) {
+            // 达到轮数上限后请求中已不再提供工具，服务端仍要求调用时停止，不再继续请求
+            if (m_currentAIResponse.isEmpty()) {
+                m_streamRenderer->discard();
+            } else {
+                m_streamRenderer->finish();
+            }
+            showErrorMessage(QString("工具调用已达到上限（%1轮），已停止，请缩小问题范围后重试").arg(kMaxToolRounds));
+            m_currentAIResponse.clear();
+        } else if (m_currentAIResponse.isEmpty()) {
+            // 没有收到任何内容，删除"正在思考中..."并显示错误
+            m_streamRenderer->discard();
             showErrorMessage("没有收到AI响应内容");
         } else {
-            // 检测内容是否包含Markdown格式，如果是则重新渲染
-            if (isMarkdownContent(m_currentAIResponse)) {
-                qDebug() << "检测到Markdown内容，删除纯文本并重新渲染...";
-                
-                // 删除最后一个AI消息段落（纯文本流式输出）
-                QTextCursor cursor = m_chatDisplay->textCursor();
-                cursor.movePosition(QTextCursor::End);
-                cursor.movePosition(QTextCursor::StartOfBlock);
-                
-                // 检查是否是左对齐的AI消息
-                QTextBlockFormat blockFormat = cursor.blockFormat();
-                if (blockFormat.alignment() == Qt::AlignLeft) {
-                    qDebug() << "找到AI消息段落，删除...";
-                    
-                    // 选择并删除整个段落
-                    cursor.select(QTextCursor::BlockUnderCursor);
-                    cursor.removeSelectedText();
-                    cursor.deletePreviousChar(); // 删除段落分隔符
-                    
-                    qDebug() << "已删除纯文本，准备插入Markdown版本";
-                }
-                
-                // 一次性插入Markdown渲染的完整内容
-                appendAIMessageWithMarkdown(m_currentAIResponse);
-                qDebug() << "已插入Markdown渲染内容";
-            }
+            m_streamRenderer->finish();
         }
+        // 用过本地工具的回答依赖当时的工程状态，不写入缓存
+        AIResponseCache::instance()->finishRequest(m_requestKey, m_currentAIResponse, m_toolRounds == 0);
     }
     
     m_currentReply->deleteLater();
     m_currentReply = nullptr;
+    endRequest();
+}
+
+void AIChatDialog::onCancelRequest()
+{
+    if (!m_isWaitingForResponse) {
+        return;
+    }
+    
+    m_cancelRequested = true;
+    if (m_currentReply) {
+        // 后续处理在 onNetworkReplyFinished 中完成
+        m_currentReply->abort();
+        return;
+    }
+    
+    // 仍在查询缓存或等待相同请求：丢弃之后到达的结果
+    m_requestKey.clear();
+    m_streamRenderer->discard();
+    appendToolNotice("已取消");
+    endRequest();
+}
+
+void AIChatDialog::replayResponse(const QString& content, const QString& note)
+{
+    // 占位文字仍在，一次写入全部内容
+    m_currentAIResponse = content;
+    m_streamRenderer->append(content);
+    m_streamRenderer->finish();
+    appendToolNotice(note);
+    endRequest();
+}
+
+void AIChatDialog::endRequest()
+{
     m_isWaitingForResponse = false;
+    m_cancelButton->setEnabled(false);
     onTextChanged(); // 更新发送按钮状态
 }
 
+void AIChatDialog::runToolCalls()
+{
+    QJsonArray toolCalls;
+    for (auto it = m_toolCalls.begin(); it != m_toolCalls.end(); ++it) {
+        // 个别服务不返回调用ID，按序号补上
+        if (it->id.isEmpty()) {
+            it->id = QString("call_%1").arg(it.key());
+        }
+        QJsonObject function;
+        function["name"] = it->name;
+        function["arguments"] = it->arguments;
+        QJsonObject call;
+        call["id"] = it->id;
+        call["type"] = "function";
+        call["function"] = function;
+        toolCalls.append(call);
+    }
+    
+    QJsonObject assistantMessage;
+    assistantMessage["role"] = "assistant";
+    assistantMessage["content"] = m_currentAIResponse.isEmpty() ? QJsonValue() : QJsonValue(m_currentAIResponse);
+    assistantMessage["tool_calls"] = toolCalls;
+    m_messages.append(assistantMessage);
+    
+    QStringList names;
+    for (auto it = m_toolCalls.constBegin(); it != m_toolCalls.constEnd(); ++it) {
+        QJsonObject toolMessage;
+        toolMessage["role"] = "tool";
+        toolMessage["tool_call_id"] = it->id;
+        toolMessage["content"] = m_toolBridge->call(it->name, it->arguments);
+        m_messages.append(toolMessage);
+        names << it->name;
+    }
+    ++m_toolRounds;
+    
+    appendToolNotice(QString("已查询本地配置: %1").arg(names.join(", ")));
+}
+
+void AIChatDialog::appendToolNotice(const QString& text)
+{
+    QString html = QString(
+        "<div style=\"margin: 4px 0; text-align: left;\">"
+        "<span style=\"color: #7f8c8d; font-size: 12px; font-style: italic;\">%1</span></div>"
+    ).arg(text.toHtmlEscaped());
+    
+    m_chatDisplay->append(html);
+    scrollToBottom();
+}
+
 void AIChatDialog::onRetryConnection()
 {
     setConnectionStatus(true);
@@ -588,174 +766,6 @@ void AIChatDialog::appendAIMessage(const QString& message)
     scrollToBottom();
 }
 
-void AIChatDialog::updateAIResponse()
-{
-    qDebug() << "调用updateAIResponse()，当前累积内容长度:" << m_currentAIResponse.length();
-    qDebug() << "当前累积内容:" << m_currentAIResponse;
-    
-    // 移除最后一个"正在思考中..."消息并添加实际响应
-    QString currentHtml = m_chatDisplay->toHtml();
-    int lastThinkingIndex = currentHtml.lastIndexOf("正在思考中...");
-    
-    qDebug() << "搜索'正在思考中...'的位置:" << lastThinkingIndex;
-    
-    if (lastThinkingIndex != -1) {
-        // 找到"正在思考中..."的开始位置
-        int divStart = currentHtml.lastIndexOf("<div", lastThinkingIndex);
-        int divEnd = currentHtml.indexOf("</div>", lastThinkingIndex) + 6;
-        
-        qDebug() << "找到div范围: start=" << divStart << ", end=" << divEnd;
-        
-        if (divStart != -1 && divEnd != -1) {
-            // 替换整个消息
-            QString beforeDiv = currentHtml.left(divStart);
-            QString afterDiv = currentHtml.mid(divEnd);
-            
-            // 创建新的AI响应HTML
-            QString aiResponseHtml = QString(
-                "<div style=\"margin: 10px 0; text-align: left;\">"
-                "<div style=\"background-color: #ecf0f1; color: #2c3e50; padding: 10px 15px; "
-                "border-radius: 18px; display: inline-block; max-width: 65%; word-wrap: break-word; "
-                "font-size: 14px; line-height: 1.5; box-shadow: 0 2px 5px rgba(0, 0, 0, 0.1);\">"
-                "%1</div></div>"
-            ).arg(m_currentAIResponse.toHtmlEscaped());
-            
-            QString newHtml = beforeDiv + aiResponseHtml + afterDiv;
-            qDebug() << "设置新的HTML内容，AI响应长度:" << aiResponseHtml.length();
-            m_chatDisplay->setHtml(newHtml);
-        } else {
-            qDebug() << "无法找到有效的div范围，直接添加新消息";
-            appendAIMessage(m_currentAIResponse);
-        }
-    } else {
-        // 如果没找到"正在思考中..."，直接添加新消息
-        qDebug() << "没有找到'正在思考中...'，直接添加新消息";
-        appendAIMessage(m_currentAIResponse);
-    }
-    
-    scrollToBottom();
-    qDebug() << "完成updateAIResponse()";
-}
-
-void AIChatDialog::updateAIResponseWithContent(const QString& content)
-{
-    // 移除最后一个"正在思考中..."消息并添加AI响应
-    QString currentHtml = m_chatDisplay->toHtml();
-    int lastThinkingIndex = currentHtml.lastIndexOf("正在思考中...");
-    
-    if (lastThinkingIndex != -1) {
-        // 找到"正在思考中..."的开始位置
-        int divStart = currentHtml.lastIndexOf("<div", lastThinkingIndex);
-        int divEnd = currentHtml.indexOf("</div>", lastThinkingIndex) + 6;
-        
-        if (divStart != -1 && divEnd != -1) {
-            // 替换整个消息
-            QString beforeDiv = currentHtml.left(divStart);
-            QString afterDiv = currentHtml.mid(divEnd);
-            
-            // 创建新的AI响应HTML
-            QString aiResponseHtml = QString(
-                "<div style=\"margin: 10px 0; text-align: left;\">"
-                "<div style=\"background-color: #ecf0f1; color: #2c3e50; padding: 10px 15px; "
-                "border-radius: 18px; display: inline-block; max-width: 65%; word-wrap: break-word; "
-                "font-size: 14px; line-height: 1.5; box-shadow: 0 2px 5px rgba(0, 0, 0, 0.1);\">"
-                "%1</div></div>"
-            ).arg(content.toHtmlEscaped());
-            
-            QString newHtml = beforeDiv + aiResponseHtml + afterDiv;
-            m_chatDisplay->setHtml(newHtml);
-        }
-    } else {
-        // 如果没找到"正在思考中..."，直接添加新消息
-        appendAIMessage(content);
-    }
-    
-    scrollToBottom();
-}
-
-void AIChatDialog::updateAIResponseStreamContent(const QString& newContent)
-{
-    if (m_isFirstContentChunk) {
-        // 第一次收到内容，删除"正在思考中..."并创建AI消息气泡
-        m_isFirstContentChunk = false;
-        
-        // 查找并删除"正在思考中..."消息
-        QString currentText = m_chatDisplay->toPlainText();
-        int lastThinkingIndex = currentText.lastIndexOf("正在思考中...");
-        
-        if (lastThinkingIndex != -1) {
-            QTextCursor cursor = m_chatDisplay->textCursor();
-            cursor.movePosition(QTextCursor::Start);
-            QTextDocument* doc = m_chatDisplay->document();
-            cursor = doc->find("正在思考中...", cursor);
-            
-            if (!cursor.isNull()) {
-                // 选择并删除整个块
-                cursor.movePosition(QTextCursor::StartOfBlock);
-                cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
-                cursor.removeSelectedText();
-                cursor.deletePreviousChar(); // 删除空行
-            }
-        }
-        
-        // 创建新的AI消息区域
-        QTextCursor cursor = m_chatDisplay->textCursor();
-        cursor.movePosition(QTextCursor::End);
-        
-        // 创建左对齐的块格式，增加上下间距
-        QTextBlockFormat blockFormat;
-        blockFormat.setAlignment(Qt::AlignLeft);
-        blockFormat.setTopMargin(15);      // 上边距
-        blockFormat.setBottomMargin(15);   // 下边距
-        cursor.insertBlock(blockFormat);
-        
-        // 插入AI消息的起始HTML
-        QString html = QString(
-            "<span style=\"background-color: #ffffffff; color: #2c3e50; padding: 10px 15px; "
-            "border-radius: 18px; display: inline-block; max-width: 65%; word-wrap: break-word; "
-            "font-size: 14px; line-height: 1.5; box-shadow: 0 2px 5px rgba(0, 0, 0, 0.1);\">"
-            "%1</span>"
-        ).arg(newContent.toHtmlEscaped());
-        
-        cursor.insertHtml(html);
-        
-        // 保存当前文档末尾位置作为插入点
-        m_streamCursor = m_chatDisplay->textCursor();
-        m_streamCursor.movePosition(QTextCursor::End);
-        
-    } else {
-        // 后续内容片段，在文档末尾追加（不是替换）
-        // 获取当前HTML内容
-        QString currentHtml = m_chatDisplay->toHtml();
-        
-        // 找到最后一个</span>标签的位置
-        int lastSpanClose = currentHtml.lastIndexOf("</span>");
-        
-        if (lastSpanClose != -1) {
-            // 在最后一个</span>之前插入新内容
-            QString beforeSpan = currentHtml.left(lastSpanClose);
-            QString afterSpan = currentHtml.mid(lastSpanClose);
-            
-            // 拼接新内容
-            QString newHtml = beforeSpan + newContent.toHtmlEscaped() + afterSpan;
-            
-            // 保存滚动条位置
-            QScrollBar* scrollBar = m_chatDisplay->verticalScrollBar();
-            bool wasAtBottom = (scrollBar->value() >= scrollBar->maximum() - 10);
-            
-            // 更新HTML
-            m_chatDisplay->setHtml(newHtml);
-            
-            // 恢复滚动位置或滚动到底部
-            if (wasAtBottom) {
-                scrollBar->setValue(scrollBar->maximum());
-            }
-        }
-    }
-    
-    scrollToBottom();
-}
-
 void AIChatDialog::showErrorMessage(const QString& error)
 {
     QString html = QString(
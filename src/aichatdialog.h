@@ -13,10 +13,16 @@
 #include <QNetworkReply>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
 #include <QScrollBar>
 #include <QTimer>
 #include <QEvent>
 #include <QKeyEvent>
+#include <functional>
+#include "ssedecoder.h"
+#include "aitoolbridge.h"
+
+class ChatStreamRenderer;
 
 class AIChatDialog : public QDialog
 {
@@ -26,12 +32,19 @@ public:
     explicit AIChatDialog(QWidget *parent = nullptr);
     ~AIChatDialog();
 
+    // 发送问题时调用，返回随请求附加的工程上下文
+    using ContextProvider = std::function<QString(const QString& question)>;
+    void setContextProvider(const ContextProvider& provider);
+    // 模型可调用的本地工具，为空时不启用工具调用
+    void setToolBridge(const AIToolBridge *toolBridge);
+
 private slots:
     void onSendMessage();
     void onTextChanged();
     void onNetworkReplyFinished();
     void onNetworkReplyReadyRead();
     void onRetryConnection();
+    void onCancelRequest();
 
 protected:
     bool eventFilter(QObject *obj, QEvent *event) override;
@@ -40,13 +53,16 @@ private:
     void setupUI();
     void setupStyles();
     void sendMessageToAI(const QString& message);
+    void postChatRequest();
+    void runToolCalls();
+    void appendToolNotice(const QString& text);
+    void replayResponse(const QString& content, const QString& note);
+    void endRequest();
     void appendUserMessage(const QString& message);
     void appendAIMessage(const QString& message);
     void appendAIMessageWithMarkdown(const QString& markdown);
     bool isMarkdownContent(const QString& content);
-    void updateAIResponse();
-    void updateAIResponseWithContent(const QString& content);
-    void updateAIResponseStreamContent(const QString& newContent);
+    void handleStreamEvents(const QList<SseEvent>& events);
     void showErrorMessage(const QString& error);
     void setConnectionStatus(bool connected);
     void scrollToBottom();
@@ -64,21 +80,39 @@ private:
     QTextEdit *m_inputLineEdit;
     QPushButton *m_sendButton;
     QPushButton *m_clearButton;
+    QPushButton *m_cancelButton;
     
     // 网络相关
     QNetworkAccessManager *m_networkManager;
     QNetworkReply *m_currentReply;
+    SseDecoder m_sseDecoder;        // 跨数据块缓存未完成的SSE行
     
     // AI API配置
     QString m_apiKey;
     QString m_baseUrl;
     QString m_model;
+    ContextProvider m_contextProvider;
     
     // 状态管理
     bool m_isConnected;
     QString m_currentAIResponse;
-    bool m_isFirstContentChunk; // 标记是否为第一个内容片段
-    QTextCursor m_streamCursor; // 用于流式更新的光标位置
+    ChatStreamRenderer *m_streamRenderer; // 流式写入当前AI回复
+    
+    // 工具调用
+    struct PendingToolCall {
+        QString id;
+        QString name;
+        QString arguments;
+    };
+    static constexpr int kMaxToolRounds = 4;    // 单个问题最多的工具调用轮数
+    const AIToolBridge *m_toolBridge;
+    QJsonArray m_messages;                      // 当前问题的完整消息列表（含工具调用结果）
+    QMap<int, PendingToolCall> m_toolCalls;     // 本轮流式返回的工具调用，按 index
+    int m_toolRounds;
+    
+    // 回复缓存与取消
+    QString m_requestKey;           // 当前问题的缓存键，取消后清空以丢弃迟到的结果
+    bool m_cancelRequested;
     
     // UI状态
     bool m_isWaitingForResponse;
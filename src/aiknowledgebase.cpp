@@ -0,0 +1,113 @@
+#include "aiknowledgebase.h"
+#include "pinfunction.h"
+#include <QDir>
+#include <QFile>
+
+AIKnowledgeBase::AIKnowledgeBase(QObject *parent)
+    : QObject(parent)
+    , m_building(false)
+    , m_rebuildPending(false)
+{
+    m_buildPool.setMaxThreadCount(1);
+}
+
+AIKnowledgeBase::~AIKnowledgeBase()
+{
+    m_buildPool.waitForDone();
+}
+
+void AIKnowledgeBase::setDocuments(const QString& group, const QList<KnowledgeDocument>& documents)
+{
+    if (documents.isEmpty()) {
+        m_groups.remove(group);
+    } else {
+        m_groups.insert(group, documents);
+    }
+    rebuild();
+}
+
+void AIKnowledgeBase::setDocuments(const QMap<QString, QList<KnowledgeDocument>>& groups)
+{
+    for (auto it = groups.constBegin(); it != groups.constEnd(); ++it) {
+        if (it.value().isEmpty()) {
+            m_groups.remove(it.key());
+        } else {
+            m_groups.insert(it.key(), it.value());
+        }
+    }
+    rebuild();
+}
+
+QList<RetrievalHit> AIKnowledgeBase::search(const QString& query, int topK) const
+{
+    if (!m_index) {
+        return {};
+    }
+    return m_index->search(query, topK);
+}
+
+bool AIKnowledgeBase::isReady() const
+{
+    return m_index != nullptr;
+}
+
+void AIKnowledgeBase::rebuild()
+{
+    // 重建期间又有文档更新时，当前重建完成后再重建一次
+    if (m_building) {
+        m_rebuildPending = true;
+        return;
+    }
+
+    m_building = true;
+    m_rebuildPending = false;
+
+    const QMap<QString, QList<KnowledgeDocument>> groups = m_groups;
+    m_buildPool.start([this, groups]() {
+        auto index = std::make_shared<RetrievalIndex>();
+        for (const QList<KnowledgeDocument>& documents : groups) {
+            for (const KnowledgeDocument& document : documents) {
+                index->addDocument(document.source, document.text, document.markdown);
+            }
+        }
+
+        std::shared_ptr<const RetrievalIndex> built = index;
+        QMetaObject::invokeMethod(this, [this, built]() {
+            m_index = built;
+            m_building = false;
+            emit indexRebuilt(built->chunkCount());
+
+            if (m_rebuildPending) {
+                rebuild();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+QList<KnowledgeDocument> AIKnowledgeBase::builtinDocuments()
+{
+    QList<KnowledgeDocument> documents;
+
+    QDir docsDir(":/docs");
+    const QStringList names = docsDir.entryList({"*.md"}, QDir::Files, QDir::Name);
+    for (const QString& name : names) {
+        QFile file(docsDir.filePath(name));
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            documents.append({name, QString::fromUtf8(file.readAll()), true});
+        }
+    }
+
+    // 引脚功能表：每个引脚一行
+    PinFunction pinFunction;
+    QString pinTable;
+    const QStringList pinNames = pinFunction.getPinNames();
+    for (const QString& pinName : pinNames) {
+        pinTable += QString("引脚 %1 可选功能: %2 (默认 %3)\n")
+                        .arg(pinName,
+                             pinFunction.getSupportedFunctions(pinName).join(", "),
+                             pinFunction.getDefaultFunction(pinName));
+    }
+    documents.append({"引脚功能表", pinTable, false});
+
+    return documents;
+}
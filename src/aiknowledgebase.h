@@ -0,0 +1,49 @@
+#ifndef AIKNOWLEDGEBASE_H
+#define AIKNOWLEDGEBASE_H
+
+#include <QObject>
+#include <QMap>
+#include <QThreadPool>
+#include <memory>
+#include "retrievalindex.h"
+
+struct KnowledgeDocument {
+    QString source;
+    QString text;
+    bool markdown = false;
+};
+
+// AI助手的本地知识库：内置说明文档、引脚数据库以及当前工程的设备树/defconfig/时钟/内存
+// 文档按组替换（如 "docs"、"dts"、"defconfig"），每次替换后在后台重建 BM25 索引，
+// 重建期间检索使用上一份索引
+class AIKnowledgeBase : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AIKnowledgeBase(QObject *parent = nullptr);
+    ~AIKnowledgeBase();
+
+    void setDocuments(const QString& group, const QList<KnowledgeDocument>& documents);
+    // 一次替换多组文档，只重建一次索引；空列表表示移除该组
+    void setDocuments(const QMap<QString, QList<KnowledgeDocument>>& groups);
+    QList<RetrievalHit> search(const QString& query, int topK) const;
+    bool isReady() const;
+
+    // 随程序打包的说明文档（资源 :/docs）和引脚功能表
+    static QList<KnowledgeDocument> builtinDocuments();
+
+signals:
+    void indexRebuilt(int chunkCount);
+
+private:
+    void rebuild();
+
+    QMap<QString, QList<KnowledgeDocument>> m_groups;
+    std::shared_ptr<const RetrievalIndex> m_index;
+    QThreadPool m_buildPool;    // 单线程，析构时等待其结束
+    bool m_building;
+    bool m_rebuildPending;
+};
+
+#endif // AIKNOWLEDGEBASE_H
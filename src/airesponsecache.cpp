@@ -0,0 +1,129 @@
+#include "airesponsecache.h"
+#include "artifactcache.h"
+#include "fileioservice.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QSettings>
+
+static QFuture<QString> readyFuture(const QString& content)
+{
+    QPromise<QString> promise;
+    QFuture<QString> future = promise.future();
+    promise.start();
+    promise.addResult(content);
+    promise.finish();
+    return future;
+}
+
+AIResponseCache* AIResponseCache::instance()
+{
+    static QPointer<AIResponseCache> cache;
+    if (!cache) {
+        cache = new AIResponseCache(QCoreApplication::instance());
+    }
+    return cache;
+}
+
+AIResponseCache::AIResponseCache(QObject *parent)
+    : QObject(parent)
+{
+    m_readPool.setMaxThreadCount(1);
+}
+
+AIResponseCache::~AIResponseCache()
+{
+    m_readPool.waitForDone();
+}
+
+QString AIResponseCache::requestKey(const QString& model, const QJsonArray& messages)
+{
+    QByteArray data = model.toUtf8() + '\n' + QJsonDocument(messages).toJson(QJsonDocument::Compact);
+    return QString("%1").arg(ArtifactCache::hash64(data.constData(), data.size()), 16, 16, QChar('0'));
+}
+
+QString AIResponseCache::entryPath(const QString& key)
+{
+    return QDir(ArtifactCache::cacheDirectory()).absoluteFilePath(QString("ai-responses/%1.json").arg(key));
+}
+
+int AIResponseCache::ttlHours() const
+{
+    QSettings settings("CviTek", "CviCubeMX");
+    return settings.value("aiCacheTtlHours", 24).toInt();
+}
+
+QString AIResponseCache::readEntry(const QString& path, qint64 ttlMs)
+{
+    // 未命中是常态，文件不存在或无法解析时直接返回空串
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    QJsonObject entry = QJsonDocument::fromJson(file.readAll()).object();
+    qint64 age = QDateTime::currentMSecsSinceEpoch() - qint64(entry["created"].toDouble());
+    if (age < 0 || age > ttlMs) {
+        return QString();
+    }
+    return entry["content"].toString();
+}
+
+QFuture<QString> AIResponseCache::lookup(const QString& key) const
+{
+    const qint64 ttlMs = qint64(ttlHours()) * 3600 * 1000;
+    if (ttlMs <= 0) {
+        return readyFuture(QString());
+    }
+
+    // 读取和解析在缓存自己的线程完成
+    auto promise = std::make_shared<QPromise<QString>>();
+    QFuture<QString> future = promise->future();
+    promise->start();
+    const QString path = entryPath(key);
+    m_readPool.start([promise, path, ttlMs]() {
+        promise->addResult(readEntry(path, ttlMs));
+        promise->finish();
+    });
+    return future;
+}
+
+bool AIResponseCache::beginRequest(const QString& key)
+{
+    if (m_inFlight.contains(key)) {
+        return false;
+    }
+
+    auto promise = std::make_shared<QPromise<QString>>();
+    promise->start();
+    m_inFlight.insert(key, promise);
+    return true;
+}
+
+QFuture<QString> AIResponseCache::pending(const QString& key) const
+{
+    auto promise = m_inFlight.value(key);
+    return promise ? promise->future() : readyFuture(QString());
+}
+
+void AIResponseCache::finishRequest(const QString& key, const QString& content, bool cacheable)
+{
+    auto promise = m_inFlight.take(key);
+    if (promise) {
+        promise->addResult(content);
+        promise->finish();
+    }
+
+    if (!cacheable || content.isEmpty() || ttlHours() <= 0) {
+        return;
+    }
+
+    QJsonObject entry;
+    entry["created"] = double(QDateTime::currentMSecsSinceEpoch());
+    entry["content"] = content;
+    FileIoService::instance()->writeData(entryPath(key), QJsonDocument(entry).toJson(QJsonDocument::Compact),
+                                         "AI回复缓存");
+}
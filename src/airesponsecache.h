@@ -0,0 +1,46 @@
+#ifndef AIRESPONSECACHE_H
+#define AIRESPONSECACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QFuture>
+#include <QPromise>
+#include <QJsonArray>
+#include <QThreadPool>
+#include <memory>
+
+// AI回复的磁盘缓存（用户缓存目录下），键为 模型+完整消息列表（含工程上下文）的哈希
+// 超过有效期（设置项 aiCacheTtlHours，默认24小时，0为不缓存）的条目不再使用
+// 同一请求正在进行时，后来的相同请求等待它的结果，不重复发送
+class AIResponseCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static AIResponseCache* instance();
+
+    static QString requestKey(const QString& model, const QJsonArray& messages);
+
+    // 后台读取缓存条目，未命中或已过期时结果为空串
+    // 使用自己的读取线程，不进入SDK文件I/O队列，未命中也不作为失败上报
+    QFuture<QString> lookup(const QString& key) const;
+
+    // 登记即将发送的请求；相同请求已在进行时返回 false，此时用 pending() 等待其结果
+    bool beginRequest(const QString& key);
+    QFuture<QString> pending(const QString& key) const;
+    // 请求结束：通知等待者，cacheable 时写入缓存；content 为空表示失败或取消
+    void finishRequest(const QString& key, const QString& content, bool cacheable);
+
+    int ttlHours() const;
+
+private:
+    explicit AIResponseCache(QObject *parent = nullptr);
+    ~AIResponseCache() override;
+    static QString entryPath(const QString& key);
+    static QString readEntry(const QString& path, qint64 ttlMs);
+
+    QHash<QString, std::shared_ptr<QPromise<QString>>> m_inFlight;
+    mutable QThreadPool m_readPool;     // 单线程，析构时等待其结束
+};
+
+#endif // AIRESPONSECACHE_H
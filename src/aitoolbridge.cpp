@@ -0,0 +1,86 @@
+#include "aitoolbridge.h"
+#include <QJsonDocument>
+
+void AIToolBridge::registerTool(const QString& name, const QString& description,
+                                const QJsonObject& parameters, const Handler& handler)
+{
+    m_tools.insert(name, {description, parameters, handler});
+}
+
+bool AIToolBridge::isEmpty() const
+{
+    return m_tools.isEmpty();
+}
+
+QJsonArray AIToolBridge::toolDefinitions() const
+{
+    QJsonArray definitions;
+    for (auto it = m_tools.constBegin(); it != m_tools.constEnd(); ++it) {
+        QJsonObject function;
+        function["name"] = it.key();
+        function["description"] = it->description;
+        function["parameters"] = it->parameters;
+
+        QJsonObject definition;
+        definition["type"] = "function";
+        definition["function"] = function;
+        definitions.append(definition);
+    }
+    return definitions;
+}
+
+QString AIToolBridge::call(const QString& name, const QString& arguments) const
+{
+    QJsonObject result;
+    auto it = m_tools.constFind(name);
+    if (it == m_tools.constEnd()) {
+        result["error"] = QString("未知工具: %1").arg(name);
+        return QString::fromUtf8(QJsonDocument(result).toJson(QJsonDocument::Compact));
+    }
+
+    QJsonObject args;
+    if (!arguments.trimmed().isEmpty()) {
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(arguments.toUtf8(), &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            result["error"] = QString("参数不是有效的JSON对象: %1").arg(error.errorString());
+            return QString::fromUtf8(QJsonDocument(result).toJson(QJsonDocument::Compact));
+        }
+        args = doc.object();
+    }
+
+    result = it->handler(args);
+
+    return QString::fromUtf8(QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+bool AIToolBridge::hasTool(const QString& name) const
+{
+    return m_tools.contains(name);
+}
+
+QJsonObject AIToolBridge::invoke(const QString& name, const QJsonObject& arguments) const
+{
+    auto it = m_tools.constFind(name);
+    if (it == m_tools.constEnd()) {
+        return QJsonObject();
+    }
+    return it->handler(arguments);
+}
+
+QJsonObject AIToolBridge::objectSchema(const QJsonObject& properties, const QStringList& required)
+{
+    QJsonObject schema;
+    schema["type"] = "object";
+    schema["properties"] = properties;
+    schema["required"] = QJsonArray::fromStringList(required);
+    return schema;
+}
+
+QJsonObject AIToolBridge::property(const QString& type, const QString& description)
+{
+    QJsonObject prop;
+    prop["type"] = type;
+    prop["description"] = description;
+    return prop;
+}
@@ -0,0 +1,45 @@
+#ifndef AITOOLBRIDGE_H
+#define AITOOLBRIDGE_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <functional>
+
+// AI助手可调用的本地工具（OpenAI tools 格式）
+// 工具在进程内直接查询引脚/时钟/内存模型，模型只获取需要的信息，请求不必附带完整配置
+class AIToolBridge
+{
+public:
+    using Handler = std::function<QJsonObject(const QJsonObject& arguments)>;
+
+    // parameters 为参数的 JSON Schema（object 类型）
+    void registerTool(const QString& name, const QString& description,
+                      const QJsonObject& parameters, const Handler& handler);
+    bool isEmpty() const;
+    QJsonArray toolDefinitions() const;
+
+    // arguments 为模型给出的JSON字符串；返回作为 tool 消息内容的JSON字符串，出错时包含 error 字段
+    QString call(const QString& name, const QString& arguments) const;
+
+    // 已解析参数的调用（本地RPC服务使用），未知工具返回空对象
+    bool hasTool(const QString& name) const;
+    QJsonObject invoke(const QString& name, const QJsonObject& arguments) const;
+
+    // 构造参数 schema：properties 为 名称 -> {type, description}
+    static QJsonObject objectSchema(const QJsonObject& properties, const QStringList& required);
+    static QJsonObject property(const QString& type, const QString& description);
+
+private:
+    struct Tool {
+        QString description;
+        QJsonObject parameters;
+        Handler handler;
+    };
+
+    QMap<QString, Tool> m_tools;
+};
+
+#endif // AITOOLBRIDGE_H
@@ -0,0 +1,186 @@
+#include "artifactcache.h"
+#include <QFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <cstring>
+
+static constexpr quint64 kPrime1 = 0x9E3779B185EBCA87ULL;
+static constexpr quint64 kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr quint64 kPrime3 = 0x165667B19E3779F9ULL;
+static constexpr quint64 kPrime4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr quint64 kPrime5 = 0x27D4EB2F165667C5ULL;
+
+static inline quint64 rotl64(quint64 value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline quint64 read64(const uchar* p)
+{
+    quint64 value;
+    std::memcpy(&value, p, sizeof(value));
+    return qFromLittleEndian(value);
+}
+
+static inline quint32 read32(const uchar* p)
+{
+    quint32 value;
+    std::memcpy(&value, p, sizeof(value));
+    return qFromLittleEndian(value);
+}
+
+static inline quint64 xxhRound(quint64 acc, quint64 input)
+{
+    acc += input * kPrime2;
+    acc = rotl64(acc, 31);
+    return acc * kPrime1;
+}
+
+static inline quint64 xxhMergeRound(quint64 acc, quint64 value)
+{
+    acc ^= xxhRound(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+ArtifactStamp ArtifactStamp::fromResult(const FileIoResult& result)
+{
+    ArtifactStamp stamp;
+    if (result.ok) {
+        stamp.filePath = result.filePath;
+        stamp.size = result.fileSize;
+        stamp.modifiedMs = result.lastModifiedMs;
+        stamp.hash = result.contentHash;
+    }
+    return stamp;
+}
+
+quint64 ArtifactCache::hash64(const char* data, qsizetype length, quint64 seed)
+{
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    const uchar* const end = p + length;
+    quint64 h;
+
+    if (length >= 32) {
+        const uchar* const limit = end - 32;
+        quint64 v1 = seed + kPrime1 + kPrime2;
+        quint64 v2 = seed + kPrime2;
+        quint64 v3 = seed;
+        quint64 v4 = seed - kPrime1;
+
+        do {
+            v1 = xxhRound(v1, read64(p));
+            v2 = xxhRound(v2, read64(p + 8));
+            v3 = xxhRound(v3, read64(p + 16));
+            v4 = xxhRound(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxhMergeRound(h, v1);
+        h = xxhMergeRound(h, v2);
+        h = xxhMergeRound(h, v3);
+        h = xxhMergeRound(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+
+    h += static_cast<quint64>(length);
+
+    while (p + 8 <= end) {
+        h ^= xxhRound(0, read64(p));
+        h = rotl64(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<quint64>(read32(p)) * kPrime1;
+        h = rotl64(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= static_cast<quint64>(*p) * kPrime5;
+        h = rotl64(h, 11) * kPrime1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+QString ArtifactCache::cacheDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation))
+        .absoluteFilePath("CviTek/CviCubeMX/artifacts");
+}
+
+QString ArtifactCache::entryPath(const QString& kind, const QString& filePath)
+{
+    QByteArray key = (kind + '\n' + QDir::cleanPath(filePath)).toUtf8();
+    return QDir(cacheDirectory()).absoluteFilePath(
+        QString("%1.cache").arg(hash64(key.constData(), key.size()), 16, 16, QChar('0')));
+}
+
+bool ArtifactCache::load(const QString& kind, const ArtifactStamp& stamp, const Reader& reader)
+{
+    if (!stamp.isValid()) {
+        return false;
+    }
+
+    QFile file(entryPath(kind, stamp.filePath));
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0) {
+        return false;
+    }
+
+    // 反序列化直接读映射内存，不再把缓存文件复制一份
+    uchar *mapped = file.map(0, file.size());
+    if (!mapped) {
+        return false;
+    }
+
+    bool ok = false;
+    {
+        const QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file.size());
+        QDataStream in(raw);
+        in.setVersion(QDataStream::Qt_6_0);
+
+        quint32 magic = 0;
+        quint32 version = 0;
+        QString entryKind;
+        QString entryFilePath;
+        qint64 size = -1;
+        qint64 modifiedMs = 0;
+        quint64 hash = 0;
+        in >> magic >> version >> entryKind >> entryFilePath >> size >> modifiedMs >> hash;
+
+        ok = in.status() == QDataStream::Ok &&
+             magic == kMagic && version == kFormatVersion &&
+             entryKind == kind && entryFilePath == QDir::cleanPath(stamp.filePath) &&
+             size == stamp.size && hash == stamp.hash;
+        ok = ok && reader(in) && in.status() == QDataStream::Ok;
+    }
+
+    file.unmap(mapped);
+    return ok;
+}
+
+void ArtifactCache::store(const QString& kind, const ArtifactStamp& stamp, const Writer& writer)
+{
+    if (!stamp.isValid()) {
+        return;
+    }
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << kMagic << kFormatVersion << kind << QDir::cleanPath(stamp.filePath)
+            << stamp.size << stamp.modifiedMs << stamp.hash;
+        writer(out);
+    }
+
+    FileIoService::instance()->writeData(entryPath(kind, stamp.filePath), data, "解析缓存");
+}
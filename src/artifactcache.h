@@ -0,0 +1,47 @@
+#ifndef ARTIFACTCACHE_H
+#define ARTIFACTCACHE_H
+
+#include <QString>
+#include <QDataStream>
+#include <functional>
+#include "fileioservice.h"
+
+// 源文件的身份：大小与内容哈希一致才认为缓存有效
+// 修改时间只做记录，git checkout/拷贝到NFS等只改mtime的操作不会让缓存失效
+struct ArtifactStamp {
+    QString filePath;
+    qint64 size = -1;
+    qint64 modifiedMs = 0;
+    quint64 hash = 0;
+
+    static ArtifactStamp fromResult(const FileIoResult& result);
+    bool isValid() const { return size >= 0 && !filePath.isEmpty(); }
+};
+
+// 解析结果的磁盘缓存（用户缓存目录下），热启动时跳过设备树/defconfig的解析
+// 条目以 类型+源文件路径 为键；读取时映射缓存文件，直接在映射内存上反序列化
+// 类型字符串带解析器版本号（如 "dts-peripherals/1"），解析逻辑变化时改版本号即可淘汰旧条目
+class ArtifactCache
+{
+public:
+    using Reader = std::function<bool(QDataStream& in)>;
+    using Writer = std::function<void(QDataStream& out)>;
+
+    // 条目存在且与stamp一致时调用reader，返回reader的结果
+    static bool load(const QString& kind, const ArtifactStamp& stamp, const Reader& reader);
+    // 序列化在调用线程完成，写文件交给后台I/O线程
+    static void store(const QString& kind, const ArtifactStamp& stamp, const Writer& writer);
+
+    // XXH64，用于校验源文件内容
+    static quint64 hash64(const char* data, qsizetype length, quint64 seed = 0);
+
+    static QString cacheDirectory();
+
+private:
+    static QString entryPath(const QString& kind, const QString& filePath);
+
+    static constexpr quint32 kMagic = 0x43564143;       // "CVAC"
+    static constexpr quint32 kFormatVersion = 1;
+};
+
+#endif // ARTIFACTCACHE_H
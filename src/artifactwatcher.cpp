@@ -0,0 +1,119 @@
+#include "artifactwatcher.h"
+#include "fileioservice.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+
+ArtifactWatcher::ArtifactWatcher(QObject *parent)
+    : QObject(parent)
+    , m_watcher(nullptr)
+    , m_debounceTimer(nullptr)
+{
+    m_watcher = new QFileSystemWatcher(this);
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(300);
+
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &ArtifactWatcher::onFileChanged);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &ArtifactWatcher::onDirectoryChanged);
+    connect(m_debounceTimer, &QTimer::timeout, this, &ArtifactWatcher::flushChanges);
+    connect(FileIoService::instance(), &FileIoService::fileWritten, this, &ArtifactWatcher::onFileWritten);
+}
+
+void ArtifactWatcher::setFiles(const QStringList& filePaths)
+{
+    QSet<QString> files;
+    for (const QString& path : filePaths) {
+        if (!path.isEmpty()) {
+            files.insert(QDir::cleanPath(path));
+        }
+    }
+    if (files == m_files) {
+        return;
+    }
+
+    const QStringList watched = m_watcher->files() + m_watcher->directories();
+    if (!watched.isEmpty()) {
+        m_watcher->removePaths(watched);
+    }
+    m_changed.intersect(files);
+    m_selfWrites.clear();
+    m_files = files;
+
+    QSet<QString> dirs;
+    for (const QString& path : m_files) {
+        if (QFileInfo::exists(path)) {
+            m_watcher->addPath(path);
+        }
+        dirs.insert(QFileInfo(path).absolutePath());
+    }
+    for (const QString& dir : dirs) {
+        if (QFileInfo(dir).isDir()) {
+            m_watcher->addPath(dir);
+        }
+    }
+}
+
+QStringList ArtifactWatcher::files() const
+{
+    return m_files.values();
+}
+
+static QPair<qint64, qint64> fileStamp(const QString& filePath)
+{
+    QFileInfo info(filePath);
+    return qMakePair(info.lastModified().toMSecsSinceEpoch(), info.size());
+}
+
+void ArtifactWatcher::onFileWritten(const QString& filePath)
+{
+    const QString path = QDir::cleanPath(filePath);
+    if (m_files.contains(path)) {
+        m_selfWrites.insert(path, fileStamp(path));
+    }
+}
+
+void ArtifactWatcher::onFileChanged(const QString& filePath)
+{
+    // 改名覆盖后监视会被移除，文件仍在时重新加上
+    rewatch(filePath);
+    m_changed.insert(filePath);
+    m_debounceTimer->start();
+}
+
+void ArtifactWatcher::onDirectoryChanged(const QString& dirPath)
+{
+    // 目录内的变化只关心被监视文件的重新出现
+    for (const QString& path : m_files) {
+        if (QFileInfo(path).absolutePath() == dirPath && !m_watcher->files().contains(path)
+                && QFileInfo::exists(path)) {
+            rewatch(path);
+            m_changed.insert(path);
+            m_debounceTimer->start();
+        }
+    }
+}
+
+void ArtifactWatcher::flushChanges()
+{
+    const QSet<QString> changed = m_changed;
+    m_changed.clear();
+    for (const QString& path : changed) {
+        if (!m_files.contains(path) || !QFileInfo::exists(path)) {
+            continue;
+        }
+        auto selfWrite = m_selfWrites.constFind(path);
+        if (selfWrite != m_selfWrites.constEnd() && selfWrite.value() == fileStamp(path)) {
+            continue;
+        }
+        qDebug() << "检测到文件外部修改：" << path;
+        emit fileChanged(path);
+    }
+}
+
+void ArtifactWatcher::rewatch(const QString& filePath)
+{
+    if (m_files.contains(filePath) && !m_watcher->files().contains(filePath) && QFileInfo::exists(filePath)) {
+        m_watcher->addPath(filePath);
+    }
+}
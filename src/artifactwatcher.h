@@ -0,0 +1,46 @@
+#ifndef ARTIFACTWATCHER_H
+#define ARTIFACTWATCHER_H
+
+#include <QObject>
+#include <QSet>
+#include <QHash>
+#include <QStringList>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+// 监视工具管理的SDK文件（设备树、defconfig、cvi_board_init.c）在外部被修改
+// 编辑器和 QSaveFile 常用"写临时文件再改名"的方式保存，原文件的监视会失效，
+// 因此同时监视所在目录，文件重新出现时补上监视并按一次修改处理；
+// 经 FileIoService 写入的文件在写入后未再变化时不报告
+class ArtifactWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ArtifactWatcher(QObject *parent = nullptr);
+
+    // 替换监视的文件集合，集合不变时不做任何事
+    void setFiles(const QStringList& filePaths);
+    QStringList files() const;
+
+signals:
+    // 同一文件短时间内的多次变化合并为一次
+    void fileChanged(const QString& filePath);
+
+private slots:
+    void onFileWritten(const QString& filePath);
+    void onFileChanged(const QString& filePath);
+    void onDirectoryChanged(const QString& dirPath);
+    void flushChanges();
+
+private:
+    void rewatch(const QString& filePath);
+
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_debounceTimer;
+    QSet<QString> m_files;
+    QSet<QString> m_changed;
+    QHash<QString, QPair<qint64, qint64>> m_selfWrites;    // 自身写入后的 修改时间/大小
+};
+
+#endif // ARTIFACTWATCHER_H
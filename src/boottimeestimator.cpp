@@ -0,0 +1,196 @@
+#include "boottimeestimator.h"
+#include <QRegularExpression>
+#include <QMap>
+
+const double BootTimeEstimator::DEFAULT_APB_FREQ_MHZ = 100.0;
+const double BootTimeEstimator::DEFAULT_AXI_FREQ_MHZ = 300.0;
+
+double BootTimeEstimate::totalUs() const
+{
+    double total = 0.0;
+    for (const BootTimeSection& section : sections) {
+        total += section.totalUs();
+    }
+    return total;
+}
+
+int BootTimeEstimate::totalReads() const
+{
+    int total = 0;
+    for (const BootTimeSection& section : sections) {
+        total += section.mmioReads;
+    }
+    return total;
+}
+
+int BootTimeEstimate::totalWrites() const
+{
+    int total = 0;
+    for (const BootTimeSection& section : sections) {
+        total += section.mmioWrites;
+    }
+    return total;
+}
+
+QString BootTimeEstimate::summary() const
+{
+    return QString("board init ≈ %1 µs").arg(totalUs(), 0, 'f', 1);
+}
+
+QString BootTimeEstimate::breakdown() const
+{
+    QStringList lines;
+    lines << QString("APB %1 MHz / AXI %2 MHz")
+                 .arg(apbFreqMHz, 0, 'f', 1)
+                 .arg(axiFreqMHz, 0, 'f', 1);
+
+    for (const BootTimeSection& section : sections) {
+        lines << QString("%1: %2 读 / %3 写, 总线 %4 µs, 延时 %5 µs, 合计 %6 µs")
+                     .arg(section.name)
+                     .arg(section.mmioReads)
+                     .arg(section.mmioWrites)
+                     .arg(section.busUs, 0, 'f', 2)
+                     .arg(section.delayUs, 0, 'f', 1)
+                     .arg(section.totalUs(), 0, 'f', 2);
+    }
+
+    if (sections.isEmpty()) {
+        lines << "当前没有需要生成的初始化序列";
+    }
+
+    lines << QString("总计: %1 读 / %2 写, %3 µs")
+                 .arg(totalReads())
+                 .arg(totalWrites())
+                 .arg(totalUs(), 0, 'f', 2);
+    return lines.join("\n");
+}
+
+BootTimeEstimator::BootTimeEstimator()
+    : m_apbFreqMHz(DEFAULT_APB_FREQ_MHZ)
+    , m_axiFreqMHz(DEFAULT_AXI_FREQ_MHZ)
+{
+}
+
+void BootTimeEstimator::setBusFrequencies(double apbFreqMHz, double axiFreqMHz)
+{
+    m_apbFreqMHz = apbFreqMHz > 0 ? apbFreqMHz : DEFAULT_APB_FREQ_MHZ;
+    m_axiFreqMHz = axiFreqMHz > 0 ? axiFreqMHz : DEFAULT_AXI_FREQ_MHZ;
+}
+
+double BootTimeEstimator::getApbFrequency() const
+{
+    return m_apbFreqMHz;
+}
+
+double BootTimeEstimator::getAxiFrequency() const
+{
+    return m_axiFreqMHz;
+}
+
+double BootTimeEstimator::readCostUs() const
+{
+    // 频率单位为MHz，周期数/MHz 即为微秒
+    return AXI_READ_CYCLES / m_axiFreqMHz + APB_ACCESS_CYCLES / m_apbFreqMHz;
+}
+
+double BootTimeEstimator::writeCostUs() const
+{
+    return AXI_WRITE_CYCLES / m_axiFreqMHz + APB_ACCESS_CYCLES / m_apbFreqMHz;
+}
+
+QString BootTimeEstimator::sectionForComment(const QString& line, const QString& current) const
+{
+    // 根据 CodeGenerator 输出的注释识别当前所在的代码段
+    if (line.contains("pins configuration")) {
+        return "PINMUX";
+    }
+    // 特殊序列结束标记（如 "PAD_MIPI PINMUX extra config set END"），之后的内容回到 PINMUX 段
+    static const QRegularExpression endRegex("PINMUX\\b.*\\bextra config\\b.*\\bEND\\s*\\*/");
+    if (endRegex.match(line).hasMatch()) {
+        return "PINMUX";
+    }
+    if (line.contains("EPHY") || line.contains("PAD_ETH")) {
+        return "ETH";
+    }
+    if (line.contains("MIPI")) {
+        return "MIPI";
+    }
+    if (line.contains("Audio") || line.contains("PAD_AUD")) {
+        return "Audio";
+    }
+    return current;
+}
+
+BootTimeEstimate BootTimeEstimator::estimate(const QString& code) const
+{
+    static const QRegularExpression readRegex("\\bmmio_read(_32)?\\s*\\(");
+    static const QRegularExpression writeRegex("\\bmmio_write(_32)?\\s*\\(");
+    static const QRegularExpression pinmuxRegex("\\bPINMUX_CONFIG\\s*\\(");
+    static const QRegularExpression udelayRegex("\\budelay\\s*\\(\\s*(\\d+)\\s*\\)");
+    static const QRegularExpression mdelayRegex("\\bmdelay\\s*\\(\\s*(\\d+)\\s*\\)");
+
+    const QStringList sectionOrder = {"PINMUX", "ETH", "MIPI", "Audio"};
+    QMap<QString, BootTimeSection> sections;
+    for (const QString& name : sectionOrder) {
+        sections[name] = BootTimeSection{name, 0, 0, 0.0, 0.0};
+    }
+
+    QString current = "PINMUX";
+    const QStringList lines = code.split('\n');
+    for (const QString& rawLine : lines) {
+        const QString line = rawLine.trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        // 纯注释行只用于识别代码段，不参与统计
+        if (line.startsWith("//") || line.startsWith("/*") || line.startsWith("*")) {
+            current = sectionForComment(line, current);
+            continue;
+        }
+
+        // 去掉行尾注释，避免注释中的函数名被重复统计
+        QString stmt = line;
+        int commentPos = stmt.indexOf("//");
+        if (commentPos >= 0) {
+            stmt = stmt.left(commentPos);
+        }
+        commentPos = stmt.indexOf("/*");
+        if (commentPos >= 0) {
+            stmt = stmt.left(commentPos);
+        }
+
+        BootTimeSection& section = sections[current];
+        section.mmioReads += stmt.count(readRegex);
+        section.mmioWrites += stmt.count(writeRegex);
+
+        // PINMUX_CONFIG 展开为对 FMUX 寄存器的读改写
+        int pinmuxCount = stmt.count(pinmuxRegex);
+        section.mmioReads += pinmuxCount;
+        section.mmioWrites += pinmuxCount;
+
+        QRegularExpressionMatchIterator it = udelayRegex.globalMatch(stmt);
+        while (it.hasNext()) {
+            section.delayUs += it.next().captured(1).toDouble();
+        }
+        it = mdelayRegex.globalMatch(stmt);
+        while (it.hasNext()) {
+            section.delayUs += it.next().captured(1).toDouble() * 1000.0;
+        }
+    }
+
+    BootTimeEstimate result;
+    result.apbFreqMHz = m_apbFreqMHz;
+    result.axiFreqMHz = m_axiFreqMHz;
+
+    for (const QString& name : sectionOrder) {
+        BootTimeSection section = sections[name];
+        if (section.mmioReads == 0 && section.mmioWrites == 0 && section.delayUs <= 0) {
+            continue;
+        }
+        section.busUs = section.mmioReads * readCostUs() + section.mmioWrites * writeCostUs();
+        result.sections.append(section);
+    }
+
+    return result;
+}
@@ -0,0 +1,64 @@
+#ifndef BOOTTIMEESTIMATOR_H
+#define BOOTTIMEESTIMATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+// 单个代码段（PINMUX / ETH / MIPI / Audio）的启动耗时统计
+struct BootTimeSection {
+    QString name;          // 段名称
+    int mmioReads;         // mmio_read 次数（PINMUX_CONFIG 计为一次读改写）
+    int mmioWrites;        // mmio_write 次数
+    double delayUs;        // udelay/mdelay 累计延时(us)
+    double busUs;          // 总线访问耗时(us)
+
+    double totalUs() const { return delayUs + busUs; }
+};
+
+// 整个 cvi_board_init 序列的估算结果
+struct BootTimeEstimate {
+    QList<BootTimeSection> sections;
+    double apbFreqMHz;     // 估算时使用的APB频率
+    double axiFreqMHz;     // 估算时使用的AXI频率
+
+    double totalUs() const;
+    int totalReads() const;
+    int totalWrites() const;
+    QString summary() const;     // 例如 "board init ≈ 12.3 µs"
+    QString breakdown() const;   // 按段的多行明细
+};
+
+class BootTimeEstimator
+{
+public:
+    BootTimeEstimator();
+
+    // 设置当前时钟树中的总线频率(MHz)，<=0 时使用默认值
+    void setBusFrequencies(double apbFreqMHz, double axiFreqMHz);
+    double getApbFrequency() const;
+    double getAxiFrequency() const;
+
+    // 对生成的板级初始化代码进行静态分析
+    BootTimeEstimate estimate(const QString& code) const;
+
+    // 单次访问耗时(us)
+    double readCostUs() const;
+    double writeCostUs() const;
+
+    static const double DEFAULT_APB_FREQ_MHZ;
+    static const double DEFAULT_AXI_FREQ_MHZ;
+
+private:
+    QString sectionForComment(const QString& line, const QString& current) const;
+
+    double m_apbFreqMHz;
+    double m_axiFreqMHz;
+
+    // 每次访问在各总线上消耗的时钟周期数
+    static const int AXI_READ_CYCLES = 8;   // 读需要等待完整的往返
+    static const int AXI_WRITE_CYCLES = 3;  // 写为posted write，只计入发出开销
+    static const int APB_ACCESS_CYCLES = 3; // APB setup + access + bridge同步
+};
+
+#endif // BOOTTIMEESTIMATOR_H
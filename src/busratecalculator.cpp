@@ -0,0 +1,181 @@
+#include "busratecalculator.h"
+#include <QtMath>
+#include <algorithm>
+
+static QString formatHz(double hz)
+{
+    if (hz >= 1e6) {
+        return QString("%1 MHz").arg(hz / 1e6, 0, 'f', 3);
+    }
+    if (hz >= 1e3) {
+        return QString("%1 kHz").arg(hz / 1e3, 0, 'f', 1);
+    }
+    return QString("%1 Hz").arg(hz, 0, 'f', 0);
+}
+
+static RateCandidate makeCandidate(int divisor, double actualHz, double requestedHz)
+{
+    RateCandidate candidate;
+    candidate.divisor = divisor;
+    candidate.actualHz = actualHz;
+    candidate.errorPercent = requestedHz > 0 ? (actualHz - requestedHz) / requestedHz * 100.0 : 0.0;
+    return candidate;
+}
+
+// 源时钟未启用或请求无效时的公共处理，返回false表示无需继续计算
+static bool checkRequest(RateEvaluation& eval)
+{
+    if (eval.sourceHz <= 0.0) {
+        eval.message = QString("源时钟 %1 未启用").arg(eval.sourceClock);
+        return false;
+    }
+    if (eval.requestedHz <= 0.0) {
+        eval.message = "请求速率无效";
+        return false;
+    }
+    return true;
+}
+
+QString RateEvaluation::summary() const
+{
+    if (best.divisor <= 0) {
+        return message;
+    }
+    QString text = QString("%1 = %2，分频 %3 → %4 (%5%6%)")
+                   .arg(sourceClock, formatHz(sourceHz))
+                   .arg(best.divisor)
+                   .arg(formatHz(best.actualHz))
+                   .arg(best.errorPercent >= 0 ? "+" : "")
+                   .arg(best.errorPercent, 0, 'f', 2);
+    if (!message.isEmpty()) {
+        text += "\n" + message;
+    }
+    return text;
+}
+
+RateEvaluation BusRateCalculator::evaluateUart(const QString& sourceClock, double sourceHz, int baud)
+{
+    RateEvaluation eval;
+    eval.sourceClock = sourceClock;
+    eval.sourceHz = sourceHz;
+    eval.requestedHz = baud;
+    if (!checkRequest(eval)) {
+        return eval;
+    }
+
+    const double maxBaud = sourceHz / UART_OVERSAMPLING;
+    int dll = qRound(sourceHz / (UART_OVERSAMPLING * static_cast<double>(baud)));
+    dll = std::clamp(dll, 1, 65535);
+    eval.best = makeCandidate(dll, sourceHz / (UART_OVERSAMPLING * dll), baud);
+
+    const double error = qAbs(eval.best.errorPercent);
+    if (baud > maxBaud * (1.0 + UART_MAX_ERROR / 100.0)) {
+        eval.verdict = RateVerdict::Invalid;
+        eval.message = QString("超过最高波特率 %1 bps（源时钟/16）").arg(qRound(maxBaud));
+    } else if (error <= UART_OK_ERROR) {
+        eval.verdict = RateVerdict::Ok;
+    } else if (error <= UART_MAX_ERROR) {
+        eval.verdict = RateVerdict::Marginal;
+        eval.message = "误差较大，对端时钟有偏差时可能出现误码";
+    } else {
+        eval.verdict = RateVerdict::Invalid;
+        eval.message = QString("误差超过 %1%，收发会出现数据错误").arg(UART_MAX_ERROR);
+    }
+
+    if (eval.verdict != RateVerdict::Ok) {
+        // 源时钟为 16 × 波特率 的整数倍时误差为0
+        const double unit = UART_OVERSAMPLING * static_cast<double>(baud);
+        const int multiple = std::max(1, qRound(sourceHz / unit));
+        eval.message += QString("；建议源时钟 %1").arg(formatHz(unit * multiple));
+    }
+    return eval;
+}
+
+RateEvaluation BusRateCalculator::evaluateI2c(const QString& sourceClock, double sourceHz, int busHz)
+{
+    RateEvaluation eval;
+    eval.sourceClock = sourceClock;
+    eval.sourceHz = sourceHz;
+    eval.requestedHz = busHz;
+    if (!checkRequest(eval)) {
+        return eval;
+    }
+
+    // 周期计数向上取整，实际SCL不超过请求速率（总线上的器件按最高速率选型）
+    const int period = static_cast<int>(qCeil(sourceHz / busHz));
+    if (period < I2C_MIN_PERIOD_COUNT) {
+        const double maxHz = sourceHz / I2C_MIN_PERIOD_COUNT;
+        eval.best = makeCandidate(I2C_MIN_PERIOD_COUNT, maxHz, busHz);
+        eval.verdict = RateVerdict::Invalid;
+        eval.message = QString("源时钟过低，最高只能达到 %1").arg(formatHz(maxHz));
+        return eval;
+    }
+
+    eval.best = makeCandidate(period, sourceHz / period, busHz);
+    if (busHz > I2C_MAX_HZ) {
+        eval.verdict = RateVerdict::Invalid;
+        eval.message = QString("超过控制器支持的最高速率 %1（Fast-mode Plus）").arg(formatHz(I2C_MAX_HZ));
+    } else if (eval.best.errorPercent < -10.0) {
+        eval.verdict = RateVerdict::Marginal;
+        eval.message = "实际速率明显低于请求值";
+    } else {
+        eval.verdict = RateVerdict::Ok;
+    }
+    return eval;
+}
+
+RateEvaluation BusRateCalculator::evaluateSpi(const QString& sourceClock, double sourceHz, int sckHz)
+{
+    RateEvaluation eval;
+    eval.sourceClock = sourceClock;
+    eval.sourceHz = sourceHz;
+    eval.requestedHz = sckHz;
+    if (!checkRequest(eval)) {
+        return eval;
+    }
+
+    // SCKDV 取不小于 源时钟/SCK 的偶数，实际SCK不超过器件允许的最高速率
+    int sckdv = static_cast<int>(qCeil(sourceHz / sckHz));
+    sckdv = std::max(2, sckdv + (sckdv % 2));
+    if (sckdv > SPI_MAX_SCKDV) {
+        eval.best = makeCandidate(SPI_MAX_SCKDV, sourceHz / SPI_MAX_SCKDV, sckHz);
+        eval.verdict = RateVerdict::Invalid;
+        eval.message = QString("请求速率过低，最低为 %1").arg(formatHz(sourceHz / SPI_MAX_SCKDV));
+        return eval;
+    }
+
+    eval.best = makeCandidate(sckdv, sourceHz / sckdv, sckHz);
+    if (sckHz > sourceHz / 2) {
+        eval.verdict = RateVerdict::Marginal;
+        eval.message = QString("超过最高SCK，将以 %1 运行").arg(formatHz(sourceHz / 2));
+    } else if (eval.best.errorPercent < -10.0) {
+        eval.verdict = RateVerdict::Marginal;
+        eval.message = "实际速率明显低于请求值";
+    } else {
+        eval.verdict = RateVerdict::Ok;
+    }
+    return eval;
+}
+
+QList<QPair<int, RateEvaluation>> BusRateCalculator::standardUartRates(const QString& sourceClock, double sourceHz)
+{
+    static const QList<int> bauds = {
+        9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600,
+        1000000, 1500000, 2000000, 3000000
+    };
+
+    QList<QPair<int, RateEvaluation>> rates;
+    for (int baud : bauds) {
+        rates.append({baud, evaluateUart(sourceClock, sourceHz, baud)});
+    }
+    return rates;
+}
+
+QList<RateCandidate> BusRateCalculator::spiRates(double sourceHz, int count)
+{
+    QList<RateCandidate> rates;
+    for (int sckdv = 2; sckdv <= SPI_MAX_SCKDV && rates.size() < count; sckdv += 2) {
+        rates.append(makeCandidate(sckdv, sourceHz / sckdv, sourceHz / sckdv));
+    }
+    return rates;
+}
@@ -0,0 +1,57 @@
+#ifndef BUSRATECALCULATOR_H
+#define BUSRATECALCULATOR_H
+
+#include <QString>
+#include <QList>
+#include <QPair>
+
+// 一个可实现的速率
+struct RateCandidate {
+    int divisor = 0;            // UART: DLL；I2C: SCL周期计数；SPI: SCKDV
+    double actualHz = 0.0;
+    double errorPercent = 0.0;  // (实际 - 请求) / 请求
+};
+
+enum class RateVerdict {
+    Ok,         // 误差在允许范围内
+    Marginal,   // 可以工作，但对端时钟偏差较大时可能出错
+    Invalid     // 会导致数据错误或超出控制器/协议能力
+};
+
+// 对一个速率请求的评估结果
+struct RateEvaluation {
+    QString sourceClock;        // 时钟树中的源时钟名
+    double sourceHz = 0.0;
+    double requestedHz = 0.0;
+    RateCandidate best;         // 最接近的合法分频
+    RateVerdict verdict = RateVerdict::Invalid;
+    QString message;
+
+    QString summary() const;    // 一行结果，显示在配置对话框中
+};
+
+// 由源时钟计算UART/I2C/SPI实际可达的速率（DesignWare UART/I2C/SSI的整数分频）
+class BusRateCalculator
+{
+public:
+    // 波特率 = 源时钟 / (16 * DLL)
+    static RateEvaluation evaluateUart(const QString& sourceClock, double sourceHz, int baud);
+    // SCL = 源时钟 / (HCNT + LCNT)，只向下取整到不超过请求速率的一档
+    static RateEvaluation evaluateI2c(const QString& sourceClock, double sourceHz, int busHz);
+    // SCK = 源时钟 / SCKDV，SCKDV为偶数
+    static RateEvaluation evaluateSpi(const QString& sourceClock, double sourceHz, int sckHz);
+
+    // 常用波特率在当前源时钟下的结果，按波特率升序
+    static QList<QPair<int, RateEvaluation>> standardUartRates(const QString& sourceClock, double sourceHz);
+    // SPI 最高的若干档SCK
+    static QList<RateCandidate> spiRates(double sourceHz, int count);
+
+    static constexpr double UART_OK_ERROR = 2.0;        // 8N1帧两端合计允许约4.5%，单端按2%/3%划分
+    static constexpr double UART_MAX_ERROR = 3.0;
+    static constexpr int UART_OVERSAMPLING = 16;
+    static constexpr int I2C_MIN_PERIOD_COUNT = 14;     // HCNT >= 6，LCNT >= 8
+    static constexpr int I2C_MAX_HZ = 1000000;          // Fast-mode Plus
+    static constexpr int SPI_MAX_SCKDV = 65534;
+};
+
+#endif // BUSRATECALCULATOR_H
@@ -0,0 +1,219 @@
+#include "chatstreamrenderer.h"
+#include <QScrollBar>
+#include <QTextBlockFormat>
+#include <QTextDocument>
+#include <QTextDocumentFragment>
+
+// 约一帧的间隔，合并期间到达的所有片段
+static constexpr int kFlushIntervalMs = 16;
+
+ChatStreamRenderer::ChatStreamRenderer(QTextEdit *view, QObject *parent)
+    : QObject(parent)
+    , m_view(view)
+    , m_flushTimer(nullptr)
+    , m_scanPos(0)
+    , m_blockEnd(0)
+    , m_inFence(false)
+    , m_active(false)
+    , m_hasPlaceholder(false)
+    , m_hasContent(false)
+{
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kFlushIntervalMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &ChatStreamRenderer::flush);
+
+    m_textFormat.setForeground(QColor("#2c3e50"));
+    m_bubbleFormat.setBackground(QColor("#ecf0f1"));
+}
+
+void ChatStreamRenderer::begin(const QString& placeholder)
+{
+    if (m_active) {
+        finish();
+    }
+
+    m_pending.clear();
+    m_tail.clear();
+    m_scanPos = 0;
+    m_blockEnd = 0;
+    m_inFence = false;
+    m_hasContent = false;
+
+    m_writeCursor = QTextCursor(m_view->document());
+    m_writeCursor.movePosition(QTextCursor::End);
+
+    // 创建左对齐的块格式，增加上下间距
+    QTextBlockFormat blockFormat;
+    blockFormat.setAlignment(Qt::AlignLeft);
+    blockFormat.setTopMargin(15);      // 上边距
+    blockFormat.setBottomMargin(15);   // 下边距
+    m_writeCursor.insertBlock(blockFormat);
+
+    // 在起点插入内容时 m_tailStart 保持不动，始终指向未完成块的开头
+    m_tailStart = m_writeCursor;
+    m_tailStart.setKeepPositionOnInsert(true);
+
+    m_writeCursor.insertText(placeholder, m_textFormat);
+    m_hasPlaceholder = true;
+    m_active = true;
+
+    QScrollBar *scrollBar = m_view->verticalScrollBar();
+    scrollBar->setValue(scrollBar->maximum());
+}
+
+void ChatStreamRenderer::append(const QString& delta)
+{
+    if (!m_active || delta.isEmpty()) {
+        return;
+    }
+
+    // 文档中 '\n' 对应一个段落分隔符，去掉 '\r' 使原文与显示的纯文本长度一致
+    QString text = delta;
+    text.remove('\r');
+    m_pending += text;
+    m_hasContent = true;
+
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void ChatStreamRenderer::finish()
+{
+    if (!m_active) {
+        return;
+    }
+    if (!m_hasContent) {
+        discard();
+        return;
+    }
+
+    m_flushTimer->stop();
+    flush();
+
+    m_writeCursor.beginEditBlock();
+    if (!m_tail.isEmpty()) {
+        commitBlocks(m_tail.size());
+    }
+    // 去掉最后一个完成块之后留下的空段落
+    if (m_tailStart.position() == m_writeCursor.position() && m_writeCursor.atBlockStart()) {
+        m_writeCursor.deletePreviousChar();
+    }
+    m_writeCursor.endEditBlock();
+
+    m_active = false;
+}
+
+void ChatStreamRenderer::discard()
+{
+    if (!m_active) {
+        return;
+    }
+
+    m_flushTimer->stop();
+    m_pending.clear();
+    removePlaceholder();
+    // 删除 begin() 插入的段落
+    m_writeCursor.deletePreviousChar();
+    m_active = false;
+}
+
+bool ChatStreamRenderer::isActive() const
+{
+    return m_active;
+}
+
+bool ChatStreamRenderer::hasContent() const
+{
+    return m_hasContent;
+}
+
+void ChatStreamRenderer::flush()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QScrollBar *scrollBar = m_view->verticalScrollBar();
+    bool wasAtBottom = (scrollBar->value() >= scrollBar->maximum() - 10);
+
+    m_writeCursor.beginEditBlock();
+    removePlaceholder();
+
+    m_writeCursor.insertText(m_pending, m_textFormat);
+    m_tail += m_pending;
+    m_pending.clear();
+
+    scanCompletedBlocks();
+    if (m_blockEnd > 0) {
+        commitBlocks(m_blockEnd);
+    }
+    m_writeCursor.endEditBlock();
+
+    // 用户向上翻看时不强制滚动
+    if (wasAtBottom) {
+        scrollBar->setValue(scrollBar->maximum());
+    }
+}
+
+void ChatStreamRenderer::removePlaceholder()
+{
+    if (!m_hasPlaceholder) {
+        return;
+    }
+
+    QTextCursor placeholder(m_view->document());
+    placeholder.setPosition(m_tailStart.position());
+    placeholder.setPosition(m_writeCursor.position(), QTextCursor::KeepAnchor);
+    placeholder.removeSelectedText();
+    m_hasPlaceholder = false;
+}
+
+void ChatStreamRenderer::scanCompletedBlocks()
+{
+    // 只扫描新到达的完整行；空行结束一个块，代码块在结束标记处结束，代码块内的空行不算
+    int lineStart = m_scanPos;
+    int newline;
+    while ((newline = m_tail.indexOf('\n', lineStart)) != -1) {
+        QStringView line = QStringView(m_tail).mid(lineStart, newline - lineStart).trimmed();
+        if (line.startsWith(u"```") || line.startsWith(u"~~~")) {
+            m_inFence = !m_inFence;
+            if (!m_inFence) {
+                m_blockEnd = newline + 1;
+            }
+        } else if (!m_inFence && line.isEmpty()) {
+            m_blockEnd = newline + 1;
+        }
+        lineStart = newline + 1;
+    }
+    m_scanPos = lineStart;
+}
+
+void ChatStreamRenderer::commitBlocks(int length)
+{
+    // 先删掉这段原文的纯文本显示（与原文等长），再在原处插入Markdown渲染结果
+    QTextCursor cursor(m_view->document());
+    cursor.setPosition(m_tailStart.position());
+    cursor.setPosition(m_tailStart.position() + length, QTextCursor::KeepAnchor);
+    cursor.removeSelectedText();
+
+    QTextDocument rendered;
+    rendered.setMarkdown(m_tail.left(length));
+
+    const int start = cursor.position();
+    cursor.insertFragment(QTextDocumentFragment(&rendered));
+
+    QTextCursor bubble(m_view->document());
+    bubble.setPosition(start);
+    bubble.setPosition(cursor.position(), QTextCursor::KeepAnchor);
+    bubble.mergeCharFormat(m_bubbleFormat);
+
+    // 未完成块从新段落开始
+    cursor.insertBlock();
+    m_tailStart.setPosition(cursor.position());
+
+    m_tail.remove(0, length);
+    m_scanPos -= length;
+    m_blockEnd = 0;
+}
@@ -0,0 +1,60 @@
+#ifndef CHATSTREAMRENDERER_H
+#define CHATSTREAMRENDERER_H
+
+#include <QObject>
+#include <QTextEdit>
+#include <QTextCursor>
+#include <QTextCharFormat>
+#include <QTimer>
+
+// AI回复的流式渲染：只在回复末尾追加，不重新生成整个聊天记录
+// - 收到的片段先缓存，按帧率（约16ms）合并写入文档
+// - 未完成的Markdown块以纯文本显示在末尾；遇到空行或代码块结束时，
+//   把完成的块替换为Markdown渲染结果，之后不再改动
+// 每次写入的开销只与新片段和当前未完成块的长度有关
+class ChatStreamRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ChatStreamRenderer(QTextEdit *view, QObject *parent = nullptr);
+
+    // 在文档末尾开始一条新的AI消息，先显示占位文字
+    void begin(const QString& placeholder);
+    // 追加一个片段，稍后合并写入
+    void append(const QString& delta);
+    // 回复结束：渲染剩余内容
+    void finish();
+    // 回复没有内容：移除占位文字
+    void discard();
+
+    bool isActive() const;
+    bool hasContent() const;
+
+private slots:
+    void flush();
+
+private:
+    void removePlaceholder();
+    void commitBlocks(int length);
+    void scanCompletedBlocks();
+
+    QTextEdit *m_view;
+    QTimer *m_flushTimer;
+
+    QTextCursor m_writeCursor;     // 消息末尾，所有内容从这里插入
+    QTextCursor m_tailStart;       // 未完成块（纯文本）在文档中的起点
+    QTextCharFormat m_textFormat;
+    QTextCharFormat m_bubbleFormat;
+
+    QString m_pending;             // 尚未写入文档的片段
+    QString m_tail;                // 未完成块的原文
+    int m_scanPos;                 // m_tail 中尚未扫描的行的起点
+    int m_blockEnd;                // m_tail 中最后一个完成块的结束位置
+    bool m_inFence;
+    bool m_active;
+    bool m_hasPlaceholder;
+    bool m_hasContent;
+};
+
+#endif // CHATSTREAMRENDERER_H
@@ -13,10 +13,12 @@
 #include <QVector2D>
 #include <QScrollBar>
 #include <QTimer>
+#include <QSet>
 #include <QResizeEvent>
 #include <QEvent>
 #include <QDialog>
 #include <QFormLayout>
+#include <QSettings>
 #include <QDialogButtonBox>
 
 // ClockConfigWidget类实现
@@ -194,6 +196,7 @@ ClockConfigWidget::ClockConfigWidget(QWidget *parent)
     , m_buttonLayout(nullptr)
     , m_resetButton(nullptr)
     , m_applyButton(nullptr)
+    , m_profileCombo(nullptr)
     , m_positionConfigButton(nullptr)
     , m_isDragging(false)
     , m_isResizing(false)
@@ -350,7 +353,20 @@ void ClockConfigWidget::setupUI()
         "}"
     );
 
-    m_applyButton = new QPushButton("OD超频配置");
+    // 性能档位：ND/OD之外可选节能档，所有合法档位都会写入设备树OPP表供运行时调频
+    m_profileCombo = new QComboBox();
+    m_profileCombo->setToolTip("启动时使用的性能档位，所有档位均生成到设备树 operating-points-v2 表");
+    for (const PerformanceProfile& profile : DvfsPlanner::builtinProfiles()) {
+        m_profileCombo->addItem(profile.name, profile.id);
+    }
+    {
+        QSettings settings("CviTek", "CviCubeMX");
+        int index = m_profileCombo->findData(settings.value("clockPerformanceProfile", "od").toString());
+        m_profileCombo->setCurrentIndex(index >= 0 ? index : 0);
+    }
+    m_profileCombo->setStyleSheet("QComboBox { padding: 8px; font-size: 13px; min-width: 90px; }");
+
+    m_applyButton = new QPushButton("应用性能档位");
     m_applyButton->setObjectName("overclockButton");
     m_applyButton->setStyleSheet(
         "QPushButton { "
@@ -394,6 +410,7 @@ void ClockConfigWidget::setupUI()
     m_buttonLayout->addWidget(m_resetButton);
     m_buttonLayout->addWidget(m_positionConfigButton);
     m_buttonLayout->addStretch();
+    m_buttonLayout->addWidget(m_profileCombo);
     m_buttonLayout->addWidget(m_applyButton);
 
     m_mainLayout->addLayout(m_buttonLayout);
@@ -5449,7 +5466,7 @@ void ClockConfigWidget::connectSignals()
     // 连接按钮信号
     connect(m_resetButton, &QPushButton::clicked, this, &ClockConfigWidget::resetToDefaults);
     connect(m_positionConfigButton, &QPushButton::clicked, this, &ClockConfigWidget::showPositionConfigDialog);
-    connect(m_applyButton, &QPushButton::clicked, this, &ClockConfigWidget::applyOverclockConfig);
+    connect(m_applyButton, &QPushButton::clicked, this, &ClockConfigWidget::applyPerformanceProfile);
     connect(m_searchButton, &QPushButton::clicked, this, &ClockConfigWidget::onSearchTriggered);
     connect(m_searchEdit, &QLineEdit::returnPressed, this, &ClockConfigWidget::onSearchTriggered);
 
@@ -7161,27 +7178,41 @@ void ClockConfigWidget::resetToDefaults()
         m_clkTPLLSubNodeDividerBoxes["clk_tpu_gdma"]->setValue(3);
     }
 
+    // clk_vip_sys_3的分频值为2（节能档位会修改）
+    if (m_clkMPLLSubNodeDividerBoxes.contains("clk_vip_sys_3")) {
+        m_clkMPLLSubNodeDividerBoxes["clk_vip_sys_3"]->setValue(2);
+    }
+
+    // 默认ND即ND性能档位
+    if (m_profileCombo) {
+        m_profileCombo->setCurrentIndex(qMax(0, m_profileCombo->findData("nd")));
+    }
+
     updateFrequencies();
     emit configChanged();
     updateConnectionOverlay();  // 重绘连接线
 
     // 导出CONFIG_OD_CLK_SEL=n到defconfig文件（如果路径和芯片类型已设置）
     if (!m_sourcePath.isEmpty() && !m_chipType.isEmpty()) {
-        if (exportToDefconfig(m_sourcePath, m_chipType, "CONFIG_OD_CLK_SEL", "n")) {
-            QString defconfigPath = QString("build/boards/cv184x/%1/%1_defconfig")
-                                   .arg(m_chipType);
-            QMessageBox::information(this, "成功",
-                                   QString("默认ND配置已应用并导出到: %1").arg(defconfigPath));
-        } else {
-            QMessageBox::critical(this, "错误", "默认ND配置应用成功，但导出到defconfig文件失败！");
-        }
+        QString defconfigPath = QString("build/boards/cv184x/%1/%1_defconfig")
+                               .arg(m_chipType);
+        exportToDefconfig(m_sourcePath, m_chipType, "CONFIG_OD_CLK_SEL", "n")
+            .then(this, [this, defconfigPath](FileIoResult result) {
+                if (result.ok) {
+                    QMessageBox::information(this, "成功",
+                                           QString("默认ND配置已应用并导出到: %1").arg(defconfigPath));
+                } else {
+                    QMessageBox::critical(this, "错误",
+                                        QString("默认ND配置应用成功，但导出到defconfig文件失败！\n%1").arg(result.errorMessage));
+                }
+            });
     } else {
         // 弹出提示信息
         QMessageBox::information(this, "默认ND配置", "默认ND配置已应用!");
     }
 }
 
-void ClockConfigWidget::applyOverclockConfig()
+void ClockConfigWidget::applyPerformanceProfile()
 {
     // 检查是否设置了源代码路径和芯片类型
     if (m_sourcePath.isEmpty() || m_chipType.isEmpty()) {
@@ -7190,39 +7221,91 @@ void ClockConfigWidget::applyOverclockConfig()
         return;
     }
 
-    // 重置PLL配置为超频的倍频值
-    // clk_appll的倍频值为44
-    if (m_pllMultiplierBoxes.contains("clk_appll")) {
-        m_pllMultiplierBoxes["clk_appll"]->setValue(44);
+    const PerformanceProfile bootProfile = DvfsPlanner::profile(m_profileCombo->currentData().toString());
+    const double tpllFreq = m_pllConfigs.value("clk_tpll").outputFreq;
+    const double mpllFreq = m_pllConfigs.value("clk_mpll").outputFreq;
+
+    // 按当前clk_tpll/clk_mpll换算各档位频点并校验上限和电压，不合法的档位不写入OPP表
+    QList<PerformanceProfile> tableProfiles;
+    QList<OperatingPoint> tablePoints;
+    QStringList rejected;
+    for (const PerformanceProfile& profile : DvfsPlanner::builtinProfiles()) {
+        const OperatingPoint point = DvfsPlanner::operatingPoint(profile, tpllFreq, mpllFreq);
+        const QStringList errors = DvfsPlanner::validate(profile, point);
+        if (!errors.isEmpty()) {
+            if (profile.id == bootProfile.id) {
+                QMessageBox::warning(this, "性能档位校验失败",
+                                   QString("性能档位\"%1\"不满足时钟限制：\n%2")
+                                   .arg(profile.name, errors.join("\n")));
+                return;
+            }
+            rejected << QString("%1: %2").arg(profile.name, errors.join("；"));
+            continue;
+        }
+        tableProfiles.append(profile);
+        tablePoints.append(point);
     }
 
-    // clk_rvpll的倍频值为64
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.setValue("clockPerformanceProfile", bootProfile.id);
+
+    // 启动档位的时钟设置
+    if (m_pllMultiplierBoxes.contains("clk_appll")) {
+        m_pllMultiplierBoxes["clk_appll"]->setValue(bootProfile.appllMultiplier);
+    }
     if (m_pllMultiplierBoxes.contains("clk_rvpll")) {
-        m_pllMultiplierBoxes["clk_rvpll"]->setValue(64);
+        m_pllMultiplierBoxes["clk_rvpll"]->setValue(bootProfile.rvpllMultiplier);
     }
-
-    // clk_tpll的倍频值不变，但子节点分频值改变
-    // clk_tpu和clk_tpu_gdma的分频值为2
+    // clk_tpll的倍频值不变，只改变clk_tpu和clk_tpu_gdma的分频值
     if (m_clkTPLLSubNodeDividerBoxes.contains("clk_tpu")) {
-        m_clkTPLLSubNodeDividerBoxes["clk_tpu"]->setValue(2);
+        m_clkTPLLSubNodeDividerBoxes["clk_tpu"]->setValue(bootProfile.tpuDivider);
     }
     if (m_clkTPLLSubNodeDividerBoxes.contains("clk_tpu_gdma")) {
-        m_clkTPLLSubNodeDividerBoxes["clk_tpu_gdma"]->setValue(2);
+        m_clkTPLLSubNodeDividerBoxes["clk_tpu_gdma"]->setValue(bootProfile.tpuDivider);
+    }
+    if (m_clkMPLLSubNodeDividerBoxes.contains("clk_vip_sys_3")) {
+        m_clkMPLLSubNodeDividerBoxes["clk_vip_sys_3"]->setValue(bootProfile.vipDivider);
     }
 
     // 触发全局更新和信号
     updateFrequencies();
     emit configChanged();
-
-    // 导出CONFIG_OD_CLK_SEL=y到defconfig文件
-    if (exportToDefconfig(m_sourcePath, m_chipType, "CONFIG_OD_CLK_SEL", "y")) {
-        QString defconfigPath = QString("build/boards/cv184x/%1/%1_defconfig")
-                               .arg(m_chipType);
-        QMessageBox::information(this, "成功",
-                               QString("OD超频配置已应用并导出到: %1").arg(defconfigPath));
-    } else {
-        QMessageBox::critical(this, "错误", "OD超频配置应用成功，但导出到defconfig文件失败！");
-    }
+    emit operatingPointsGenerated(DvfsPlanner::operatingPointTables(tableProfiles, tablePoints));
+
+    // 导出启动档位对应的配置项到defconfig文件
+    QString defconfigPath = QString("build/boards/cv184x/%1/%1_defconfig")
+                           .arg(m_chipType);
+    const QMap<QString, QString> defconfig = DvfsPlanner::defconfigSettings(bootProfile);
+    QList<QFuture<FileIoResult>> futures;
+    for (auto it = defconfig.constBegin(); it != defconfig.constEnd(); ++it) {
+        futures.append(exportToDefconfig(m_sourcePath, m_chipType, it.key(), it.value()));
+    }
+    const QString profileName = bootProfile.name;
+    const int pointCount = tableProfiles.size();
+    // 任意一项写入失败都视为导出失败
+    QtFuture::whenAll(futures.begin(), futures.end())
+        .then(this, [this, defconfigPath, profileName, pointCount, rejected](const QList<QFuture<FileIoResult>>& results) {
+            QStringList errors;
+            for (const QFuture<FileIoResult>& future : results) {
+                if (future.isCanceled()) {
+                    errors.append("写入已取消");
+                } else if (!future.result().ok) {
+                    errors.append(future.result().errorMessage);
+                }
+            }
+            if (errors.isEmpty()) {
+                QString text = QString("性能档位\"%1\"已应用并导出到: %2\n设备树OPP表包含 %3 个档位")
+                               .arg(profileName, defconfigPath).arg(pointCount);
+                if (!rejected.isEmpty()) {
+                    text += "\n\n以下档位未通过校验，未写入OPP表：\n" + rejected.join("\n");
+                }
+                QMessageBox::information(this, "成功", text);
+            } else {
+                QMessageBox::critical(this, "错误",
+                                    QString("性能档位\"%1\"应用成功，但导出到defconfig文件失败！\n%2")
+                                    .arg(profileName, errors.join("\n")));
+            }
+        });
 }
 
 PLLConfig ClockConfigWidget::getPLLConfig(const QString& pllName) const
@@ -7242,6 +7325,89 @@ void ClockConfigWidget::setPLLConfig(const QString& pllName, const PLLConfig& co
     updatePLLFrequency(pllName);
 }
 
+QList<const QMap<QString, ClockOutput>*> ClockConfigWidget::outputMaps() const
+{
+    // OSC输出及各子节点数据（部分节点会被镜像到m_pllConfigs，以子节点数据为准）
+    return {
+        &m_outputs, &m_clk1MSubNodes, &m_clkCam1PLLSubNodes, &m_clkRawAxiSubNodes,
+        &m_clkCam0PLLSubNodes, &m_clkDispPLLSubNodes, &m_clkSysDispSubNodes,
+        &m_clkA0PLLSubNodes, &m_clkRVPLLSubNodes, &m_clkAPPLLSubNodes,
+        &m_clkFPLLSubNodes, &m_clkTPLLSubNodes, &m_clkMPLLSubNodes,
+        &m_clkFAB100MSubNodes, &m_clkXtalMiscSubNodes, &m_clkI2CSubNodes,
+        &m_clkAPBI2CSubNodes, &m_clkAPBVCSYSSubNodes, &m_clkX2PSubNodes,
+        &m_clkHSPeriSubNodes, &m_clkRTCSYSSubNodes, &m_clkVIPSYS0SubNodes,
+        &m_clkVIPSYS1SubNodes, &m_clkVIPSYS2SubNodes, &m_clkVIPSYS3SubNodes,
+        &m_clkSPISubNodes, &m_clkKeyscanXclkSubNodes, &m_clkWgnXclkSubNodes
+    };
+}
+
+double ClockConfigWidget::getClockFrequency(const QString& clockName) const
+{
+    // 优先查找OSC输出及各子节点数据
+    const QList<const QMap<QString, ClockOutput>*> maps = outputMaps();
+    for (const QMap<QString, ClockOutput>* outputs : maps) {
+        auto it = outputs->constFind(clockName);
+        if (it != outputs->constEnd()) {
+            return it->enabled ? it->frequency : 0.0;
+        }
+    }
+
+    // PLL节点
+    if (m_pllConfigs.contains(clockName)) {
+        const PLLConfig& pll = m_pllConfigs[clockName];
+        return pll.enabled ? pll.outputFreq : 0.0;
+    }
+
+    return 0.0;
+}
+
+QMap<QString, double> ClockConfigWidget::getClockFrequencies() const
+{
+    QMap<QString, double> frequencies;
+    for (auto it = m_pllConfigs.constBegin(); it != m_pllConfigs.constEnd(); ++it) {
+        if (it->enabled) {
+            frequencies.insert(it.key(), it->outputFreq);
+        }
+    }
+    // 子节点数据覆盖PLL镜像，与 getClockFrequency 一致；前面的表优先
+    const QList<const QMap<QString, ClockOutput>*> maps = outputMaps();
+    QSet<QString> seen;
+    for (const QMap<QString, ClockOutput>* outputs : maps) {
+        for (auto it = outputs->constBegin(); it != outputs->constEnd(); ++it) {
+            if (seen.contains(it.key())) {
+                continue;
+            }
+            seen.insert(it.key());
+            if (it->enabled) {
+                frequencies.insert(it.key(), it->frequency);
+            } else {
+                frequencies.remove(it.key());
+            }
+        }
+    }
+    return frequencies;
+}
+
+QMap<QString, QString> ClockConfigWidget::getClockParents() const
+{
+    QMap<QString, QString> parents;
+    for (auto it = m_pllConfigs.constBegin(); it != m_pllConfigs.constEnd(); ++it) {
+        parents.insert(it.key(), it->source);
+    }
+    // 与 getClockFrequencies 一致，子节点数据覆盖PLL镜像，前面的表优先
+    const QList<const QMap<QString, ClockOutput>*> maps = outputMaps();
+    QSet<QString> seen;
+    for (const QMap<QString, ClockOutput>* outputs : maps) {
+        for (auto it = outputs->constBegin(); it != outputs->constEnd(); ++it) {
+            if (!seen.contains(it.key())) {
+                seen.insert(it.key());
+                parents.insert(it.key(), it->source);
+            }
+        }
+    }
+    return parents;
+}
+
 bool ClockConfigWidget::saveConfig(const QString& filePath)
 {
     // TODO: 实现配置保存功能
@@ -9680,66 +9846,33 @@ void ClockConfigWidget::setChipType(const QString& chipType)
     m_chipType = chipType;
 }
 
-bool ClockConfigWidget::exportToDefconfig(const QString& sourcePath, const QString& chipType, const QString& configName, const QString& value)
+QFuture<FileIoResult> ClockConfigWidget::exportToDefconfig(const QString& sourcePath, const QString& chipType, const QString& configName, const QString& value)
 {
     // 构建defconfig文件路径
     QString defconfigPath = QString("%1/build/boards/cv184x/%2/%2_defconfig")
                            .arg(sourcePath)
                            .arg(chipType);
 
-    // 检查文件是否存在
-    QFile defconfigFile(defconfigPath);
-    if (!defconfigFile.exists()) {
-        QMessageBox::critical(nullptr, "错误",
-                            QString("Defconfig文件不存在: %1").arg(defconfigPath));
-        return false;
-    }
-
-    // 读取现有文件内容
-    if (!defconfigFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::critical(nullptr, "错误",
-                            QString("无法读取defconfig文件: %1").arg(defconfigPath));
-        return false;
-    }
-
-    QTextStream in(&defconfigFile);
-    QStringList lines;
-    while (!in.atEnd()) {
-        lines.append(in.readLine());
-    }
-    defconfigFile.close();
-
-    // 更新配置行
-    bool foundConfig = false;
-    QString configLine = QString("%1=%2").arg(configName).arg(value);
-
-    for (int i = 0; i < lines.size(); ++i) {
-        QString& line = lines[i];
+    // 读取、更新配置行并写回在I/O线程中完成
+    return FileIoService::instance()->modifyLines(defconfigPath,
+        [configName, value](QStringList& lines, QString&) {
+            bool foundConfig = false;
+            QString configLine = QString("%1=%2").arg(configName).arg(value);
 
-        if (line.startsWith(configName + "=")) {
-            line = configLine;
-            foundConfig = true;
-            break;
-        }
-    }
+            for (int i = 0; i < lines.size(); ++i) {
+                QString& line = lines[i];
 
-    // 如果没有找到配置项，则添加到文件末尾
-    if (!foundConfig) {
-        lines.append(configLine);
-    }
-
-    // 写回文件
-    if (!defconfigFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(nullptr, "错误",
-                            QString("无法写入defconfig文件: %1").arg(defconfigPath));
-        return false;
-    }
-
-    QTextStream out(&defconfigFile);
-    for (const QString& line : lines) {
-        out << line << "\n";
-    }
-    defconfigFile.close();
+                if (line.startsWith(configName + "=")) {
+                    line = configLine;
+                    foundConfig = true;
+                    break;
+                }
+            }
 
-    return true;
+            // 如果没有找到配置项，则添加到文件末尾
+            if (!foundConfig) {
+                lines.append(configLine);
+            }
+            return true;
+        }, "时钟defconfig");
 }
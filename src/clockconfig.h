@@ -24,6 +24,8 @@
 #include <QPaintEvent>
 #include <QMouseEvent>
 #include <QPolygon>
+#include "fileioservice.h"
+#include "dvfsplanner.h"
 
 // 前向声明
 class ConnectionOverlay;
@@ -83,6 +85,13 @@ public:
     PLLConfig getPLLConfig(const QString& pllName) const;
     void setPLLConfig(const QString& pllName, const PLLConfig& config);
 
+    // 按名称查询任意时钟节点的当前频率(MHz)，未找到或未启用时返回0
+    double getClockFrequency(const QString& clockName) const;
+    // 所有启用的时钟节点及其频率(MHz)
+    QMap<QString, double> getClockFrequencies() const;
+    // 时钟树结构：节点名 -> 父时钟名（PLL的父节点为OSC）
+    QMap<QString, QString> getClockParents() const;
+
     // 保存和加载配置
     bool saveConfig(const QString& filePath);
     bool loadConfig(const QString& filePath);
@@ -91,8 +100,8 @@ public:
     void setSourcePath(const QString& sourcePath);
     void setChipType(const QString& chipType);
 
-    // 导出到defconfig文件
-    bool exportToDefconfig(const QString& sourcePath, const QString& chipType, const QString& configName, const QString& value);
+    // 导出到defconfig文件（后台读写，结果通过future在界面线程处理）
+    QFuture<FileIoResult> exportToDefconfig(const QString& sourcePath, const QString& chipType, const QString& configName, const QString& value);
 
     // 模块位置配置相关函数
     void showPositionConfigDialog();
@@ -113,6 +122,8 @@ protected:
 signals:
     void configChanged();
     void pllConfigChanged(const QString& pllName);
+    // 应用性能档位后生成的OPP表节点（key为节点标签），由主窗口写入设备树
+    void operatingPointsGenerated(const QMap<QString, QString>& nodes);
 
 private slots:
     void onPLLMultiplierChanged(const QString& pllName, int multiplier);
@@ -146,10 +157,11 @@ private slots:
 
     void updateFrequencies();
     void resetToDefaults();
-    void applyOverclockConfig(); // 新增OD超频函数
+    void applyPerformanceProfile(); // 应用所选性能档位，生成OPP表和defconfig
     void onSearchTriggered();    // 新增：搜索触发
 
 private:
+    QList<const QMap<QString, ClockOutput>*> outputMaps() const;  // 所有时钟输出表，按查找优先级排列
     void setupUI();
     void setupClockSources();
     void setupPLLs();
@@ -603,6 +615,7 @@ private:
     QHBoxLayout* m_buttonLayout;
     QPushButton* m_resetButton;
     QPushButton* m_applyButton;
+    QComboBox* m_profileCombo;            // 性能档位选择
     QPushButton* m_positionConfigButton;  // 新增：位置配置按钮
     QLineEdit* m_searchEdit;              // 新增：搜索框
     QPushButton* m_searchButton;          // 新增：搜索按钮
@@ -0,0 +1,263 @@
+#include "clockgatingplanner.h"
+#include <QRegularExpression>
+#include <QSet>
+#include <algorithm>
+
+// 外设节点前缀对应的defconfig外设类型
+static const QMap<QString, QString>& driverTypes()
+{
+    static const QMap<QString, QString> types = {
+        {"uart", "UART"}, {"i2c", "I2C"}, {"spi", "SPI"},
+        {"pwm", "PWM"}, {"gpio", "GPIO"}, {"saradc", "ADC"}
+    };
+    return types;
+}
+
+// 启动代码可直接关闭的时钟：CLK_EN_1 中的UART功能时钟与APB时钟
+static const QMap<QString, QPair<quint32, int>>& gateBits()
+{
+    static const QMap<QString, QPair<quint32, int>> bits = {
+        {"clk_uart1", {0x004, 16}}, {"clk_apb_uart1", {0x004, 17}},
+        {"clk_uart2", {0x004, 18}}, {"clk_apb_uart2", {0x004, 19}},
+        {"clk_uart3", {0x004, 20}}, {"clk_apb_uart3", {0x004, 21}},
+        {"clk_uart4", {0x004, 22}}, {"clk_apb_uart4", {0x004, 23}}
+    };
+    return bits;
+}
+
+// 即使外设被禁用也不能关闭的时钟
+static const QSet<QString>& criticalClocks()
+{
+    static const QSet<QString> clocks = {
+        "clk_uart0", "clk_apb_uart0",   // 启动控制台
+        "clk_apb_gpio"                  // 板级初始化和其他子系统仍会访问GPIO
+    };
+    return clocks;
+}
+
+double ClockGatingPlan::gateSavingMw() const
+{
+    double total = 0.0;
+    for (const ClockGate& gate : gates) {
+        total += gate.savingMw;
+    }
+    return total;
+}
+
+double ClockGatingPlan::totalSavingMw() const
+{
+    return gateSavingMw() + pllSavingMw;
+}
+
+QString ClockGatingPlan::summary() const
+{
+    if (gates.isEmpty()) {
+        return "时钟门控: 无可关闭时钟";
+    }
+    return QString("时钟门控 %1 个 ≈ -%2 mW").arg(gates.size()).arg(totalSavingMw(), 0, 'f', 1);
+}
+
+QString ClockGatingPlan::breakdown() const
+{
+    QStringList lines;
+    for (const ClockGate& gate : gates) {
+        lines << QString("%1 (%2 MHz, %3): -%4 mW%5")
+                 .arg(gate.clockName)
+                 .arg(gate.frequencyMHz, 0, 'f', 1)
+                 .arg(gate.consumers.join("/"))
+                 .arg(gate.savingMw, 0, 'f', 2)
+                 .arg(gate.hasGateBit ? "" : "（由内核 clk_disable_unused 关闭）");
+    }
+    for (const QString& pll : idlePlls) {
+        lines << QString("%1 无使用者，可关闭: -%2 mW").arg(pll).arg(ClockGatingPlanner::PLL_IDLE_MW, 0, 'f', 1);
+    }
+    if (!keptClocks.isEmpty()) {
+        lines << QString("保留: %1").arg(keptClocks.join(", "));
+    }
+    if (lines.isEmpty()) {
+        lines << "所有外设时钟均有使用者";
+    }
+    return lines.join("\n");
+}
+
+QString ClockGatingPlan::bootSequence() const
+{
+    // 按寄存器合并，每个寄存器一次读改写
+    QMap<quint32, quint32> masks;
+    QMap<quint32, QStringList> names;
+    for (const ClockGate& gate : gates) {
+        if (gate.hasGateBit) {
+            masks[gate.gateRegister] |= (1u << gate.gateBit);
+            names[gate.gateRegister] << gate.clockName;
+        }
+    }
+    if (masks.isEmpty()) {
+        return QString();
+    }
+
+    QString seq = "/* Clock gating: disable clocks of unused peripherals */\n";
+    for (auto it = masks.constBegin(); it != masks.constEnd(); ++it) {
+        seq += QString("mmio_write(0x%1, mmio_read(0x%1) & ~0x%2); // %3\n")
+               .arg(it.key(), 8, 16, QChar('0'))
+               .arg(it.value(), 8, 16, QChar('0'))
+               .arg(names.value(it.key()).join(" "));
+    }
+    return seq;
+}
+
+QStringList ClockGatingPlanner::peripheralClocks(const QString& nodeName, const PeripheralInfo& info)
+{
+    QStringList clocks;
+    for (const QString& name : info.clockNames) {
+        clocks << "clk_" + name.toLower();
+    }
+
+    static const QRegularExpression nodeRegex("^(i2c|[a-z]+)(\\d*)$");
+    const QRegularExpressionMatch match = nodeRegex.match(nodeName);
+    if (match.hasMatch()) {
+        const QString type = match.captured(1);
+        const QString index = match.captured(2);
+        if (type == "uart") {
+            clocks << "clk_uart" + index << "clk_apb_uart" + index;
+        } else if (type == "i2c") {
+            clocks << "clk_apb_i2c" + index << "clk_apb_i2c" << "clk_i2c";
+        } else if (type == "spi") {
+            clocks << "clk_apb_spi" + index << "clk_spi";
+        } else if (type == "pwm") {
+            clocks << "clk_pwm";
+        } else if (type == "gpio") {
+            clocks << "clk_apb_gpio";
+        } else if (type == "saradc") {
+            clocks << "clk_saradc";
+        }
+    }
+
+    clocks.removeDuplicates();
+    return clocks;
+}
+
+ClockGatingPlan ClockGatingPlanner::plan(const QMap<QString, PeripheralInfo>& peripherals,
+                                         const QMap<QString, bool>& driverStates,
+                                         const QMap<QString, double>& clocksMHz,
+                                         const QMap<QString, QString>& parents)
+{
+    ClockGatingPlan plan;
+    plan.pllSavingMw = 0.0;
+
+    // 时钟 -> 已禁用/仍启用的使用者
+    QMap<QString, QStringList> disabledUsers;
+    QSet<QString> usedClocks;
+    static const QRegularExpression typeRegex("^(i2c|[a-z]+)\\d*$");
+    for (auto it = peripherals.constBegin(); it != peripherals.constEnd(); ++it) {
+        const QString type = typeRegex.match(it.key()).captured(1);
+        if (!driverTypes().contains(type)) {
+            continue;   // sysdma_remap 等非外设节点
+        }
+
+        const bool driverOn = driverStates.value(driverTypes().value(type), true);
+        const bool enabled = driverOn && it->status != "disabled";
+        for (const QString& clock : peripheralClocks(it.key(), it.value())) {
+            if (!parents.contains(clock) && !gateBits().contains(clock)) {
+                continue;   // 时钟树中不存在的时钟（如设备树中的复位/总线别名）
+            }
+            if (enabled) {
+                usedClocks.insert(clock);
+            } else {
+                disabledUsers[clock] << it.key();
+            }
+        }
+    }
+
+    QSet<QString> gated;
+    for (auto it = disabledUsers.constBegin(); it != disabledUsers.constEnd(); ++it) {
+        const QString& clock = it.key();
+        if (usedClocks.contains(clock)) {
+            continue;
+        }
+        if (criticalClocks().contains(clock)) {
+            plan.keptClocks << clock;
+            continue;
+        }
+
+        const double mhz = clocksMHz.value(clock, 0.0);
+        if (mhz <= 0.0) {
+            continue;   // 已经关闭
+        }
+
+        ClockGate gate;
+        gate.clockName = clock;
+        gate.frequencyMHz = mhz;
+        gate.savingMw = mhz * (clock.startsWith("clk_apb_") ? APB_MW_PER_MHZ : FUNC_MW_PER_MHZ);
+        gate.consumers = it.value();
+        gate.hasGateBit = gateBits().contains(clock);
+        gate.gateRegister = gate.hasGateBit ? CLK_EN_BASE + gateBits().value(clock).first : 0;
+        gate.gateBit = gate.hasGateBit ? gateBits().value(clock).second : -1;
+        plan.gates << gate;
+        gated.insert(clock);
+    }
+
+    QMap<QString, QStringList> children;
+    for (auto it = parents.constBegin(); it != parents.constEnd(); ++it) {
+        if (!it.value().isEmpty() && it.value() != it.key()) {
+            children[it.value()] << it.key();
+        }
+    }
+
+    // 共享时钟（如 clk_i2c -> clk_apb_i2c -> clk_apb_i2cN）只有在下游仍在运行的时钟都关闭时才能关闭
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = plan.gates.size() - 1; i >= 0; --i) {
+            const QStringList downstream = children.value(plan.gates[i].clockName);
+            const bool feedsRunningClock = std::any_of(downstream.begin(), downstream.end(),
+                [&gated, &clocksMHz](const QString& child) {
+                    return !gated.contains(child) && clocksMHz.value(child, 0.0) > 0.0;
+                });
+            if (feedsRunningClock) {
+                gated.remove(plan.gates[i].clockName);
+                plan.keptClocks << plan.gates[i].clockName;
+                plan.gates.removeAt(i);
+                changed = true;
+            }
+        }
+    }
+    std::sort(plan.gates.begin(), plan.gates.end(), [](const ClockGate& a, const ClockGate& b) {
+        return a.savingMw > b.savingMw;
+    });
+
+    // PLL的全部叶子时钟都被关闭时，PLL本身也没有使用者
+    for (auto it = parents.constBegin(); it != parents.constEnd(); ++it) {
+        const QString& pll = it.key();
+        if (!pll.endsWith("pll") || clocksMHz.value(pll, 0.0) <= 0.0) {
+            continue;
+        }
+
+        QStringList pending = children.value(pll);
+        QSet<QString> visited;
+        int leaves = 0;
+        bool idle = !pending.isEmpty();
+        while (idle && !pending.isEmpty()) {
+            const QString node = pending.takeLast();
+            if (visited.contains(node)) {
+                continue;
+            }
+            visited.insert(node);
+            if (gated.contains(node) || clocksMHz.value(node, 0.0) <= 0.0) {
+                ++leaves;
+                continue;   // 已关闭的子树
+            }
+            if (!children.contains(node)) {
+                idle = false;   // 仍在运行的叶子时钟
+                break;
+            }
+            pending << children.value(node);
+        }
+        if (idle && leaves > 0) {
+            plan.idlePlls << pll;
+            plan.pllSavingMw += PLL_IDLE_MW;
+        }
+    }
+
+    plan.keptClocks.removeDuplicates();
+    return plan;
+}
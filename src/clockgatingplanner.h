@@ -0,0 +1,56 @@
+#ifndef CLOCKGATINGPLANNER_H
+#define CLOCKGATINGPLANNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include "dtsconfig.h"
+
+// 可以关闭的时钟
+struct ClockGate {
+    QString clockName;
+    double frequencyMHz;
+    double savingMw;            // 估算的动态功耗节省
+    QStringList consumers;      // 使用该时钟的外设（均已禁用）
+    bool hasGateBit;            // 启动代码中可直接关闭（否则交由内核 clk_disable_unused）
+    quint32 gateRegister;
+    int gateBit;
+};
+
+// 时钟门控分析结果
+struct ClockGatingPlan {
+    QList<ClockGate> gates;
+    QStringList keptClocks;     // 外设已禁用但时钟必须保留（控制台、GPIO等）
+    QStringList idlePlls;       // 所有下游时钟都已关闭的PLL
+    double pllSavingMw;
+
+    double gateSavingMw() const;
+    double totalSavingMw() const;
+    QString summary() const;
+    QString breakdown() const;
+    // 插入 cvi_board_init() 的门控序列（未缩进，无可关闭时钟时为空）
+    QString bootSequence() const;
+};
+
+// 由设备树中禁用的外设、defconfig中关闭的驱动和时钟树推导可在启动时关闭的时钟
+class ClockGatingPlanner
+{
+public:
+    // driverStates 为 defconfig 中各外设类型（UART/I2C/SPI/PWM/GPIO/ADC）的驱动开关
+    // clocksMHz 为当前启用的时钟及频率，parents 为时钟树（节点 -> 父时钟）
+    static ClockGatingPlan plan(const QMap<QString, PeripheralInfo>& peripherals,
+                                const QMap<QString, bool>& driverStates,
+                                const QMap<QString, double>& clocksMHz,
+                                const QMap<QString, QString>& parents);
+
+    // 外设节点使用的时钟树节点：设备树 clocks 属性加上内置的总线/共享时钟
+    static QStringList peripheralClocks(const QString& nodeName, const PeripheralInfo& info);
+
+    static constexpr quint32 CLK_EN_BASE = 0x03002000;     // 时钟使能寄存器 CLK_EN_0..4
+    static constexpr double FUNC_MW_PER_MHZ = 0.012;        // 外设功能时钟，经验值
+    static constexpr double APB_MW_PER_MHZ = 0.004;         // APB接口时钟，经验值
+    static constexpr double PLL_IDLE_MW = 2.5;              // 空闲PLL的模拟部分功耗，经验值
+};
+
+#endif // CLOCKGATINGPLANNER_H
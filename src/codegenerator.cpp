@@ -24,20 +24,25 @@ QString CodeGenerator::generateCode(const ChipConfig& config)
         return updateExistingFile(defaultFilePath, config);
     } else {
         // 如果不存在默认文件，则生成新的代码（保留原有逻辑）
-        QString code;
+        return generateStandaloneCode(config);
+    }
+}
 
-        // 生成文件头
-        code += generateHeader();
+QString CodeGenerator::generateStandaloneCode(const ChipConfig& config)
+{
+    QString code;
 
-        // 生成包含文件
-        // code += "\n#include \"cvi_board_init.h\"\n";
-        // code += "#include \"pinmux.h\"\n\n";
+    // 生成文件头
+    code += generateHeader();
 
-        // 生成引脚复用函数
-        code += generatePinmuxFunction(config);
+    // 生成包含文件
+    // code += "\n#include \"cvi_board_init.h\"\n";
+    // code += "#include \"pinmux.h\"\n\n";
 
-        return code;
-    }
+    // 生成引脚复用函数
+    code += generatePinmuxFunction(config);
+
+    return code;
 }
 
 QString CodeGenerator::updateExistingFile(const QString& filePath, const ChipConfig& config)
@@ -51,6 +56,28 @@ QString CodeGenerator::updateExistingFile(const QString& filePath, const ChipCon
     QString content = in.readAll();
     file.close();
 
+    // 生成新的 PINMUX 配置及特殊寄存器序列
+    QString pinmuxConfig = generateBoardInitBody(config);
+
+    QString errorMessage;
+    if (!updateBoardInitContent(content, pinmuxConfig, errorMessage)) {
+        return "Error: " + errorMessage;
+    }
+
+    // 写回文件
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return QString("Error: Cannot write to file %1").arg(filePath);
+    }
+
+    QTextStream out(&file);
+    out << content;
+    file.close();
+
+    return pinmuxConfig.isEmpty() ? "Existing generated configurations removed" : "File updated successfully";
+}
+
+bool CodeGenerator::updateBoardInitContent(QString& content, const QString& body, QString& errorMessage)
+{
     // 查找现有的生成配置块并删除（包括前后的空行）
     QRegularExpression generatedRegex("\\n*\\s*// Generated PINMUX configurations\\n.*?(?=\\n*\\s*return\\s+0\\s*;)",
                                      QRegularExpression::DotMatchesEverythingOption);
@@ -65,32 +92,13 @@ QString CodeGenerator::updateExistingFile(const QString& filePath, const ChipCon
     QRegularExpressionMatch match = returnRegex.match(content);
 
     if (!match.hasMatch()) {
-        return "Error: Cannot find 'return 0;' in the existing file";
+        errorMessage = "Cannot find 'return 0;' in the existing file";
+        return false;
     }
 
     int returnPosition = match.capturedStart();
 
-    // 生成新的 PINMUX 配置
-    QString pinmuxConfig = generatePinmuxConfig(config);
-
-    // 也基于相同的 pinFunctions 生成 ETH / MIPI / Audio 的特殊寄存器序列，
-    // 因为 updateExistingFile 分支只插入 PINMUX_CONFIG，需要把这些序列追加
-    QMap<QString, QString> pinFunctions = config.getAllPinFunctions();
-    QString specialSeq;
-    specialSeq += generateEthSequence(pinFunctions);
-    specialSeq += generateMipiSequence(pinFunctions);
-    specialSeq += generateAudioSequence(pinFunctions);
-    if (!specialSeq.isEmpty()) {
-        // 保证特殊序列与 PINMUX_CONFIG 之间有空行
-        if (!pinmuxConfig.endsWith("\n")) pinmuxConfig += "\n";
-        // 将生成的行每行前加一个制表符进行对齐（写入到文件中时与其它行一致）
-        QStringList lines = specialSeq.split('\n', Qt::SkipEmptyParts);
-        for (const QString &ln : lines) {
-            pinmuxConfig += "\t" + ln + "\n";
-        }
-    }
-
-    if (!pinmuxConfig.isEmpty()) {
+    if (!body.isEmpty()) {
         // 在 return 0; 之前插入新的配置
         QString newContent = content.left(returnPosition);
 
@@ -101,35 +109,43 @@ QString CodeGenerator::updateExistingFile(const QString& filePath, const ChipCon
 
         // 始终使用制表符缩进，不依赖于当前return语句的缩进状态
         newContent += "\n\t// Generated PINMUX configurations\n";
-        newContent += pinmuxConfig;
+        newContent += body;
         newContent += "\n\treturn 0;\n";
         newContent += "}";
 
-        // 写回文件
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            return QString("Error: Cannot write to file %1").arg(filePath);
-        }
-
-        QTextStream out(&file);
-        out << newContent;
-        file.close();
-
-        return "File updated successfully";
+        content = newContent;
     } else {
         // 如果没有配置要添加，确保删除任何现有的生成配置，并保持正确的return格式
         QRegularExpression returnFix("\\n*\\s*return\\s+0\\s*;");
         content.replace(returnFix, "\n\treturn 0;");
+    }
 
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            return QString("Error: Cannot write to file %1").arg(filePath);
-        }
+    return true;
+}
 
-        QTextStream out(&file);
-        out << content;
-        file.close();
+QString CodeGenerator::generateBoardInitBody(const ChipConfig& config)
+{
+    QString pinmuxConfig = generatePinmuxConfig(config);
 
-        return "Existing generated configurations removed";
+    // 也基于相同的 pinFunctions 生成 ETH / MIPI / Audio 的特殊寄存器序列，
+    // 因为 updateExistingFile 分支只插入 PINMUX_CONFIG，需要把这些序列追加
+    QMap<QString, QString> pinFunctions = config.getAllPinFunctions();
+    QString specialSeq;
+    specialSeq += generateEthSequence(pinFunctions);
+    specialSeq += generateMipiSequence(pinFunctions);
+    specialSeq += generateAudioSequence(pinFunctions);
+    specialSeq += m_clockGatingSequence;
+    if (!specialSeq.isEmpty()) {
+        // 保证特殊序列与 PINMUX_CONFIG 之间有空行
+        if (!pinmuxConfig.endsWith("\n")) pinmuxConfig += "\n";
+        // 将生成的行每行前加一个制表符进行对齐（写入到文件中时与其它行一致）
+        QStringList lines = specialSeq.split('\n', Qt::SkipEmptyParts);
+        for (const QString &ln : lines) {
+            pinmuxConfig += "\t" + ln + "\n";
+        }
     }
+
+    return pinmuxConfig;
 }
 
 QString CodeGenerator::generateHeader()
@@ -434,6 +450,7 @@ QString CodeGenerator::generatePinmuxFunction(const ChipConfig& config)
     function += generateEthSequence(pinFunctions);
     function += generateMipiSequence(pinFunctions);
     function += generateAudioSequence(pinFunctions);
+    function += m_clockGatingSequence;
 
     // 如果没有配置任何引脚，添加默认注释
     if (functionGroups.isEmpty()) {
@@ -605,6 +622,11 @@ void CodeGenerator::initializeFunctionMacros()
     m_functionMacros["Timer"] = "TIMER";
 }
 
+void CodeGenerator::setClockGatingSequence(const QString& sequence)
+{
+    m_clockGatingSequence = sequence;
+}
+
 void CodeGenerator::setSourcePath(const QString& sourcePath)
 {
     m_sourcePath = sourcePath;
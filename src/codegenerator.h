@@ -15,11 +15,27 @@ public:
     
     QString generateCode(const ChipConfig& config);
     QString updateExistingFile(const QString& filePath, const ChipConfig& config);
+
+    // 默认文件不存在时生成的完整代码（文件头 + 引脚复用函数）
+    QString generateStandaloneCode(const ChipConfig& config);
+
+    // 把 generateBoardInitBody() 的结果替换进已有 cvi_board_init.c 的文本，不读写文件，
+    // 可在后台I/O线程中调用；找不到 return 0; 时返回false
+    static bool updateBoardInitContent(QString& content, const QString& body, QString& errorMessage);
+
+    // 生成插入到 cvi_board_init() 中的配置内容（PINMUX + ETH/MIPI/Audio 序列），不写文件
+    QString generateBoardInitBody(const ChipConfig& config);
     
+    // 启动时关闭未使用外设时钟的序列（由时钟门控分析生成），追加在特殊寄存器序列之后
+    void setClockGatingSequence(const QString& sequence);
+
     // 设置源代码路径
     void setSourcePath(const QString& sourcePath);
     QString getSourcePath() const;
 
+    // 获取默认的 cvi_board_init.c 文件路径
+    QString getDefaultBoardInitFilePath(const ChipConfig& config) const;
+
 private:
     QString generateHeader();
     QString generatePinmuxFunction(const ChipConfig& config);
@@ -29,12 +45,10 @@ private:
     QString functionToMacro(const QString& function, const QString& pinName);
     QString getPinMuxName(const QString& pinName, const QString& function);
     
-    // 获取默认的 cvi_board_init.c 文件路径
-    QString getDefaultBoardInitFilePath(const ChipConfig& config) const;
-    
     QMap<QString, QString> m_functionMacros;
     PinFunction m_pinFunction;
     QString m_sourcePath; // 源代码根路径
+    QString m_clockGatingSequence;
     
     void initializeFunctionMacros();
 };
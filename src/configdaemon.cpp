@@ -0,0 +1,475 @@
+#include "configdaemon.h"
+#include "artifactwatcher.h"
+#include "clockconfig.h"
+#include "fileioservice.h"
+#include "rpcserver.h"
+#include "sdkindexer.h"
+#include <QDir>
+#include <QJsonArray>
+#include <QSettings>
+#include <QSignalBlocker>
+#include <QDebug>
+
+// 未指定板子时与界面的默认板子一致
+static const QString kDefaultBoard = "cv1842hp_wevb_0014a_emmc";
+static const int kMaxFindResults = 200;
+
+ConfigDaemon::ConfigDaemon(QObject *parent)
+    : QObject(parent)
+    , m_dtsConfig(new DtsConfig(this))
+    , m_defconfigLoaded(false)
+    , m_clockWidget(new ClockConfigWidget())
+    , m_sdkIndexer(new SdkIndexer(this))
+    , m_watcher(new ArtifactWatcher(this))
+    , m_server(new RpcServer(&m_methods, this))
+{
+    connect(m_clockWidget, &ClockConfigWidget::configChanged, this, [this]() {
+        refreshClockFrequencies();
+        m_server->notify("clock.changed", {{"source", "clock_tree"}});
+    });
+
+    connect(m_dtsConfig, &DtsConfig::externallyChanged, this,
+            [this](const QStringList &changedNodes, const QStringList &conflicts) {
+        m_server->notify("dts.changed", {
+            {"nodes", QJsonArray::fromStringList(changedNodes)},
+            {"conflicts", QJsonArray::fromStringList(conflicts)}
+        });
+    });
+    connect(m_watcher, &ArtifactWatcher::fileChanged, this, &ConfigDaemon::onArtifactChanged);
+    // 索引完成后defconfig的实际位置可能与后备路径不同，重新读取
+    connect(m_sdkIndexer, &SdkIndexer::catalogChanged, this, [this]() {
+        if (!m_sourcePath.isEmpty() && defconfigFilePath() != m_defconfigPath) {
+            loadDefconfig(true);
+            updateWatchedFiles();
+        }
+    });
+    connect(m_server, &RpcServer::clientCountChanged, this, [](int count) {
+        qDebug() << "RPC客户端数量:" << count;
+    });
+
+    registerMethods();
+    refreshClockFrequencies();
+}
+
+ConfigDaemon::~ConfigDaemon()
+{
+    // 时钟树控件没有父对象（不显示），随守护进程一起销毁
+    delete m_clockWidget;
+}
+
+bool ConfigDaemon::start(const QString &sourcePath, const QString &board, const QString &socketName)
+{
+    if (!m_server->listen(socketName.isEmpty() ? RpcServer::defaultSocketName() : socketName)) {
+        return false;
+    }
+
+    // 未指定源码路径时使用界面上次打开的路径
+    QString path = sourcePath;
+    if (path.isEmpty()) {
+        QSettings settings("CviTek", "CviCubeMX");
+        path = settings.value("lastSourcePath", "").toString();
+    }
+    loadProject(path, board);
+    return true;
+}
+
+void ConfigDaemon::loadProject(const QString &sourcePath, const QString &board)
+{
+    m_sourcePath = sourcePath;
+    m_board = board.isEmpty() ? kDefaultBoard : board;
+    m_clockWidget->setSourcePath(m_sourcePath);
+    m_clockWidget->setChipType(m_board);
+    m_chipConfig.clearPinFunctions();
+    {
+        // 新工程的defconfig随后直接读取，不需要由切换根目录触发
+        QSignalBlocker blocker(m_sdkIndexer);
+        m_sdkIndexer->setRootPath(m_sourcePath);
+    }
+
+    if (m_sourcePath.isEmpty()) {
+        qDebug() << "守护进程未指定源码路径，只提供引脚数据库和时钟树查询";
+        m_dtsConfig->clear();
+        m_defconfig = DefconfigIndex();
+        m_defconfigLoaded = false;
+        m_defconfigPath.clear();
+        updateWatchedFiles();
+        return;
+    }
+
+    m_dtsConfig->loadDtsFile(dtsFilePath()).then(this, [this](FileIoResult result) {
+        if (!result.ok) {
+            // 不保留上一个工程的设备树，避免查询到旧的外设
+            qDebug() << "守护进程无法加载设备树文件：" << result.filePath;
+            m_dtsConfig->clear();
+        }
+        updateWatchedFiles();
+        m_server->notify("project.loaded", projectInfo());
+    });
+    loadDefconfig(false);
+}
+
+void ConfigDaemon::loadDefconfig(bool notifyChanges)
+{
+    m_defconfigPath = defconfigFilePath();
+    const QString path = m_defconfigPath;
+    FileIoService::instance()->readText(path, "defconfig").then(this, [this, path, notifyChanges](FileIoResult result) {
+        // 读取期间已切换到其他文件
+        if (path != m_defconfigPath) {
+            return;
+        }
+        const DefconfigIndex previous = m_defconfig;
+        m_defconfig = result.ok ? DefconfigIndex::parse(result.content) : DefconfigIndex();
+        m_defconfigLoaded = result.ok;
+        if (!result.ok) {
+            qDebug() << "守护进程无法读取defconfig：" << result.filePath;
+        }
+        if (!notifyChanges) {
+            return;
+        }
+
+        // 只通知值发生变化的配置项
+        QStringList changedKeys;
+        for (const QString &key : m_defconfig.keys()) {
+            if (previous.value(key) != m_defconfig.value(key)) {
+                changedKeys << key;
+            }
+        }
+        for (const QString &key : previous.keys()) {
+            if (!m_defconfig.contains(key)) {
+                changedKeys << key;
+            }
+        }
+        if (!changedKeys.isEmpty()) {
+            changedKeys.sort();
+            m_server->notify("defconfig.changed", {{"keys", QJsonArray::fromStringList(changedKeys)}});
+        }
+    });
+}
+
+void ConfigDaemon::updateWatchedFiles()
+{
+    QStringList files;
+    if (m_dtsConfig->isLoaded()) {
+        files << m_dtsConfig->filePath();
+    }
+    if (!m_defconfigPath.isEmpty()) {
+        files << m_defconfigPath;
+    }
+    m_watcher->setFiles(files);
+}
+
+void ConfigDaemon::onArtifactChanged(const QString &filePath)
+{
+    if (m_dtsConfig->isLoaded() && filePath == QDir::cleanPath(m_dtsConfig->filePath())) {
+        m_dtsConfig->reloadFromDisk();
+    } else if (filePath == QDir::cleanPath(m_defconfigPath)) {
+        loadDefconfig(true);
+    }
+}
+
+void ConfigDaemon::refreshClockFrequencies()
+{
+    m_clockFrequencies = m_clockWidget->getClockFrequencies();
+    for (auto it = m_publishedClocks.constBegin(); it != m_publishedClocks.constEnd(); ++it) {
+        m_clockFrequencies.insert(it.key(), it.value());
+    }
+}
+
+QString ConfigDaemon::dtsFilePath() const
+{
+    return QDir(m_sourcePath).absoluteFilePath("build/boards/default/dts/cv184x/cv184x_base.dtsi");
+}
+
+QString ConfigDaemon::defconfigFilePath() const
+{
+    // 已索引的板子直接使用实际文件位置
+    const SdkBoard *board = m_sdkIndexer->catalog().findBoard(m_board);
+    if (board && !board->linuxDefconfig.isEmpty()) {
+        return m_sdkIndexer->catalog().absolutePath(board->linuxDefconfig);
+    }
+
+    return QDir(m_sourcePath).absoluteFilePath(QString("build/boards/cv184x/%1/linux/cvitek_%1_defconfig").arg(m_board));
+}
+
+QJsonObject ConfigDaemon::projectInfo() const
+{
+    QJsonObject info;
+    info["source"] = m_sourcePath;
+    info["board"] = m_board;
+    info["dts"] = m_dtsConfig->isLoaded() ? m_dtsConfig->filePath() : QString();
+    info["defconfig"] = m_defconfigLoaded ? m_defconfigPath : QString();
+    info["defconfig_keys"] = m_defconfig.size();
+    info["pads"] = m_pinFunction.getPinNames().size();
+    info["clocks"] = m_clockFrequencies.size();
+    return info;
+}
+
+QJsonObject ConfigDaemon::peripheralToJson(const PeripheralInfo &info)
+{
+    QJsonObject object;
+    object["name"] = info.name;
+    object["status"] = info.status.isEmpty() ? QString("okay") : info.status;
+    if (info.hasClock) {
+        object["clock"] = info.clockName;
+    }
+    if (!info.clockNames.isEmpty()) {
+        object["clocks"] = QJsonArray::fromStringList(info.clockNames);
+    }
+    if (info.hasClockFreq) {
+        object["clock_frequency"] = info.clockFrequency;
+    }
+    if (info.hasCurrentSpeed) {
+        object["current_speed"] = info.currentSpeed;
+    }
+    if (info.hasPwmCells) {
+        object["pwm_cells"] = info.pwmCells;
+    }
+    if (info.hasSysdmaChannels) {
+        object["ch_remap"] = QJsonArray::fromStringList(info.sysdmaChannels);
+    }
+    return object;
+}
+
+void ConfigDaemon::registerMethods()
+{
+    auto currentFunction = [this](const QString &pad) {
+        QString function = m_chipConfig.getPinFunction(pad);
+        return function.isEmpty() ? m_pinFunction.getDefaultFunction(pad) : function;
+    };
+
+    m_methods.registerTool("pin.functions",
+        "列出焊盘（如 PAD_MIPIRX4P）支持的全部复用功能、默认功能和当前功能",
+        AIToolBridge::objectSchema({{"pad", AIToolBridge::property("string", "焊盘名称")}}, {"pad"}),
+        [this, currentFunction](const QJsonObject &args) {
+            const QString pad = args["pad"].toString().trimmed().toUpper();
+            QJsonObject result;
+            const QStringList functions = m_pinFunction.getSupportedFunctions(pad);
+            if (functions.isEmpty()) {
+                result["error"] = QString("引脚数据库中没有焊盘 %1").arg(pad);
+                return result;
+            }
+            result["pad"] = pad;
+            result["functions"] = QJsonArray::fromStringList(functions);
+            result["default"] = m_pinFunction.getDefaultFunction(pad);
+            result["current"] = currentFunction(pad);
+            return result;
+        });
+
+    m_methods.registerTool("pin.find",
+        "查找可以复用为某个信号（如 UART2_TX，可只给前缀）的焊盘",
+        AIToolBridge::objectSchema({{"signal", AIToolBridge::property("string", "信号名称或前缀")}}, {"signal"}),
+        [this, currentFunction](const QJsonObject &args) {
+            const QString signal = args["signal"].toString().trimmed();
+            QJsonObject result;
+            if (signal.isEmpty()) {
+                result["error"] = "缺少 signal 参数";
+                return result;
+            }
+            QJsonArray matches;
+            const QStringList pinNames = m_pinFunction.getPinNames();
+            for (const QString &pad : pinNames) {
+                const QStringList functions = m_pinFunction.getSupportedFunctions(pad);
+                for (const QString &function : functions) {
+                    if (function.contains(signal, Qt::CaseInsensitive)) {
+                        matches.append(QJsonObject{{"pad", pad}, {"function", function}, {"current", currentFunction(pad)}});
+                    }
+                }
+            }
+            result["signal"] = signal;
+            result["matches"] = matches;
+            return result;
+        });
+
+    m_methods.registerTool("pin.set",
+        "设置焊盘的当前功能：单个 {pad, function}，或批量 {assignments: {焊盘: 功能}}；function 为空表示恢复默认",
+        AIToolBridge::objectSchema({
+            {"pad", AIToolBridge::property("string", "焊盘名称")},
+            {"function", AIToolBridge::property("string", "功能名称")},
+            {"assignments", AIToolBridge::property("object", "焊盘 -> 功能")}
+        }, {}),
+        [this](const QJsonObject &args) {
+            QMap<QString, QString> assignments;
+            if (args.contains("assignments")) {
+                const QJsonObject object = args["assignments"].toObject();
+                for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+                    assignments.insert(it.key().trimmed().toUpper(), it.value().toString().trimmed());
+                }
+            } else {
+                assignments.insert(args["pad"].toString().trimmed().toUpper(), args["function"].toString().trimmed());
+            }
+
+            QJsonObject result;
+            QStringList unsupported;
+            QJsonObject changed;
+            for (auto it = assignments.constBegin(); it != assignments.constEnd(); ++it) {
+                const QString function = it.value().isEmpty() ? m_pinFunction.getDefaultFunction(it.key()) : it.value();
+                if (!m_pinFunction.isPinFunctionSupported(it.key(), function)) {
+                    unsupported << QString("%1=%2").arg(it.key(), function);
+                    continue;
+                }
+                if (m_chipConfig.getPinFunction(it.key()) != function) {
+                    m_chipConfig.setPinFunction(it.key(), function);
+                    changed[it.key()] = function;
+                }
+            }
+            if (!changed.isEmpty()) {
+                m_server->notify("pin.changed", {{"assignments", changed}});
+            }
+            result["changed"] = changed;
+            if (!unsupported.isEmpty()) {
+                result["error"] = QString("焊盘不支持这些功能: %1").arg(unsupported.join(", "));
+            }
+            return result;
+        });
+
+    m_methods.registerTool("clock.get",
+        "查询时钟树中某个时钟节点（如 clk_spi、clk_uart1）当前的频率",
+        AIToolBridge::objectSchema({{"clock", AIToolBridge::property("string", "时钟节点名称")}}, {"clock"}),
+        [this](const QJsonObject &args) {
+            const QString clock = args["clock"].toString().trimmed();
+            QJsonObject result;
+            if (m_clockFrequencies.contains(clock)) {
+                result["clock"] = clock;
+                result["frequency_mhz"] = m_clockFrequencies.value(clock);
+                result["published"] = m_publishedClocks.contains(clock);
+                return result;
+            }
+            QStringList similar;
+            for (auto it = m_clockFrequencies.constBegin(); it != m_clockFrequencies.constEnd() && similar.size() < 10; ++it) {
+                if (it.key().contains(clock, Qt::CaseInsensitive)) {
+                    similar << it.key();
+                }
+            }
+            result["error"] = QString("时钟 %1 不存在或未启用").arg(clock);
+            result["similar"] = QJsonArray::fromStringList(similar);
+            return result;
+        });
+
+    m_methods.registerTool("clock.list",
+        "列出全部已启用时钟的频率(MHz)",
+        AIToolBridge::objectSchema({}, {}),
+        [this](const QJsonObject &) {
+            QJsonObject clocks;
+            for (auto it = m_clockFrequencies.constBegin(); it != m_clockFrequencies.constEnd(); ++it) {
+                clocks[it.key()] = it.value();
+            }
+            return QJsonObject{{"clocks", clocks}};
+        });
+
+    m_methods.registerTool("clock.update",
+        "发布时钟频率（界面客户端使用）：frequencies 为 时钟 -> MHz，replace 为真时替换之前发布的全部频率",
+        AIToolBridge::objectSchema({
+            {"frequencies", AIToolBridge::property("object", "时钟 -> MHz")},
+            {"replace", AIToolBridge::property("boolean", "替换之前发布的频率")}
+        }, {"frequencies"}),
+        [this](const QJsonObject &args) {
+            const QMap<QString, double> previous = m_clockFrequencies;
+            if (args["replace"].toBool()) {
+                m_publishedClocks.clear();
+            }
+            const QJsonObject frequencies = args["frequencies"].toObject();
+            for (auto it = frequencies.constBegin(); it != frequencies.constEnd(); ++it) {
+                m_publishedClocks.insert(it.key(), it.value().toDouble());
+            }
+            refreshClockFrequencies();
+
+            QStringList changed;
+            for (auto it = m_clockFrequencies.constBegin(); it != m_clockFrequencies.constEnd(); ++it) {
+                if (!previous.contains(it.key()) || !qFuzzyCompare(previous.value(it.key()) + 1.0, it.value() + 1.0)) {
+                    changed << it.key();
+                }
+            }
+            if (!changed.isEmpty()) {
+                m_server->notify("clock.changed", {{"source", "client"}, {"clocks", QJsonArray::fromStringList(changed)}});
+            }
+            return QJsonObject{{"changed", QJsonArray::fromStringList(changed)}};
+        });
+
+    m_methods.registerTool("dts.peripherals",
+        "列出设备树中工具管理的全部外设节点及其状态",
+        AIToolBridge::objectSchema({}, {}),
+        [this](const QJsonObject &) {
+            QJsonObject result;
+            if (!m_dtsConfig->isLoaded()) {
+                result["error"] = "设备树文件未加载";
+                return result;
+            }
+            QJsonArray peripherals;
+            const QMap<QString, PeripheralInfo> infos = m_dtsConfig->getPeripheralInfos();
+            for (const PeripheralInfo &info : infos) {
+                peripherals.append(peripheralToJson(info));
+            }
+            result["peripherals"] = peripherals;
+            return result;
+        });
+
+    m_methods.registerTool("dts.peripheral",
+        "查询设备树中某个外设节点（如 uart1、spi0、sysdma_remap）",
+        AIToolBridge::objectSchema({{"name", AIToolBridge::property("string", "节点名")}}, {"name"}),
+        [this](const QJsonObject &args) {
+            const QString name = args["name"].toString().trimmed();
+            QJsonObject result;
+            const QMap<QString, PeripheralInfo> infos = m_dtsConfig->getPeripheralInfos();
+            if (!infos.contains(name)) {
+                result["error"] = QString("设备树中没有外设 %1").arg(name);
+                return result;
+            }
+            return peripheralToJson(infos.value(name));
+        });
+
+    m_methods.registerTool("defconfig.get",
+        "查询defconfig中的配置项（可省略 CONFIG_ 前缀）",
+        AIToolBridge::objectSchema({{"key", AIToolBridge::property("string", "配置项")}}, {"key"}),
+        [this](const QJsonObject &args) {
+            QString key = args["key"].toString().trimmed();
+            if (!key.startsWith("CONFIG_")) {
+                key.prepend("CONFIG_");
+            }
+            QJsonObject result;
+            result["key"] = key;
+            result["present"] = m_defconfig.contains(key);
+            if (m_defconfig.contains(key)) {
+                result["value"] = m_defconfig.value(key);
+                result["enabled"] = m_defconfig.isEnabled(key);
+                result["line"] = m_defconfig.lineOf(key) + 1;
+            }
+            return result;
+        });
+
+    m_methods.registerTool("defconfig.find",
+        "列出名称包含给定文本的defconfig配置项及其值",
+        AIToolBridge::objectSchema({{"pattern", AIToolBridge::property("string", "名称中的文本")}}, {"pattern"}),
+        [this](const QJsonObject &args) {
+            const QString pattern = args["pattern"].toString().trimmed();
+            QJsonObject matches;
+            QStringList keys = m_defconfig.keys();
+            keys.sort();
+            for (const QString &key : keys) {
+                if (key.contains(pattern, Qt::CaseInsensitive)) {
+                    matches[key] = m_defconfig.value(key);
+                    if (matches.size() >= kMaxFindResults) {
+                        break;
+                    }
+                }
+            }
+            return QJsonObject{{"matches", matches}};
+        });
+
+    m_methods.registerTool("project.info",
+        "当前加载的源码路径、板子及各模型的规模",
+        AIToolBridge::objectSchema({}, {}),
+        [this](const QJsonObject &) {
+            return projectInfo();
+        });
+
+    m_methods.registerTool("project.load",
+        "切换源码路径和板子，加载完成后推送 project.loaded",
+        AIToolBridge::objectSchema({
+            {"source", AIToolBridge::property("string", "SDK源码路径")},
+            {"board", AIToolBridge::property("string", "板子名称")}
+        }, {"source"}),
+        [this](const QJsonObject &args) {
+            loadProject(args["source"].toString().trimmed(), args["board"].toString().trimmed());
+            return QJsonObject{{"loading", true}};
+        });
+}
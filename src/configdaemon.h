@@ -0,0 +1,69 @@
+#ifndef CONFIGDAEMON_H
+#define CONFIGDAEMON_H
+
+#include <QObject>
+#include <QMap>
+#include <QString>
+#include <QJsonObject>
+#include "aitoolbridge.h"
+#include "chipconfig.h"
+#include "defconfigindex.h"
+#include "dtsconfig.h"
+#include "pinfunction.h"
+
+class ArtifactWatcher;
+class ClockConfigWidget;
+class RpcServer;
+class SdkIndexer;
+
+// 常驻的配置服务（CviCubeMX --daemon）
+// 引脚数据库、设备树、defconfig和时钟树常驻内存，通过本地套接字的 JSON-RPC 提供查询，
+// 文件在外部修改或客户端更新配置时向订阅者推送通知；界面可作为其中一个客户端发布自己的引脚和时钟配置
+//
+// 方法：pin.functions / pin.find / pin.set，clock.get / clock.list / clock.update，
+//       dts.peripherals / dts.peripheral，defconfig.get / defconfig.find，project.info / project.load
+// 通知：pin.changed、clock.changed、dts.changed、defconfig.changed、project.loaded
+class ConfigDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConfigDaemon(QObject *parent = nullptr);
+    ~ConfigDaemon() override;
+
+    // 加载工程并开始监听，套接字被占用时返回false
+    bool start(const QString &sourcePath, const QString &board, const QString &socketName);
+
+private slots:
+    void onArtifactChanged(const QString &filePath);
+
+private:
+    void registerMethods();
+    void loadProject(const QString &sourcePath, const QString &board);
+    void loadDefconfig(bool notifyChanges);
+    void updateWatchedFiles();
+    void refreshClockFrequencies();
+
+    QString dtsFilePath() const;
+    QString defconfigFilePath() const;
+    QJsonObject projectInfo() const;
+    static QJsonObject peripheralToJson(const PeripheralInfo &info);
+
+    QString m_sourcePath;
+    QString m_board;
+    PinFunction m_pinFunction;
+    ChipConfig m_chipConfig;            // 客户端发布的引脚配置
+    DtsConfig *m_dtsConfig;
+    DefconfigIndex m_defconfig;
+    bool m_defconfigLoaded;
+    ClockConfigWidget *m_clockWidget;   // 不显示，仅作为时钟树模型
+    SdkIndexer *m_sdkIndexer;           // 板级文件的实际位置
+    QString m_defconfigPath;            // 当前读取的defconfig文件
+    QMap<QString, double> m_publishedClocks;    // 客户端发布的时钟频率，优先于本地时钟树
+    QMap<QString, double> m_clockFrequencies;   // 合并后的结果，查询时直接使用
+    ArtifactWatcher *m_watcher;
+    AIToolBridge m_methods;
+    RpcServer *m_server;
+};
+
+#endif // CONFIGDAEMON_H
@@ -0,0 +1,229 @@
+#include "ddrbandwidthdialog.h"
+#include <QHeaderView>
+#include <QDebug>
+#include <algorithm>
+
+DdrBandwidthDialog::DdrBandwidthDialog(const VideoPipelineConfig& pipeline,
+                                       const QMap<QString, double>& clocksMHz,
+                                       QWidget *parent)
+    : QDialog(parent)
+    , m_pipeline(pipeline)
+    , m_clocks(clocksMHz)
+    , m_dataRateSpin(nullptr)
+    , m_busWidthCombo(nullptr)
+    , m_efficiencySpin(nullptr)
+    , m_tpuDutySpin(nullptr)
+    , m_cpuLoadSpin(nullptr)
+    , m_pipelineLabel(nullptr)
+    , m_ddrLabel(nullptr)
+    , m_ddrBar(nullptr)
+    , m_axiLabel(nullptr)
+    , m_axiBar(nullptr)
+    , m_masterTable(nullptr)
+    , m_warningText(nullptr)
+    , m_closeButton(nullptr)
+{
+    setupUI();
+    updateReport();
+}
+
+void DdrBandwidthDialog::setupUI()
+{
+    setWindowTitle("DDR 带宽分析");
+    setMinimumSize(720, 600);
+    setModal(true);
+
+    DdrBandwidthSettings settings = DdrBandwidthSettings::load();
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    // DDR 与负载参数
+    QGroupBox* settingsGroup = new QGroupBox("DDR 与负载参数", this);
+    QGridLayout* settingsLayout = new QGridLayout(settingsGroup);
+
+    m_dataRateSpin = new QSpinBox(this);
+    m_dataRateSpin->setRange(400, 4266);
+    m_dataRateSpin->setSingleStep(133);
+    m_dataRateSpin->setSuffix(" MT/s");
+    m_dataRateSpin->setValue(settings.dataRateMTs);
+
+    m_busWidthCombo = new QComboBox(this);
+    m_busWidthCombo->addItem("x16", 16);
+    m_busWidthCombo->addItem("x32", 32);
+    int widthIndex = m_busWidthCombo->findData(settings.busWidthBits);
+    m_busWidthCombo->setCurrentIndex(widthIndex >= 0 ? widthIndex : 0);
+
+    m_efficiencySpin = new QSpinBox(this);
+    m_efficiencySpin->setRange(10, 100);
+    m_efficiencySpin->setSuffix(" %");
+    m_efficiencySpin->setValue(settings.efficiencyPercent);
+
+    m_tpuDutySpin = new QSpinBox(this);
+    m_tpuDutySpin->setRange(0, 100);
+    m_tpuDutySpin->setSuffix(" %");
+    m_tpuDutySpin->setValue(settings.tpuDutyPercent);
+
+    m_cpuLoadSpin = new QSpinBox(this);
+    m_cpuLoadSpin->setRange(0, 100);
+    m_cpuLoadSpin->setSuffix(" %");
+    m_cpuLoadSpin->setValue(settings.cpuLoadPercent);
+
+    settingsLayout->addWidget(new QLabel("DDR速率:", this), 0, 0);
+    settingsLayout->addWidget(m_dataRateSpin, 0, 1);
+    settingsLayout->addWidget(new QLabel("DDR位宽:", this), 0, 2);
+    settingsLayout->addWidget(m_busWidthCombo, 0, 3);
+    settingsLayout->addWidget(new QLabel("DDR效率:", this), 1, 0);
+    settingsLayout->addWidget(m_efficiencySpin, 1, 1);
+    settingsLayout->addWidget(new QLabel("TPU占用率:", this), 1, 2);
+    settingsLayout->addWidget(m_tpuDutySpin, 1, 3);
+    settingsLayout->addWidget(new QLabel("CPU负载:", this), 2, 0);
+    settingsLayout->addWidget(m_cpuLoadSpin, 2, 1);
+
+    // 视频管线来自内存配置中的ION容量计算
+    m_pipelineLabel = new QLabel(this);
+    m_pipelineLabel->setWordWrap(true);
+    m_pipelineLabel->setStyleSheet("color: #7f8c8d;");
+    settingsLayout->addWidget(m_pipelineLabel, 3, 0, 1, 4);
+
+    // 利用率
+    QGroupBox* utilGroup = new QGroupBox("利用率", this);
+    QGridLayout* utilLayout = new QGridLayout(utilGroup);
+    m_ddrLabel = new QLabel(this);
+    m_ddrBar = new QProgressBar(this);
+    m_axiLabel = new QLabel(this);
+    m_axiBar = new QProgressBar(this);
+    utilLayout->addWidget(m_ddrLabel, 0, 0);
+    utilLayout->addWidget(m_ddrBar, 0, 1);
+    utilLayout->addWidget(m_axiLabel, 1, 0);
+    utilLayout->addWidget(m_axiBar, 1, 1);
+    utilLayout->setColumnStretch(1, 1);
+
+    // 各主设备
+    m_masterTable = new QTableWidget(0, 5, this);
+    m_masterTable->setHorizontalHeaderLabels({"主设备", "时钟", "需求(MB/s)", "端口利用率", "说明"});
+    m_masterTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_masterTable->horizontalHeader()->setSectionResizeMode(4, QHeaderView::Stretch);
+    m_masterTable->verticalHeader()->setVisible(false);
+    m_masterTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_masterTable->setSelectionMode(QAbstractItemView::NoSelection);
+
+    // 告警
+    m_warningText = new QTextEdit(this);
+    m_warningText->setReadOnly(true);
+    m_warningText->setMaximumHeight(120);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    m_closeButton = new QPushButton("关闭", this);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_closeButton);
+
+    mainLayout->addWidget(settingsGroup);
+    mainLayout->addWidget(utilGroup);
+    mainLayout->addWidget(m_masterTable);
+    mainLayout->addWidget(new QLabel("告警:", this));
+    mainLayout->addWidget(m_warningText);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(m_dataRateSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &DdrBandwidthDialog::onSettingsChanged);
+    connect(m_busWidthCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &DdrBandwidthDialog::onSettingsChanged);
+    connect(m_efficiencySpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &DdrBandwidthDialog::onSettingsChanged);
+    connect(m_tpuDutySpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &DdrBandwidthDialog::onSettingsChanged);
+    connect(m_cpuLoadSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &DdrBandwidthDialog::onSettingsChanged);
+    connect(m_closeButton, &QPushButton::clicked, this, &DdrBandwidthDialog::onClose);
+}
+
+DdrBandwidthSettings DdrBandwidthDialog::getSettings() const
+{
+    DdrBandwidthSettings settings;
+    settings.dataRateMTs = m_dataRateSpin->value();
+    settings.busWidthBits = m_busWidthCombo->currentData().toInt();
+    settings.efficiencyPercent = m_efficiencySpin->value();
+    settings.tpuDutyPercent = m_tpuDutySpin->value();
+    settings.cpuLoadPercent = m_cpuLoadSpin->value();
+    return settings;
+}
+
+void DdrBandwidthDialog::setUtilizationBar(QProgressBar* bar, double percent)
+{
+    // 超过100%时进度条保持满格，通过颜色和文本提示
+    bar->setRange(0, 100);
+    bar->setValue(static_cast<int>(std::min(100.0, std::max(0.0, percent))));
+    bar->setFormat(QString("%1%").arg(percent, 0, 'f', 1));
+
+    QString color = "#27ae60";
+    if (percent > DdrBandwidthModel::MAX_UTILIZATION) {
+        color = "#e74c3c";
+    } else if (percent > DdrBandwidthModel::WARN_UTILIZATION) {
+        color = "#f39c12";
+    }
+    bar->setStyleSheet(QString("QProgressBar { border: 1px solid #bdc3c7; border-radius: 3px; text-align: center; } "
+                               "QProgressBar::chunk { background-color: %1; }").arg(color));
+}
+
+void DdrBandwidthDialog::updateReport()
+{
+    DdrBandwidthReport report = DdrBandwidthModel::analyze(m_pipeline, getSettings(), m_clocks);
+
+    m_pipelineLabel->setText(QString("视频管线（在内存配置的“ION容量计算”中修改）: %1x%2@%3fps x%4路，"
+                                     "VPSS %5通道 %6x%7，%8个编码通道")
+                                 .arg(m_pipeline.sensorWidth)
+                                 .arg(m_pipeline.sensorHeight)
+                                 .arg(m_pipeline.fps)
+                                 .arg(m_pipeline.viChannels)
+                                 .arg(m_pipeline.vpssChannels)
+                                 .arg(m_pipeline.vpssWidth)
+                                 .arg(m_pipeline.vpssHeight)
+                                 .arg(m_pipeline.encoders.size()));
+
+    m_ddrLabel->setText(QString("DDR %1 / %2 MB/s (峰值 %3)")
+                            .arg(report.totalDemandMBps(), 0, 'f', 0)
+                            .arg(report.ddrUsableMBps, 0, 'f', 0)
+                            .arg(report.ddrPeakMBps, 0, 'f', 0));
+    setUtilizationBar(m_ddrBar, report.ddrUtilization());
+
+    m_axiLabel->setText(QString("AXI clk_bus %1 MHz, %2 MB/s")
+                            .arg(report.axiClockMHz, 0, 'f', 1)
+                            .arg(report.axiCapacityMBps, 0, 'f', 0));
+    setUtilizationBar(m_axiBar, report.axiUtilization());
+
+    m_masterTable->setRowCount(report.masters.size());
+    for (int row = 0; row < report.masters.size(); ++row) {
+        const DdrMasterLoad& master = report.masters[row];
+        m_masterTable->setItem(row, 0, new QTableWidgetItem(master.name));
+        m_masterTable->setItem(row, 1, new QTableWidgetItem(
+            QString("%1 (%2 MHz)").arg(master.clockName).arg(master.clockMHz, 0, 'f', 1)));
+        m_masterTable->setItem(row, 2, new QTableWidgetItem(QString::number(master.demandMBps, 'f', 1)));
+
+        QProgressBar* bar = qobject_cast<QProgressBar*>(m_masterTable->cellWidget(row, 3));
+        if (!bar) {
+            bar = new QProgressBar(m_masterTable);
+            m_masterTable->setCellWidget(row, 3, bar);
+        }
+        setUtilizationBar(bar, master.portUtilization());
+
+        m_masterTable->setItem(row, 4, new QTableWidgetItem(master.detail));
+    }
+
+    QStringList lines;
+    for (const QString& warning : report.warnings) {
+        lines << QString("<span style='color:#e74c3c;'>✖ %1</span>").arg(warning.toHtmlEscaped());
+    }
+    for (const QString& notice : report.notices) {
+        lines << QString("<span style='color:#d35400;'>⚠ %1</span>").arg(notice.toHtmlEscaped());
+    }
+    if (lines.isEmpty()) {
+        lines << "<span style='color:#27ae60;'>✔ 当前配置的带宽需求在DDR和总线能力范围内</span>";
+    }
+    m_warningText->setHtml(lines.join("<br>"));
+}
+
+void DdrBandwidthDialog::onSettingsChanged()
+{
+    updateReport();
+}
+
+void DdrBandwidthDialog::onClose()
+{
+    getSettings().save();
+    accept();
+}
@@ -0,0 +1,59 @@
+#ifndef DDRBANDWIDTHDIALOG_H
+#define DDRBANDWIDTHDIALOG_H
+
+#include <QDialog>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QLabel>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QProgressBar>
+#include <QTextEdit>
+#include <QMap>
+#include "ddrbandwidthmodel.h"
+
+// DDR 带宽分析对话框：显示各主设备带宽需求、DDR/AXI 利用率及告警
+class DdrBandwidthDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    DdrBandwidthDialog(const VideoPipelineConfig& pipeline,
+                       const QMap<QString, double>& clocksMHz,
+                       QWidget *parent = nullptr);
+
+    DdrBandwidthSettings getSettings() const;
+
+private slots:
+    void onSettingsChanged();
+    void onClose();
+
+private:
+    void setupUI();
+    void updateReport();
+    void setUtilizationBar(QProgressBar* bar, double percent);
+
+    VideoPipelineConfig m_pipeline;
+    QMap<QString, double> m_clocks;
+
+    QSpinBox* m_dataRateSpin;
+    QComboBox* m_busWidthCombo;
+    QSpinBox* m_efficiencySpin;
+    QSpinBox* m_tpuDutySpin;
+    QSpinBox* m_cpuLoadSpin;
+
+    QLabel* m_pipelineLabel;
+    QLabel* m_ddrLabel;
+    QProgressBar* m_ddrBar;
+    QLabel* m_axiLabel;
+    QProgressBar* m_axiBar;
+    QTableWidget* m_masterTable;
+    QTextEdit* m_warningText;
+    QPushButton* m_closeButton;
+};
+
+#endif // DDRBANDWIDTHDIALOG_H
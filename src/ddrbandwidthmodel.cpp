@@ -0,0 +1,278 @@
+#include "ddrbandwidthmodel.h"
+#include <QSettings>
+#include <algorithm>
+
+namespace {
+
+const double BYTES_PER_MB = 1024.0 * 1024.0;
+
+double toMBps(double bytesPerSecond)
+{
+    return bytesPerSecond / BYTES_PER_MB;
+}
+
+} // namespace
+
+DdrBandwidthSettings DdrBandwidthSettings::defaultSettings()
+{
+    // 默认：DDR3-1866 x16
+    DdrBandwidthSettings settings;
+    settings.dataRateMTs = 1866;
+    settings.busWidthBits = 16;
+    settings.efficiencyPercent = 70;
+    settings.tpuDutyPercent = 30;
+    settings.cpuLoadPercent = 30;
+    return settings;
+}
+
+DdrBandwidthSettings DdrBandwidthSettings::load()
+{
+    DdrBandwidthSettings defaults = defaultSettings();
+    DdrBandwidthSettings result;
+
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.beginGroup("DdrBandwidth");
+    result.dataRateMTs = settings.value("dataRateMTs", defaults.dataRateMTs).toInt();
+    result.busWidthBits = settings.value("busWidthBits", defaults.busWidthBits).toInt();
+    result.efficiencyPercent = settings.value("efficiencyPercent", defaults.efficiencyPercent).toInt();
+    result.tpuDutyPercent = settings.value("tpuDutyPercent", defaults.tpuDutyPercent).toInt();
+    result.cpuLoadPercent = settings.value("cpuLoadPercent", defaults.cpuLoadPercent).toInt();
+    settings.endGroup();
+
+    return result;
+}
+
+void DdrBandwidthSettings::save() const
+{
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.beginGroup("DdrBandwidth");
+    settings.setValue("dataRateMTs", dataRateMTs);
+    settings.setValue("busWidthBits", busWidthBits);
+    settings.setValue("efficiencyPercent", efficiencyPercent);
+    settings.setValue("tpuDutyPercent", tpuDutyPercent);
+    settings.setValue("cpuLoadPercent", cpuLoadPercent);
+    settings.endGroup();
+}
+
+double DdrMasterLoad::portUtilization() const
+{
+    if (portCapacityMBps <= 0) {
+        return demandMBps > 0 ? 1000.0 : 0.0;
+    }
+    return demandMBps / portCapacityMBps * 100.0;
+}
+
+double DdrBandwidthReport::totalDemandMBps() const
+{
+    double total = 0.0;
+    for (const DdrMasterLoad& master : masters) {
+        total += master.demandMBps;
+    }
+    return total;
+}
+
+double DdrBandwidthReport::ddrUtilization() const
+{
+    if (ddrUsableMBps <= 0) {
+        return 0.0;
+    }
+    return totalDemandMBps() / ddrUsableMBps * 100.0;
+}
+
+double DdrBandwidthReport::axiUtilization() const
+{
+    if (axiCapacityMBps <= 0) {
+        return 0.0;
+    }
+    return totalDemandMBps() / axiCapacityMBps * 100.0;
+}
+
+bool DdrBandwidthReport::hasErrors() const
+{
+    return !warnings.isEmpty();
+}
+
+QString DdrBandwidthReport::summary() const
+{
+    return QString("DDR %1 / %2 MB/s (%3%)")
+               .arg(totalDemandMBps(), 0, 'f', 0)
+               .arg(ddrUsableMBps, 0, 'f', 0)
+               .arg(ddrUtilization(), 0, 'f', 1);
+}
+
+QStringList DdrBandwidthModel::requiredClocks()
+{
+    return {"clk_bus", "clk_isp_top_vip", "clk_raw_axi", "clk_vpss0_vip", "clk_video_axi",
+            "clk_vc_src0", "clk_tpu", "clk_cpu"};
+}
+
+double DdrBandwidthModel::clock(const QMap<QString, double>& clocksMHz, const QString& name)
+{
+    return std::max(0.0, clocksMHz.value(name, 0.0));
+}
+
+DdrBandwidthReport DdrBandwidthModel::analyze(const VideoPipelineConfig& pipeline,
+                                              const DdrBandwidthSettings& settings,
+                                              const QMap<QString, double>& clocksMHz)
+{
+    DdrBandwidthReport report;
+    report.ddrPeakMBps = toMBps(static_cast<double>(settings.dataRateMTs) * 1e6 * settings.busWidthBits / 8.0);
+    report.ddrUsableMBps = report.ddrPeakMBps * settings.efficiencyPercent / 100.0;
+    report.axiClockMHz = clock(clocksMHz, "clk_bus");
+    report.axiCapacityMBps = toMBps(report.axiClockMHz * 1e6 * AXI_BYTES_PER_CYCLE);
+
+    const double fps = std::max(0, pipeline.fps);
+    const double viChannels = std::max(0, pipeline.viChannels);
+    const double sensorPixels = static_cast<double>(std::max(0, pipeline.sensorWidth)) *
+                                std::max(0, pipeline.sensorHeight);
+    const double rawFrame = IonPoolCalculator::rawFrameSize(pipeline.sensorWidth, pipeline.sensorHeight,
+                                                            pipeline.rawBits);
+    const double sensorYuv = IonPoolCalculator::yuv420FrameSize(pipeline.sensorWidth, pipeline.sensorHeight);
+
+    // ISP：VI写RAW、ISP读RAW写YUV，3DNR读写参考帧和运动信息，LDC读写一帧
+    {
+        DdrMasterLoad isp;
+        isp.name = "ISP";
+        isp.clockName = "clk_isp_top_vip";
+        isp.clockMHz = clock(clocksMHz, isp.clockName);
+        double perFrame = rawFrame * 2 + sensorYuv;
+        QStringList parts = {"RAW写+读", "YUV写"};
+        if (pipeline.ispNr3d) {
+            perFrame += sensorYuv * 2 + sensorPixels / 4 * 2;
+            parts << "3DNR参考帧读写";
+        }
+        if (pipeline.ispLdc) {
+            perFrame += sensorYuv * 2;
+            parts << "LDC读写";
+        }
+        isp.demandMBps = toMBps(perFrame * fps * viChannels);
+        isp.portCapacityMBps = toMBps(clock(clocksMHz, "clk_raw_axi") * 1e6 * AXI_BYTES_PER_CYCLE);
+        isp.pixelRate = sensorPixels * fps * viChannels * BLANKING_FACTOR;
+        isp.pixelCapacity = isp.clockMHz * 1e6 * PIXELS_PER_CYCLE;
+        isp.detail = parts.join(" + ");
+        report.masters.append(isp);
+    }
+
+    // VPSS：每路读入一帧YUV，每个输出通道写出一帧
+    {
+        DdrMasterLoad vpss;
+        vpss.name = "VPSS";
+        vpss.clockName = "clk_vpss0_vip";
+        vpss.clockMHz = clock(clocksMHz, vpss.clockName);
+        double outFrame = IonPoolCalculator::yuv420FrameSize(pipeline.vpssWidth, pipeline.vpssHeight);
+        double outChannels = std::max(0, pipeline.vpssChannels);
+        vpss.demandMBps = pipeline.vpssChannels > 0
+                              ? toMBps((sensorYuv * viChannels + outFrame * outChannels) * fps)
+                              : 0.0;
+        vpss.portCapacityMBps = toMBps(clock(clocksMHz, "clk_video_axi") * 1e6 * AXI_BYTES_PER_CYCLE);
+        double outPixels = static_cast<double>(std::max(0, pipeline.vpssWidth)) * std::max(0, pipeline.vpssHeight);
+        vpss.pixelRate = pipeline.vpssChannels > 0
+                             ? (sensorPixels * viChannels + outPixels * outChannels) * fps
+                             : 0.0;
+        vpss.pixelCapacity = vpss.clockMHz * 1e6 * PIXELS_PER_CYCLE;
+        vpss.detail = QString("输入%1路 + 输出%2通道").arg(pipeline.viChannels).arg(pipeline.vpssChannels);
+        report.masters.append(vpss);
+    }
+
+    // VENC：读源帧、读参考帧（含搜索窗口重复读取）、写重构帧、写码流
+    {
+        DdrMasterLoad venc;
+        venc.name = "VENC";
+        venc.clockName = "clk_vc_src0";
+        venc.clockMHz = clock(clocksMHz, venc.clockName);
+        double bytesPerSecond = 0.0;
+        double pixelRate = 0.0;
+        for (const VideoEncoderProfile& profile : pipeline.encoders) {
+            double frame = IonPoolCalculator::yuv420FrameSize(profile.width, profile.height);
+            double encFps = std::max(0, profile.fps);
+            bool isJpeg = profile.codec.compare("JPEG", Qt::CaseInsensitive) == 0;
+            double perFrame = frame;
+            if (isJpeg) {
+                perFrame += frame / 2;
+            } else {
+                perFrame += frame * std::max(0, profile.refFrames) * REF_OVERFETCH + frame;
+            }
+            bytesPerSecond += perFrame * encFps;
+            if (!isJpeg) {
+                bytesPerSecond += std::max(0, profile.bitrateKbps) * 1000.0 / 8.0;
+            }
+            pixelRate += static_cast<double>(std::max(0, profile.width)) * std::max(0, profile.height) * encFps;
+        }
+        venc.demandMBps = toMBps(bytesPerSecond);
+        venc.portCapacityMBps = toMBps(venc.clockMHz * 1e6 * AXI_BYTES_PER_CYCLE);
+        venc.pixelRate = pixelRate;
+        venc.pixelCapacity = venc.clockMHz * 1e6 * PIXELS_PER_CYCLE;
+        venc.detail = QString("%1个编码通道").arg(pipeline.encoders.size());
+        report.masters.append(venc);
+    }
+
+    // TPU：按时钟和占用率估算
+    {
+        DdrMasterLoad tpu;
+        tpu.name = "TPU";
+        tpu.clockName = "clk_tpu";
+        tpu.clockMHz = clock(clocksMHz, tpu.clockName);
+        tpu.demandMBps = toMBps(tpu.clockMHz * 1e6 * TPU_BYTES_PER_CYCLE * settings.tpuDutyPercent / 100.0);
+        tpu.portCapacityMBps = toMBps(tpu.clockMHz * 1e6 * AXI_BYTES_PER_CYCLE);
+        tpu.pixelRate = 0.0;
+        tpu.pixelCapacity = 0.0;
+        tpu.detail = QString("占用率 %1%").arg(settings.tpuDutyPercent);
+        report.masters.append(tpu);
+    }
+
+    // CPU：按时钟和负载估算
+    {
+        DdrMasterLoad cpu;
+        cpu.name = "CPU";
+        cpu.clockName = "clk_cpu";
+        cpu.clockMHz = clock(clocksMHz, cpu.clockName);
+        cpu.demandMBps = toMBps(cpu.clockMHz * 1e6 * CPU_BYTES_PER_CYCLE * settings.cpuLoadPercent / 100.0);
+        cpu.portCapacityMBps = toMBps(cpu.clockMHz * 1e6 * AXI_BYTES_PER_CYCLE);
+        cpu.pixelRate = 0.0;
+        cpu.pixelCapacity = 0.0;
+        cpu.detail = QString("负载 %1%").arg(settings.cpuLoadPercent);
+        report.masters.append(cpu);
+    }
+
+    // 生成告警
+    for (const DdrMasterLoad& master : report.masters) {
+        if (master.pixelRate > 0 && master.pixelRate > master.pixelCapacity) {
+            report.warnings << QString("%1: 需要处理 %2 Mpixel/s，%3 (%4 MHz) 只能提供 %5 Mpixel/s，将会丢帧")
+                                   .arg(master.name)
+                                   .arg(master.pixelRate / 1e6, 0, 'f', 1)
+                                   .arg(master.clockName)
+                                   .arg(master.clockMHz, 0, 'f', 1)
+                                   .arg(master.pixelCapacity / 1e6, 0, 'f', 1);
+        }
+        if (master.demandMBps > 0 && master.portUtilization() > MAX_UTILIZATION) {
+            report.warnings << QString("%1: 带宽需求 %2 MB/s 超过AXI端口能力 %3 MB/s")
+                                   .arg(master.name)
+                                   .arg(master.demandMBps, 0, 'f', 0)
+                                   .arg(master.portCapacityMBps, 0, 'f', 0);
+        }
+    }
+
+    double ddrUtil = report.ddrUtilization();
+    if (ddrUtil > MAX_UTILIZATION) {
+        report.warnings << QString("DDR: 总需求 %1 MB/s 超过可用带宽 %2 MB/s (%3%)")
+                               .arg(report.totalDemandMBps(), 0, 'f', 0)
+                               .arg(report.ddrUsableMBps, 0, 'f', 0)
+                               .arg(ddrUtil, 0, 'f', 1);
+    } else if (ddrUtil > WARN_UTILIZATION) {
+        report.notices << QString("DDR: 利用率 %1%，突发负载下可能出现延迟抖动").arg(ddrUtil, 0, 'f', 1);
+    }
+
+    double axiUtil = report.axiUtilization();
+    if (report.axiCapacityMBps <= 0) {
+        report.warnings << "AXI: clk_bus 未使能，无法评估总线能力";
+    } else if (axiUtil > MAX_UTILIZATION) {
+        report.warnings << QString("AXI: 总需求超过 clk_bus (%1 MHz) 能力 %2 MB/s (%3%)")
+                               .arg(report.axiClockMHz, 0, 'f', 1)
+                               .arg(report.axiCapacityMBps, 0, 'f', 0)
+                               .arg(axiUtil, 0, 'f', 1);
+    } else if (axiUtil > WARN_UTILIZATION) {
+        report.notices << QString("AXI: 利用率 %1%").arg(axiUtil, 0, 'f', 1);
+    }
+
+    return report;
+}
@@ -0,0 +1,80 @@
+#ifndef DDRBANDWIDTHMODEL_H
+#define DDRBANDWIDTHMODEL_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include "ionpoolcalculator.h"
+
+// DDR 及非视频负载参数
+struct DdrBandwidthSettings {
+    int dataRateMTs;        // DDR 数据速率（MT/s）
+    int busWidthBits;       // DDR 数据位宽
+    int efficiencyPercent;  // 实际可用效率（刷新、bank冲突、读写切换）
+    int tpuDutyPercent;     // TPU 平均占用率
+    int cpuLoadPercent;     // CPU 访存负载
+
+    static DdrBandwidthSettings defaultSettings();
+    // 从 QSettings 的 "DdrBandwidth" 分组读写
+    static DdrBandwidthSettings load();
+    void save() const;
+};
+
+// 单个总线主设备的带宽需求
+struct DdrMasterLoad {
+    QString name;           // ISP / VPSS / VENC / TPU / CPU
+    QString clockName;      // 决定该主设备处理能力的时钟
+    double clockMHz;
+    double demandMBps;      // 按当前管线配置估算的DDR流量
+    double portCapacityMBps;// 该主设备AXI端口的理论上限
+    double pixelRate;       // 需要处理的像素率（像素/秒，非视频模块为0）
+    double pixelCapacity;   // 时钟能提供的像素处理能力（像素/秒）
+    QString detail;         // 流量组成说明
+
+    double portUtilization() const;
+};
+
+// 带宽分析结果
+struct DdrBandwidthReport {
+    QList<DdrMasterLoad> masters;
+    double ddrPeakMBps;
+    double ddrUsableMBps;
+    double axiClockMHz;
+    double axiCapacityMBps;
+    QStringList warnings;   // 超出能力的配置（会丢帧）
+    QStringList notices;    // 余量不足的配置
+
+    double totalDemandMBps() const;
+    double ddrUtilization() const;      // 百分比
+    double axiUtilization() const;      // 百分比
+    bool hasErrors() const;
+    QString summary() const;
+};
+
+// DDR 带宽预算模型：由时钟树和视频管线配置推导各主设备流量，并与DDR/AXI能力比较
+class DdrBandwidthModel
+{
+public:
+    // 模型需要查询的时钟节点
+    static QStringList requiredClocks();
+
+    // clocksMHz 为 requiredClocks() 中各时钟的当前频率（MHz），0表示时钟被关闭
+    static DdrBandwidthReport analyze(const VideoPipelineConfig& pipeline,
+                                      const DdrBandwidthSettings& settings,
+                                      const QMap<QString, double>& clocksMHz);
+
+    static constexpr double AXI_BYTES_PER_CYCLE = 16.0;   // 128位AXI
+    static constexpr double PIXELS_PER_CYCLE = 1.0;       // 视频模块每周期处理1像素
+    static constexpr double BLANKING_FACTOR = 1.1;        // 行/场消隐开销
+    static constexpr double REF_OVERFETCH = 1.5;          // 运动搜索窗口导致的参考帧重复读取
+    static constexpr double TPU_BYTES_PER_CYCLE = 8.0;
+    static constexpr double CPU_BYTES_PER_CYCLE = 0.5;    // 经验值：cache miss 引起的平均访存
+    static constexpr double WARN_UTILIZATION = 80.0;
+    static constexpr double MAX_UTILIZATION = 100.0;
+
+private:
+    static double clock(const QMap<QString, double>& clocksMHz, const QString& name);
+};
+
+#endif // DDRBANDWIDTHMODEL_H
@@ -0,0 +1,68 @@
+#include "defconfigindex.h"
+
+DefconfigIndex DefconfigIndex::parse(const QString& content)
+{
+    static const QString kNotSetSuffix = " is not set";
+
+    DefconfigIndex index;
+    const QStringList lines = content.split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        const QString line = lines[i].trimmed();
+
+        if (line.startsWith("CONFIG_")) {
+            int eq = line.indexOf('=');
+            if (eq > 0) {
+                QString key = line.left(eq);
+                index.m_values.insert(key, line.mid(eq + 1));
+                index.m_lines.insert(key, i);
+            }
+        } else if (line.startsWith("# CONFIG_") && line.endsWith(kNotSetSuffix)) {
+            QString key = line.mid(2, line.size() - 2 - kNotSetSuffix.size());
+            index.m_values.insert(key, "n");
+            index.m_lines.insert(key, i);
+        }
+    }
+    return index;
+}
+
+bool DefconfigIndex::contains(const QString& key) const
+{
+    return m_values.contains(key);
+}
+
+QString DefconfigIndex::value(const QString& key) const
+{
+    return m_values.value(key);
+}
+
+bool DefconfigIndex::isEnabled(const QString& key) const
+{
+    return m_values.value(key) == "y";
+}
+
+int DefconfigIndex::lineOf(const QString& key) const
+{
+    return m_lines.value(key, -1);
+}
+
+QStringList DefconfigIndex::keys() const
+{
+    return m_values.keys();
+}
+
+int DefconfigIndex::size() const
+{
+    return m_values.size();
+}
+
+QDataStream& operator<<(QDataStream& out, const DefconfigIndex& index)
+{
+    out << index.m_values << index.m_lines;
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, DefconfigIndex& index)
+{
+    in >> index.m_values >> index.m_lines;
+    return in;
+}
@@ -0,0 +1,31 @@
+#ifndef DEFCONFIGINDEX_H
+#define DEFCONFIGINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QDataStream>
+
+// defconfig 的键值索引：CONFIG_X=... 记录等号后的原值，"# CONFIG_X is not set" 记为 "n"
+// 同一键出现多次时以最后一次为准（与Kconfig一致）
+class DefconfigIndex
+{
+public:
+    static DefconfigIndex parse(const QString& content);
+
+    bool contains(const QString& key) const;
+    QString value(const QString& key) const;    // 不存在返回空
+    bool isEnabled(const QString& key) const;   // 值为 y
+    int lineOf(const QString& key) const;       // 所在行号（从0开始），-1表示无
+    QStringList keys() const;
+    int size() const;
+
+    friend QDataStream& operator<<(QDataStream& out, const DefconfigIndex& index);
+    friend QDataStream& operator>>(QDataStream& in, DefconfigIndex& index);
+
+private:
+    QHash<QString, QString> m_values;
+    QHash<QString, int> m_lines;
+};
+
+#endif // DEFCONFIGINDEX_H
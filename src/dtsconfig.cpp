@@ -1,72 +1,404 @@
 #include "dtsconfig.h"
-#include <QFile>
-#include <QTextStream>
+#include "artifactcache.h"
 #include <QRegularExpression>
 #include <QDebug>
+#include <memory>
 
-DtsConfig::DtsConfig(QObject *parent) : QObject(parent)
+// 解析结果缓存；parseDtsFile()/parseNode() 的输出变化时递增版本号
+static const QString kPeripheralCacheKind = "dts-peripherals/2";
+
+static void writePeripherals(QDataStream &out, const QMap<QString, PeripheralInfo> &peripherals)
 {
+    out << static_cast<quint32>(peripherals.size());
+    for (auto it = peripherals.constBegin(); it != peripherals.constEnd(); ++it) {
+        const PeripheralInfo &info = it.value();
+        out << it.key() << info.name << info.status << info.clockName << info.clockNames << info.clockFreq
+            << qint32(info.clockFrequency) << qint32(info.pwmCells) << qint32(info.currentSpeed)
+            << info.sysdmaChannels << info.hasStatus << info.hasClock << info.hasClockFreq
+            << info.hasPwmCells << info.hasCurrentSpeed << info.hasSysdmaChannels << qint32(info.lineNumber);
+    }
 }
 
-bool DtsConfig::loadDtsFile(const QString &filePath)
+static bool readPeripherals(QDataStream &in, QMap<QString, PeripheralInfo> &peripherals)
 {
-    m_filePath = filePath;
-    QFile file(filePath);
-    
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "无法打开设备树文件：" << filePath;
+    quint32 count = 0;
+    in >> count;
+
+    QMap<QString, PeripheralInfo> loaded;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString key;
+        PeripheralInfo info;
+        qint32 clockFrequency = 0;
+        qint32 pwmCells = 0;
+        qint32 currentSpeed = 0;
+        qint32 lineNumber = 0;
+        in >> key >> info.name >> info.status >> info.clockName >> info.clockNames >> info.clockFreq
+           >> clockFrequency >> pwmCells >> currentSpeed
+           >> info.sysdmaChannels >> info.hasStatus >> info.hasClock >> info.hasClockFreq
+           >> info.hasPwmCells >> info.hasCurrentSpeed >> info.hasSysdmaChannels >> lineNumber;
+        info.clockFrequency = clockFrequency;
+        info.pwmCells = pwmCells;
+        info.currentSpeed = currentSpeed;
+        info.lineNumber = lineNumber;
+        loaded.insert(key, info);
+    }
+
+    if (in.status() != QDataStream::Ok) {
         return false;
     }
-    
-    QTextStream in(&file);
-    m_fileContent = in.readAll();
-    file.close();
-    
-    parseDtsFile();
+    peripherals = loaded;
     return true;
 }
 
-bool DtsConfig::saveDtsFile()
+// 节点的完整文本，不存在时为空
+static QString nodeText(const QString &content, const QPair<int, int> &range)
+{
+    return range.first == -1 ? QString() : content.mid(range.first, range.second - range.first);
+}
+
+// 从'{'之后开始查找匹配的'}'，返回'}'之后的位置，未闭合时返回-1
+static int closingBraceEnd(const QString &content, int pos)
+{
+    int braceCount = 1;
+    while (pos < content.length() && braceCount > 0) {
+        if (content.at(pos) == '{') {
+            braceCount++;
+        } else if (content.at(pos) == '}') {
+            braceCount--;
+        }
+        pos++;
+    }
+    return braceCount == 0 ? pos : -1;
+}
+
+// 节点结束'}'之后的分号位置之后，没有分号时原样返回
+static int statementEnd(const QString &content, int pos)
+{
+    int end = pos;
+    while (end < content.length() && content.at(end).isSpace()) {
+        end++;
+    }
+    return (end < content.length() && content.at(end) == ';') ? end + 1 : pos;
+}
+
+// 除第一行外的每行加上缩进
+static QString indentLines(const QString &text, const QString &indent)
+{
+    QString result = text;
+    return result.replace("\n", "\n" + indent);
+}
+
+// 追加到文件末尾时节点的完整写法：覆盖节点保留'&'，嵌套在其他节点中的放进根节点
+static QString topLevelNodeText(const QString &content, const QPair<int, int> &range)
+{
+    const QString text = nodeText(content, range);
+    if (text.isEmpty()) {
+        return text;
+    }
+    if (range.first > 0 && content.at(range.first - 1) == '&') {
+        return "&" + text + ";";
+    }
+
+    int depth = 0;
+    for (int i = 0; i < range.first; ++i) {
+        if (content.at(i) == '{') {
+            depth++;
+        } else if (content.at(i) == '}') {
+            depth--;
+        }
+    }
+    if (depth > 0) {
+        return "/ {\n\t" + indentLines(text, "\t") + ";\n};";
+    }
+    return text;
+}
+
+DtsConfig::DtsConfig(QObject *parent)
+    : QObject(parent)
+    , m_pendingWrites(0)
+{
+}
+
+QFuture<FileIoResult> DtsConfig::loadDtsFile(const QString &filePath)
+{
+    return FileIoService::instance()->readText(filePath, "设备树文件")
+        .then(this, [this](FileIoResult result) {
+            if (!result.ok) {
+                qDebug() << "无法打开设备树文件：" << result.filePath;
+            } else {
+                m_filePath = result.filePath;
+                m_fileContent = result.content;
+                m_baseContent = result.content;
+
+                // 文件内容未变时直接使用上次的解析结果
+                ArtifactStamp stamp = ArtifactStamp::fromResult(result);
+                if (!ArtifactCache::load(kPeripheralCacheKind, stamp, [this](QDataStream &in) {
+                        return readPeripherals(in, m_peripherals);
+                    })) {
+                    parseDtsFile();
+                    ArtifactCache::store(kPeripheralCacheKind, stamp, [this](QDataStream &out) {
+                        writePeripherals(out, m_peripherals);
+                    });
+                }
+            }
+            emit loaded(result.ok);
+            return result;
+        })
+        .onCanceled(this, [this, filePath]() {
+            // 读取被取消时同样报告加载失败，调用方不会一直等待结果
+            FileIoResult result;
+            result.filePath = filePath;
+            result.errorMessage = "已取消";
+            emit loaded(false);
+            return result;
+        });
+}
+
+bool DtsConfig::isLoaded() const
+{
+    return !m_filePath.isEmpty();
+}
+
+void DtsConfig::clear()
+{
+    m_filePath.clear();
+    m_fileContent.clear();
+    m_baseContent.clear();
+    m_peripherals.clear();
+}
+
+QFuture<FileIoResult> DtsConfig::saveDtsFile()
 {
     if (m_filePath.isEmpty()) {
-        return false;
+        FileIoResult result;
+        result.errorMessage = "设备树文件未加载";
+        return FileIoService::finished(result);
     }
     
     updateFileContent();
     
-    QFile file(m_filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "无法写入设备树文件：" << m_filePath;
-        return false;
-    }
-    
-    QTextStream out(&file);
-    out << m_fileContent;
-    file.close();
-    
-    return true;
+    return writeMerged();
 }
 
-bool DtsConfig::savePeripheralConfig(const QString &peripheral)
+QFuture<FileIoResult> DtsConfig::savePeripheralConfig(const QString &peripheral)
 {
     if (m_filePath.isEmpty()) {
-        return false;
+        FileIoResult result;
+        result.errorMessage = "设备树文件未加载";
+        return FileIoService::finished(result);
     }
     
     // 只更新指定外设的内容
     updateSinglePeripheralContent(peripheral);
     
-    QFile file(m_filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "无法写入设备树文件：" << m_filePath;
-        return false;
+    return writeMerged();
+}
+
+QFuture<FileIoResult> DtsConfig::saveGeneratedNodes(const QMap<QString, QString> &nodes)
+{
+    if (m_filePath.isEmpty()) {
+        FileIoResult result;
+        result.errorMessage = "设备树文件未加载";
+        return FileIoService::finished(result);
     }
-    
-    QTextStream out(&file);
-    out << m_fileContent;
-    file.close();
-    
-    return true;
+
+    for (auto it = nodes.constBegin(); it != nodes.constEnd(); ++it) {
+        QPair<int, int> range = findNodePosition(it.key());
+        if (range.first == -1) {
+            // 带标签的节点不能直接写在顶层，放进根节点
+            if (!it.value().isEmpty()) {
+                m_fileContent.append("\n\n/ {\n\t" + indentLines(it.value(), "\t") + "\n};\n");
+            }
+            continue;
+        }
+
+        // 生成的文本以"};"结尾，替换范围包括原节点后的分号
+        range.second = statementEnd(m_fileContent, range.second);
+        if (it.value().isEmpty()) {
+            m_fileContent.remove(range.first, range.second - range.first);
+        } else {
+            const int lineStart = m_fileContent.lastIndexOf('\n', range.first) + 1;
+            const QString indent = m_fileContent.mid(lineStart, range.first - lineStart);
+            m_fileContent.replace(range.first, range.second - range.first, indentLines(it.value(), indent));
+        }
+    }
+
+    return writeMerged();
+}
+
+void DtsConfig::setOverrideProperty(const QString &label, const QString &property, const QString &value)
+{
+    const QString line = QString("\t%1 = %2;\n").arg(property, value);
+
+    QRegularExpression overrideRegex(QString("&%1\\s*\\{").arg(QRegularExpression::escape(label)));
+    QRegularExpressionMatch match = overrideRegex.match(m_fileContent);
+    const int bodyStart = match.hasMatch() ? match.capturedEnd() : -1;
+    const int nodeEnd = match.hasMatch() ? closingBraceEnd(m_fileContent, bodyStart) : -1;
+    if (nodeEnd == -1) {
+        if (!value.isEmpty()) {
+            m_fileContent.append(QString("\n&%1 {\n%2};\n").arg(label, line));
+        }
+        return;
+    }
+
+    const int bodyEnd = nodeEnd - 1;    // '}' 的位置
+    QRegularExpression propertyRegex(QString("^[ \\t]*%1\\s*=[^;]*;[ \\t]*\\n?").arg(QRegularExpression::escape(property)),
+                                     QRegularExpression::MultilineOption);
+    QRegularExpressionMatch propertyMatch = propertyRegex.match(m_fileContent.left(bodyEnd), bodyStart);
+    if (propertyMatch.hasMatch()) {
+        m_fileContent.replace(propertyMatch.capturedStart(), propertyMatch.capturedLength(),
+                              value.isEmpty() ? QString() : line);
+    } else if (!value.isEmpty()) {
+        // '}' 独占一行时插到该行之前，否则插到'}'之前并换行
+        const int lineStart = m_fileContent.lastIndexOf('\n', bodyEnd - 1) + 1;
+        if (m_fileContent.mid(lineStart, bodyEnd - lineStart).trimmed().isEmpty()) {
+            m_fileContent.insert(lineStart, line);
+        } else {
+            m_fileContent.insert(bodyEnd, "\n" + line);
+        }
+    }
+}
+
+QFuture<FileIoResult> DtsConfig::reloadFromDisk()
+{
+    if (m_filePath.isEmpty()) {
+        FileIoResult result;
+        result.errorMessage = "设备树文件未加载";
+        return FileIoService::finished(result);
+    }
+
+    return FileIoService::instance()->readText(m_filePath, "设备树文件")
+        .then(this, [this](FileIoResult result) {
+            // 自身写入触发的通知，或尚有写入未完成（写入时会自行合并）
+            if (!result.ok || m_pendingWrites > 0 || result.content == m_baseContent) {
+                return result;
+            }
+            applyMerge(result.content, mergeContent(m_baseContent, m_fileContent, result.content));
+            return result;
+        });
+}
+
+QString DtsConfig::filePath() const
+{
+    return m_filePath;
+}
+
+QFuture<FileIoResult> DtsConfig::writeMerged()
+{
+    // 按值提交当前内容，写入期间界面上的修改不影响本次保存；
+    // 写入前在后台线程读取磁盘内容，外部修改过的节点合并进来而不是被覆盖
+    const QString base = m_baseContent;
+    const QString ours = m_fileContent;
+    auto merge = std::make_shared<DtsMergeResult>();
+
+    // 之后提交的写入以本次内容为基准
+    m_baseContent = ours;
+    ++m_pendingWrites;
+
+    return FileIoService::instance()->modifyText(m_filePath,
+        [base, ours, merge](QString &content, QString &) {
+            *merge = mergeContent(base, ours, content);
+            content = merge->content;
+            return true;
+        }, "设备树文件")
+        .then(this, [this, base, ours, merge](FileIoResult result) {
+            --m_pendingWrites;
+            if (m_pendingWrites > 0) {
+                return result;
+            }
+            if (!result.ok) {
+                m_baseContent = base;
+                return result;
+            }
+
+            // 写入期间界面上又有修改时，把合并结果作为新基准再合并一次
+            if (m_fileContent == ours) {
+                applyMerge(result.content, *merge);
+            } else {
+                applyMerge(result.content, mergeContent(ours, m_fileContent, result.content));
+            }
+            return result;
+        })
+        .onCanceled(this, [this, base, ours]() {
+            // 取消时文件未写入，与写入失败一样恢复基准，之后的外部修改照常合并
+            --m_pendingWrites;
+            if (m_baseContent == ours) {
+                m_baseContent = base;
+            }
+            FileIoResult result;
+            result.filePath = m_filePath;
+            result.errorMessage = "已取消";
+            return result;
+        });
+}
+
+void DtsConfig::applyMerge(const QString &diskContent, const DtsMergeResult &merge)
+{
+    m_baseContent = diskContent;
+    if (merge.content != m_fileContent) {
+        m_fileContent = merge.content;
+        parseDtsFile();
+    }
+
+    if (!merge.conflicts.isEmpty()) {
+        qDebug() << "设备树节点同时被外部修改，保留外部版本：" << merge.conflicts;
+    }
+    if (!merge.changedNodes.isEmpty() || !merge.conflicts.isEmpty()) {
+        emit externallyChanged(merge.changedNodes, merge.conflicts);
+    }
+}
+
+DtsMergeResult DtsConfig::mergeContent(const QString &base, const QString &ours, const QString &theirs)
+{
+    DtsMergeResult merge;
+    if (theirs == base || theirs == ours) {
+        merge.content = ours;
+        return merge;
+    }
+
+    QStringList names = managedNodeNames(ours);
+    for (const QString &name : managedNodeNames(base) + managedNodeNames(theirs)) {
+        if (!names.contains(name)) {
+            names.append(name);
+        }
+    }
+
+    merge.content = theirs;
+    if (ours != base) {
+        for (const QString &name : names) {
+            const QString baseNode = nodeText(base, findNodeRange(base, name));
+            const QString ourNode = nodeText(ours, findNodeRange(ours, name));
+            if (ourNode == baseNode) {
+                continue;   // 工具未修改，取外部版本
+            }
+
+            QPair<int, int> range = findNodeRange(merge.content, name);
+            const QString theirNode = nodeText(merge.content, range);
+            if (theirNode == ourNode) {
+                continue;
+            }
+            if (theirNode != baseNode) {
+                merge.conflicts.append(name);
+                continue;
+            }
+
+            // 只有工具修改了该节点
+            if (range.first == -1) {
+                merge.content.append("\n" + topLevelNodeText(ours, findNodeRange(ours, name)) + "\n");
+            } else if (ourNode.isEmpty()) {
+                merge.content.remove(range.first, range.second - range.first);
+            } else {
+                merge.content.replace(range.first, range.second - range.first, ourNode);
+            }
+        }
+    }
+
+    for (const QString &name : names) {
+        if (nodeText(ours, findNodeRange(ours, name)) != nodeText(merge.content, findNodeRange(merge.content, name))) {
+            merge.changedNodes.append(name);
+        }
+    }
+    return merge;
 }
 
 QMap<QString, PeripheralInfo> DtsConfig::getPeripheralInfos() const
@@ -102,12 +434,10 @@ PeripheralInfo DtsConfig::getPeripheralInfo(const QString &peripheral) const
     return m_peripherals.value(peripheral, PeripheralInfo());
 }
 
-void DtsConfig::parseDtsFile()
+QStringList DtsConfig::peripheralNodeNames(const QString &content)
 {
-    m_peripherals.clear();
-    
     // 定义要解析的外设类型及其模式
-    QStringList peripheralPatterns = {
+    static const QStringList peripheralPatterns = {
         "pwm[0-9]+:",
         "i2c[0-9]+:",
         "spi[0-9]+:",
@@ -116,10 +446,11 @@ void DtsConfig::parseDtsFile()
         "saradc[0-9]*:",
         "sysdma_remap\\s*\\{" // sysdma_remap节点格式不同，没有冒号
     };
-    
+
+    QStringList names;
     for (const QString &pattern : peripheralPatterns) {
         QRegularExpression regex(pattern);
-        QRegularExpressionMatchIterator iterator = regex.globalMatch(m_fileContent);
+        QRegularExpressionMatchIterator iterator = regex.globalMatch(content);
         
         while (iterator.hasNext()) {
             QRegularExpressionMatch match = iterator.next();
@@ -140,16 +471,48 @@ void DtsConfig::parseDtsFile()
                 nodeName = matched;
             }
             
-            if (!nodeName.isEmpty()) {
-                QPair<int, int> nodePos = findNodePosition(nodeName);
-                if (nodePos.first != -1 && nodePos.second != -1) {
-                    PeripheralInfo info = parseNode(nodeName, nodePos.first, nodePos.second);
-                    info.name = nodeName;
-                    m_peripherals[nodeName] = info;
-                }
+            if (!nodeName.isEmpty() && !names.contains(nodeName)) {
+                names.append(nodeName);
+            }
+        }
+    }
+    return names;
+}
+
+QStringList DtsConfig::managedNodeNames(const QString &content)
+{
+    QStringList names = peripheralNodeNames(content);
+
+    // 性能档位生成的OPP表，以及引用OPP表的覆盖节点
+    static const QStringList generatedPatterns = {
+        "\\b(\\w+_opp_table)\\s*:",
+        "&(\\w+)\\s*\\{[^{}]*\\boperating-points-v2\\b"
+    };
+    for (const QString &pattern : generatedPatterns) {
+        QRegularExpression regex(pattern);
+        QRegularExpressionMatchIterator iterator = regex.globalMatch(content);
+        while (iterator.hasNext()) {
+            const QString nodeName = iterator.next().captured(1);
+            if (!names.contains(nodeName)) {
+                names.append(nodeName);
             }
         }
     }
+    return names;
+}
+
+void DtsConfig::parseDtsFile()
+{
+    m_peripherals.clear();
+    
+    for (const QString &nodeName : peripheralNodeNames(m_fileContent)) {
+        QPair<int, int> nodePos = findNodePosition(nodeName);
+        if (nodePos.first != -1 && nodePos.second != -1) {
+            PeripheralInfo info = parseNode(nodeName, nodePos.first, nodePos.second);
+            info.name = nodeName;
+            m_peripherals[nodeName] = info;
+        }
+    }
     
     // 确保sysdma_remap节点存在（即使DTS文件中没有）
     if (!m_peripherals.contains("sysdma_remap")) {
@@ -181,17 +544,22 @@ PeripheralInfo DtsConfig::parseNode(const QString &nodeName, int startPos, int e
     }
     
     // 解析clock相关信息
-    QRegularExpression clockRegex("clocks\\s*=\\s*<([^>]+)>;");
+    // 支持 clocks = <&clk A>, <&clk B>; 形式，不匹配 assigned-clocks
+    QRegularExpression clockRegex("(?<![\\w-])clocks\\s*=\\s*((?:<[^>]+>\\s*,?\\s*)+);");
     QRegularExpressionMatch clockMatch = clockRegex.match(nodeContent);
     if (clockMatch.hasMatch()) {
         QString clockContent = clockMatch.captured(1);
-        info.hasClock = true;
+        // 多个时钟的节点只用于分析，不由工具改写 clocks 属性
+        info.hasClock = clockContent.count('<') == 1;
         
-        // 提取时钟名称（通常是最后一个参数）
+        // 提取时钟名称（通常是最后一个参数），多个时钟时第一个为功能时钟
         QRegularExpression clockNameRegex("CV184X_CLK_(\\w+)");
-        QRegularExpressionMatch clockNameMatch = clockNameRegex.match(clockContent);
-        if (clockNameMatch.hasMatch()) {
-            info.clockName = clockNameMatch.captured(1);
+        QRegularExpressionMatchIterator clockNameIterator = clockNameRegex.globalMatch(clockContent);
+        while (clockNameIterator.hasNext()) {
+            info.clockNames.append(clockNameIterator.next().captured(1));
+        }
+        if (!info.clockNames.isEmpty()) {
+            info.clockName = info.clockNames.first();
         }
     } else {
         info.hasClock = false;
@@ -515,15 +883,20 @@ void DtsConfig::updateSinglePeripheralContent(const QString &peripheral)
 }
 
 QPair<int, int> DtsConfig::findNodePosition(const QString &nodeName)
+{
+    return findNodeRange(m_fileContent, nodeName);
+}
+
+QPair<int, int> DtsConfig::findNodeRange(const QString &content, const QString &nodeName)
 {
     // 查找节点开始位置，支持两种格式：
     // 1. nodeName: { } (设备树覆盖格式)
     // 2. nodeName { } (普通节点格式)
     QRegularExpression nodeRegex1(QString("\\b%1\\s*:\\s*[^{]*\\{").arg(QRegularExpression::escape(nodeName)));
-    QRegularExpressionMatch match1 = nodeRegex1.match(m_fileContent);
+    QRegularExpressionMatch match1 = nodeRegex1.match(content);
     
     QRegularExpression nodeRegex2(QString("\\b%1\\s+\\{").arg(QRegularExpression::escape(nodeName)));
-    QRegularExpressionMatch match2 = nodeRegex2.match(m_fileContent);
+    QRegularExpressionMatch match2 = nodeRegex2.match(content);
     
     QRegularExpressionMatch match;
     if (match1.hasMatch()) {
@@ -535,23 +908,11 @@ QPair<int, int> DtsConfig::findNodePosition(const QString &nodeName)
     }
     
     int startPos = match.capturedStart();
-    int braceStart = match.capturedEnd() - 1; // '{' 的位置
     
     // 查找匹配的结束大括号
-    int braceCount = 1;
-    int pos = braceStart + 1;
-    
-    while (pos < m_fileContent.length() && braceCount > 0) {
-        if (m_fileContent.at(pos) == '{') {
-            braceCount++;
-        } else if (m_fileContent.at(pos) == '}') {
-            braceCount--;
-        }
-        pos++;
-    }
-    
-    if (braceCount == 0) {
-        return QPair<int, int>(startPos, pos);
+    int endPos = closingBraceEnd(content, match.capturedEnd());
+    if (endPos != -1) {
+        return QPair<int, int>(startPos, endPos);
     }
     
     return QPair<int, int>(-1, -1);
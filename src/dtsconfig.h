@@ -4,11 +4,13 @@
 #include <QString>
 #include <QMap>
 #include <QObject>
+#include "fileioservice.h"
 
 struct PeripheralInfo {
     QString name;
     QString status;  // "okay", "disabled", or empty (defaults to okay)
     QString clockName;
+    QStringList clockNames;  // clocks 属性中的全部时钟（去掉 CV184X_CLK_ 前缀），用于时钟门控分析
     QString clockFreq;
     int clockFrequency = 0;  // 时钟频率 (从 clock-frequency 属性解析)
     int pwmCells = 1;        // PWM cells 数量 (从 #pwm-cells 属性解析)
@@ -29,6 +31,13 @@ struct PeripheralInfo {
     }
 };
 
+// 设备树三方合并的结果：以节点为单位合并工具的修改和外部修改
+struct DtsMergeResult {
+    QString content;
+    QStringList changedNodes;   // 相对工具当前内容发生变化的节点
+    QStringList conflicts;      // 两边都修改了的节点，保留外部版本
+};
+
 class DtsConfig : public QObject
 {
     Q_OBJECT
@@ -36,14 +45,30 @@ class DtsConfig : public QObject
 public:
     explicit DtsConfig(QObject *parent = nullptr);
 
-    // 加载设备树文件
-    bool loadDtsFile(const QString &filePath);
+    // 加载设备树文件（后台读取，完成后在界面线程解析并发出loaded信号）
+    QFuture<FileIoResult> loadDtsFile(const QString &filePath);
+    bool isLoaded() const;
+    // 丢弃已加载的内容和解析结果，回到未加载状态
+    void clear();
     
-    // 保存设备树文件
-    bool saveDtsFile();
+    // 保存设备树文件（在界面线程生成内容，后台写入）
+    QFuture<FileIoResult> saveDtsFile();
     
     // 保存单个外设配置到文件
-    bool savePeripheralConfig(const QString &peripheral);
+    QFuture<FileIoResult> savePeripheralConfig(const QString &peripheral);
+
+    // 替换/追加工具生成的整个节点（如OPP表，key为节点标签），内容为空表示删除，然后保存
+    QFuture<FileIoResult> saveGeneratedNodes(const QMap<QString, QString> &nodes);
+
+    // 在 &label { } 覆盖节点中设置属性，节点不存在时追加，取值为空表示删除该属性（不保存）
+    void setOverrideProperty(const QString &label, const QString &property, const QString &value);
+
+    // 文件在外部被修改后重新读取，与工具的修改合并后重新解析
+    QFuture<FileIoResult> reloadFromDisk();
+    QString filePath() const;
+
+    // 三方合并：base为上次读写时的文件内容，ours为工具当前内容，theirs为磁盘上的最新内容
+    static DtsMergeResult mergeContent(const QString &base, const QString &ours, const QString &theirs);
     
     // 获取外设信息
     QMap<QString, PeripheralInfo> getPeripheralInfos() const;
@@ -69,11 +94,22 @@ public:
     // 获取特定外设信息
     PeripheralInfo getPeripheralInfo(const QString &peripheral) const;
 
+signals:
+    void loaded(bool ok);
+    // 外部修改已合并进来
+    void externallyChanged(const QStringList &changedNodes, const QStringList &conflicts);
+
 private:
     QString m_filePath;
     QString m_fileContent;
+    QString m_baseContent;      // 磁盘上应有的内容（上次读取或写入的结果）
+    int m_pendingWrites;
     QMap<QString, PeripheralInfo> m_peripherals;
     
+    // 与磁盘内容合并后写入
+    QFuture<FileIoResult> writeMerged();
+    void applyMerge(const QString &diskContent, const DtsMergeResult &merge);
+
     // 解析设备树文件
     void parseDtsFile();
     
@@ -88,6 +124,12 @@ private:
     
     // 查找节点在文件中的位置
     QPair<int, int> findNodePosition(const QString &nodeName);
+    static QPair<int, int> findNodeRange(const QString &content, const QString &nodeName);
+
+    // 文件中工具管理的外设节点名
+    static QStringList peripheralNodeNames(const QString &content);
+    // 合并时以节点为单位处理的全部节点：外设节点及工具生成的节点
+    static QStringList managedNodeNames(const QString &content);
     
     // 将SYSDMA常量名转换为数字
     QString getChannelNumber(const QString &channelName);
@@ -0,0 +1,176 @@
+#include "dvfsplanner.h"
+#include <algorithm>
+
+QList<PerformanceProfile> DvfsPlanner::builtinProfiles()
+{
+    // ND/OD两档与SDK中 CONFIG_OD_CLK_SEL 的时钟设置一致，节能档降低CPU/TPU/VIP频率及电压
+    return {
+        {"eco", "节能", 32, 40, 4, 3, 850000, 850000, false},
+        {"nd", "默认ND", 40, 48, 3, 2, 900000, 900000, false},
+        {"od", "OD超频", 44, 64, 2, 2, 1000000, 1000000, true}
+    };
+}
+
+PerformanceProfile DvfsPlanner::profile(const QString& id)
+{
+    const QList<PerformanceProfile> profiles = builtinProfiles();
+    for (const PerformanceProfile& profile : profiles) {
+        if (profile.id == id) {
+            return profile;
+        }
+    }
+    return profiles.value(1);   // 未知档位按默认ND处理
+}
+
+const QList<DvfsClockLimit>& DvfsPlanner::clockLimits()
+{
+    // 频率上限及各频段所需的最低电压
+    static const QList<DvfsClockLimit> limits = {
+        {"clk_cpu", true, 1100.0, {{850.0, 850000}, {1000.0, 900000}, {1100.0, 1000000}}},
+        {"clk_rv1", false, 1600.0, {{1000.0, 850000}, {1200.0, 900000}, {1600.0, 1000000}}},
+        {"clk_tpu", false, 750.0, {{375.0, 850000}, {500.0, 900000}, {750.0, 1000000}}},
+        {"clk_vip_sys_3", false, 600.0, {{400.0, 850000}, {600.0, 900000}}}
+    };
+    return limits;
+}
+
+OperatingPoint DvfsPlanner::operatingPoint(const PerformanceProfile& profile, double tpllMHz, double mpllMHz)
+{
+    OperatingPoint point;
+    point.cpuMHz = OSC_MHZ * profile.appllMultiplier;
+    point.rvMHz = OSC_MHZ * profile.rvpllMultiplier;
+    point.tpuMHz = profile.tpuDivider > 0 ? tpllMHz / profile.tpuDivider : 0.0;
+    point.vipMHz = profile.vipDivider > 0 ? mpllMHz / profile.vipDivider : 0.0;
+    return point;
+}
+
+QStringList DvfsPlanner::validate(const PerformanceProfile& profile, const OperatingPoint& point)
+{
+    QStringList errors;
+
+    for (int microvolt : {profile.cpuMicrovolt, profile.coreMicrovolt}) {
+        if (microvolt < RAIL_MIN_MICROVOLT || microvolt > RAIL_MAX_MICROVOLT) {
+            errors << QString("电压 %1 mV 超出电源允许范围 %2-%3 mV")
+                      .arg(microvolt / 1000.0).arg(RAIL_MIN_MICROVOLT / 1000).arg(RAIL_MAX_MICROVOLT / 1000);
+        }
+    }
+
+    const QMap<QString, double> frequencies = {
+        {"clk_cpu", point.cpuMHz}, {"clk_rv1", point.rvMHz},
+        {"clk_tpu", point.tpuMHz}, {"clk_vip_sys_3", point.vipMHz}
+    };
+    for (const DvfsClockLimit& limit : clockLimits()) {
+        const double mhz = frequencies.value(limit.clockName);
+        if (mhz <= 0.0) {
+            errors << QString("%1 频率无效").arg(limit.clockName);
+            continue;
+        }
+        if (mhz > limit.maxMHz + 0.001) {
+            errors << QString("%1 = %2 MHz，超过上限 %3 MHz").arg(limit.clockName).arg(mhz).arg(limit.maxMHz);
+            continue;
+        }
+
+        const int microvolt = limit.cpuRail ? profile.cpuMicrovolt : profile.coreMicrovolt;
+        for (const QPair<double, int>& step : limit.voltageCurve) {
+            if (mhz <= step.first + 0.001) {
+                if (microvolt < step.second) {
+                    errors << QString("%1 = %2 MHz 需要 %3 电压至少 %4 mV，当前 %5 mV")
+                              .arg(limit.clockName).arg(mhz)
+                              .arg(limit.cpuRail ? "VDD_CPU" : "VDDC")
+                              .arg(step.second / 1000.0).arg(microvolt / 1000.0);
+                }
+                break;
+            }
+        }
+    }
+    return errors;
+}
+
+// 单张OPP表：频率相同的档位合并为一个运行点，取较高电压
+static QString oppTableNode(const QString& label, const QString& nodeName, const QString& clockName,
+                            const QList<PerformanceProfile>& profiles, const QList<double>& frequencies,
+                            bool cpuRail)
+{
+    struct Entry {
+        quint64 hz;
+        int microvolt;
+        bool turbo;
+        QStringList ids;
+    };
+    QList<Entry> entries;
+
+    for (int i = 0; i < profiles.size() && i < frequencies.size(); ++i) {
+        const PerformanceProfile& profile = profiles[i];
+        const quint64 hz = static_cast<quint64>(frequencies[i] * 1000000.0 + 0.5);
+        const int microvolt = cpuRail ? profile.cpuMicrovolt : profile.coreMicrovolt;
+
+        auto it = std::find_if(entries.begin(), entries.end(), [hz](const Entry& entry) {
+            return entry.hz == hz;
+        });
+        if (it == entries.end()) {
+            Entry entry;
+            entry.hz = hz;
+            entry.microvolt = microvolt;
+            entry.turbo = profile.overdrive;
+            entry.ids << profile.id;
+            entries.append(entry);
+        } else {
+            it->microvolt = std::max(it->microvolt, microvolt);
+            it->turbo = it->turbo && profile.overdrive;
+            it->ids.append(profile.id);
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.hz < b.hz;
+    });
+
+    QString node = QString("%1: %2 {\n"
+                           "\tcompatible = \"operating-points-v2\";\n"
+                           "\topp-shared;\n"
+                           "\t/* %3，由性能档位生成 */\n").arg(label, nodeName, clockName);
+    for (const Entry& entry : entries) {
+        node += QString("\n\topp-%1 { /* %2 */\n"
+                        "\t\topp-hz = /bits/ 64 <%1>;\n"
+                        "\t\topp-microvolt = <%3>;\n").arg(entry.hz).arg(entry.ids.join(" ")).arg(entry.microvolt);
+        if (entry.turbo) {
+            node += "\t\tturbo-mode;\n";
+        }
+        node += "\t};\n";
+    }
+    node += "};";
+    return node;
+}
+
+QMap<QString, QString> DvfsPlanner::operatingPointTables(const QList<PerformanceProfile>& profiles,
+                                                         const QList<OperatingPoint>& points)
+{
+    QList<double> cpu, tpu, vip;
+    for (const OperatingPoint& point : points) {
+        cpu << point.cpuMHz;
+        tpu << point.tpuMHz;
+        vip << point.vipMHz;
+    }
+
+    QMap<QString, QString> nodes;
+    nodes.insert("cpu_opp_table", oppTableNode("cpu_opp_table", "cpu-opp-table", "clk_cpu", profiles, cpu, true));
+    nodes.insert("tpu_opp_table", oppTableNode("tpu_opp_table", "tpu-opp-table", "clk_tpu", profiles, tpu, false));
+    nodes.insert("vip_opp_table", oppTableNode("vip_opp_table", "vip-opp-table", "clk_vip_sys_3", profiles, vip, false));
+    return nodes;
+}
+
+QMap<QString, QString> DvfsPlanner::operatingPointConsumers()
+{
+    return {
+        {"cpu0", "cpu_opp_table"},
+        {"tpu", "tpu_opp_table"},
+        {"vi", "vip_opp_table"}
+    };
+}
+
+QMap<QString, QString> DvfsPlanner::defconfigSettings(const PerformanceProfile& bootProfile)
+{
+    // u-boot按 CONFIG_OD_CLK_SEL 选择启动时钟及电压，运行时由内核按OPP表调频
+    return {
+        {"CONFIG_OD_CLK_SEL", bootProfile.overdrive ? "y" : "n"}
+    };
+}
@@ -0,0 +1,68 @@
+#ifndef DVFSPLANNER_H
+#define DVFSPLANNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include <QPair>
+
+// 性能档位：一组CPU/TPU/VIP时钟设置及对应的电源电压
+struct PerformanceProfile {
+    QString id;             // 档位标识（eco / nd / od），用于设备树注释和设置保存
+    QString name;           // 界面显示名称
+    int appllMultiplier;    // clk_appll倍频，clk_cpu = OSC * 倍频
+    int rvpllMultiplier;    // clk_rvpll倍频，clk_rv1 = OSC * 倍频
+    int tpuDivider;         // clk_tpu / clk_tpu_gdma = clk_tpll / 分频
+    int vipDivider;         // clk_vip_sys_3 = clk_mpll / 分频
+    int cpuMicrovolt;       // VDD_CPU 电压(uV)
+    int coreMicrovolt;      // VDDC 电压(uV)，TPU/VIP/小核所在电源域
+    bool overdrive;         // 启动时使用OD时钟（CONFIG_OD_CLK_SEL）
+};
+
+// 档位换算后的实际频点(MHz)
+struct OperatingPoint {
+    double cpuMHz = 0.0;
+    double rvMHz = 0.0;
+    double tpuMHz = 0.0;
+    double vipMHz = 0.0;
+};
+
+// 单个时钟的频率上限及频率-电压曲线
+struct DvfsClockLimit {
+    QString clockName;
+    bool cpuRail;                       // true: VDD_CPU，false: VDDC
+    double maxMHz;
+    QList<QPair<double, int>> voltageCurve;   // (频率上限MHz, 最低电压uV)，按频率升序
+};
+
+// 由性能档位生成内核 operating-points-v2 表和启动时钟选择
+class DvfsPlanner
+{
+public:
+    static QList<PerformanceProfile> builtinProfiles();
+    static PerformanceProfile profile(const QString& id);
+    static const QList<DvfsClockLimit>& clockLimits();
+
+    static OperatingPoint operatingPoint(const PerformanceProfile& profile, double tpllMHz, double mpllMHz);
+
+    // 校验频率上限及电压是否满足频率-电压曲线，返回错误描述，空表示通过
+    static QStringList validate(const PerformanceProfile& profile, const OperatingPoint& point);
+
+    // 生成设备树节点文本，key为节点标签（cpu_opp_table / tpu_opp_table / vip_opp_table）
+    // OD档位的运行点标记为 turbo-mode，只有开启boost时内核才会使用
+    static QMap<QString, QString> operatingPointTables(const QList<PerformanceProfile>& profiles,
+                                                       const QList<OperatingPoint>& points);
+
+    // 通过 operating-points-v2 引用OPP表的设备节点，key为设备节点标签，value为OPP表标签
+    static QMap<QString, QString> operatingPointConsumers();
+
+    // 启动档位对应的defconfig配置项
+    static QMap<QString, QString> defconfigSettings(const PerformanceProfile& bootProfile);
+
+    static constexpr double OSC_MHZ = 25.0;
+    static constexpr int RAIL_MIN_MICROVOLT = 800000;
+    static constexpr int RAIL_MAX_MICROVOLT = 1050000;
+};
+
+#endif // DVFSPLANNER_H
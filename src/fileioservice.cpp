@@ -0,0 +1,294 @@
+#include "fileioservice.h"
+#include "artifactcache.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QPointer>
+#include <memory>
+
+// 分块读写，块之间检查取消并报告进度
+static constexpr qint64 kChunkSize = 256 * 1024;
+
+static QStringList splitLines(const QString& content)
+{
+    if (content.isEmpty()) {
+        return QStringList();
+    }
+    QStringList lines = content.split('\n');
+    if (content.endsWith('\n')) {
+        lines.removeLast();
+    }
+    return lines;
+}
+
+static QString joinLines(const QStringList& lines)
+{
+    QString content;
+    for (const QString& line : lines) {
+        content += line;
+        content += '\n';
+    }
+    return content;
+}
+
+FileIoService* FileIoService::instance()
+{
+    static QPointer<FileIoService> service;
+    if (!service) {
+        service = new FileIoService(QCoreApplication::instance());
+    }
+    return service;
+}
+
+FileIoService::FileIoService(QObject *parent)
+    : QObject(parent)
+    , m_worker(nullptr)
+{
+    m_thread.setObjectName("FileIoService");
+    m_worker = new QObject;
+    m_worker->moveToThread(&m_thread);
+    m_thread.start();
+}
+
+FileIoService::~FileIoService()
+{
+    // 退出前让已提交的写入全部落盘，再结束线程
+    QMetaObject::invokeMethod(m_worker, [this]() { m_thread.quit(); }, Qt::QueuedConnection);
+    m_thread.wait();
+    delete m_worker;
+}
+
+QFuture<FileIoResult> FileIoService::readText(const QString& filePath, const QString& description)
+{
+    return submit(filePath, description,
+                  [this, filePath](const QPromise<FileIoResult>& promise, const QString& taskDescription) {
+        FileIoResult result;
+        result.ok = readFile(filePath, taskDescription, promise, result);
+        return result;
+    });
+}
+
+QFuture<FileIoResult> FileIoService::writeText(const QString& filePath, const QString& content,
+                                               const QString& description)
+{
+    return submit(filePath, description,
+                  [this, filePath, content](const QPromise<FileIoResult>& promise, const QString& taskDescription) {
+        FileIoResult result;
+        result.content = content;
+        result.ok = writeFile(filePath, content.toUtf8(), QIODevice::Text, taskDescription, promise, result);
+        result.written = result.ok;
+        return result;
+    });
+}
+
+QFuture<FileIoResult> FileIoService::writeData(const QString& filePath, const QByteArray& data,
+                                               const QString& description)
+{
+    return submit(filePath, description,
+                  [this, filePath, data](const QPromise<FileIoResult>& promise, const QString& taskDescription) {
+        FileIoResult result;
+        QDir().mkpath(QFileInfo(filePath).absolutePath());
+        result.ok = writeFile(filePath, data, QIODevice::NotOpen, taskDescription, promise, result);
+        result.written = result.ok;
+        return result;
+    });
+}
+
+QFuture<FileIoResult> FileIoService::modifyText(const QString& filePath, FileTextTransform transform,
+                                                const QString& description)
+{
+    return submit(filePath, description,
+                  [this, filePath, transform](const QPromise<FileIoResult>& promise, const QString& taskDescription) {
+        FileIoResult result;
+        if (!readFile(filePath, taskDescription, promise, result)) {
+            return result;
+        }
+
+        const QString original = result.content;
+        if (!transform(result.content, result.errorMessage)) {
+            return result;
+        }
+        if (result.content == original) {
+            result.ok = true;
+            return result;
+        }
+
+        result.ok = writeFile(filePath, result.content.toUtf8(), QIODevice::Text, taskDescription, promise, result);
+        result.written = result.ok;
+        return result;
+    });
+}
+
+QFuture<FileIoResult> FileIoService::modifyLines(const QString& filePath, FileLinesTransform transform,
+                                                 const QString& description)
+{
+    return modifyText(filePath, [transform](QString& content, QString& errorMessage) {
+        QStringList lines = splitLines(content);
+        if (!transform(lines, errorMessage)) {
+            return false;
+        }
+        content = joinLines(lines);
+        return true;
+    }, description);
+}
+
+QFuture<FileIoResult> FileIoService::finished(const FileIoResult& result)
+{
+    QPromise<FileIoResult> promise;
+    QFuture<FileIoResult> future = promise.future();
+    promise.start();
+    promise.addResult(result);
+    promise.finish();
+    return future;
+}
+
+bool FileIoService::isBusy() const
+{
+    return !m_pending.isEmpty();
+}
+
+void FileIoService::cancelAll()
+{
+    for (QFuture<FileIoResult>& future : m_pending) {
+        future.cancel();
+    }
+}
+
+QFuture<FileIoResult> FileIoService::submit(const QString& filePath, const QString& description, Job job)
+{
+    // QPromise不可复制，排队调用的函数对象通过共享指针持有
+    auto promise = std::make_shared<QPromise<FileIoResult>>();
+    QFuture<FileIoResult> future = promise->future();
+    m_pending.append(future);
+
+    const QString taskDescription = description.isEmpty() ? QFileInfo(filePath).fileName() : description;
+    QMetaObject::invokeMethod(m_worker, [this, promise, filePath, taskDescription, job]() {
+        promise->start();
+
+        FileIoResult result;
+        result.filePath = filePath;
+        if (promise->isCanceled()) {
+            result.errorMessage = "已取消";
+        } else {
+            result = job(*promise, taskDescription);
+            result.filePath = filePath;
+        }
+
+        if (!result.ok && !promise->isCanceled()) {
+            emit taskFailed(taskDescription, result.errorMessage);
+        }
+
+        promise->addResult(result);
+        promise->finish();
+        QMetaObject::invokeMethod(this, &FileIoService::onTaskDone, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+
+    return future;
+}
+
+void FileIoService::onTaskDone()
+{
+    m_pending.removeIf([](const QFuture<FileIoResult>& future) { return future.isFinished(); });
+    if (m_pending.isEmpty()) {
+        emit idle();
+    }
+}
+
+bool FileIoService::readFile(const QString& filePath, const QString& description,
+                             const QPromise<FileIoResult>& promise, FileIoResult& result)
+{
+    QFile file(filePath);
+    if (!file.exists()) {
+        result.missing = true;
+        result.errorMessage = QString("文件不存在: %1").arg(filePath);
+        return false;
+    }
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        result.errorMessage = QString("无法读取文件: %1 (%2)").arg(filePath).arg(file.errorString());
+        return false;
+    }
+
+    const qint64 total = file.size();
+    result.fileSize = total;
+    result.lastModifiedMs = file.fileTime(QFileDevice::FileModificationTime).toMSecsSinceEpoch();
+    const QString activity = QString("正在读取 %1").arg(description);
+    int lastPercent = -1;
+    QByteArray data;
+    data.reserve(total);
+
+    while (!file.atEnd()) {
+        if (promise.isCanceled()) {
+            result.errorMessage = "已取消";
+            return false;
+        }
+
+        QByteArray chunk = file.read(kChunkSize);
+        if (chunk.isEmpty()) {
+            if (file.error() != QFileDevice::NoError) {
+                result.errorMessage = QString("读取文件失败: %1 (%2)").arg(filePath).arg(file.errorString());
+                return false;
+            }
+            break;
+        }
+        data.append(chunk);
+        reportProgress(activity, data.size(), total, lastPercent);
+    }
+
+    result.contentHash = ArtifactCache::hash64(data.constData(), data.size());
+    result.content = QString::fromUtf8(data);
+    return true;
+}
+
+bool FileIoService::writeFile(const QString& filePath, const QByteArray& data, QIODevice::OpenMode mode,
+                              const QString& description, const QPromise<FileIoResult>& promise, FileIoResult& result)
+{
+    // 已取消的任务不再写文件；QSaveFile未提交前析构会丢弃临时文件，原文件保持不变
+    if (promise.isCanceled()) {
+        result.errorMessage = "已取消";
+        return false;
+    }
+
+    QSaveFile file(filePath);
+    file.setDirectWriteFallback(true);
+    if (!file.open(QIODevice::WriteOnly | mode)) {
+        result.errorMessage = QString("无法写入文件: %1 (%2)").arg(filePath).arg(file.errorString());
+        return false;
+    }
+
+    const QString activity = QString("正在写入 %1").arg(description);
+    int lastPercent = -1;
+    qint64 written = 0;
+
+    while (written < data.size()) {
+        if (promise.isCanceled()) {
+            result.errorMessage = "已取消";
+            return false;
+        }
+
+        qint64 count = file.write(data.constData() + written, qMin(kChunkSize, data.size() - written));
+        if (count < 0) {
+            result.errorMessage = QString("写入文件失败: %1 (%2)").arg(filePath).arg(file.errorString());
+            return false;
+        }
+        written += count;
+        reportProgress(activity, written, data.size(), lastPercent);
+    }
+
+    if (!file.commit()) {
+        result.errorMessage = QString("无法保存文件: %1 (%2)").arg(filePath).arg(file.errorString());
+        return false;
+    }
+    emit fileWritten(filePath);
+    return true;
+}
+
+void FileIoService::reportProgress(const QString& description, qint64 done, qint64 total, int& lastPercent)
+{
+    int percent = total > 0 ? static_cast<int>(qMin<qint64>(100, done * 100 / total)) : -1;
+    if (percent != lastPercent) {
+        lastPercent = percent;
+        emit activityChanged(description, percent);
+    }
+}
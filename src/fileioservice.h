@@ -0,0 +1,92 @@
+#ifndef FILEIOSERVICE_H
+#define FILEIOSERVICE_H
+
+#include <QObject>
+#include <QThread>
+#include <QFuture>
+#include <QPromise>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+// 一次文件读写任务的结果
+struct FileIoResult {
+    QString filePath;
+    bool ok = false;
+    bool missing = false;       // 文件不存在
+    bool written = false;       // 是否实际写入（修改任务内容不变时不写回）
+    QString content;            // 读取到的文本；修改任务为修改后的文本
+    QString errorMessage;
+
+    // 读取时记录的源文件身份，用于解析缓存校验
+    qint64 fileSize = -1;
+    qint64 lastModifiedMs = 0;
+    quint64 contentHash = 0;    // 读取到的原始字节的XXH64
+};
+
+// 在I/O线程中修改文本，返回false表示放弃写回并由errorMessage说明原因
+// 只能使用按值捕获的数据，不能访问界面对象
+using FileTextTransform = std::function<bool(QString& content, QString& errorMessage)>;
+using FileLinesTransform = std::function<bool(QStringList& lines, QString& errorMessage)>;
+
+// 后台文件I/O服务：SDK目录下的读写在专用线程中按提交顺序串行执行，界面线程不再等待磁盘/NFS
+// 结果通过QFuture返回，调用方用 future.then(context, ...) 回到界面线程处理
+// QFuture::cancel() 后尚未开始或仍在读取的任务不会再写文件；写入使用QSaveFile，不会留下半个文件
+class FileIoService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static FileIoService* instance();
+    ~FileIoService() override;
+
+    QFuture<FileIoResult> readText(const QString& filePath, const QString& description = QString());
+    QFuture<FileIoResult> writeText(const QString& filePath, const QString& content,
+                                    const QString& description = QString());
+    // 二进制写入，目录不存在时自动创建（缓存等工具自有文件）
+    QFuture<FileIoResult> writeData(const QString& filePath, const QByteArray& data,
+                                    const QString& description = QString());
+    // 读取-修改-写回在I/O线程中连续完成，内容不变时不写回
+    QFuture<FileIoResult> modifyText(const QString& filePath, FileTextTransform transform,
+                                     const QString& description = QString());
+    // 按行修改，写回时每行以换行结尾（与逐行读写defconfig的方式一致）
+    QFuture<FileIoResult> modifyLines(const QString& filePath, FileLinesTransform transform,
+                                      const QString& description = QString());
+
+    // 无需I/O即可确定结果时（如参数校验失败）返回已完成的future
+    static QFuture<FileIoResult> finished(const FileIoResult& result);
+
+    bool isBusy() const;
+
+public slots:
+    void cancelAll();
+
+signals:
+    // percent < 0 表示进度未知；信号在I/O线程发出，连接到界面对象时自动排队
+    void activityChanged(const QString& description, int percent);
+    void taskFailed(const QString& description, const QString& errorMessage);
+    void idle();
+    // 文件已由本服务写入（在I/O线程发出），用于区分自身写入和外部修改
+    void fileWritten(const QString& filePath);
+
+private:
+    explicit FileIoService(QObject *parent = nullptr);
+
+    using Job = std::function<FileIoResult(const QPromise<FileIoResult>& promise, const QString& description)>;
+    QFuture<FileIoResult> submit(const QString& filePath, const QString& description, Job job);
+    void onTaskDone();
+
+    // 以下在I/O线程中执行
+    bool readFile(const QString& filePath, const QString& description, const QPromise<FileIoResult>& promise,
+                  FileIoResult& result);
+    bool writeFile(const QString& filePath, const QByteArray& data, QIODevice::OpenMode mode,
+                   const QString& description, const QPromise<FileIoResult>& promise, FileIoResult& result);
+    void reportProgress(const QString& description, qint64 done, qint64 total, int& lastPercent);
+
+    QThread m_thread;
+    QObject *m_worker;                          // 驻留在I/O线程，任务以排队调用的方式投递
+    QList<QFuture<FileIoResult>> m_pending;     // 界面线程维护，用于取消和空闲判断
+};
+
+#endif // FILEIOSERVICE_H
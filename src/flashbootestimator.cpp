@@ -0,0 +1,379 @@
+#include "flashbootestimator.h"
+#include <QSettings>
+#include <algorithm>
+
+namespace {
+
+const double BYTES_PER_MB = 1024.0 * 1024.0;
+
+QString mediaKey(FlashGeometry::MediaType media)
+{
+    switch (media) {
+    case FlashGeometry::EMMC:
+        return "emmc";
+    case FlashGeometry::SPI_NAND:
+        return "spinand";
+    case FlashGeometry::SPI_NOR:
+        return "spinor";
+    }
+    return "emmc";
+}
+
+bool isEmmcMode(FlashBusConfig::BusMode mode)
+{
+    return mode <= FlashBusConfig::EMMC_HS400;
+}
+
+} // namespace
+
+FlashBusConfig FlashBusConfig::defaultConfig(FlashGeometry::MediaType media)
+{
+    FlashBusConfig config;
+    config.media = media;
+
+    switch (media) {
+    case FlashGeometry::EMMC:
+        config.mode = EMMC_HS200;
+        config.clockMHz = 200.0;
+        config.busWidth = 8;
+        break;
+    case FlashGeometry::SPI_NAND:
+        config.mode = SPI_QUAD;
+        config.clockMHz = 100.0;
+        config.busWidth = 4;
+        break;
+    case FlashGeometry::SPI_NOR:
+    default:
+        config.mode = SPI_QUAD;
+        config.clockMHz = 100.0;
+        config.busWidth = 4;
+        break;
+    }
+
+    return config;
+}
+
+FlashBusConfig FlashBusConfig::bootRomConfig(FlashGeometry::MediaType media)
+{
+    // BootROM 不做总线调优，按上电后的兼容模式读取fip
+    FlashBusConfig config;
+    config.media = media;
+    if (media == FlashGeometry::EMMC) {
+        config.mode = EMMC_LEGACY;
+        config.clockMHz = 25.0;
+        config.busWidth = 4;
+    } else {
+        config.mode = SPI_SINGLE;
+        config.clockMHz = 25.0;
+        config.busWidth = 1;
+    }
+    return config;
+}
+
+QList<FlashBusConfig::BusMode> FlashBusConfig::modesFor(FlashGeometry::MediaType media)
+{
+    if (media == FlashGeometry::EMMC) {
+        return {EMMC_LEGACY, EMMC_HS52, EMMC_DDR52, EMMC_HS200, EMMC_HS400};
+    }
+    return {SPI_SINGLE, SPI_DUAL, SPI_QUAD};
+}
+
+QString FlashBusConfig::modeName(BusMode mode)
+{
+    switch (mode) {
+    case EMMC_LEGACY:
+        return "Legacy";
+    case EMMC_HS52:
+        return "HS52";
+    case EMMC_DDR52:
+        return "DDR52";
+    case EMMC_HS200:
+        return "HS200";
+    case EMMC_HS400:
+        return "HS400";
+    case SPI_SINGLE:
+        return "x1";
+    case SPI_DUAL:
+        return "x2 (Dual)";
+    case SPI_QUAD:
+        return "x4 (Quad)";
+    }
+    return "Legacy";
+}
+
+double FlashBusConfig::maxClockMHz(BusMode mode)
+{
+    switch (mode) {
+    case EMMC_LEGACY:
+        return 26.0;
+    case EMMC_HS52:
+    case EMMC_DDR52:
+        return 52.0;
+    case EMMC_HS200:
+    case EMMC_HS400:
+        return 200.0;
+    case SPI_SINGLE:
+    case SPI_DUAL:
+    case SPI_QUAD:
+        return 133.0;
+    }
+    return 26.0;
+}
+
+QString FlashBusConfig::clockNameFor(FlashGeometry::MediaType media)
+{
+    switch (media) {
+    case FlashGeometry::EMMC:
+        return "clk_emmc_card";
+    case FlashGeometry::SPI_NAND:
+        return "clk_spi_nand";
+    case FlashGeometry::SPI_NOR:
+        return "clk_spi_nor";
+    }
+    return "clk_emmc_card";
+}
+
+FlashBusConfig FlashBusConfig::load(FlashGeometry::MediaType media)
+{
+    FlashBusConfig defaults = defaultConfig(media);
+    FlashBusConfig result = defaults;
+
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.beginGroup("FlashBoot");
+    settings.beginGroup(mediaKey(media));
+    int mode = settings.value("mode", static_cast<int>(defaults.mode)).toInt();
+    if (modesFor(media).contains(static_cast<BusMode>(mode))) {
+        result.mode = static_cast<BusMode>(mode);
+    }
+    result.clockMHz = settings.value("clockMHz", defaults.clockMHz).toDouble();
+    result.busWidth = settings.value("busWidth", defaults.busWidth).toInt();
+    settings.endGroup();
+    settings.endGroup();
+
+    return result;
+}
+
+void FlashBusConfig::save() const
+{
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.beginGroup("FlashBoot");
+    settings.beginGroup(mediaKey(media));
+    settings.setValue("mode", static_cast<int>(mode));
+    settings.setValue("clockMHz", clockMHz);
+    settings.setValue("busWidth", busWidth);
+    settings.endGroup();
+    settings.endGroup();
+}
+
+double FlashBusConfig::dataLines() const
+{
+    switch (mode) {
+    case EMMC_HS400:
+        return 8.0 * 2.0;
+    case EMMC_DDR52:
+        return busWidth * 2.0;
+    case EMMC_LEGACY:
+    case EMMC_HS52:
+    case EMMC_HS200:
+        return busWidth;
+    case SPI_SINGLE:
+        return 1.0;
+    case SPI_DUAL:
+        return 2.0;
+    case SPI_QUAD:
+        return 4.0;
+    }
+    return 1.0;
+}
+
+double FlashBusConfig::peakMBps() const
+{
+    double clock = std::min(clockMHz, maxClockMHz(mode));
+    return clock * 1e6 * dataLines() / 8.0 / BYTES_PER_MB;
+}
+
+double FlashBusConfig::effectiveMBps() const
+{
+    double clock = std::min(clockMHz, maxClockMHz(mode));
+    if (clock <= 0) {
+        return 0.0;
+    }
+
+    if (isEmmcMode(mode)) {
+        return peakMBps() * FlashBootEstimator::EMMC_EFFICIENCY;
+    }
+    if (media == FlashGeometry::SPI_NOR) {
+        return peakMBps() * FlashBootEstimator::SPI_NOR_EFFICIENCY;
+    }
+
+    // SPI-NAND：每页先从阵列读到cache，再经SPI读出；命令和地址在单线上发送
+    double transferUs = (FlashBootEstimator::SPI_COMMAND_BITS +
+                         FlashBootEstimator::SPI_NAND_PAGE_BYTES * 8.0 / dataLines()) / clock;
+    double pageUs = FlashBootEstimator::SPI_NAND_PAGE_READ_US + transferUs;
+    return FlashBootEstimator::SPI_NAND_PAGE_BYTES / pageUs * 1e6 / BYTES_PER_MB;
+}
+
+QString FlashBusConfig::description() const
+{
+    QString text = QString("%1 %2 %3 MHz")
+                       .arg(FlashGeometry::mediaName(media))
+                       .arg(modeName(mode))
+                       .arg(std::min(clockMHz, maxClockMHz(mode)), 0, 'f', 1);
+    if (isEmmcMode(mode)) {
+        text += QString(" %1bit").arg(mode == EMMC_HS400 ? 8 : busWidth);
+    }
+    return text;
+}
+
+double BootStorageEstimate::totalMs() const
+{
+    double total = 0.0;
+    for (const PartitionLoadTime& load : loads) {
+        total += load.ms;
+    }
+    return total;
+}
+
+const PartitionLoadTime* BootStorageEstimate::dominant() const
+{
+    for (const PartitionLoadTime& load : loads) {
+        if (load.partitionNumber == dominantPartition) {
+            return &load;
+        }
+    }
+    return nullptr;
+}
+
+QString BootStorageEstimate::summary() const
+{
+    const PartitionLoadTime* top = dominant();
+    double total = totalMs();
+    if (!top || total <= 0) {
+        return "启动读取 ≈ -- ms";
+    }
+    return QString("启动读取 ≈ %1 ms，主要为 %2 (%3%)")
+               .arg(total, 0, 'f', 1)
+               .arg(top->label)
+               .arg(top->ms / total * 100.0, 0, 'f', 0);
+}
+
+QString BootStorageEstimate::breakdown() const
+{
+    QStringList lines;
+    lines << QString("启动总线: %1，持续带宽 %2 MB/s")
+                 .arg(bus.description())
+                 .arg(bus.effectiveMBps(), 0, 'f', 1);
+    for (const PartitionLoadTime& load : loads) {
+        lines << QString("  %1%2 [%3]: %4 KB @ %5 MB/s = %6 ms")
+                     .arg(load.partitionNumber == dominantPartition ? "*" : " ")
+                     .arg(load.label, -8)
+                     .arg(load.stage)
+                     .arg(load.bytes / 1024)
+                     .arg(load.effectiveMBps, 0, 'f', 1)
+                     .arg(load.ms, 0, 'f', 1);
+    }
+    lines << QString("  合计: %1 ms").arg(totalMs(), 0, 'f', 1);
+    lines << notes;
+    return lines.join("\n");
+}
+
+QStringList FlashBootEstimator::requiredClocks()
+{
+    return {FlashBusConfig::clockNameFor(FlashGeometry::EMMC),
+            FlashBusConfig::clockNameFor(FlashGeometry::SPI_NAND),
+            FlashBusConfig::clockNameFor(FlashGeometry::SPI_NOR)};
+}
+
+QString FlashBootEstimator::stageFor(const QString& label)
+{
+    QString lower = label.toLower();
+    if (lower == "fip") {
+        return "BootROM";
+    }
+    if (lower == "2nd") {
+        return "FSBL";
+    }
+    if (lower == "env" || lower == "boot") {
+        return "U-Boot";
+    }
+    if (lower == "rootfs") {
+        return "Kernel";
+    }
+    return QString();
+}
+
+BootStorageEstimate FlashBootEstimator::estimate(const FlashPlan& plan,
+                                                 const FlashBusConfig& bus,
+                                                 const QMap<QString, double>& clocksMHz,
+                                                 const QMap<int, PayloadScanResult>& payloads)
+{
+    BootStorageEstimate result;
+    result.bus = bus;
+    result.dominantPartition = -1;
+    result.busClockFromTreeMHz = clocksMHz.value(FlashBusConfig::clockNameFor(bus.media), 0.0);
+
+    // 总线时钟不能超过时钟树给控制器的时钟
+    if (result.busClockFromTreeMHz > 0 && result.busClockFromTreeMHz < result.bus.clockMHz) {
+        result.notes << QString("总线时钟受时钟树 %1 限制为 %2 MHz")
+                            .arg(FlashBusConfig::clockNameFor(bus.media))
+                            .arg(result.busClockFromTreeMHz, 0, 'f', 1);
+        result.bus.clockMHz = result.busClockFromTreeMHz;
+    }
+    if (result.bus.clockMHz > FlashBusConfig::maxClockMHz(result.bus.mode)) {
+        result.notes << QString("%1 模式最高 %2 MHz")
+                            .arg(FlashBusConfig::modeName(result.bus.mode))
+                            .arg(FlashBusConfig::maxClockMHz(result.bus.mode), 0, 'f', 0);
+    }
+
+    const FlashBusConfig romBus = FlashBusConfig::bootRomConfig(bus.media);
+    double maxMs = 0.0;
+    bool estimatedFromSize = false;
+    bool readByRom = false;
+
+    for (const PlannedPartition& planned : plan.partitions) {
+        QString stage = stageFor(planned.label);
+        if (stage.isEmpty()) {
+            continue;
+        }
+
+        PartitionLoadTime load;
+        load.partitionNumber = planned.partitionNumber;
+        load.label = planned.label;
+        load.stage = stage;
+
+        // 有扫描结果时按实际数据量计算，否则按分区大小估算
+        if (payloads.contains(planned.partitionNumber)) {
+            load.bytes = static_cast<quint64>(payloads[planned.partitionNumber].dataBlocks) * FlashPayloadScanner::BLOCK_SIZE;
+        } else {
+            load.bytes = planned.requestedKB * 1024;
+            estimatedFromSize = true;
+        }
+        if (stage == "Kernel") {
+            load.bytes = load.bytes * ROOTFS_BOOT_READ_PERCENT / 100;
+        }
+
+        readByRom = readByRom || stage == "BootROM";
+        const FlashBusConfig& readBus = stage == "BootROM" ? romBus : result.bus;
+        load.effectiveMBps = readBus.effectiveMBps();
+        load.ms = load.effectiveMBps > 0 ? load.bytes / BYTES_PER_MB / load.effectiveMBps * 1000.0 : 0.0;
+        if (bus.media == FlashGeometry::EMMC) {
+            load.ms += EMMC_COMMAND_MS;
+        }
+
+        if (load.ms > maxMs) {
+            maxMs = load.ms;
+            result.dominantPartition = load.partitionNumber;
+        }
+        result.loads.append(load);
+    }
+
+    if (estimatedFromSize) {
+        result.notes << "部分分区未扫描数据文件，按分区大小估算（偏大）";
+    }
+    if (readByRom) {
+        result.notes << QString("fip 由 BootROM 以 %1 读取").arg(romBus.description());
+    }
+    result.notes << QString("rootfs 按启动期间读取 %1% 估算").arg(ROOTFS_BOOT_READ_PERCENT);
+
+    return result;
+}
@@ -0,0 +1,97 @@
+#ifndef FLASHBOOTESTIMATOR_H
+#define FLASHBOOTESTIMATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include "flashpartitionplanner.h"
+#include "flashpayloadscanner.h"
+
+// 启动介质的总线模式与时钟
+struct FlashBusConfig {
+    enum BusMode {
+        EMMC_LEGACY = 0,    // 26MHz SDR
+        EMMC_HS52,          // 52MHz SDR
+        EMMC_DDR52,         // 52MHz DDR
+        EMMC_HS200,         // 200MHz SDR
+        EMMC_HS400,         // 200MHz DDR，仅8位
+        SPI_SINGLE,
+        SPI_DUAL,
+        SPI_QUAD
+    };
+
+    FlashGeometry::MediaType media;
+    BusMode mode;
+    double clockMHz;        // 总线时钟（eMMC为卡时钟，SPI为SCK）
+    int busWidth;           // eMMC数据线宽度 1/4/8；SPI由模式决定
+
+    static FlashBusConfig defaultConfig(FlashGeometry::MediaType media);
+    // BootROM 读取fip时使用的兼容模式
+    static FlashBusConfig bootRomConfig(FlashGeometry::MediaType media);
+    static QList<BusMode> modesFor(FlashGeometry::MediaType media);
+    static QString modeName(BusMode mode);
+    static double maxClockMHz(BusMode mode);
+    // 时钟树中决定该介质总线时钟的节点
+    static QString clockNameFor(FlashGeometry::MediaType media);
+
+    // 按介质分别保存在 QSettings 的 "FlashBoot" 分组
+    static FlashBusConfig load(FlashGeometry::MediaType media);
+    void save() const;
+
+    double dataLines() const;           // 每个时钟沿传输的数据位数
+    double peakMBps() const;            // 总线理论带宽
+    double effectiveMBps() const;       // 计入命令开销、NAND页读取延迟后的持续带宽
+    QString description() const;
+};
+
+// 单个启动关键分区的读取耗时
+struct PartitionLoadTime {
+    int partitionNumber;
+    QString label;
+    QString stage;          // 由哪个启动阶段读取
+    quint64 bytes;          // 启动时实际读取的数据量
+    double effectiveMBps;
+    double ms;
+};
+
+// 启动存储读取耗时估算结果
+struct BootStorageEstimate {
+    QList<PartitionLoadTime> loads;
+    FlashBusConfig bus;
+    double busClockFromTreeMHz;     // 时钟树给出的控制器时钟，0表示未获取
+    int dominantPartition;          // 耗时最多的分区号，-1表示无
+    QStringList notes;
+
+    double totalMs() const;
+    const PartitionLoadTime* dominant() const;
+    QString summary() const;        // 例如 "启动读取 ≈ 85.2 ms，主要为 BOOT (62%)"
+    QString breakdown() const;
+};
+
+// 启动路径读取耗时估算：fip读取2nd，U-Boot读取ENV/BOOT，内核挂载ROOTFS
+class FlashBootEstimator
+{
+public:
+    // 估算需要查询的时钟节点
+    static QStringList requiredClocks();
+
+    // plan 中只包含启用的分区；payloads 为分区数据扫描结果（可为空，此时按分区大小估算）
+    static BootStorageEstimate estimate(const FlashPlan& plan,
+                                        const FlashBusConfig& bus,
+                                        const QMap<QString, double>& clocksMHz,
+                                        const QMap<int, PayloadScanResult>& payloads);
+
+    static constexpr double EMMC_EFFICIENCY = 0.85;         // 命令/CRC/块间间隙开销
+    static constexpr double SPI_NOR_EFFICIENCY = 0.95;      // 连续读，仅命令和地址开销
+    static constexpr double SPI_NAND_PAGE_READ_US = 60.0;   // 阵列到cache的页读取时间tRD
+    static constexpr double SPI_NAND_PAGE_BYTES = 2048.0;
+    static constexpr double SPI_COMMAND_BITS = 32.0;        // 读cache命令+地址+dummy
+    static constexpr double EMMC_COMMAND_MS = 0.5;          // 每次读取的初始化和命令开销
+    static constexpr int ROOTFS_BOOT_READ_PERCENT = 40;     // 启动到应用就绪时rootfs被读取的比例
+
+private:
+    static QString stageFor(const QString& label);
+};
+
+#endif // FLASHBOOTESTIMATOR_H
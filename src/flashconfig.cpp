@@ -7,8 +7,36 @@
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QCheckBox>
+#include <QGridLayout>
+#include <QProgressDialog>
+#include <QSettings>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+// 后台组装镜像的结果，回到界面线程后提示用户
+struct ImageAssembleOutcome {
+    bool ok = false;
+    bool canceled = false;
+    FlashImageResult result = {};
+    QString errorMessage;
+};
+
+// 后台扫描分区数据文件的结果
+struct PayloadScanBatch {
+    QMap<int, PayloadScanResult> scans;
+    QStringList missing;
+    quint64 fileBytes = 0;
+    quint64 sparseBytes = 0;
+};
+
+} // namespace
 
 FlashConfigWidget::FlashConfigWidget(QWidget *parent)
     : QWidget(parent)
@@ -17,6 +45,7 @@ FlashConfigWidget::FlashConfigWidget(QWidget *parent)
     , m_tableWidget(nullptr)
     , m_tableLayout(nullptr)
     , m_partitionTable(nullptr)
+    , m_partitionModel(nullptr)
     , m_tableTitle(nullptr)
     , m_controlPanel(nullptr)
     , m_controlLayout(nullptr)
@@ -27,6 +56,8 @@ FlashConfigWidget::FlashConfigWidget(QWidget *parent)
     , m_resetButton(nullptr)
     , m_exportButton(nullptr)
     , m_importButton(nullptr)
+    , m_assembleButton(nullptr)
+    , m_scanButton(nullptr)
     , m_searchGroup(nullptr)
     , m_searchLayout(nullptr)
     , m_searchEdit(nullptr)
@@ -45,6 +76,19 @@ FlashConfigWidget::FlashConfigWidget(QWidget *parent)
     , m_mountpointEdit(nullptr)
     , m_typeEdit(nullptr)
     , m_configExpanded(false)
+    , m_mediaGroup(nullptr)
+    , m_mediaCombo(nullptr)
+    , m_capacityEdit(nullptr)
+    , m_eraseBlockSpin(nullptr)
+    , m_writeUnitSpin(nullptr)
+    , m_headReserveSpin(nullptr)
+    , m_planSummaryLabel(nullptr)
+    , m_alignButton(nullptr)
+    , m_bootGroup(nullptr)
+    , m_busModeCombo(nullptr)
+    , m_busWidthCombo(nullptr)
+    , m_busClockSpin(nullptr)
+    , m_bootTimeLabel(nullptr)
     , m_visualizationGroup(nullptr)
     , m_visualizationLayout(nullptr)
     , m_partitionMapText(nullptr)
@@ -53,10 +97,11 @@ FlashConfigWidget::FlashConfigWidget(QWidget *parent)
     , m_flashSize("32GB")
     , m_partitionCount(9)
 {
+    m_planner.setGeometry(FlashGeometry::defaultGeometry(FlashGeometry::EMMC, m_flashSize));
+    
     setupUI();
     initializePartitions();
-    populateTable();
-    updatePartitionVisualization();
+    updatePlan();
 }
 
 FlashConfigWidget::~FlashConfigWidget()
@@ -113,13 +158,10 @@ void FlashConfigWidget::setupPartitionTable()
         "border-radius: 4px;"
     );
     
-    // 创建分区表格
-    m_partitionTable = new QTableWidget(0, COL_COUNT, m_tableWidget);
-    
-    // 设置表头
-    QStringList headers;
-    headers << "分区号" << "启用" << "标签" << "大小(KB)" << "文件" << "挂载点" << "类型";
-    m_partitionTable->setHorizontalHeaderLabels(headers);
+    // 创建分区表格（分区数据与表头由模型提供）
+    m_partitionModel = new FlashPartitionModel(this);
+    m_partitionTable = new QTableView(m_tableWidget);
+    m_partitionTable->setModel(m_partitionModel);
     
     // 设置表格属性
     m_partitionTable->setAlternatingRowColors(true);
@@ -129,17 +171,17 @@ void FlashConfigWidget::setupPartitionTable()
     
     // 设置表格样式
     m_partitionTable->setStyleSheet(
-        "QTableWidget { "
+        "QTableView { "
         "gridline-color: #bdc3c7; "
         "background-color: #ffffff; "
         "border: 1px solid #bdc3c7; "
         "border-radius: 4px; "
         "} "
-        "QTableWidget::item { "
+        "QTableView::item { "
         "padding: 8px; "
         "border-bottom: 1px solid #ecf0f1; "
         "} "
-        "QTableWidget::item:selected { "
+        "QTableView::item:selected { "
         "background-color: #3498db; "
         "color: white; "
         "} "
@@ -155,17 +197,25 @@ void FlashConfigWidget::setupPartitionTable()
     // 设置列宽
     QHeaderView* header = m_partitionTable->horizontalHeader();
     header->setStretchLastSection(true);
-    header->resizeSection(COL_PARTITION_NUM, 80);
-    header->resizeSection(COL_ENABLED, 80);
-    header->resizeSection(COL_LABEL, 150);
-    header->resizeSection(COL_SIZE, 120);
-    header->resizeSection(COL_FILE, 150);
-    header->resizeSection(COL_MOUNTPOINT, 120);
-    header->resizeSection(COL_TYPE, 100);
+    header->resizeSection(FlashPartitionModel::COL_PARTITION_NUM, 80);
+    header->resizeSection(FlashPartitionModel::COL_ENABLED, 80);
+    header->resizeSection(FlashPartitionModel::COL_LABEL, 150);
+    header->resizeSection(FlashPartitionModel::COL_SIZE, 120);
+    header->resizeSection(FlashPartitionModel::COL_OFFSET, 120);
+    header->resizeSection(FlashPartitionModel::COL_FILE, 150);
+    header->resizeSection(FlashPartitionModel::COL_DATA, 100);
+    header->resizeSection(FlashPartitionModel::COL_MOUNTPOINT, 120);
+    header->resizeSection(FlashPartitionModel::COL_TYPE, 100);
     
     // 连接双击信号
-    connect(m_partitionTable, &QTableWidget::itemDoubleClicked, 
-            this, &FlashConfigWidget::onTableItemDoubleClicked);
+    connect(m_partitionTable, &QTableView::doubleClicked, 
+            this, &FlashConfigWidget::onTableDoubleClicked);
+    
+    // 启用状态变化会改变后续分区的偏移
+    connect(m_partitionModel, &FlashPartitionModel::partitionEnabledChanged, this, [this]() {
+        updatePlan();
+        emit configChanged();
+    });
     
     // 添加到布局
     m_tableLayout->addWidget(m_tableTitle);
@@ -190,6 +240,8 @@ void FlashConfigWidget::setupControlPanel()
     m_resetButton = new QPushButton("重置配置", m_operationGroup);
     m_exportButton = new QPushButton("导出配置", m_operationGroup);
     m_importButton = new QPushButton("导入配置", m_operationGroup);
+    m_scanButton = new QPushButton("分析数据", m_operationGroup);
+    m_assembleButton = new QPushButton("生成镜像", m_operationGroup);
     
     // 设置按钮样式
     QString buttonStyle = 
@@ -213,12 +265,16 @@ void FlashConfigWidget::setupControlPanel()
     m_resetButton->setStyleSheet(buttonStyle.replace("#e74c3c", "#f39c12").replace("#c0392b", "#e67e22").replace("#a93226", "#d35400"));
     m_exportButton->setStyleSheet(buttonStyle.replace("#f39c12", "#27ae60").replace("#e67e22", "#229954").replace("#d35400", "#1e8449"));
     m_importButton->setStyleSheet(buttonStyle.replace("#27ae60", "#8e44ad").replace("#229954", "#7d3c98").replace("#1e8449", "#6c3483"));
+    m_scanButton->setStyleSheet(buttonStyle.replace("#8e44ad", "#34495e").replace("#7d3c98", "#2c3e50").replace("#6c3483", "#1b2631"));
+    m_assembleButton->setStyleSheet(buttonStyle.replace("#34495e", "#16a085").replace("#2c3e50", "#138d75").replace("#1b2631", "#117a65"));
     
     m_operationLayout->addWidget(m_addButton);
     m_operationLayout->addWidget(m_removeButton);
     m_operationLayout->addWidget(m_resetButton);
     m_operationLayout->addWidget(m_exportButton);
     m_operationLayout->addWidget(m_importButton);
+    m_operationLayout->addWidget(m_scanButton);
+    m_operationLayout->addWidget(m_assembleButton);
     
     // 分区搜索组
     m_searchGroup = new QGroupBox("分区搜索", m_controlPanel);
@@ -387,6 +443,12 @@ void FlashConfigWidget::setupControlPanel()
     m_configContainerLayout->addWidget(m_configHeader);
     m_configContainerLayout->addWidget(m_configContent);
     
+    // Flash介质组
+    setupMediaGroup();
+    
+    // 启动读取组
+    setupBootGroup();
+    
     // 分区可视化组
     m_visualizationGroup = new QGroupBox("分区映射", m_controlPanel);
     m_visualizationLayout = new QVBoxLayout(m_visualizationGroup);
@@ -409,6 +471,8 @@ void FlashConfigWidget::setupControlPanel()
     
     // 添加到控制面板布局
     m_controlLayout->addWidget(m_operationGroup);
+    m_controlLayout->addWidget(m_mediaGroup);
+    m_controlLayout->addWidget(m_bootGroup);
     m_controlLayout->addWidget(m_searchGroup);
     m_controlLayout->addWidget(m_configContainer);
     m_controlLayout->addWidget(m_visualizationGroup);
@@ -420,11 +484,13 @@ void FlashConfigWidget::setupControlPanel()
     connect(m_resetButton, &QPushButton::clicked, this, &FlashConfigWidget::onResetPartitions);
     connect(m_exportButton, &QPushButton::clicked, this, &FlashConfigWidget::onExportConfig);
     connect(m_importButton, &QPushButton::clicked, this, &FlashConfigWidget::onImportConfig);
+    connect(m_scanButton, &QPushButton::clicked, this, &FlashConfigWidget::onScanPayloads);
+    connect(m_assembleButton, &QPushButton::clicked, this, &FlashConfigWidget::onAssembleImage);
     
     connect(m_searchEdit, &QLineEdit::textChanged, this, &FlashConfigWidget::onSearchTextChanged);
     connect(m_searchEdit, &QLineEdit::returnPressed, this, &FlashConfigWidget::onSearchEnterPressed);
     connect(m_configToggleButton, &QToolButton::clicked, this, &FlashConfigWidget::onToggleConfigPanel);
-    connect(m_partitionTable, &QTableWidget::itemSelectionChanged, 
+    connect(m_partitionTable->selectionModel(), &QItemSelectionModel::selectionChanged, 
             this, &FlashConfigWidget::onTableSelectionChanged);
     
     connect(m_labelEdit, &QLineEdit::editingFinished, this, &FlashConfigWidget::onConfigFieldChanged);
@@ -439,8 +505,7 @@ void FlashConfigWidget::setupControlPanel()
 void FlashConfigWidget::initializePartitions()
 {
     // 根据用户提供的defconfig示例初始化分区
-    m_partitions.clear();
-    m_partitionOrder.clear();
+    QList<FlashPartition> partitions;
     
     // 分区2: 2nd
     FlashPartition p2;
@@ -452,8 +517,7 @@ void FlashConfigWidget::initializePartitions()
     p2.mountpoint = "";
     p2.type = "";
     p2.enabled = true;
-    m_partitions[2] = p2;
-    m_partitionOrder.append(2);
+    partitions.append(p2);
     
     // 分区3: BOOT
     FlashPartition p3;
@@ -465,8 +529,7 @@ void FlashConfigWidget::initializePartitions()
     p3.mountpoint = "";
     p3.type = "";
     p3.enabled = true;
-    m_partitions[3] = p3;
-    m_partitionOrder.append(3);
+    partitions.append(p3);
     
     // 分区4: MISC
     FlashPartition p4;
@@ -478,8 +541,7 @@ void FlashConfigWidget::initializePartitions()
     p4.mountpoint = "";
     p4.type = "";
     p4.enabled = true;
-    m_partitions[4] = p4;
-    m_partitionOrder.append(4);
+    partitions.append(p4);
     
     // 分区5: ENV
     FlashPartition p5;
@@ -491,8 +553,7 @@ void FlashConfigWidget::initializePartitions()
     p5.mountpoint = "";
     p5.type = "";
     p5.enabled = true;
-    m_partitions[5] = p5;
-    m_partitionOrder.append(5);
+    partitions.append(p5);
     
     // 分区6: ROOTFS
     FlashPartition p6;
@@ -504,8 +565,7 @@ void FlashConfigWidget::initializePartitions()
     p6.mountpoint = "";
     p6.type = "";
     p6.enabled = true;
-    m_partitions[6] = p6;
-    m_partitionOrder.append(6);
+    partitions.append(p6);
     
     // 分区7: SYSTEM
     FlashPartition p7;
@@ -517,8 +577,7 @@ void FlashConfigWidget::initializePartitions()
     p7.mountpoint = "/mnt/system";
     p7.type = "ext4";
     p7.enabled = true;
-    m_partitions[7] = p7;
-    m_partitionOrder.append(7);
+    partitions.append(p7);
     
     // 分区8: CFG
     FlashPartition p8;
@@ -530,8 +589,7 @@ void FlashConfigWidget::initializePartitions()
     p8.mountpoint = "mnt/cfg";
     p8.type = "ext4";
     p8.enabled = true;
-    m_partitions[8] = p8;
-    m_partitionOrder.append(8);
+    partitions.append(p8);
     
     // 分区9: DATA
     FlashPartition p9;
@@ -543,78 +601,24 @@ void FlashConfigWidget::initializePartitions()
     p9.mountpoint = "mnt/data";
     p9.type = "ext4";
     p9.enabled = true;
-    m_partitions[9] = p9;
-    m_partitionOrder.append(9);
+    partitions.append(p9);
+    
+    m_partitionModel->setPartitions(partitions);
 }
 
-void FlashConfigWidget::populateTable()
+int FlashConfigWidget::currentPartitionNumber() const
 {
-    // 暂时断开信号
-    m_partitionTable->blockSignals(true);
-    
-    // 清空表格
-    m_partitionTable->setRowCount(0);
-    
-    // 按顺序填充表格
-    for (int i = 0; i < m_partitionOrder.size(); ++i) {
-        int partNum = m_partitionOrder[i];
-        if (!m_partitions.contains(partNum)) continue;
-        
-        const FlashPartition& partition = m_partitions[partNum];
-        
-        m_partitionTable->insertRow(i);
-        
-        // 分区号列
-        QTableWidgetItem* numItem = new QTableWidgetItem(QString::number(partition.partitionNumber));
-        numItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        m_partitionTable->setItem(i, COL_PARTITION_NUM, numItem);
-        
-        // 启用列 - 使用复选框
-        QTableWidgetItem* enabledItem = new QTableWidgetItem();
-        enabledItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable | Qt::ItemIsSelectable);
-        enabledItem->setCheckState(partition.enabled ? Qt::Checked : Qt::Unchecked);
-        m_partitionTable->setItem(i, COL_ENABLED, enabledItem);
-        
-        // 标签列
-        QTableWidgetItem* labelItem = new QTableWidgetItem(partition.label);
-        labelItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        m_partitionTable->setItem(i, COL_LABEL, labelItem);
-        
-        // 大小列
-        QTableWidgetItem* sizeItem = new QTableWidgetItem(QString::number(partition.size));
-        sizeItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        m_partitionTable->setItem(i, COL_SIZE, sizeItem);
-        
-        // 文件列
-        QTableWidgetItem* fileItem = new QTableWidgetItem(partition.file);
-        fileItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        m_partitionTable->setItem(i, COL_FILE, fileItem);
-        
-        // 挂载点列
-        QTableWidgetItem* mountpointItem = new QTableWidgetItem(partition.mountpoint);
-        mountpointItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        m_partitionTable->setItem(i, COL_MOUNTPOINT, mountpointItem);
-        
-        // 类型列
-        QTableWidgetItem* typeItem = new QTableWidgetItem(partition.type);
-        typeItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        m_partitionTable->setItem(i, COL_TYPE, typeItem);
-    }
-    
-    // 重新启用信号
-    m_partitionTable->blockSignals(false);
+    QModelIndex current = m_partitionTable->currentIndex();
+    return current.isValid() ? m_partitionModel->partitionNumberAt(current.row()) : -1;
 }
 
-void FlashConfigWidget::onTableItemDoubleClicked(QTableWidgetItem* item)
+void FlashConfigWidget::onTableDoubleClicked(const QModelIndex& index)
 {
-    if (!item) return;
-    
-    int row = item->row();
-    if (row < 0 || row >= m_partitionOrder.size()) return;
+    if (!index.isValid()) return;
     
     // 选择整行
-    m_partitionTable->selectRow(row);
-    m_partitionTable->setCurrentItem(item);
+    m_partitionTable->selectRow(index.row());
+    m_partitionTable->setCurrentIndex(index);
     
     // 展开配置面板
     setConfigPanelExpanded(true);
@@ -635,7 +639,7 @@ void FlashConfigWidget::onAddPartition()
 {
     // 查找下一个可用的分区号
     int newPartNum = 2;  // 从分区2开始（分区1是eMMC的fip.bin）
-    while (m_partitions.contains(newPartNum)) {
+    while (m_partitionModel->contains(newPartNum)) {
         newPartNum++;
     }
     
@@ -649,37 +653,27 @@ void FlashConfigWidget::onAddPartition()
     partition.type = "";
     partition.enabled = false;
     
-    m_partitions[newPartNum] = partition;
-    m_partitionOrder.append(newPartNum);
-    
-    populateTable();
-    updatePartitionVisualization();
+    m_partitionModel->appendPartition(partition);
+    updatePlan();
     
     emit configChanged();
 }
 
 void FlashConfigWidget::onRemovePartition()
 {
-    QTableWidgetItem* currentItem = m_partitionTable->currentItem();
-    if (!currentItem) {
+    int partNum = currentPartitionNumber();
+    if (partNum < 0) {
         QMessageBox::warning(this, "警告", "请选择要删除的分区！");
         return;
     }
     
-    int currentRow = currentItem->row();
-    if (currentRow < 0 || currentRow >= m_partitionOrder.size()) return;
-    
-    int partNum = m_partitionOrder[currentRow];
-    
     int ret = QMessageBox::question(this, "确认删除", 
                                    QString("确定要删除分区 %1 吗？").arg(partNum),
                                    QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        m_partitions.remove(partNum);
-        m_partitionOrder.removeAll(partNum);
-        populateTable();
-        updatePartitionVisualization();
+        m_partitionModel->removePartition(partNum);
+        updatePlan();
         
         emit configChanged();
     }
@@ -693,8 +687,7 @@ void FlashConfigWidget::onResetPartitions()
     
     if (ret == QMessageBox::Yes) {
         initializePartitions();
-        populateTable();
-        updatePartitionVisualization();
+        updatePlan();
         
         emit configChanged();
     }
@@ -708,13 +701,15 @@ void FlashConfigWidget::onExportConfig()
         return;
     }
     
-    if (exportToDefconfig(m_sourcePath, m_chipType)) {
-        QString defconfigPath = getDefconfigPath();
-        QMessageBox::information(this, "成功", 
-                               QString("Flash分区配置已导出到:\n%1").arg(defconfigPath));
-    } else {
-        QMessageBox::critical(this, "错误", "导出Flash分区配置失败！");
-    }
+    exportToDefconfig(m_sourcePath, m_chipType).then(this, [this](FileIoResult result) {
+        if (result.ok) {
+            QMessageBox::information(this, "成功", 
+                                   QString("Flash分区配置已导出到:\n%1").arg(result.filePath));
+        } else {
+            QMessageBox::critical(this, "错误",
+                                QString("导出Flash分区配置失败！\n%1").arg(result.errorMessage));
+        }
+    });
 }
 
 void FlashConfigWidget::onImportConfig()
@@ -726,8 +721,7 @@ void FlashConfigWidget::onImportConfig()
     
     if (!fileName.isEmpty()) {
         if (importFromJson(fileName)) {
-            populateTable();
-            updatePartitionVisualization();
+            updatePlan();
             QMessageBox::information(this, "成功", "分区配置已导入: " + fileName);
             emit configChanged();
         } else {
@@ -738,13 +732,8 @@ void FlashConfigWidget::onImportConfig()
 
 void FlashConfigWidget::onSearchTextChanged(const QString& searchText)
 {
-    for (int row = 0; row < m_partitionTable->rowCount(); ++row) {
-        QTableWidgetItem* labelItem = m_partitionTable->item(row, COL_LABEL);
-        if (labelItem) {
-            bool visible = searchText.isEmpty() || 
-                          labelItem->text().contains(searchText, Qt::CaseInsensitive);
-            m_partitionTable->setRowHidden(row, !visible);
-        }
+    for (int row = 0; row < m_partitionModel->rowCount(); ++row) {
+        m_partitionTable->setRowHidden(row, !m_partitionModel->labelContains(row, searchText));
     }
 }
 
@@ -762,8 +751,8 @@ void FlashConfigWidget::onTableSelectionChanged()
         return;
     }
     
-    QTableWidgetItem* currentItem = m_partitionTable->currentItem();
-    if (!currentItem) {
+    int partNum = currentPartitionNumber();
+    if (partNum < 0) {
         m_labelEdit->clear();
         m_sizeEdit->clear();
         m_sizeUnitCombo->setCurrentText("KB");
@@ -773,45 +762,31 @@ void FlashConfigWidget::onTableSelectionChanged()
         return;
     }
     
-    int currentRow = currentItem->row();
-    if (currentRow < 0 || currentRow >= m_partitionOrder.size()) {
-        m_labelEdit->clear();
-        m_sizeEdit->clear();
-        m_sizeUnitCombo->setCurrentText("KB");
-        m_fileEdit->clear();
-        m_mountpointEdit->clear();
-        m_typeEdit->clear();
-        return;
-    }
+    const FlashPartition partition = m_partitionModel->partition(partNum);
     
-    int partNum = m_partitionOrder[currentRow];
-    if (m_partitions.contains(partNum)) {
-        const FlashPartition& partition = m_partitions[partNum];
-        
-        m_labelEdit->blockSignals(true);
-        m_sizeEdit->blockSignals(true);
-        m_sizeUnitCombo->blockSignals(true);
-        m_fileEdit->blockSignals(true);
-        m_mountpointEdit->blockSignals(true);
-        m_typeEdit->blockSignals(true);
-        
-        m_labelEdit->setText(partition.label);
-        
-        // 大小直接显示KB值，不进行单位转换
-        m_sizeEdit->setText(QString::number(partition.size));
-        m_sizeUnitCombo->setCurrentText("KB");
-        
-        m_fileEdit->setText(partition.file);
-        m_mountpointEdit->setText(partition.mountpoint);
-        m_typeEdit->setText(partition.type);
-        
-        m_labelEdit->blockSignals(false);
-        m_sizeEdit->blockSignals(false);
-        m_sizeUnitCombo->blockSignals(false);
-        m_fileEdit->blockSignals(false);
-        m_mountpointEdit->blockSignals(false);
-        m_typeEdit->blockSignals(false);
-    }
+    m_labelEdit->blockSignals(true);
+    m_sizeEdit->blockSignals(true);
+    m_sizeUnitCombo->blockSignals(true);
+    m_fileEdit->blockSignals(true);
+    m_mountpointEdit->blockSignals(true);
+    m_typeEdit->blockSignals(true);
+    
+    m_labelEdit->setText(partition.label);
+    
+    // 大小直接显示KB值，不进行单位转换
+    m_sizeEdit->setText(QString::number(partition.size));
+    m_sizeUnitCombo->setCurrentText("KB");
+    
+    m_fileEdit->setText(partition.file);
+    m_mountpointEdit->setText(partition.mountpoint);
+    m_typeEdit->setText(partition.type);
+    
+    m_labelEdit->blockSignals(false);
+    m_sizeEdit->blockSignals(false);
+    m_sizeUnitCombo->blockSignals(false);
+    m_fileEdit->blockSignals(false);
+    m_mountpointEdit->blockSignals(false);
+    m_typeEdit->blockSignals(false);
 }
 
 void FlashConfigWidget::onConfigFieldChanged()
@@ -820,22 +795,13 @@ void FlashConfigWidget::onConfigFieldChanged()
         return;
     }
     
-    QTableWidgetItem* currentItem = m_partitionTable->currentItem();
-    if (!currentItem) {
-        return;
-    }
-    
-    int currentRow = currentItem->row();
-    if (currentRow < 0 || currentRow >= m_partitionOrder.size()) {
+    int partNum = currentPartitionNumber();
+    if (partNum < 0) {
         return;
     }
     
-    int partNum = m_partitionOrder[currentRow];
-    if (!m_partitions.contains(partNum)) {
-        return;
-    }
-    
-    FlashPartition& partition = m_partitions[partNum];
+    // 使用副本修改，验证通过后再写回模型
+    FlashPartition partition = m_partitionModel->partition(partNum);
     
     // 保存旧值，以便验证失败时恢复
     quint64 oldSize = partition.size;
@@ -847,27 +813,39 @@ void FlashConfigWidget::onConfigFieldChanged()
     // 更新标签
     partition.label = m_labelEdit->text().trimmed();
     
-    // 更新大小 - 只支持KB单位，且必须是64的倍数
+    // 更新大小 - 只支持KB单位，且必须按当前介质的擦除块对齐
     bool ok;
     quint64 sizeValue = m_sizeEdit->text().toULongLong(&ok);
     if (ok && sizeValue >= 0) {
-        // 检查是否是64的倍数
-        if (sizeValue % 64 != 0) {
-            // 显示错误消息
-            QMessageBox::warning(this, "大小验证错误", 
-                               QString("分区大小必须是64的倍数！\n"
-                                      "当前输入: %1 KB\n"
-                                      "建议值: %2 KB 或 %3 KB")
+        // 检查是否按擦除块对齐
+        if (!m_planner.isAligned(sizeValue)) {
+            quint64 alignment = m_planner.geometry().alignmentKB();
+            quint64 roundedUp = m_planner.alignUp(sizeValue);
+            int ret = QMessageBox::question(this, "大小对齐",
+                               QString("%1 的擦除块对齐粒度为 %2 KB，分区大小必须是它的倍数。\n"
+                                      "当前输入: %3 KB\n"
+                                      "可选值: %4 KB 或 %5 KB\n\n"
+                                      "是否向上取整为 %5 KB？")
+                               .arg(FlashGeometry::mediaName(m_planner.geometry().media))
+                               .arg(alignment)
                                .arg(sizeValue)
-                               .arg((sizeValue / 64) * 64)
-                               .arg(((sizeValue / 64) + 1) * 64));
+                               .arg(m_planner.alignDown(sizeValue))
+                               .arg(roundedUp),
+                               QMessageBox::Yes | QMessageBox::No);
             
-            // 恢复旧值
+            if (ret != QMessageBox::Yes) {
+                // 恢复旧值
+                m_sizeEdit->blockSignals(true);
+                m_sizeEdit->setText(QString::number(oldSize));
+                m_sizeEdit->blockSignals(false);
+                
+                return; // 不继续更新
+            }
+            
+            sizeValue = roundedUp;
             m_sizeEdit->blockSignals(true);
-            m_sizeEdit->setText(QString::number(oldSize));
+            m_sizeEdit->setText(QString::number(sizeValue));
             m_sizeEdit->blockSignals(false);
-            
-            return; // 不继续更新
         }
         
         // 大小验证通过
@@ -904,24 +882,10 @@ void FlashConfigWidget::onConfigFieldChanged()
     // 更新类型
     partition.type = m_typeEdit->text().trimmed();
     
-    // 更新表格显示
-    updateSizeString(currentRow);
+    // 写回模型，只刷新该分区所在行
+    m_partitionModel->updatePartition(partition);
     
-    // 更新表格中的其他字段
-    if (QTableWidgetItem* labelItem = m_partitionTable->item(currentRow, COL_LABEL)) {
-        labelItem->setText(partition.label);
-    }
-    if (QTableWidgetItem* fileItem = m_partitionTable->item(currentRow, COL_FILE)) {
-        fileItem->setText(partition.file);
-    }
-    if (QTableWidgetItem* mountpointItem = m_partitionTable->item(currentRow, COL_MOUNTPOINT)) {
-        mountpointItem->setText(partition.mountpoint);
-    }
-    if (QTableWidgetItem* typeItem = m_partitionTable->item(currentRow, COL_TYPE)) {
-        typeItem->setText(partition.type);
-    }
-    
-    updatePartitionVisualization();
+    updatePlan();
     
     // 显示配置成功提示
     QMessageBox msgBox(this);
@@ -946,43 +910,36 @@ void FlashConfigWidget::onToggleConfigPanel()
     setConfigPanelExpanded(!m_configExpanded);
 }
 
-void FlashConfigWidget::updateSizeString(int row)
-{
-    if (row < 0 || row >= m_partitionOrder.size()) return;
-    
-    int partNum = m_partitionOrder[row];
-    if (!m_partitions.contains(partNum)) return;
-    
-    const FlashPartition& partition = m_partitions[partNum];
-    
-    QTableWidgetItem* sizeItem = m_partitionTable->item(row, COL_SIZE);
-    if (sizeItem) {
-        sizeItem->setText(QString::number(partition.size));
-    }
-}
-
 void FlashConfigWidget::updatePartitionVisualization()
 {
     QString partitionMap;
     
+    FlashGeometry geometry = m_planner.geometry();
+    
     partitionMap += "Flash分区映射:\n";
     partitionMap += "========================================\n";
-    partitionMap += QString("Flash大小: %1\n").arg(m_flashSize);
+    partitionMap += QString("Flash介质: %1  大小: %2\n").arg(FlashGeometry::mediaName(geometry.media)).arg(m_flashSize);
     partitionMap += QString("分区数量: %1\n").arg(m_partitionCount);
+    partitionMap += QString("起始预留: %1 KB  对齐: %2 KB\n").arg(m_plan.headKB).arg(m_plan.alignmentKB);
     partitionMap += "========================================\n";
     
-    for (int i = 0; i < m_partitionOrder.size(); ++i) {
-        int partNum = m_partitionOrder[i];
-        if (!m_partitions.contains(partNum)) continue;
-        
-        const FlashPartition& partition = m_partitions[partNum];
+    for (const FlashPartition& partition : m_partitionModel->orderedPartitions()) {
+        const PlannedPartition* planned = m_plan.find(partition.partitionNumber);
         
         partitionMap += QString("分区%1 [%2]: %3 (%4 KB)\n")
                        .arg(partition.partitionNumber)
-                       .arg(partition.enabled ? "启用" : "禁用")
+                       .arg(planned ? "启用" : "禁用")
                        .arg(partition.label, -12)
                        .arg(partition.size);
         
+        if (planned) {
+            partitionMap += QString("  偏移: %1 KB - %2 KB%3\n")
+                           .arg(planned->offsetKB)
+                           .arg(planned->offsetKB + planned->alignedKB)
+                           .arg(planned->alignedKB != planned->requestedKB
+                                    ? QString(" (对齐后 %1 KB)").arg(planned->alignedKB) : QString());
+        }
+        
         if (!partition.file.isEmpty()) {
             partitionMap += QString("  文件: %1\n").arg(partition.file);
         }
@@ -994,9 +951,601 @@ void FlashConfigWidget::updatePartitionVisualization()
         }
     }
     
+    partitionMap += "========================================\n";
+    partitionMap += m_plan.summary() + "\n";
+    if (!m_plan.fits()) {
+        partitionMap += "建议: " + m_plan.suggestion() + "\n";
+    }
+    
+    if (!m_bootEstimate.loads.isEmpty()) {
+        partitionMap += "========================================\n";
+        partitionMap += m_bootEstimate.breakdown() + "\n";
+    }
+    
     m_partitionMapText->setPlainText(partitionMap);
 }
 
+void FlashConfigWidget::setupMediaGroup()
+{
+    m_mediaGroup = new QGroupBox("Flash介质", m_controlPanel);
+    QGridLayout* mediaLayout = new QGridLayout(m_mediaGroup);
+    mediaLayout->setSpacing(5);
+    
+    m_mediaCombo = new QComboBox(m_mediaGroup);
+    m_mediaCombo->addItem(FlashGeometry::mediaName(FlashGeometry::EMMC), FlashGeometry::EMMC);
+    m_mediaCombo->addItem(FlashGeometry::mediaName(FlashGeometry::SPI_NAND), FlashGeometry::SPI_NAND);
+    m_mediaCombo->addItem(FlashGeometry::mediaName(FlashGeometry::SPI_NOR), FlashGeometry::SPI_NOR);
+    
+    m_capacityEdit = new QLineEdit(m_mediaGroup);
+    m_capacityEdit->setPlaceholderText("32GB / 256MB");
+    
+    m_eraseBlockSpin = new QSpinBox(m_mediaGroup);
+    m_eraseBlockSpin->setRange(4, 65536);
+    m_eraseBlockSpin->setSuffix(" KB");
+    
+    m_writeUnitSpin = new QSpinBox(m_mediaGroup);
+    m_writeUnitSpin->setRange(1, 1024);
+    m_writeUnitSpin->setSuffix(" KB");
+    
+    m_headReserveSpin = new QSpinBox(m_mediaGroup);
+    m_headReserveSpin->setRange(0, 65536);
+    m_headReserveSpin->setSingleStep(64);
+    m_headReserveSpin->setSuffix(" KB");
+    m_headReserveSpin->setToolTip("分区表及分区1(fip)占用的起始空间");
+    
+    m_planSummaryLabel = new QLabel(m_mediaGroup);
+    m_planSummaryLabel->setWordWrap(true);
+    
+    m_alignButton = new QPushButton("按擦除块对齐分区", m_mediaGroup);
+    m_alignButton->setToolTip("将所有分区大小向上取整到擦除块边界，超出容量时按建议缩小分区");
+    
+    mediaLayout->addWidget(new QLabel("介质:"), 0, 0);
+    mediaLayout->addWidget(m_mediaCombo, 0, 1);
+    mediaLayout->addWidget(new QLabel("容量:"), 1, 0);
+    mediaLayout->addWidget(m_capacityEdit, 1, 1);
+    mediaLayout->addWidget(new QLabel("擦除块:"), 2, 0);
+    mediaLayout->addWidget(m_eraseBlockSpin, 2, 1);
+    mediaLayout->addWidget(new QLabel("写单元:"), 3, 0);
+    mediaLayout->addWidget(m_writeUnitSpin, 3, 1);
+    mediaLayout->addWidget(new QLabel("起始预留:"), 4, 0);
+    mediaLayout->addWidget(m_headReserveSpin, 4, 1);
+    mediaLayout->addWidget(m_planSummaryLabel, 5, 0, 1, 2);
+    mediaLayout->addWidget(m_alignButton, 6, 0, 1, 2);
+    
+    applyGeometryToUI(m_planner.geometry());
+    
+    connect(m_mediaCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &FlashConfigWidget::onMediaTypeChanged);
+    connect(m_capacityEdit, &QLineEdit::editingFinished, this, &FlashConfigWidget::onGeometryChanged);
+    connect(m_eraseBlockSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &FlashConfigWidget::onGeometryChanged);
+    connect(m_writeUnitSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &FlashConfigWidget::onGeometryChanged);
+    connect(m_headReserveSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &FlashConfigWidget::onGeometryChanged);
+    connect(m_alignButton, &QPushButton::clicked, this, &FlashConfigWidget::onAlignPartitions);
+}
+
+void FlashConfigWidget::applyGeometryToUI(const FlashGeometry& geometry)
+{
+    m_mediaCombo->blockSignals(true);
+    m_capacityEdit->blockSignals(true);
+    m_eraseBlockSpin->blockSignals(true);
+    m_writeUnitSpin->blockSignals(true);
+    m_headReserveSpin->blockSignals(true);
+    
+    m_mediaCombo->setCurrentIndex(m_mediaCombo->findData(geometry.media));
+    m_capacityEdit->setText(m_flashSize);
+    m_eraseBlockSpin->setValue(static_cast<int>(geometry.eraseBlockKB));
+    m_writeUnitSpin->setValue(static_cast<int>(geometry.writeUnitKB));
+    m_headReserveSpin->setValue(static_cast<int>(geometry.reservedHeadKB));
+    
+    m_mediaCombo->blockSignals(false);
+    m_capacityEdit->blockSignals(false);
+    m_eraseBlockSpin->blockSignals(false);
+    m_writeUnitSpin->blockSignals(false);
+    m_headReserveSpin->blockSignals(false);
+}
+
+void FlashConfigWidget::setupBootGroup()
+{
+    m_bootGroup = new QGroupBox("启动读取", m_controlPanel);
+    QGridLayout* bootLayout = new QGridLayout(m_bootGroup);
+    bootLayout->setSpacing(5);
+    
+    m_busModeCombo = new QComboBox(m_bootGroup);
+    m_busModeCombo->setToolTip("FSBL/U-Boot/内核读取分区时使用的总线模式");
+    
+    m_busWidthCombo = new QComboBox(m_bootGroup);
+    m_busWidthCombo->addItem("4bit", 4);
+    m_busWidthCombo->addItem("8bit", 8);
+    
+    m_busClockSpin = new QSpinBox(m_bootGroup);
+    m_busClockSpin->setRange(1, 200);
+    m_busClockSpin->setSuffix(" MHz");
+    
+    m_bootTimeLabel = new QLabel(m_bootGroup);
+    m_bootTimeLabel->setWordWrap(true);
+    
+    bootLayout->addWidget(new QLabel("总线模式:"), 0, 0);
+    bootLayout->addWidget(m_busModeCombo, 0, 1);
+    bootLayout->addWidget(new QLabel("数据线:"), 1, 0);
+    bootLayout->addWidget(m_busWidthCombo, 1, 1);
+    bootLayout->addWidget(new QLabel("总线时钟:"), 2, 0);
+    bootLayout->addWidget(m_busClockSpin, 2, 1);
+    bootLayout->addWidget(m_bootTimeLabel, 3, 0, 1, 2);
+    
+    m_busConfig = FlashBusConfig::load(m_planner.geometry().media);
+    applyBusConfigToUI(m_busConfig);
+    
+    connect(m_busModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &FlashConfigWidget::onBusConfigChanged);
+    connect(m_busWidthCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &FlashConfigWidget::onBusConfigChanged);
+    connect(m_busClockSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &FlashConfigWidget::onBusConfigChanged);
+}
+
+void FlashConfigWidget::applyBusConfigToUI(const FlashBusConfig& config)
+{
+    m_busModeCombo->blockSignals(true);
+    m_busWidthCombo->blockSignals(true);
+    m_busClockSpin->blockSignals(true);
+    
+    // 模式列表随介质变化
+    m_busModeCombo->clear();
+    for (FlashBusConfig::BusMode mode : FlashBusConfig::modesFor(config.media)) {
+        m_busModeCombo->addItem(FlashBusConfig::modeName(mode), mode);
+    }
+    m_busModeCombo->setCurrentIndex(m_busModeCombo->findData(config.mode));
+    
+    bool emmc = config.media == FlashGeometry::EMMC;
+    m_busWidthCombo->setEnabled(emmc && config.mode != FlashBusConfig::EMMC_HS400);
+    int widthIndex = m_busWidthCombo->findData(config.mode == FlashBusConfig::EMMC_HS400 ? 8 : config.busWidth);
+    m_busWidthCombo->setCurrentIndex(widthIndex >= 0 ? widthIndex : 0);
+    
+    m_busClockSpin->setMaximum(static_cast<int>(FlashBusConfig::maxClockMHz(config.mode)));
+    m_busClockSpin->setValue(static_cast<int>(config.clockMHz));
+    
+    m_busModeCombo->blockSignals(false);
+    m_busWidthCombo->blockSignals(false);
+    m_busClockSpin->blockSignals(false);
+}
+
+void FlashConfigWidget::onBusConfigChanged()
+{
+    FlashBusConfig config = m_busConfig;
+    FlashBusConfig::BusMode mode = static_cast<FlashBusConfig::BusMode>(m_busModeCombo->currentData().toInt());
+    
+    // 切换模式时时钟默认取该模式上限
+    if (mode != config.mode) {
+        config.clockMHz = FlashBusConfig::maxClockMHz(mode);
+    } else {
+        config.clockMHz = m_busClockSpin->value();
+    }
+    config.mode = mode;
+    if (config.media == FlashGeometry::EMMC) {
+        config.busWidth = mode == FlashBusConfig::EMMC_HS400 ? 8 : m_busWidthCombo->currentData().toInt();
+    } else {
+        config.busWidth = static_cast<int>(config.dataLines());
+    }
+    
+    m_busConfig = config;
+    m_busConfig.save();
+    applyBusConfigToUI(m_busConfig);
+    
+    updateBootEstimate();
+    updatePartitionVisualization();
+}
+
+void FlashConfigWidget::setClockFrequencies(const QMap<QString, double>& clocksMHz)
+{
+    m_clocksMHz = clocksMHz;
+    updateBootEstimate();
+    updatePartitionVisualization();
+}
+
+void FlashConfigWidget::updateBootEstimate()
+{
+    if (!m_bootTimeLabel) {
+        return;
+    }
+    
+    m_bootEstimate = FlashBootEstimator::estimate(m_plan, m_busConfig, m_clocksMHz, m_payloadScans);
+    
+    const PartitionLoadTime* dominant = m_bootEstimate.dominant();
+    m_bootTimeLabel->setText(m_bootEstimate.summary());
+    m_bootTimeLabel->setToolTip(m_bootEstimate.breakdown());
+    m_bootTimeLabel->setStyleSheet(dominant ? "color: #2c3e50;" : "color: #7f8c8d;");
+    
+    // 在表格中突出显示耗时最多的分区
+    m_partitionModel->setBootEstimate(m_bootEstimate);
+}
+
+void FlashConfigWidget::onMediaTypeChanged(int index)
+{
+    FlashGeometry::MediaType media = static_cast<FlashGeometry::MediaType>(m_mediaCombo->itemData(index).toInt());
+    switchMedia(media, QString());
+}
+
+void FlashConfigWidget::switchMedia(FlashGeometry::MediaType media, const QString& reason)
+{
+    // 切换介质时加载该介质的默认几何参数
+    m_flashSize = FlashGeometry::defaultCapacity(media);
+    FlashGeometry geometry = FlashGeometry::defaultGeometry(media, m_flashSize);
+    
+    m_planner.setGeometry(geometry);
+    applyGeometryToUI(geometry);
+    m_busConfig = FlashBusConfig::load(media);
+    applyBusConfigToUI(m_busConfig);
+    
+    updatePlan();
+    onTableSelectionChanged();
+    
+    emit configChanged();
+    
+    QString text = reason.isEmpty()
+        ? QString("Flash介质已切换为 %1 (%2)").arg(FlashGeometry::mediaName(media)).arg(m_flashSize)
+        : reason;
+    
+    // 默认布局按eMMC容量设计（DATA 3GB），放不下时给出最小调整建议，确认后再收缩分区
+    if (!m_plan.fits() && m_plan.shrinkPartition >= 0 && m_partitionModel->contains(m_plan.shrinkPartition)) {
+        int ret = QMessageBox::question(this, "Flash介质",
+                                       QString("%1\n\n%2\n%3，是否应用？").arg(text, m_plan.summary(), m_plan.suggestion()),
+                                       QMessageBox::Yes | QMessageBox::No);
+        if (ret == QMessageBox::Yes) {
+            fitPartitionsToMedia(m_plan);
+            updatePlan();
+            onTableSelectionChanged();
+            emit configChanged();
+        }
+        return;
+    }
+    
+    if (reason.isEmpty() && m_plan.fits()) {
+        return;
+    }
+    if (!m_plan.fits()) {
+        text += "\n\n" + m_plan.summary() + "\n" + m_plan.suggestion();
+        QMessageBox::warning(this, "Flash介质", text);
+    } else {
+        QMessageBox::information(this, "Flash介质", text);
+    }
+}
+
+void FlashConfigWidget::fitPartitionsToMedia(const FlashPlan& plan)
+{
+    // 采用规划器的最小调整建议：由能吸收超出量的最大分区缩小
+    if (plan.fits() || plan.shrinkPartition < 0 || !m_partitionModel->contains(plan.shrinkPartition)) {
+        return;
+    }
+    
+    FlashPartition partition = m_partitionModel->partition(plan.shrinkPartition);
+    partition.size = plan.suggestedSizeKB;
+    partition.sizeString = formatSize(partition.size);
+    m_partitionModel->updatePartition(partition);
+}
+
+void FlashConfigWidget::onGeometryChanged()
+{
+    FlashGeometry geometry = m_planner.geometry();
+    
+    quint64 capacityKB = FlashGeometry::parseCapacityKB(geometry.media, m_capacityEdit->text());
+    if (capacityKB == 0) {
+        QMessageBox::warning(this, "容量错误",
+                           QString("无法识别的容量: %1\n请输入如 32GB、256MB 的格式").arg(m_capacityEdit->text()));
+        m_capacityEdit->blockSignals(true);
+        m_capacityEdit->setText(m_flashSize);
+        m_capacityEdit->blockSignals(false);
+        return;
+    }
+    
+    m_flashSize = m_capacityEdit->text().trimmed().toUpper();
+    geometry.capacityKB = capacityKB;
+    geometry.eraseBlockKB = static_cast<quint64>(m_eraseBlockSpin->value());
+    geometry.writeUnitKB = static_cast<quint64>(m_writeUnitSpin->value());
+    geometry.reservedHeadKB = static_cast<quint64>(m_headReserveSpin->value());
+    
+    m_planner.setGeometry(geometry);
+    updatePlan();
+    
+    emit configChanged();
+}
+
+void FlashConfigWidget::onAlignPartitions()
+{
+    // 将所有分区大小写回为对齐后的大小，容量不足时应用最小调整建议
+    QStringList changes;
+    for (FlashPartition partition : m_partitionModel->orderedPartitions()) {
+        quint64 aligned = m_planner.alignUp(partition.size);
+        if (aligned != partition.size) {
+            changes << QString("分区%1 %2: %3 KB -> %4 KB").arg(partition.partitionNumber).arg(partition.label).arg(partition.size).arg(aligned);
+            partition.size = aligned;
+            partition.sizeString = formatSize(aligned);
+            m_partitionModel->updatePartition(partition);
+        }
+    }
+    
+    FlashPlan plan = m_planner.plan(m_partitionModel->orderedPartitions());
+    if (!plan.fits() && plan.shrinkPartition >= 0 && m_partitionModel->contains(plan.shrinkPartition)) {
+        int ret = QMessageBox::question(this, "容量不足",
+                                       QString("%1\n\n%2，是否应用？").arg(plan.summary()).arg(plan.suggestion()),
+                                       QMessageBox::Yes | QMessageBox::No);
+        if (ret == QMessageBox::Yes) {
+            FlashPartition partition = m_partitionModel->partition(plan.shrinkPartition);
+            changes << QString("分区%1 %2: %3 KB -> %4 KB").arg(partition.partitionNumber).arg(partition.label)
+                           .arg(partition.size).arg(plan.suggestedSizeKB);
+            partition.size = plan.suggestedSizeKB;
+            partition.sizeString = formatSize(partition.size);
+            m_partitionModel->updatePartition(partition);
+        }
+    }
+    
+    updatePlan();
+    onTableSelectionChanged();
+    
+    if (changes.isEmpty()) {
+        QMessageBox::information(this, "分区对齐", "所有分区已按擦除块对齐，无需调整。");
+        return;
+    }
+    
+    QMessageBox::information(this, "分区对齐", "已调整以下分区:\n\n" + changes.join("\n"));
+    emit configChanged();
+}
+
+void FlashConfigWidget::updatePlan()
+{
+    // 启用状态以模型中的分区数据为准
+    m_plan = m_planner.plan(m_partitionModel->orderedPartitions());
+    
+    // 更新偏移列
+    m_partitionModel->setPlan(m_plan);
+    updateBootEstimate();
+    
+    if (m_planSummaryLabel) {
+        QString text = m_plan.summary();
+        if (!m_plan.fits()) {
+            text += "\n" + m_plan.suggestion();
+        }
+        m_planSummaryLabel->setText(text);
+        m_planSummaryLabel->setStyleSheet(m_plan.fits() ? "color: #27ae60;" : "color: #e74c3c;");
+    }
+    
+    updatePartitionVisualization();
+}
+
+QString FlashConfigWidget::defaultImageInputDir() const
+{
+    QSettings settings("CviTek", "CviCubeMX");
+    QString lastDir = settings.value("flashImageInputDir", "").toString();
+    if (!lastDir.isEmpty() && QDir(lastDir).exists()) {
+        return lastDir;
+    }
+    
+    // SDK编译输出目录 install/soc_<板型>
+    if (!m_sourcePath.isEmpty() && !m_chipType.isEmpty()) {
+        QString installDir = QDir(m_sourcePath).absoluteFilePath(QString("install/soc_%1").arg(m_chipType));
+        if (QDir(installDir).exists()) {
+            return installDir;
+        }
+    }
+    return m_sourcePath;
+}
+
+void FlashConfigWidget::onScanPayloads()
+{
+    QString inputDir = QFileDialog::getExistingDirectory(this, "选择分区文件所在目录", defaultImageInputDir());
+    if (inputDir.isEmpty()) {
+        return;
+    }
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.setValue("flashImageInputDir", inputDir);
+    
+    QList<FlashPartition> targets;
+    for (const FlashPartition& partition : m_partitionModel->orderedPartitions()) {
+        if (!partition.file.isEmpty()) {
+            targets.append(partition);
+        }
+    }
+    
+    // 逐块扫描大镜像耗时较长，在后台线程中进行；取消后保留已扫描完成的分区
+    auto canceled = std::make_shared<std::atomic<bool>>(false);
+    QFuture<PayloadScanBatch> future = QtConcurrent::run(
+        [targets, inputDir, canceled](QPromise<PayloadScanBatch>& promise) {
+        PayloadScanBatch batch;
+        QDir dir(inputDir);
+        promise.setProgressRange(0, targets.size());
+        for (int i = 0; i < targets.size() && !canceled->load(); ++i) {
+            const FlashPartition& partition = targets[i];
+            promise.setProgressValueAndText(i, QString("正在扫描分区 %1 (%2) ...").arg(partition.label).arg(partition.file));
+            
+            QString filePath = dir.absoluteFilePath(partition.file);
+            if (!QFileInfo::exists(filePath)) {
+                batch.missing << partition.file;
+                continue;
+            }
+            
+            PayloadScanResult scan;
+            QString errorMessage;
+            if (!FlashPayloadScanner::scan(filePath, scan, errorMessage, canceled.get())) {
+                if (!canceled->load()) {
+                    batch.missing << QString("%1 (%2)").arg(partition.file).arg(errorMessage);
+                }
+                continue;
+            }
+            batch.scans[partition.partitionNumber] = scan;
+            batch.fileBytes += scan.fileBytes;
+            batch.sparseBytes += scan.sparseBytes();
+        }
+        promise.addResult(batch);
+    });
+    
+    auto* progressDialog = new QProgressDialog("正在扫描分区数据...", "取消", 0, targets.size(), this);
+    progressDialog->setWindowTitle("分析数据");
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setMinimumDuration(300);
+    progressDialog->setAutoClose(false);
+    progressDialog->setAutoReset(false);
+    connect(progressDialog, &QProgressDialog::canceled, progressDialog, [canceled, progressDialog]() {
+        canceled->store(true);
+        progressDialog->setLabelText("正在取消...");
+    });
+    
+    setImageToolsEnabled(false);
+    auto* watcher = new QFutureWatcher<PayloadScanBatch>(this);
+    connect(watcher, &QFutureWatcherBase::progressValueChanged, progressDialog, &QProgressDialog::setValue);
+    connect(watcher, &QFutureWatcherBase::progressTextChanged, progressDialog, &QProgressDialog::setLabelText);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, progressDialog]() {
+        const PayloadScanBatch batch = watcher->result();
+        watcher->deleteLater();
+        progressDialog->close();
+        progressDialog->deleteLater();
+        setImageToolsEnabled(true);
+        
+        m_payloadScans = batch.scans;
+        m_partitionModel->setPayloadScans(m_payloadScans);
+        updateBootEstimate();
+        updatePartitionVisualization();
+        
+        QString message = QString("已扫描 %1 个分区文件。\n原始数据 %2 MB，sparse格式需传输 %3 MB")
+                              .arg(m_payloadScans.size())
+                              .arg(batch.fileBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                              .arg(batch.sparseBytes / (1024.0 * 1024.0), 0, 'f', 1);
+        if (batch.fileBytes > 0) {
+            message += QString("（约为原来的 %1%）").arg(batch.sparseBytes * 100.0 / batch.fileBytes, 0, 'f', 1);
+        }
+        if (!batch.missing.isEmpty()) {
+            message += "\n\n以下文件未能扫描:\n" + batch.missing.join("\n");
+        }
+        QMessageBox::information(this, "分析数据", message);
+    });
+    watcher->setFuture(future);
+}
+
+void FlashConfigWidget::onAssembleImage()
+{
+    if (!m_plan.fits()) {
+        QMessageBox::warning(this, "警告",
+                           QString("分区总大小超出器件容量，无法生成镜像:\n%1\n\n建议: %2")
+                           .arg(m_plan.summary()).arg(m_plan.suggestion()));
+        return;
+    }
+    
+    QString inputDir = QFileDialog::getExistingDirectory(this, "选择分区文件所在目录", defaultImageInputDir());
+    if (inputDir.isEmpty()) {
+        return;
+    }
+    
+    QString selectedFilter;
+    QString outputPath = QFileDialog::getSaveFileName(this, "保存Flash镜像",
+        QDir(inputDir).absoluteFilePath(QString("%1_flash.img").arg(m_chipType.isEmpty() ? "cvicube" : m_chipType)),
+        "Raw Image (*.img *.bin);;Android Sparse Image (*.simg)", &selectedFilter);
+    if (outputPath.isEmpty()) {
+        return;
+    }
+    
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.setValue("flashImageInputDir", inputDir);
+    
+    FlashImageAssembler::OutputFormat format = selectedFilter.contains("Sparse") || outputPath.endsWith(".simg")
+                                                   ? FlashImageAssembler::AndroidSparse
+                                                   : FlashImageAssembler::RawImage;
+    
+    // 按规划偏移构建镜像数据段
+    QList<FlashImageSegment> segments;
+    QDir dir(inputDir);
+    for (const PlannedPartition& planned : m_plan.partitions) {
+        FlashPartition partition = m_partitionModel->partition(planned.partitionNumber);
+        FlashImageSegment segment;
+        segment.partitionNumber = planned.partitionNumber;
+        segment.label = planned.label;
+        segment.filePath = partition.file.isEmpty() ? QString() : dir.absoluteFilePath(partition.file);
+        segment.offsetBytes = planned.offsetKB * 1024;
+        segment.capacityBytes = planned.alignedKB * 1024;
+        segments.append(segment);
+    }
+    
+    QStringList missingFiles;
+    QStringList errors = FlashImageAssembler::checkSegments(segments, missingFiles);
+    if (!errors.isEmpty()) {
+        QMessageBox::critical(this, "错误", "分区文件超出分区容量:\n\n" + errors.join("\n"));
+        return;
+    }
+    if (!missingFiles.isEmpty()) {
+        int ret = QMessageBox::question(this, "分区文件缺失",
+                                       QString("以下分区文件不存在，对应分区将保持为空:\n\n%1\n\n是否继续生成镜像？")
+                                       .arg(missingFiles.join("\n")),
+                                       QMessageBox::Yes | QMessageBox::No);
+        if (ret != QMessageBox::Yes) {
+            return;
+        }
+        for (FlashImageSegment& segment : segments) {
+            if (!segment.filePath.isEmpty() && !QFileInfo::exists(segment.filePath)) {
+                segment.filePath.clear();
+            }
+        }
+    }
+    
+    // 组装在后台线程中进行，写入GB级镜像时界面保持响应；
+    // 组装器的进度信号从工作线程发出，自动排队到界面线程更新进度框
+    auto* assembler = new FlashImageAssembler;
+    auto* progressDialog = new QProgressDialog("正在生成Flash镜像...", "取消", 0, 1000, this);
+    progressDialog->setWindowTitle("生成镜像");
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setMinimumDuration(300);
+    progressDialog->setAutoClose(false);
+    progressDialog->setAutoReset(false);
+    
+    connect(assembler, &FlashImageAssembler::segmentStarted, progressDialog, [progressDialog](const QString& label) {
+        progressDialog->setLabelText(QString("正在写入分区 %1 ...").arg(label));
+    });
+    connect(assembler, &FlashImageAssembler::progress, progressDialog, [progressDialog](qint64 done, qint64 total) {
+        progressDialog->setValue(total > 0 ? static_cast<int>(done * 1000 / total) : 0);
+    });
+    connect(progressDialog, &QProgressDialog::canceled, progressDialog, [assembler, progressDialog]() {
+        assembler->cancel();
+        progressDialog->setLabelText("正在取消...");
+    });
+    
+    // 镜像覆盖到最后一个分区结束位置
+    const quint64 imageBytes = m_plan.endKB * 1024;
+    const quint64 headKB = m_plan.headKB;
+    QFuture<ImageAssembleOutcome> future = QtConcurrent::run([assembler, segments, imageBytes, outputPath, format]() {
+        ImageAssembleOutcome outcome;
+        outcome.ok = assembler->assemble(segments, imageBytes, outputPath, format, outcome.result, outcome.errorMessage);
+        outcome.canceled = assembler->isCanceled();
+        return outcome;
+    });
+    
+    setImageToolsEnabled(false);
+    auto* watcher = new QFutureWatcher<ImageAssembleOutcome>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, assembler, progressDialog, outputPath, headKB]() {
+        const ImageAssembleOutcome outcome = watcher->result();
+        watcher->deleteLater();
+        assembler->deleteLater();
+        progressDialog->close();
+        progressDialog->deleteLater();
+        setImageToolsEnabled(true);
+        
+        if (!outcome.ok) {
+            if (outcome.canceled) {
+                QMessageBox::information(this, "生成镜像", outcome.errorMessage);
+            } else {
+                QMessageBox::critical(this, "错误", QString("生成Flash镜像失败:\n%1").arg(outcome.errorMessage));
+            }
+            return;
+        }
+        
+        QMessageBox::information(this, "成功",
+                               QString("Flash镜像已生成:\n%1\n\n%2\n\n注意：起始 %3 KB 的分区表/fip区域由烧录工具写入，镜像中保持为空。")
+                               .arg(outputPath)
+                               .arg(outcome.result.summary())
+                               .arg(headKB));
+    });
+    watcher->setFuture(future);
+}
+
+void FlashConfigWidget::setImageToolsEnabled(bool enabled)
+{
+    // 后台扫描或组装期间禁止再次启动，避免同时读写同一批分区文件
+    m_scanButton->setEnabled(enabled);
+    m_assembleButton->setEnabled(enabled);
+}
+
 void FlashConfigWidget::validatePartitionLayout()
 {
     // 可以在这里添加分区布局验证逻辑
@@ -1042,25 +1591,23 @@ quint64 FlashConfigWidget::parseSize(const QString& sizeStr)
 
 void FlashConfigWidget::searchAndSelectPartition(const QString& searchText)
 {
-    for (int row = 0; row < m_partitionTable->rowCount(); ++row) {
-        QTableWidgetItem* labelItem = m_partitionTable->item(row, COL_LABEL);
-        if (labelItem && labelItem->text().compare(searchText, Qt::CaseInsensitive) == 0) {
-            m_partitionTable->selectRow(row);
-            m_partitionTable->setCurrentItem(labelItem);
-            
-            setConfigPanelExpanded(true);
-            
-            m_labelEdit->setEnabled(true);
-            m_sizeEdit->setEnabled(true);
-            m_sizeUnitCombo->setEnabled(true);
-            m_fileEdit->setEnabled(true);
-            m_mountpointEdit->setEnabled(true);
-            m_typeEdit->setEnabled(true);
-            
-            onTableSelectionChanged();
-            
-            return;
-        }
+    int row = m_partitionModel->findLabel(searchText);
+    if (row >= 0) {
+        m_partitionTable->selectRow(row);
+        m_partitionTable->setCurrentIndex(m_partitionModel->index(row, FlashPartitionModel::COL_LABEL));
+        
+        setConfigPanelExpanded(true);
+        
+        m_labelEdit->setEnabled(true);
+        m_sizeEdit->setEnabled(true);
+        m_sizeUnitCombo->setEnabled(true);
+        m_fileEdit->setEnabled(true);
+        m_mountpointEdit->setEnabled(true);
+        m_typeEdit->setEnabled(true);
+        
+        onTableSelectionChanged();
+        
+        return;
     }
     
     QMessageBox::information(this, "搜索结果", 
@@ -1110,17 +1657,15 @@ void FlashConfigWidget::formatSizeForInput(quint64 sizeInKB, QString& sizeText,
 
 FlashPartition FlashConfigWidget::getPartition(int partitionNumber) const
 {
-    return m_partitions.value(partitionNumber, FlashPartition());
+    return m_partitionModel->partition(partitionNumber);
 }
 
 void FlashConfigWidget::setPartition(int partitionNumber, const FlashPartition& partition)
 {
-    m_partitions[partitionNumber] = partition;
-    if (!m_partitionOrder.contains(partitionNumber)) {
-        m_partitionOrder.append(partitionNumber);
-    }
-    populateTable();
-    updatePartitionVisualization();
+    FlashPartition stored = partition;
+    stored.partitionNumber = partitionNumber;
+    m_partitionModel->appendPartition(stored);
+    updatePlan();
     emit configChanged();
 }
 
@@ -1132,7 +1677,13 @@ bool FlashConfigWidget::exportToJson(const QString& filePath)
     root["flashSize"] = m_flashSize;
     root["partitionCount"] = m_partitionCount;
     
-    for (const auto& partition : m_partitions) {
+    FlashGeometry geometry = m_planner.geometry();
+    root["mediaType"] = FlashGeometry::mediaName(geometry.media);
+    root["eraseBlockKB"] = QString::number(geometry.eraseBlockKB);
+    root["writeUnitKB"] = QString::number(geometry.writeUnitKB);
+    root["reservedHeadKB"] = QString::number(geometry.reservedHeadKB);
+    
+    for (const auto& partition : m_partitionModel->partitions()) {
         QJsonObject partObj;
         partObj["partitionNumber"] = partition.partitionNumber;
         partObj["label"] = partition.label;
@@ -1182,11 +1733,32 @@ bool FlashConfigWidget::importFromJson(const QString& filePath)
     m_flashSize = root["flashSize"].toString();
     m_partitionCount = root["partitionCount"].toInt();
     
-    QJsonArray partitionsArray = root["partitions"].toArray();
+    // 介质几何参数（旧版本配置文件没有这些字段，使用eMMC默认值）
+    FlashGeometry::MediaType media = FlashGeometry::EMMC;
+    QString mediaName = root["mediaType"].toString();
+    if (mediaName == FlashGeometry::mediaName(FlashGeometry::SPI_NAND)) {
+        media = FlashGeometry::SPI_NAND;
+    } else if (mediaName == FlashGeometry::mediaName(FlashGeometry::SPI_NOR)) {
+        media = FlashGeometry::SPI_NOR;
+    }
+    FlashGeometry geometry = FlashGeometry::defaultGeometry(media, m_flashSize);
+    if (root.contains("eraseBlockKB")) {
+        geometry.eraseBlockKB = root["eraseBlockKB"].toString().toULongLong();
+    }
+    if (root.contains("writeUnitKB")) {
+        geometry.writeUnitKB = root["writeUnitKB"].toString().toULongLong();
+    }
+    if (root.contains("reservedHeadKB")) {
+        geometry.reservedHeadKB = root["reservedHeadKB"].toString().toULongLong();
+    }
+    m_planner.setGeometry(geometry);
+    if (m_mediaCombo) {
+        applyGeometryToUI(geometry);
+    }
     
-    m_partitions.clear();
-    m_partitionOrder.clear();
+    QJsonArray partitionsArray = root["partitions"].toArray();
     
+    QList<FlashPartition> partitions;
     for (const auto& value : partitionsArray) {
         QJsonObject partObj = value.toObject();
         
@@ -1200,9 +1772,9 @@ bool FlashConfigWidget::importFromJson(const QString& filePath)
         partition.type = partObj["type"].toString();
         partition.enabled = partObj["enabled"].toBool();
         
-        m_partitions[partition.partitionNumber] = partition;
-        m_partitionOrder.append(partition.partitionNumber);
+        partitions.append(partition);
     }
+    m_partitionModel->setPartitions(partitions);
     
     return true;
 }
@@ -1215,6 +1787,19 @@ void FlashConfigWidget::setSourcePath(const QString& sourcePath)
 void FlashConfigWidget::setChipType(const QString& chipType)
 {
     m_chipType = chipType;
+    
+    // 板型名称以存储介质结尾（*_emmc / *_spinand / *_spinor），无法识别时保持当前介质
+    FlashGeometry::MediaType media = FlashGeometry::EMMC;
+    if (FlashGeometry::mediaFromChipType(chipType, media) && media != m_planner.geometry().media && m_mediaCombo) {
+        m_mediaCombo->blockSignals(true);
+        m_mediaCombo->setCurrentIndex(m_mediaCombo->findData(media));
+        m_mediaCombo->blockSignals(false);
+        switchMedia(media, QString("板型 %1 使用 %2，Flash介质已由 %3 切换为 %2 (%4)")
+                               .arg(chipType)
+                               .arg(FlashGeometry::mediaName(media))
+                               .arg(FlashGeometry::mediaName(m_planner.geometry().media))
+                               .arg(FlashGeometry::defaultCapacity(media)));
+    }
 }
 
 QString FlashConfigWidget::getDefconfigPath() const
@@ -1231,49 +1816,46 @@ QString FlashConfigWidget::getDefconfigPath() const
     return workspaceDir.absoluteFilePath(defconfigPath);
 }
 
-bool FlashConfigWidget::exportToDefconfig(const QString& sourcePath, const QString& chipType)
+QFuture<FileIoResult> FlashConfigWidget::exportToDefconfig(const QString& sourcePath, const QString& chipType)
 {
     QString defconfigPath = getDefconfigPath();
     
-    QFile defconfigFile(defconfigPath);
-    if (!defconfigFile.exists()) {
-        QMessageBox::critical(nullptr, "错误", 
-                            QString("Defconfig文件不存在:\n%1").arg(defconfigPath));
-        return false;
+    // 按介质擦除块规划分区，放不下时拒绝导出
+    FlashPlan plan = m_planner.plan(m_partitionModel->orderedPartitions());
+    if (!plan.fits()) {
+        QMessageBox::critical(nullptr, "错误",
+                            QString("分区总大小超出%1容量:\n%2\n\n建议: %3")
+                            .arg(FlashGeometry::mediaName(m_planner.geometry().media))
+                            .arg(plan.summary())
+                            .arg(plan.suggestion()));
+        FileIoResult result;
+        result.filePath = defconfigPath;
+        result.errorMessage = plan.summary();
+        return FileIoService::finished(result);
     }
     
-    if (!defconfigFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::critical(nullptr, "错误", 
-                            QString("无法读取defconfig文件:\n%1").arg(defconfigPath));
-        return false;
-    }
-    
-    QTextStream in(&defconfigFile);
-    QStringList lines;
-    while (!in.atEnd()) {
-        lines.append(in.readLine());
+    // 导出对齐后的大小；分区数据按值交给I/O线程，之后界面上的修改不影响本次导出
+    // 启用状态由模型维护（表格复选框直接写回分区数据）
+    QList<FlashPartition> partitions = m_partitionModel->orderedPartitions();
+    for (FlashPartition& partition : partitions) {
+        if (const PlannedPartition* planned = plan.find(partition.partitionNumber)) {
+            partition.size = planned->alignedKB;
+        }
     }
-    defconfigFile.close();
-    
-    // 只更新修改的配置项，不重新生成整个段
-    bool fileModified = false;
     
-    for (int partNum : m_partitionOrder) {
-        if (!m_partitions.contains(partNum)) continue;
-        
-        const FlashPartition& partition = m_partitions[partNum];
-        
-        // 获取启用状态
-        QTableWidgetItem* enabledItem = nullptr;
-        for (int row = 0; row < m_partitionTable->rowCount(); ++row) {
-            QTableWidgetItem* numItem = m_partitionTable->item(row, COL_PARTITION_NUM);
-            if (numItem && numItem->text().toInt() == partNum) {
-                enabledItem = m_partitionTable->item(row, COL_ENABLED);
-                break;
-            }
-        }
-        
-        bool enabled = enabledItem ? (enabledItem->checkState() == Qt::Checked) : partition.enabled;
+    // 内容不变时不写回
+    return FileIoService::instance()->modifyLines(defconfigPath,
+        [partitions](QStringList& lines, QString&) {
+            applyPartitionsToDefconfig(lines, partitions);
+            return true;
+        }, "Flash分区defconfig");
+}
+
+void FlashConfigWidget::applyPartitionsToDefconfig(QStringList& lines, const QList<FlashPartition>& partitions)
+{
+    for (const FlashPartition& partition : partitions) {
+        int partNum = partition.partitionNumber;
+        bool enabled = partition.enabled;
         
         // 更新各个配置项
         QString enabledConfig = QString("CONFIG_PARTITION_%1=y").arg(partNum);
@@ -1293,48 +1875,27 @@ bool FlashConfigWidget::exportToDefconfig(const QString& sourcePath, const QStri
                     // 如果不启用，删除这行
                     lines.removeAt(i);
                     i--;
-                    fileModified = true;
                 }
             }
             // 更新标签
             else if (line.startsWith(labelConfig)) {
-                QString newLine = QString("CONFIG_PARTITION_%1_LABEL=\"%2\"").arg(partNum).arg(partition.label);
-                if (line != newLine) {
-                    line = newLine;
-                    fileModified = true;
-                }
+                line = QString("CONFIG_PARTITION_%1_LABEL=\"%2\"").arg(partNum).arg(partition.label);
             }
             // 更新大小
             else if (line.startsWith(sizeConfig)) {
-                QString newLine = QString("CONFIG_PARTITION_%1_SIZE=\"%2\"").arg(partNum).arg(partition.size);
-                if (line != newLine) {
-                    line = newLine;
-                    fileModified = true;
-                }
+                line = QString("CONFIG_PARTITION_%1_SIZE=\"%2\"").arg(partNum).arg(partition.size);
             }
             // 更新文件
             else if (line.startsWith(fileConfig)) {
-                QString newLine = QString("CONFIG_PARTITION_%1_FILE=\"%2\"").arg(partNum).arg(partition.file);
-                if (line != newLine) {
-                    line = newLine;
-                    fileModified = true;
-                }
+                line = QString("CONFIG_PARTITION_%1_FILE=\"%2\"").arg(partNum).arg(partition.file);
             }
             // 更新挂载点
             else if (line.startsWith(mountpointConfig)) {
-                QString newLine = QString("CONFIG_PARTITION_%1_MOUNTPOINT=\"%2\"").arg(partNum).arg(partition.mountpoint);
-                if (line != newLine) {
-                    line = newLine;
-                    fileModified = true;
-                }
+                line = QString("CONFIG_PARTITION_%1_MOUNTPOINT=\"%2\"").arg(partNum).arg(partition.mountpoint);
             }
             // 更新类型
             else if (line.startsWith(typeConfig)) {
-                QString newLine = QString("CONFIG_PARTITION_%1_TYPE=\"%2\"").arg(partNum).arg(partition.type);
-                if (line != newLine) {
-                    line = newLine;
-                    fileModified = true;
-                }
+                line = QString("CONFIG_PARTITION_%1_TYPE=\"%2\"").arg(partNum).arg(partition.type);
             }
         }
         
@@ -1375,30 +1936,9 @@ bool FlashConfigWidget::exportToDefconfig(const QString& sourcePath, const QStri
                 lines.insert(insertPos++, QString("CONFIG_PARTITION_%1_MOUNTPOINT=\"%2\"").arg(partNum).arg(partition.mountpoint));
                 lines.insert(insertPos++, QString("CONFIG_PARTITION_%1_TYPE=\"%2\"").arg(partNum).arg(partition.type));
                 lines.insert(insertPos++, "");
-                fileModified = true;
             }
         }
     }
-    
-    // 只有在文件被修改时才写回
-    if (!fileModified) {
-        return true; // 没有修改，直接返回成功
-    }
-    
-    // 写回文件
-    if (!defconfigFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(nullptr, "错误", 
-                            QString("无法写入defconfig文件:\n%1").arg(defconfigPath));
-        return false;
-    }
-    
-    QTextStream out(&defconfigFile);
-    for (const QString& line : lines) {
-        out << line << "\n";
-    }
-    defconfigFile.close();
-    
-    return true;
 }
 
 bool FlashConfigWidget::saveConfig(const QString& filePath)
@@ -4,8 +4,7 @@
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QTableWidget>
-#include <QTableWidgetItem>
+#include <QTableView>
 #include <QHeaderView>
 #include <QPushButton>
 #include <QGroupBox>
@@ -23,18 +22,13 @@
 #include <QString>
 #include <QFrame>
 #include <QToolButton>
-
-// Flash分区配置结构
-struct FlashPartition {
-    int partitionNumber;      // 分区号
-    QString label;            // 分区标签
-    quint64 size;             // 大小（KB）
-    QString sizeString;       // 大小字符串（方便显示）
-    QString file;             // 关联文件
-    QString mountpoint;       // 挂载点
-    QString type;             // 类型（ext4等）
-    bool enabled;             // 是否启用
-};
+#include <QSpinBox>
+#include "flashpartitionplanner.h"
+#include "flashimageassembler.h"
+#include "flashpayloadscanner.h"
+#include "flashbootestimator.h"
+#include "flashpartitionmodel.h"
+#include "fileioservice.h"
 
 class FlashConfigWidget : public QWidget
 {
@@ -56,19 +50,22 @@ public:
     bool exportToJson(const QString& filePath);
     bool importFromJson(const QString& filePath);
     
-    // 导出到defconfig文件
-    bool exportToDefconfig(const QString& sourcePath, const QString& chipType);
+    // 导出到defconfig文件（后台读写，结果通过future在界面线程处理）
+    QFuture<FileIoResult> exportToDefconfig(const QString& sourcePath, const QString& chipType);
     
     // 设置源代码路径和芯片类型
     void setSourcePath(const QString& sourcePath);
     void setChipType(const QString& chipType);
+    
+    // 设置时钟树频率（MHz），用于启动读取耗时估算
+    void setClockFrequencies(const QMap<QString, double>& clocksMHz);
 
 signals:
     void configChanged();
     void partitionChanged(int partitionNumber);
 
 private slots:
-    void onTableItemDoubleClicked(QTableWidgetItem* item);
+    void onTableDoubleClicked(const QModelIndex& index);
     void onAddPartition();
     void onRemovePartition();
     void onResetPartitions();
@@ -79,14 +76,19 @@ private slots:
     void onTableSelectionChanged();
     void onConfigFieldChanged();
     void onToggleConfigPanel();
+    void onMediaTypeChanged(int index);
+    void onGeometryChanged();
+    void onAlignPartitions();
+    void onAssembleImage();
+    void onScanPayloads();
+    void onBusConfigChanged();
 
 private:
     void setupUI();
     void setupPartitionTable();
     void setupControlPanel();
     void initializePartitions();
-    void populateTable();
-    void updateSizeString(int row);
+    int currentPartitionNumber() const;
     void updatePartitionVisualization();
     void validatePartitionLayout();
     QString formatSize(quint64 sizeInKB);
@@ -95,6 +97,23 @@ private:
     void setConfigPanelExpanded(bool expanded);
     void formatSizeForInput(quint64 sizeInKB, QString& sizeText, QString& unit);
     QString getDefconfigPath() const;
+    // 只更新修改的配置项，不读写文件，在I/O线程中执行
+    static void applyPartitionsToDefconfig(QStringList& lines, const QList<FlashPartition>& partitions);
+    
+    // 分区规划
+    void setupMediaGroup();
+    void applyGeometryToUI(const FlashGeometry& geometry);
+    // 切换介质，新容量放不下时给出最小调整建议，用户确认后才修改分区；reason 非空时（由板型自动识别）提示用户
+    void switchMedia(FlashGeometry::MediaType media, const QString& reason);
+    void fitPartitionsToMedia(const FlashPlan& plan);
+    void updatePlan();
+    QString defaultImageInputDir() const;
+    void setImageToolsEnabled(bool enabled);
+    
+    // 启动读取耗时
+    void setupBootGroup();
+    void applyBusConfigToUI(const FlashBusConfig& config);
+    void updateBootEstimate();
     
     // UI组件
     QVBoxLayout* m_mainLayout;
@@ -103,7 +122,8 @@ private:
     // 分区表格区域
     QWidget* m_tableWidget;
     QVBoxLayout* m_tableLayout;
-    QTableWidget* m_partitionTable;
+    QTableView* m_partitionTable;
+    FlashPartitionModel* m_partitionModel;
     QLabel* m_tableTitle;
     
     // 控制面板
@@ -118,6 +138,8 @@ private:
     QPushButton* m_resetButton;
     QPushButton* m_exportButton;
     QPushButton* m_importButton;
+    QPushButton* m_assembleButton;
+    QPushButton* m_scanButton;
     
     // 分区搜索组
     QGroupBox* m_searchGroup;
@@ -141,15 +163,28 @@ private:
     QLineEdit* m_typeEdit;
     bool m_configExpanded;
     
+    // Flash介质组
+    QGroupBox* m_mediaGroup;
+    QComboBox* m_mediaCombo;
+    QLineEdit* m_capacityEdit;
+    QSpinBox* m_eraseBlockSpin;
+    QSpinBox* m_writeUnitSpin;
+    QSpinBox* m_headReserveSpin;
+    QLabel* m_planSummaryLabel;
+    QPushButton* m_alignButton;
+    
+    // 启动读取组
+    QGroupBox* m_bootGroup;
+    QComboBox* m_busModeCombo;
+    QComboBox* m_busWidthCombo;
+    QSpinBox* m_busClockSpin;
+    QLabel* m_bootTimeLabel;
+    
     // 分区可视化区域
     QGroupBox* m_visualizationGroup;
     QVBoxLayout* m_visualizationLayout;
     QTextEdit* m_partitionMapText;
     
-    // 数据存储
-    QMap<int, FlashPartition> m_partitions;
-    QList<int> m_partitionOrder;  // 用于保持原始顺序
-    
     // 源代码路径和芯片类型
     QString m_sourcePath;
     QString m_chipType;
@@ -157,18 +192,12 @@ private:
     // Flash配置
     QString m_flashSize;  // Flash大小（如"32GB"）
     int m_partitionCount;  // 分区数量
-    
-    // 表格列索引
-    enum TableColumns {
-        COL_PARTITION_NUM = 0,
-        COL_ENABLED,
-        COL_LABEL,
-        COL_SIZE,
-        COL_FILE,
-        COL_MOUNTPOINT,
-        COL_TYPE,
-        COL_COUNT
-    };
+    FlashPartitionPlanner m_planner;
+    FlashPlan m_plan;
+    QMap<int, PayloadScanResult> m_payloadScans;  // 分区数据文件扫描结果
+    FlashBusConfig m_busConfig;
+    QMap<QString, double> m_clocksMHz;
+    BootStorageEstimate m_bootEstimate;
 };
 
 #endif // FLASHCONFIG_H
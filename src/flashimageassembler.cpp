@@ -0,0 +1,496 @@
+#include "flashimageassembler.h"
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+
+// Android sparse 格式常量（system/core/libsparse/sparse_format.h）
+const quint32 SPARSE_HEADER_MAGIC = 0xed26ff3a;
+const quint16 SPARSE_MAJOR_VERSION = 1;
+const quint16 SPARSE_MINOR_VERSION = 0;
+const quint16 SPARSE_FILE_HEADER_SIZE = 28;
+const quint16 SPARSE_CHUNK_HEADER_SIZE = 12;
+const quint16 CHUNK_TYPE_RAW = 0xcac1;
+const quint16 CHUNK_TYPE_FILL = 0xcac2;
+const quint16 CHUNK_TYPE_DONT_CARE = 0xcac3;
+
+} // namespace
+
+QString FlashImageResult::summary() const
+{
+    QString text = QString("镜像 %1 MB，写入数据 %2 MB，输出文件 %3 MB，耗时 %4 ms")
+                       .arg(imageBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                       .arg(dataBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                       .arg(outputBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                       .arg(elapsedMs);
+    if (chunkCount > 0) {
+        text += QString("，%1 个sparse chunk").arg(chunkCount);
+    }
+    if (skippedBytes > 0) {
+        text += QString("，跳过空闲/填充数据 %1 MB").arg(skippedBytes / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+    if (usedCopyFileRange) {
+        text += "（copy_file_range）";
+    }
+    return text;
+}
+
+FlashImageAssembler::FlashImageAssembler(QObject *parent)
+    : QObject(parent)
+    , m_canceled(false)
+    , m_doneBytes(0)
+    , m_totalBytes(0)
+{
+}
+
+void FlashImageAssembler::cancel()
+{
+    m_canceled = true;
+}
+
+bool FlashImageAssembler::isCanceled() const
+{
+    return m_canceled;
+}
+
+void FlashImageAssembler::reportProgress(qint64 bytes)
+{
+    m_doneBytes += bytes;
+    emit progress(m_doneBytes, m_totalBytes);
+}
+
+QStringList FlashImageAssembler::checkSegments(const QList<FlashImageSegment>& segments, QStringList& missingFiles)
+{
+    QStringList errors;
+    missingFiles.clear();
+
+    for (const FlashImageSegment& segment : segments) {
+        if (segment.filePath.isEmpty()) {
+            continue;
+        }
+        QFileInfo info(segment.filePath);
+        if (!info.exists() || !info.isFile()) {
+            missingFiles << QString("分区%1 %2: %3").arg(segment.partitionNumber).arg(segment.label).arg(segment.filePath);
+            continue;
+        }
+        if (static_cast<quint64>(info.size()) > segment.capacityBytes) {
+            errors << QString("分区%1 %2: 文件 %3 大小 %4 KB 超过分区容量 %5 KB")
+                          .arg(segment.partitionNumber)
+                          .arg(segment.label)
+                          .arg(info.fileName())
+                          .arg(info.size() / 1024)
+                          .arg(segment.capacityBytes / 1024);
+        }
+    }
+
+    return errors;
+}
+
+bool FlashImageAssembler::assemble(const QList<FlashImageSegment>& segments, quint64 imageBytes,
+                                   const QString& outputPath, OutputFormat format,
+                                   FlashImageResult& result, QString& errorMessage)
+{
+    m_canceled = false;
+    m_doneBytes = 0;
+    m_totalBytes = 0;
+
+    result.imageBytes = imageBytes;
+    result.dataBytes = 0;
+    result.outputBytes = 0;
+    result.chunkCount = 0;
+    result.skippedBytes = 0;
+    result.elapsedMs = 0;
+    result.usedCopyFileRange = false;
+
+    // 校验分区按偏移排列且互不重叠
+    quint64 lastEnd = 0;
+    for (const FlashImageSegment& segment : segments) {
+        if (segment.offsetBytes < lastEnd) {
+            errorMessage = QString("分区%1 %2 与前一个分区重叠").arg(segment.partitionNumber).arg(segment.label);
+            return false;
+        }
+        if (segment.offsetBytes + segment.capacityBytes > imageBytes) {
+            errorMessage = QString("分区%1 %2 超出镜像范围").arg(segment.partitionNumber).arg(segment.label);
+            return false;
+        }
+        if (segment.offsetBytes % SPARSE_BLOCK_SIZE != 0) {
+            errorMessage = QString("分区%1 %2 偏移未按 %3 字节对齐")
+                               .arg(segment.partitionNumber).arg(segment.label).arg(SPARSE_BLOCK_SIZE);
+            return false;
+        }
+        lastEnd = segment.offsetBytes + segment.capacityBytes;
+
+        if (!segment.filePath.isEmpty()) {
+            m_totalBytes += QFileInfo(segment.filePath).size();
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    bool ok = format == AndroidSparse
+                  ? assembleSparse(segments, imageBytes, outputPath, result, errorMessage)
+                  : assembleRaw(segments, imageBytes, outputPath, result, errorMessage);
+
+    result.elapsedMs = timer.elapsed();
+
+    if (!ok) {
+        // 失败或取消时删除不完整的镜像
+        QFile::remove(outputPath);
+        if (m_canceled && errorMessage.isEmpty()) {
+            errorMessage = "镜像生成已取消";
+        }
+        return false;
+    }
+
+    result.outputBytes = static_cast<quint64>(QFileInfo(outputPath).size());
+    return true;
+}
+
+bool FlashImageAssembler::assembleRaw(const QList<FlashImageSegment>& segments, quint64 imageBytes,
+                                      const QString& outputPath, FlashImageResult& result, QString& errorMessage)
+{
+    QFile output(outputPath);
+    if (!output.open(QIODevice::ReadWrite | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        errorMessage = QString("无法创建镜像文件: %1").arg(output.errorString());
+        return false;
+    }
+
+    // 直接扩展到镜像大小：未写入的区域保持为文件空洞，不占用磁盘空间
+    if (!output.resize(static_cast<qint64>(imageBytes))) {
+        errorMessage = QString("无法设置镜像大小: %1").arg(output.errorString());
+        return false;
+    }
+
+    for (const FlashImageSegment& segment : segments) {
+        if (segment.filePath.isEmpty()) {
+            continue;
+        }
+        if (m_canceled) {
+            return false;
+        }
+
+        emit segmentStarted(segment.label);
+
+        QFile source(segment.filePath);
+        if (!source.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            errorMessage = QString("无法读取分区文件 %1: %2").arg(segment.filePath).arg(source.errorString());
+            return false;
+        }
+
+        quint64 length = std::min(static_cast<quint64>(source.size()), segment.capacityBytes);
+        if (!copyToOffset(source, output, segment.offsetBytes, length, result, errorMessage)) {
+            return false;
+        }
+    }
+
+    output.close();
+    return true;
+}
+
+bool FlashImageAssembler::copyToOffset(QFile& source, QFile& output, quint64 offset, quint64 length,
+                                       FlashImageResult& result, QString& errorMessage)
+{
+    quint64 copied = 0;
+
+#ifdef Q_OS_LINUX
+    // 优先使用 copy_file_range：数据在内核内复制，同一文件系统上可能直接共享数据块
+    {
+        loff_t inOffset = 0;
+        loff_t outOffset = static_cast<loff_t>(offset);
+        bool fallback = false;
+        while (copied < length && !m_canceled) {
+            size_t chunk = static_cast<size_t>(std::min<quint64>(length - copied, COPY_BUFFER_SIZE));
+            ssize_t n = ::copy_file_range(source.handle(), &inOffset, output.handle(), &outOffset, chunk, 0);
+            if (n < 0) {
+                if (copied == 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+                    fallback = true;
+                    break;
+                }
+                errorMessage = QString("复制分区数据失败: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+                return false;
+            }
+            if (n == 0) {
+                break;
+            }
+            copied += static_cast<quint64>(n);
+            result.dataBytes += static_cast<quint64>(n);
+            reportProgress(n);
+        }
+        if (!fallback) {
+            result.usedCopyFileRange = true;
+            return !m_canceled;
+        }
+    }
+#endif
+
+    // 通用路径：按固定大小缓冲流式复制，全零块跳过以保留文件空洞
+    std::unique_ptr<char[]> buffer(new char[COPY_BUFFER_SIZE]);
+    if (!source.seek(0)) {
+        errorMessage = QString("无法定位分区文件: %1").arg(source.errorString());
+        return false;
+    }
+
+    while (copied < length && !m_canceled) {
+        qint64 want = static_cast<qint64>(std::min<quint64>(length - copied, COPY_BUFFER_SIZE));
+        qint64 n = source.read(buffer.get(), want);
+        if (n < 0) {
+            errorMessage = QString("读取分区文件失败: %1").arg(source.errorString());
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+
+        for (qint64 pos = 0; pos < n; pos += SPARSE_BLOCK_SIZE) {
+            qint64 blockLength = std::min<qint64>(SPARSE_BLOCK_SIZE, n - pos);
+            if (FlashPayloadScanner::isZeroBlock(buffer.get() + pos, blockLength)) {
+                continue;
+            }
+            if (!output.seek(static_cast<qint64>(offset + copied) + pos) ||
+                !writeAll(output, buffer.get() + pos, blockLength, errorMessage)) {
+                if (errorMessage.isEmpty()) {
+                    errorMessage = QString("写入镜像失败: %1").arg(output.errorString());
+                }
+                return false;
+            }
+        }
+
+        copied += static_cast<quint64>(n);
+        result.dataBytes += static_cast<quint64>(n);
+        reportProgress(n);
+    }
+
+    return !m_canceled;
+}
+
+bool FlashImageAssembler::assembleSparse(const QList<FlashImageSegment>& segments, quint64 imageBytes,
+                                         const QString& outputPath, FlashImageResult& result, QString& errorMessage)
+{
+    QFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = QString("无法创建镜像文件: %1").arg(output.errorString());
+        return false;
+    }
+
+    const quint32 totalBlocks = static_cast<quint32>((imageBytes + SPARSE_BLOCK_SIZE - 1) / SPARSE_BLOCK_SIZE);
+    quint32 chunks = 0;
+    quint32 cursor = 0;     // 当前已描述到的块号
+
+    // 先写占位文件头，chunk总数在结束后回填
+    if (!writeSparseHeader(output, totalBlocks, 0, errorMessage)) {
+        return false;
+    }
+
+    std::unique_ptr<char[]> buffer(new char[COPY_BUFFER_SIZE]);
+
+    for (const FlashImageSegment& segment : segments) {
+        if (segment.filePath.isEmpty()) {
+            continue;
+        }
+        if (m_canceled) {
+            return false;
+        }
+
+        emit segmentStarted(segment.label);
+
+        // 分区之间未使用的区域
+        quint32 startBlock = static_cast<quint32>(segment.offsetBytes / SPARSE_BLOCK_SIZE);
+        if (startBlock > cursor) {
+            if (!writeChunkHeader(output, CHUNK_TYPE_DONT_CARE, startBlock - cursor, 0, errorMessage)) {
+                return false;
+            }
+            ++chunks;
+            cursor = startBlock;
+        }
+
+        if (!writeSegmentChunks(output, segment, buffer.get(), cursor, chunks, result, errorMessage)) {
+            return false;
+        }
+    }
+
+    if (m_canceled) {
+        return false;
+    }
+
+    if (cursor < totalBlocks) {
+        if (!writeChunkHeader(output, CHUNK_TYPE_DONT_CARE, totalBlocks - cursor, 0, errorMessage)) {
+            return false;
+        }
+        ++chunks;
+    }
+
+    // 回填chunk总数
+    if (!output.seek(0) || !writeSparseHeader(output, totalBlocks, chunks, errorMessage)) {
+        if (errorMessage.isEmpty()) {
+            errorMessage = QString("回写sparse文件头失败: %1").arg(output.errorString());
+        }
+        return false;
+    }
+
+    output.close();
+    result.chunkCount = static_cast<int>(chunks);
+    return true;
+}
+
+bool FlashImageAssembler::writeSegmentChunks(QFile& output, const FlashImageSegment& segment, char* buffer,
+                                             quint32& cursor, quint32& chunks, FlashImageResult& result, QString& errorMessage)
+{
+    FlashPayloadScanner scanner;
+    if (!scanner.open(segment.filePath, errorMessage)) {
+        return false;
+    }
+
+    QFile source(segment.filePath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("无法读取分区文件 %1: %2").arg(segment.filePath).arg(source.errorString());
+        return false;
+    }
+
+    // 尚未写出的FILL/DONT_CARE连续块，跨缓冲区合并
+    quint16 pendingType = 0;
+    quint32 pendingBlocks = 0;
+    quint32 pendingFill = 0;
+    auto flushPending = [&]() -> bool {
+        if (pendingBlocks == 0) {
+            return true;
+        }
+        if (pendingType == CHUNK_TYPE_FILL) {
+            char fill[sizeof(quint32)];
+            std::memcpy(fill, &pendingFill, sizeof(fill));
+            if (!writeChunkHeader(output, CHUNK_TYPE_FILL, pendingBlocks, sizeof(fill), errorMessage) ||
+                !writeAll(output, fill, sizeof(fill), errorMessage)) {
+                return false;
+            }
+        } else if (!writeChunkHeader(output, CHUNK_TYPE_DONT_CARE, pendingBlocks, 0, errorMessage)) {
+            return false;
+        }
+        ++chunks;
+        cursor += pendingBlocks;
+        result.skippedBytes += static_cast<quint64>(pendingBlocks) * SPARSE_BLOCK_SIZE;
+        pendingBlocks = 0;
+        return true;
+    };
+    auto writeRaw = [&](const char* data, quint32 blocks) -> bool {
+        if (!flushPending() ||
+            !writeChunkHeader(output, CHUNK_TYPE_RAW, blocks, blocks * SPARSE_BLOCK_SIZE, errorMessage) ||
+            !writeAll(output, data, static_cast<qint64>(blocks) * SPARSE_BLOCK_SIZE, errorMessage)) {
+            return false;
+        }
+        ++chunks;
+        cursor += blocks;
+        return true;
+    };
+
+    quint32 blockIndex = 0;
+    quint64 remaining = std::min(scanner.fileBytes(), segment.capacityBytes);
+    while (remaining > 0 && !m_canceled) {
+        qint64 want = static_cast<qint64>(std::min<quint64>(remaining, COPY_BUFFER_SIZE));
+        qint64 n = source.read(buffer, want);
+        if (n <= 0) {
+            if (n < 0) {
+                errorMessage = QString("读取分区文件失败: %1").arg(source.errorString());
+                return false;
+            }
+            break;
+        }
+
+        // 末尾不足一块的部分补零
+        qint64 padded = (n + SPARSE_BLOCK_SIZE - 1) / SPARSE_BLOCK_SIZE * SPARSE_BLOCK_SIZE;
+        if (padded > n) {
+            std::memset(buffer + n, 0, static_cast<size_t>(padded - n));
+        }
+
+        // 连续数据块合并为一个RAW chunk，空闲块和填充块延迟合并
+        quint32 blocks = static_cast<quint32>(padded / SPARSE_BLOCK_SIZE);
+        qint64 dataStart = -1;
+        for (quint32 b = 0; b < blocks; ++b) {
+            quint32 fill = 0;
+            FlashPayloadScanner::BlockKind kind = scanner.classify(blockIndex + b, buffer + b * SPARSE_BLOCK_SIZE, fill);
+            if (kind == FlashPayloadScanner::DataBlock) {
+                if (dataStart < 0) {
+                    dataStart = b;
+                }
+                continue;
+            }
+
+            if (dataStart >= 0) {
+                if (!writeRaw(buffer + dataStart * SPARSE_BLOCK_SIZE, b - static_cast<quint32>(dataStart))) {
+                    return false;
+                }
+                dataStart = -1;
+            }
+
+            quint16 type = kind == FlashPayloadScanner::UnusedBlock ? CHUNK_TYPE_DONT_CARE : CHUNK_TYPE_FILL;
+            if (pendingBlocks > 0 && (pendingType != type || (type == CHUNK_TYPE_FILL && pendingFill != fill))) {
+                if (!flushPending()) {
+                    return false;
+                }
+            }
+            pendingType = type;
+            pendingFill = fill;
+            ++pendingBlocks;
+        }
+        if (dataStart >= 0 && !writeRaw(buffer + dataStart * SPARSE_BLOCK_SIZE, blocks - static_cast<quint32>(dataStart))) {
+            return false;
+        }
+
+        blockIndex += blocks;
+        remaining -= static_cast<quint64>(n);
+        result.dataBytes += static_cast<quint64>(n);
+        reportProgress(n);
+    }
+
+    if (m_canceled) {
+        return false;
+    }
+    return flushPending();
+}
+
+bool FlashImageAssembler::writeSparseHeader(QFile& output, quint32 totalBlocks, quint32 totalChunks, QString& errorMessage)
+{
+    uchar header[SPARSE_FILE_HEADER_SIZE];
+    qToLittleEndian<quint32>(SPARSE_HEADER_MAGIC, header + 0);
+    qToLittleEndian<quint16>(SPARSE_MAJOR_VERSION, header + 4);
+    qToLittleEndian<quint16>(SPARSE_MINOR_VERSION, header + 6);
+    qToLittleEndian<quint16>(SPARSE_FILE_HEADER_SIZE, header + 8);
+    qToLittleEndian<quint16>(SPARSE_CHUNK_HEADER_SIZE, header + 10);
+    qToLittleEndian<quint32>(SPARSE_BLOCK_SIZE, header + 12);
+    qToLittleEndian<quint32>(totalBlocks, header + 16);
+    qToLittleEndian<quint32>(totalChunks, header + 20);
+    qToLittleEndian<quint32>(0, header + 24);   // image_checksum，不使用
+    return writeAll(output, reinterpret_cast<const char*>(header), sizeof(header), errorMessage);
+}
+
+bool FlashImageAssembler::writeChunkHeader(QFile& output, quint16 type, quint32 blocks, quint32 dataBytes, QString& errorMessage)
+{
+    uchar header[SPARSE_CHUNK_HEADER_SIZE];
+    qToLittleEndian<quint16>(type, header + 0);
+    qToLittleEndian<quint16>(0, header + 2);
+    qToLittleEndian<quint32>(blocks, header + 4);
+    qToLittleEndian<quint32>(SPARSE_CHUNK_HEADER_SIZE + dataBytes, header + 8);
+    return writeAll(output, reinterpret_cast<const char*>(header), sizeof(header), errorMessage);
+}
+
+bool FlashImageAssembler::writeAll(QFile& output, const char* data, qint64 length, QString& errorMessage)
+{
+    qint64 written = 0;
+    while (written < length) {
+        qint64 n = output.write(data + written, length - written);
+        if (n <= 0) {
+            errorMessage = QString("写入镜像失败: %1").arg(output.errorString());
+            return false;
+        }
+        written += n;
+    }
+    return true;
+}
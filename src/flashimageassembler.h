@@ -0,0 +1,90 @@
+#ifndef FLASHIMAGEASSEMBLER_H
+#define FLASHIMAGEASSEMBLER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QFile>
+#include <atomic>
+#include "flashpayloadscanner.h"
+
+// 镜像中的一个分区数据段
+struct FlashImageSegment {
+    int partitionNumber;
+    QString label;
+    QString filePath;         // 分区数据文件，空表示该分区不写入数据
+    quint64 offsetBytes;      // 在镜像中的偏移
+    quint64 capacityBytes;    // 分区容量
+};
+
+// 镜像生成结果
+struct FlashImageResult {
+    quint64 imageBytes;       // 镜像逻辑大小
+    quint64 dataBytes;        // 实际写入的分区数据
+    quint64 outputBytes;      // 输出文件大小（sparse格式时远小于镜像大小）
+    int chunkCount;           // sparse格式的chunk数量
+    quint64 skippedBytes;     // sparse格式中以FILL/DONT_CARE描述、无需传输的数据
+    qint64 elapsedMs;
+    bool usedCopyFileRange;
+
+    QString summary() const;
+};
+
+// 流式Flash镜像组装：按规划偏移放置各分区数据，不整文件缓存
+// 原始镜像中未使用的区域保留为文件空洞；可选输出 Android sparse 格式，
+// 其中ext4未分配块记为DONT_CARE，整块重复值（含全零）记为FILL
+class FlashImageAssembler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum OutputFormat {
+        RawImage = 0,
+        AndroidSparse
+    };
+
+    explicit FlashImageAssembler(QObject *parent = nullptr);
+
+    // segments 需按偏移升序排列；imageBytes 为镜像逻辑大小
+    bool assemble(const QList<FlashImageSegment>& segments, quint64 imageBytes,
+                  const QString& outputPath, OutputFormat format,
+                  FlashImageResult& result, QString& errorMessage);
+
+    // 检查分区文件是否存在、是否超过分区容量
+    static QStringList checkSegments(const QList<FlashImageSegment>& segments, QStringList& missingFiles);
+
+    void cancel();
+    bool isCanceled() const;
+
+    static constexpr qint64 COPY_BUFFER_SIZE = 4 * 1024 * 1024;   // 4MB，按sparse块大小对齐
+    static constexpr quint32 SPARSE_BLOCK_SIZE = 4096;
+
+signals:
+    void progress(qint64 doneBytes, qint64 totalBytes);
+    void segmentStarted(const QString& label);
+
+private:
+    bool assembleRaw(const QList<FlashImageSegment>& segments, quint64 imageBytes,
+                     const QString& outputPath, FlashImageResult& result, QString& errorMessage);
+    bool assembleSparse(const QList<FlashImageSegment>& segments, quint64 imageBytes,
+                        const QString& outputPath, FlashImageResult& result, QString& errorMessage);
+
+    // 将源文件流式复制到输出文件的指定偏移
+    bool copyToOffset(QFile& source, QFile& output, quint64 offset, quint64 length,
+                      FlashImageResult& result, QString& errorMessage);
+
+    bool writeSparseHeader(QFile& output, quint32 totalBlocks, quint32 totalChunks, QString& errorMessage);
+    bool writeChunkHeader(QFile& output, quint16 type, quint32 blocks, quint32 dataBytes, QString& errorMessage);
+    bool writeSegmentChunks(QFile& output, const FlashImageSegment& segment, char* buffer,
+                            quint32& cursor, quint32& chunks, FlashImageResult& result, QString& errorMessage);
+    bool writeAll(QFile& output, const char* data, qint64 length, QString& errorMessage);
+
+    void reportProgress(qint64 bytes);
+
+    std::atomic<bool> m_canceled;
+    qint64 m_doneBytes;
+    qint64 m_totalBytes;
+};
+
+#endif // FLASHIMAGEASSEMBLER_H
@@ -0,0 +1,346 @@
+#include "flashpartitionmodel.h"
+#include <QBrush>
+#include <QColor>
+#include <QFileInfo>
+
+FlashPartitionModel::FlashPartitionModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_usableKB(0)
+    , m_dominantPartition(-1)
+{
+}
+
+int FlashPartitionModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_partitionOrder.size();
+}
+
+int FlashPartitionModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : COL_COUNT;
+}
+
+QVariant FlashPartitionModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_partitionOrder.size()) {
+        return QVariant();
+    }
+
+    int partNum = m_partitionOrder[index.row()];
+    auto it = m_partitions.constFind(partNum);
+    if (it == m_partitions.constEnd()) {
+        return QVariant();
+    }
+    const FlashPartition& partition = it.value();
+    auto planned = m_planned.constFind(partNum);
+    bool hasPlan = planned != m_planned.constEnd();
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case COL_PARTITION_NUM: return QString::number(partition.partitionNumber);
+        case COL_LABEL:         return partition.label;
+        case COL_SIZE:          return QString::number(partition.size);
+        case COL_OFFSET:        return hasPlan ? QString::number(planned->offsetKB) : QString("-");
+        case COL_FILE:          return partition.file;
+        case COL_DATA:
+            return hasCurrentScan(partNum)
+                       ? QString("%1%").arg(m_payloadScans[partNum].dataRatio(), 0, 'f', 1)
+                       : QString("-");
+        case COL_MOUNTPOINT:    return partition.mountpoint;
+        case COL_TYPE:          return partition.type;
+        default:                return QVariant();
+        }
+
+    case Qt::CheckStateRole:
+        if (index.column() == COL_ENABLED) {
+            return partition.enabled ? Qt::Checked : Qt::Unchecked;
+        }
+        return QVariant();
+
+    case Qt::ToolTipRole:
+        if (index.column() == COL_OFFSET && hasPlan) {
+            bool overflow = planned->offsetKB + planned->alignedKB > m_usableKB;
+            return QString("0x%1 - 0x%2 字节%3")
+                .arg(planned->offsetKB * 1024, 0, 16)
+                .arg((planned->offsetKB + planned->alignedKB) * 1024, 0, 16)
+                .arg(overflow ? "，超出器件容量" : "");
+        }
+        if (index.column() == COL_DATA) {
+            if (!hasCurrentScan(partNum)) {
+                return QString("点击“分析数据”扫描分区文件");
+            }
+            const PayloadScanResult& scan = m_payloadScans[partNum];
+            return QString("%1\n文件 %2 KB，sparse下载 %3 KB")
+                .arg(scan.summary())
+                .arg(scan.fileBytes / 1024)
+                .arg(scan.sparseBytes() / 1024);
+        }
+        if (index.column() == COL_LABEL && m_bootLoads.contains(partNum)) {
+            const PartitionLoadTime& load = m_bootLoads[partNum];
+            return QString("启动时由 %1 读取 %2 KB，约 %3 ms%4")
+                .arg(load.stage)
+                .arg(load.bytes / 1024)
+                .arg(load.ms, 0, 'f', 1)
+                .arg(partNum == m_dominantPartition ? "（启动读取耗时最多）" : "");
+        }
+        return QVariant();
+
+    case Qt::BackgroundRole:
+        // 超出容量的偏移、适合sparse烧录的数据、启动读取耗时最多的分区
+        if (index.column() == COL_OFFSET && hasPlan &&
+            planned->offsetKB + planned->alignedKB > m_usableKB) {
+            return QBrush(QColor("#fadbd8"));
+        }
+        if (index.column() == COL_DATA && hasCurrentScan(partNum) &&
+            m_payloadScans[partNum].dataRatio() < 50.0) {
+            return QBrush(QColor("#d5f5e3"));
+        }
+        if (index.column() == COL_LABEL && partNum == m_dominantPartition && m_bootLoads.contains(partNum)) {
+            return QBrush(QColor("#fdebd0"));
+        }
+        return QVariant();
+
+    default:
+        return QVariant();
+    }
+}
+
+bool FlashPartitionModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || index.column() != COL_ENABLED || role != Qt::CheckStateRole) {
+        return false;
+    }
+
+    int partNum = partitionNumberAt(index.row());
+    if (partNum < 0) {
+        return false;
+    }
+    return setPartitionEnabled(partNum, static_cast<Qt::CheckState>(value.toInt()) == Qt::Checked);
+}
+
+Qt::ItemFlags FlashPartitionModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    // 表格只读，除启用复选框外均通过配置面板修改
+    Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (index.column() == COL_ENABLED) {
+        itemFlags |= Qt::ItemIsUserCheckable;
+    }
+    return itemFlags;
+}
+
+QVariant FlashPartitionModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    static const QStringList headers = {
+        "分区号", "启用", "标签", "大小(KB)", "偏移(KB)", "文件", "有效数据", "挂载点", "类型"
+    };
+    return section >= 0 && section < headers.size() ? headers[section] : QVariant();
+}
+
+void FlashPartitionModel::setPartitions(const QList<FlashPartition>& partitions)
+{
+    beginResetModel();
+    m_partitions.clear();
+    m_partitionOrder.clear();
+    for (const FlashPartition& partition : partitions) {
+        if (!m_partitions.contains(partition.partitionNumber)) {
+            m_partitionOrder.append(partition.partitionNumber);
+        }
+        m_partitions[partition.partitionNumber] = partition;
+    }
+    rebuildIndex();
+    endResetModel();
+}
+
+void FlashPartitionModel::appendPartition(const FlashPartition& partition)
+{
+    if (m_partitions.contains(partition.partitionNumber)) {
+        updatePartition(partition);
+        return;
+    }
+
+    int row = m_partitionOrder.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_partitions[partition.partitionNumber] = partition;
+    m_partitionOrder.append(partition.partitionNumber);
+    m_rowIndex.insert(partition.partitionNumber, row);
+    QString labelKey = partition.label.toLower();
+    if (!m_labelIndex.contains(labelKey)) {
+        m_labelIndex.insert(labelKey, row);
+    }
+    endInsertRows();
+}
+
+bool FlashPartitionModel::removePartition(int partitionNumber)
+{
+    int row = rowOf(partitionNumber);
+    if (row < 0) {
+        return false;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_partitions.remove(partitionNumber);
+    m_partitionOrder.removeAt(row);
+    m_payloadScans.remove(partitionNumber);
+    rebuildIndex();
+    endRemoveRows();
+    return true;
+}
+
+bool FlashPartitionModel::updatePartition(const FlashPartition& partition)
+{
+    int row = rowOf(partition.partitionNumber);
+    if (row < 0) {
+        return false;
+    }
+
+    FlashPartition& stored = m_partitions[partition.partitionNumber];
+    bool labelChanged = stored.label.compare(partition.label, Qt::CaseInsensitive) != 0;
+    stored = partition;
+    if (labelChanged) {
+        rebuildIndex();
+    }
+
+    emit dataChanged(index(row, 0), index(row, COL_COUNT - 1));
+    return true;
+}
+
+bool FlashPartitionModel::setPartitionEnabled(int partitionNumber, bool enabled)
+{
+    int row = rowOf(partitionNumber);
+    if (row < 0) {
+        return false;
+    }
+
+    FlashPartition& partition = m_partitions[partitionNumber];
+    if (partition.enabled == enabled) {
+        return true;
+    }
+    partition.enabled = enabled;
+
+    QModelIndex enabledIndex = index(row, COL_ENABLED);
+    emit dataChanged(enabledIndex, enabledIndex, {Qt::CheckStateRole});
+    emit partitionEnabledChanged(partitionNumber, enabled);
+    return true;
+}
+
+bool FlashPartitionModel::contains(int partitionNumber) const
+{
+    return m_rowIndex.contains(partitionNumber);
+}
+
+FlashPartition FlashPartitionModel::partition(int partitionNumber) const
+{
+    return m_partitions.value(partitionNumber, FlashPartition());
+}
+
+int FlashPartitionModel::rowOf(int partitionNumber) const
+{
+    return m_rowIndex.value(partitionNumber, -1);
+}
+
+int FlashPartitionModel::partitionNumberAt(int row) const
+{
+    return row >= 0 && row < m_partitionOrder.size() ? m_partitionOrder[row] : -1;
+}
+
+int FlashPartitionModel::findLabel(const QString& label) const
+{
+    return m_labelIndex.value(label.toLower(), -1);
+}
+
+bool FlashPartitionModel::labelContains(int row, const QString& text) const
+{
+    int partNum = partitionNumberAt(row);
+    if (partNum < 0) {
+        return false;
+    }
+    return text.isEmpty() || m_partitions[partNum].label.contains(text, Qt::CaseInsensitive);
+}
+
+const QMap<int, FlashPartition>& FlashPartitionModel::partitions() const
+{
+    return m_partitions;
+}
+
+const QList<int>& FlashPartitionModel::partitionOrder() const
+{
+    return m_partitionOrder;
+}
+
+QList<FlashPartition> FlashPartitionModel::orderedPartitions() const
+{
+    QList<FlashPartition> partitions;
+    partitions.reserve(m_partitionOrder.size());
+    for (int partNum : m_partitionOrder) {
+        partitions.append(m_partitions[partNum]);
+    }
+    return partitions;
+}
+
+void FlashPartitionModel::setPlan(const FlashPlan& plan)
+{
+    m_planned.clear();
+    for (const PlannedPartition& planned : plan.partitions) {
+        m_planned.insert(planned.partitionNumber, planned);
+    }
+    m_usableKB = plan.usableKB;
+    emitColumnChanged(COL_OFFSET);
+}
+
+void FlashPartitionModel::setPayloadScans(const QMap<int, PayloadScanResult>& scans)
+{
+    m_payloadScans = scans;
+    emitColumnChanged(COL_DATA);
+}
+
+void FlashPartitionModel::setBootEstimate(const BootStorageEstimate& estimate)
+{
+    m_bootLoads.clear();
+    for (const PartitionLoadTime& load : estimate.loads) {
+        m_bootLoads.insert(load.partitionNumber, load);
+    }
+    m_dominantPartition = estimate.dominantPartition;
+    emitColumnChanged(COL_LABEL);
+}
+
+bool FlashPartitionModel::hasCurrentScan(int partitionNumber) const
+{
+    // 文件名修改后旧的扫描结果失效
+    auto scan = m_payloadScans.constFind(partitionNumber);
+    if (scan == m_payloadScans.constEnd()) {
+        return false;
+    }
+    const QString file = m_partitions.value(partitionNumber).file;
+    return !file.isEmpty() && QFileInfo(scan->filePath).fileName() == QFileInfo(file).fileName();
+}
+
+void FlashPartitionModel::rebuildIndex()
+{
+    m_rowIndex.clear();
+    m_labelIndex.clear();
+    for (int row = 0; row < m_partitionOrder.size(); ++row) {
+        int partNum = m_partitionOrder[row];
+        m_rowIndex.insert(partNum, row);
+        QString labelKey = m_partitions[partNum].label.toLower();
+        if (!m_labelIndex.contains(labelKey)) {
+            m_labelIndex.insert(labelKey, row);
+        }
+    }
+}
+
+void FlashPartitionModel::emitColumnChanged(int column)
+{
+    if (m_partitionOrder.isEmpty()) {
+        return;
+    }
+    emit dataChanged(index(0, column), index(m_partitionOrder.size() - 1, column));
+}
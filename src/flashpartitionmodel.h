@@ -0,0 +1,89 @@
+#ifndef FLASHPARTITIONMODEL_H
+#define FLASHPARTITIONMODEL_H
+
+#include <QAbstractTableModel>
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include "flashpartitionplanner.h"
+#include "flashpayloadscanner.h"
+#include "flashbootestimator.h"
+
+// Flash 分区表模型：分区数据的唯一来源，按分区号/标签O(1)定位行
+// 不依赖任何控件，导出、规划等逻辑可在无界面时直接使用
+class FlashPartitionModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        COL_PARTITION_NUM = 0,
+        COL_ENABLED,
+        COL_LABEL,
+        COL_SIZE,
+        COL_OFFSET,
+        COL_FILE,
+        COL_DATA,
+        COL_MOUNTPOINT,
+        COL_TYPE,
+        COL_COUNT
+    };
+
+    explicit FlashPartitionModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // 分区数据（按列表顺序显示）
+    void setPartitions(const QList<FlashPartition>& partitions);
+    void appendPartition(const FlashPartition& partition);
+    bool removePartition(int partitionNumber);
+    bool updatePartition(const FlashPartition& partition);   // 按分区号替换，只刷新该行
+    bool setPartitionEnabled(int partitionNumber, bool enabled);
+
+    bool contains(int partitionNumber) const;
+    FlashPartition partition(int partitionNumber) const;
+    int rowOf(int partitionNumber) const;                   // 不存在返回-1
+    int partitionNumberAt(int row) const;                   // 越界返回-1
+    int findLabel(const QString& label) const;              // 标签精确匹配（不区分大小写）的行，-1表示无
+    bool labelContains(int row, const QString& text) const;
+
+    const QMap<int, FlashPartition>& partitions() const;
+    const QList<int>& partitionOrder() const;
+    QList<FlashPartition> orderedPartitions() const;
+
+    // 派生列：规划偏移、数据扫描结果、启动读取耗时
+    void setPlan(const FlashPlan& plan);
+    void setPayloadScans(const QMap<int, PayloadScanResult>& scans);
+    void setBootEstimate(const BootStorageEstimate& estimate);
+
+    // 扫描结果是否对应分区当前的文件
+    bool hasCurrentScan(int partitionNumber) const;
+
+signals:
+    void partitionEnabledChanged(int partitionNumber, bool enabled);
+
+private:
+    void rebuildIndex();
+    void emitColumnChanged(int column);
+
+    // 数据存储
+    QMap<int, FlashPartition> m_partitions;
+    QList<int> m_partitionOrder;            // 用于保持原始顺序
+    QHash<int, int> m_rowIndex;             // 分区号 -> 行
+    QHash<QString, int> m_labelIndex;       // 小写标签 -> 行（重名时取第一个）
+
+    // 派生数据
+    QHash<int, PlannedPartition> m_planned;
+    quint64 m_usableKB;
+    QMap<int, PayloadScanResult> m_payloadScans;
+    QHash<int, PartitionLoadTime> m_bootLoads;
+    int m_dominantPartition;
+};
+
+#endif // FLASHPARTITIONMODEL_H
@@ -0,0 +1,272 @@
+#include "flashpartitionplanner.h"
+#include <QRegularExpression>
+#include <algorithm>
+
+FlashGeometry FlashGeometry::defaultGeometry(MediaType media, const QString& capacity)
+{
+    FlashGeometry geometry;
+    geometry.media = media;
+
+    switch (media) {
+    case EMMC:
+        // eMMC：高容量擦除组512KB，写组4KB；起始1MB用于GPT并保证第一个分区1MB对齐
+        geometry.eraseBlockKB = 512;
+        geometry.writeUnitKB = 4;
+        geometry.reservedHeadKB = 1024;
+        geometry.spareBlockPercent = 0;
+        break;
+    case SPI_NAND:
+        // SPI-NAND：128KB擦除块、2KB页；起始预留fip及其备份，末尾预留2%的坏块替换区
+        geometry.eraseBlockKB = 128;
+        geometry.writeUnitKB = 2;
+        geometry.reservedHeadKB = 2048;
+        geometry.spareBlockPercent = 2;
+        break;
+    case SPI_NOR:
+    default:
+        // SPI-NOR：64KB块擦除、256字节页（按1KB计）；起始预留fip
+        geometry.eraseBlockKB = 64;
+        geometry.writeUnitKB = 1;
+        geometry.reservedHeadKB = 1024;
+        geometry.spareBlockPercent = 0;
+        break;
+    }
+
+    geometry.capacityKB = parseCapacityKB(media, capacity);
+    if (geometry.capacityKB == 0) {
+        geometry.capacityKB = parseCapacityKB(media, defaultCapacity(media));
+    }
+
+    return geometry;
+}
+
+bool FlashGeometry::mediaFromChipType(const QString& chipType, MediaType& media)
+{
+    QString lower = chipType.toLower();
+    if (lower.endsWith("_spinand")) {
+        media = SPI_NAND;
+    } else if (lower.endsWith("_spinor")) {
+        media = SPI_NOR;
+    } else if (lower.endsWith("_emmc")) {
+        media = EMMC;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString FlashGeometry::mediaName(MediaType media)
+{
+    switch (media) {
+    case EMMC:
+        return "eMMC";
+    case SPI_NAND:
+        return "SPI-NAND";
+    case SPI_NOR:
+        return "SPI-NOR";
+    }
+    return "eMMC";
+}
+
+QString FlashGeometry::defaultCapacity(MediaType media)
+{
+    switch (media) {
+    case EMMC:
+        return "32GB";
+    case SPI_NAND:
+        return "256MB";
+    case SPI_NOR:
+        return "16MB";
+    }
+    return "32GB";
+}
+
+quint64 FlashGeometry::parseCapacityKB(MediaType media, const QString& capacity)
+{
+    static const QRegularExpression capacityRegex("^\\s*(\\d+(?:\\.\\d+)?)\\s*(GB|MB|KB|G|M|K)?\\s*$",
+                                                  QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatch match = capacityRegex.match(capacity);
+    if (!match.hasMatch()) {
+        return 0;
+    }
+
+    double value = match.captured(1).toDouble();
+    QString unit = match.captured(2).toUpper();
+    if (unit.isEmpty()) {
+        unit = "KB";
+    }
+
+    // eMMC 标称容量为十进制（32GB = 32*10^9 字节），SPI Flash 为二进制
+    if (media == EMMC) {
+        double bytes = value;
+        if (unit.startsWith("G")) {
+            bytes *= 1e9;
+        } else if (unit.startsWith("M")) {
+            bytes *= 1e6;
+        } else {
+            bytes *= 1e3;
+        }
+        return static_cast<quint64>(bytes / 1024.0);
+    }
+
+    double kb = value;
+    if (unit.startsWith("G")) {
+        kb *= 1024.0 * 1024.0;
+    } else if (unit.startsWith("M")) {
+        kb *= 1024.0;
+    }
+    return static_cast<quint64>(kb);
+}
+
+quint64 FlashGeometry::alignmentKB() const
+{
+    // 分区边界同时满足擦除块、写单元以及SDK的64KB大小单位
+    quint64 alignment = std::max({eraseBlockKB, writeUnitKB, FlashPartitionPlanner::SDK_SIZE_UNIT_KB});
+    return alignment > 0 ? alignment : FlashPartitionPlanner::SDK_SIZE_UNIT_KB;
+}
+
+quint64 FlashGeometry::tailReservedKB() const
+{
+    quint64 alignment = alignmentKB();
+    quint64 tail = 0;
+    if (media == EMMC) {
+        // 备份GPT位于器件末尾，预留一个擦除组
+        tail = alignment;
+    } else if (media == SPI_NAND && spareBlockPercent > 0) {
+        tail = capacityKB * static_cast<quint64>(spareBlockPercent) / 100;
+    }
+    return (tail + alignment - 1) / alignment * alignment;
+}
+
+quint64 FlashGeometry::usableKB() const
+{
+    quint64 reserved = tailReservedKB();
+    quint64 end = capacityKB > reserved ? capacityKB - reserved : 0;
+    // 可用区域的结束位置也按擦除块对齐
+    return end / alignmentKB() * alignmentKB();
+}
+
+bool FlashPlan::fits() const
+{
+    return overflowKB == 0;
+}
+
+const PlannedPartition* FlashPlan::find(int partitionNumber) const
+{
+    for (const PlannedPartition& partition : partitions) {
+        if (partition.partitionNumber == partitionNumber) {
+            return &partition;
+        }
+    }
+    return nullptr;
+}
+
+QString FlashPlan::summary() const
+{
+    if (fits()) {
+        return QString("已使用 %1 KB / %2 KB，剩余 %3 KB（对齐 %4 KB）")
+                   .arg(endKB)
+                   .arg(usableKB)
+                   .arg(usableKB - endKB)
+                   .arg(alignmentKB);
+    }
+    return QString("超出容量 %1 KB（已使用 %2 KB / %3 KB，对齐 %4 KB）")
+               .arg(overflowKB)
+               .arg(endKB)
+               .arg(usableKB)
+               .arg(alignmentKB);
+}
+
+QString FlashPlan::suggestion() const
+{
+    if (fits()) {
+        return QString();
+    }
+    if (shrinkPartition < 0) {
+        return QString("没有单个分区可以吸收 %1 KB 的超出量，请减少多个分区的大小或更换更大容量的器件").arg(overflowKB);
+    }
+    const PlannedPartition* partition = find(shrinkPartition);
+    return QString("将分区%1 (%2) 从 %3 KB 缩小到 %4 KB 即可放下")
+               .arg(shrinkPartition)
+               .arg(partition ? partition->label : QString())
+               .arg(partition ? partition->alignedKB : 0)
+               .arg(suggestedSizeKB);
+}
+
+FlashPartitionPlanner::FlashPartitionPlanner()
+    : m_geometry(FlashGeometry::defaultGeometry(FlashGeometry::EMMC))
+{
+}
+
+void FlashPartitionPlanner::setGeometry(const FlashGeometry& geometry)
+{
+    m_geometry = geometry;
+}
+
+FlashGeometry FlashPartitionPlanner::geometry() const
+{
+    return m_geometry;
+}
+
+quint64 FlashPartitionPlanner::alignUp(quint64 sizeKB) const
+{
+    quint64 alignment = m_geometry.alignmentKB();
+    return (sizeKB + alignment - 1) / alignment * alignment;
+}
+
+quint64 FlashPartitionPlanner::alignDown(quint64 sizeKB) const
+{
+    quint64 alignment = m_geometry.alignmentKB();
+    return sizeKB / alignment * alignment;
+}
+
+bool FlashPartitionPlanner::isAligned(quint64 sizeKB) const
+{
+    return sizeKB % m_geometry.alignmentKB() == 0;
+}
+
+FlashPlan FlashPartitionPlanner::plan(const QList<FlashPartition>& partitions) const
+{
+    FlashPlan result;
+    result.alignmentKB = m_geometry.alignmentKB();
+    result.headKB = alignUp(m_geometry.reservedHeadKB);
+    result.usableKB = m_geometry.usableKB();
+    result.overflowKB = 0;
+    result.shrinkPartition = -1;
+    result.suggestedSizeKB = 0;
+
+    quint64 offset = result.headKB;
+    for (const FlashPartition& partition : partitions) {
+        if (!partition.enabled) {
+            continue;
+        }
+
+        PlannedPartition planned;
+        planned.partitionNumber = partition.partitionNumber;
+        planned.label = partition.label;
+        planned.requestedKB = partition.size;
+        planned.alignedKB = alignUp(partition.size);
+        planned.offsetKB = offset;
+        result.partitions.append(planned);
+
+        offset += planned.alignedKB;
+    }
+    result.endKB = offset;
+
+    if (result.endKB > result.usableKB) {
+        result.overflowKB = result.endKB - result.usableKB;
+
+        // 最小调整：由能够吸收超出量的最大分区缩小，相对改动最小
+        quint64 shrinkBy = alignUp(result.overflowKB);
+        quint64 largest = 0;
+        for (const PlannedPartition& planned : result.partitions) {
+            if (planned.alignedKB > shrinkBy && planned.alignedKB > largest) {
+                largest = planned.alignedKB;
+                result.shrinkPartition = planned.partitionNumber;
+                result.suggestedSizeKB = planned.alignedKB - shrinkBy;
+            }
+        }
+    }
+
+    return result;
+}
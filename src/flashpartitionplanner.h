@@ -0,0 +1,97 @@
+#ifndef FLASHPARTITIONPLANNER_H
+#define FLASHPARTITIONPLANNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+// Flash分区配置结构
+struct FlashPartition {
+    int partitionNumber;      // 分区号
+    QString label;            // 分区标签
+    quint64 size;             // 大小（KB）
+    QString sizeString;       // 大小字符串（方便显示）
+    QString file;             // 关联文件
+    QString mountpoint;       // 挂载点
+    QString type;             // 类型（ext4等）
+    bool enabled;             // 是否启用
+};
+
+// Flash 介质几何参数（单位均为KB）
+struct FlashGeometry {
+    enum MediaType {
+        EMMC = 0,
+        SPI_NAND,
+        SPI_NOR
+    };
+
+    MediaType media;
+    quint64 capacityKB;       // 器件可用容量
+    quint64 eraseBlockKB;     // 擦除块（eMMC为erase group）
+    quint64 writeUnitKB;      // 最小写入单元（eMMC写组 / NAND页 / NOR页）
+    quint64 reservedHeadKB;   // 起始预留：分区表及分区1(fip)
+    int spareBlockPercent;    // 末尾预留的坏块替换比例（仅SPI-NAND）
+
+    // 各介质的默认几何参数；capacity 为器件标称容量字符串（如"32GB"、"128MB"）
+    static FlashGeometry defaultGeometry(MediaType media, const QString& capacity = QString());
+    // 根据板型名称后缀（*_emmc / *_spinand / *_spinor）判断介质类型，没有这些后缀时返回false
+    static bool mediaFromChipType(const QString& chipType, MediaType& media);
+    static QString mediaName(MediaType media);
+    static QString defaultCapacity(MediaType media);
+    static quint64 parseCapacityKB(MediaType media, const QString& capacity);
+
+    // 分区起始地址和大小的对齐粒度
+    quint64 alignmentKB() const;
+    quint64 tailReservedKB() const;
+    quint64 usableKB() const;
+};
+
+// 规划后的单个分区
+struct PlannedPartition {
+    int partitionNumber;
+    QString label;
+    quint64 requestedKB;      // 用户配置的大小
+    quint64 alignedKB;        // 按擦除块向上取整后的大小
+    quint64 offsetKB;         // 在器件中的起始偏移
+};
+
+// 分区规划结果
+struct FlashPlan {
+    QList<PlannedPartition> partitions;
+    quint64 alignmentKB;
+    quint64 headKB;
+    quint64 endKB;            // 最后一个分区的结束偏移
+    quint64 usableKB;         // 可用于分区的结束偏移
+    quint64 overflowKB;       // 超出容量的部分（0表示放得下）
+    int shrinkPartition;      // 建议缩小的分区号（-1表示无需调整）
+    quint64 suggestedSizeKB;  // 建议缩小后的大小
+
+    bool fits() const;
+    const PlannedPartition* find(int partitionNumber) const;
+    QString summary() const;
+    QString suggestion() const;
+};
+
+// 擦除块感知的分区规划器：对齐每个分区、计算偏移、检查容量并给出最小调整建议
+class FlashPartitionPlanner
+{
+public:
+    FlashPartitionPlanner();
+
+    void setGeometry(const FlashGeometry& geometry);
+    FlashGeometry geometry() const;
+
+    quint64 alignUp(quint64 sizeKB) const;
+    quint64 alignDown(quint64 sizeKB) const;
+    bool isAligned(quint64 sizeKB) const;
+
+    // partitions 需按分区顺序排列，未启用的分区不占用空间
+    FlashPlan plan(const QList<FlashPartition>& partitions) const;
+
+    static constexpr quint64 SDK_SIZE_UNIT_KB = 64;   // SDK分区脚本要求的最小大小单位
+
+private:
+    FlashGeometry m_geometry;
+};
+
+#endif // FLASHPARTITIONPLANNER_H
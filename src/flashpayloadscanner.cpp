@@ -0,0 +1,364 @@
+#include "flashpayloadscanner.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QByteArray>
+#include <QtEndian>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// ext4 超级块字段（fs/ext4/ext4.h）
+const qint64 EXT4_SUPERBLOCK_OFFSET = 1024;
+const int EXT4_SUPERBLOCK_SIZE = 1024;
+const quint16 EXT4_MAGIC = 0xEF53;
+const quint32 EXT4_INCOMPAT_META_BG = 0x0010;
+const quint32 EXT4_INCOMPAT_64BIT = 0x0080;
+const quint16 EXT4_BG_BLOCK_UNINIT = 0x0002;
+const quint32 EXT4_MIN_DESC_SIZE = 32;
+const quint32 EXT4_MIN_DESC_SIZE_64BIT = 64;
+
+quint16 readLe16(const char* p)
+{
+    return qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(p));
+}
+
+quint32 readLe32(const char* p)
+{
+    return qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(p));
+}
+
+} // namespace
+
+double PayloadScanResult::dataRatio() const
+{
+    if (totalBlocks == 0) {
+        return 0.0;
+    }
+    return dataBlocks * 100.0 / totalBlocks;
+}
+
+quint64 PayloadScanResult::sparseBytes() const
+{
+    // 数据块 + 每个chunk头12字节 + FILL chunk的4字节填充值（按上限估算）
+    return static_cast<quint64>(dataBlocks) * FlashPayloadScanner::BLOCK_SIZE +
+           static_cast<quint64>(chunkCount) * (12 + 4);
+}
+
+QString PayloadScanResult::summary() const
+{
+    return QString("%1：%2 块，有效数据 %3 块（%4%），填充 %5 块，未分配 %6 块，sparse %7 个chunk")
+               .arg(ext4 ? "ext4" : "raw")
+               .arg(totalBlocks)
+               .arg(dataBlocks)
+               .arg(dataRatio(), 0, 'f', 1)
+               .arg(fillBlocks)
+               .arg(unusedBlocks)
+               .arg(chunkCount);
+}
+
+FlashPayloadScanner::FlashPayloadScanner()
+    : m_fileBytes(0)
+    , m_ext4(false)
+{
+}
+
+bool FlashPayloadScanner::isExt4() const
+{
+    return m_ext4;
+}
+
+quint64 FlashPayloadScanner::fileBytes() const
+{
+    return m_fileBytes;
+}
+
+bool FlashPayloadScanner::open(const QString& filePath, QString& errorMessage)
+{
+    QFileInfo info(filePath);
+    if (!info.exists() || !info.isFile()) {
+        errorMessage = QString("分区文件不存在: %1").arg(filePath);
+        return false;
+    }
+
+    m_fileBytes = static_cast<quint64>(info.size());
+    m_ext4 = false;
+    m_unusedBlocks.clear();
+
+    // 位图读取失败时按普通文件处理，只做零块/填充检测
+    if (loadExt4Bitmap(filePath)) {
+        m_ext4 = true;
+    } else {
+        m_unusedBlocks.clear();
+    }
+    return true;
+}
+
+bool FlashPayloadScanner::loadExt4Bitmap(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    if (!file.seek(EXT4_SUPERBLOCK_OFFSET)) {
+        return false;
+    }
+    QByteArray superBlock = file.read(EXT4_SUPERBLOCK_SIZE);
+    if (superBlock.size() != EXT4_SUPERBLOCK_SIZE) {
+        return false;
+    }
+    const char* sb = superBlock.constData();
+    if (readLe16(sb + 0x38) != EXT4_MAGIC) {
+        return false;
+    }
+
+    quint32 logBlockSize = readLe32(sb + 0x18);
+    if (logBlockSize > 2) {
+        // 文件系统块大于4KB时无法映射到sparse块
+        return false;
+    }
+    const quint32 blockSize = 1024u << logBlockSize;
+    const quint32 incompat = readLe32(sb + 0x60);
+    if (incompat & EXT4_INCOMPAT_META_BG) {
+        // META_BG 的组描述符分散存放，不做解析
+        return false;
+    }
+
+    quint64 blocksCount = readLe32(sb + 0x04);
+    quint32 descSize = EXT4_MIN_DESC_SIZE;
+    if (incompat & EXT4_INCOMPAT_64BIT) {
+        blocksCount |= static_cast<quint64>(readLe32(sb + 0x150)) << 32;
+        descSize = std::max<quint32>(readLe16(sb + 0xFE), EXT4_MIN_DESC_SIZE);
+    }
+    const quint32 firstDataBlock = readLe32(sb + 0x14);
+    const quint32 blocksPerGroup = readLe32(sb + 0x20);
+    if (blocksCount == 0 || blocksPerGroup == 0 || blocksPerGroup > blockSize * 8 ||
+        blocksCount <= firstDataBlock) {
+        return false;
+    }
+
+    const quint64 groupCount = (blocksCount - firstDataBlock + blocksPerGroup - 1) / blocksPerGroup;
+    if (!file.seek(static_cast<qint64>(firstDataBlock + 1) * blockSize)) {
+        return false;
+    }
+    QByteArray descriptors = file.read(static_cast<qint64>(groupCount * descSize));
+    if (static_cast<quint64>(descriptors.size()) != groupCount * descSize) {
+        return false;
+    }
+
+    // 先按文件系统块记录空闲状态，再折算到4KB块
+    QBitArray freeBlocks(static_cast<int>(blocksCount));
+    for (quint64 group = 0; group < groupCount; ++group) {
+        const char* desc = descriptors.constData() + group * descSize;
+        if (readLe16(desc + 0x12) & EXT4_BG_BLOCK_UNINIT) {
+            // 位图未初始化的块组按已使用处理，由零块检测兜底
+            continue;
+        }
+
+        quint64 bitmapBlock = readLe32(desc + 0x00);
+        if (descSize >= EXT4_MIN_DESC_SIZE_64BIT) {
+            bitmapBlock |= static_cast<quint64>(readLe32(desc + 0x20)) << 32;
+        }
+        if (bitmapBlock >= blocksCount || !file.seek(static_cast<qint64>(bitmapBlock * blockSize))) {
+            return false;
+        }
+        QByteArray bitmap = file.read(blockSize);
+        if (bitmap.size() != static_cast<int>(blockSize)) {
+            return false;
+        }
+
+        const quint64 groupStart = firstDataBlock + group * blocksPerGroup;
+        const quint64 groupBlocks = std::min<quint64>(blocksPerGroup, blocksCount - groupStart);
+        const uchar* bits = reinterpret_cast<const uchar*>(bitmap.constData());
+        for (quint64 i = 0; i < groupBlocks; ++i) {
+            if (!(bits[i / 8] & (1u << (i % 8)))) {
+                freeBlocks.setBit(static_cast<int>(groupStart + i));
+            }
+        }
+    }
+
+    // 4KB块内的所有文件系统块都空闲才视为未分配
+    const quint32 perBlock = BLOCK_SIZE / blockSize;
+    const quint64 sparseBlocks = blocksCount / perBlock;
+    m_unusedBlocks.resize(static_cast<int>(sparseBlocks));
+    for (quint64 block = 0; block < sparseBlocks; ++block) {
+        bool allFree = true;
+        for (quint32 i = 0; i < perBlock && allFree; ++i) {
+            allFree = freeBlocks.testBit(static_cast<int>(block * perBlock + i));
+        }
+        if (allFree) {
+            m_unusedBlocks.setBit(static_cast<int>(block));
+        }
+    }
+    return true;
+}
+
+FlashPayloadScanner::BlockKind FlashPayloadScanner::classify(quint32 blockIndex, const char* data, quint32& fillValue) const
+{
+    if (m_ext4 && blockIndex < static_cast<quint32>(m_unusedBlocks.size()) && m_unusedBlocks.testBit(static_cast<int>(blockIndex))) {
+        return UnusedBlock;
+    }
+    if (isUniformBlock(data, BLOCK_SIZE, fillValue)) {
+        return FillBlock;
+    }
+    return DataBlock;
+}
+
+bool FlashPayloadScanner::scan(const QString& filePath, PayloadScanResult& result, QString& errorMessage,
+                               const std::atomic<bool>* canceled)
+{
+    result.filePath = filePath;
+    result.fileBytes = 0;
+    result.totalBlocks = 0;
+    result.dataBlocks = 0;
+    result.fillBlocks = 0;
+    result.unusedBlocks = 0;
+    result.chunkCount = 0;
+    result.ext4 = false;
+
+    FlashPayloadScanner scanner;
+    if (!scanner.open(filePath, errorMessage)) {
+        return false;
+    }
+    result.fileBytes = scanner.fileBytes();
+    result.ext4 = scanner.isExt4();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("无法读取分区文件 %1: %2").arg(filePath).arg(file.errorString());
+        return false;
+    }
+
+    std::unique_ptr<char[]> buffer(new char[SCAN_BUFFER_SIZE]);
+    quint32 blockIndex = 0;
+    int lastKind = -1;
+    quint32 lastFill = 0;
+
+    while (true) {
+        if (canceled && *canceled) {
+            errorMessage = "扫描已取消";
+            return false;
+        }
+        qint64 n = file.read(buffer.get(), SCAN_BUFFER_SIZE);
+        if (n < 0) {
+            errorMessage = QString("读取分区文件失败: %1").arg(file.errorString());
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+
+        // 末尾不足一块的部分补零
+        qint64 padded = (n + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+        if (padded > n) {
+            std::memset(buffer.get() + n, 0, static_cast<size_t>(padded - n));
+        }
+
+        for (qint64 pos = 0; pos < padded; pos += BLOCK_SIZE, ++blockIndex) {
+            quint32 fill = 0;
+            BlockKind kind = scanner.classify(blockIndex, buffer.get() + pos, fill);
+            switch (kind) {
+            case DataBlock:
+                ++result.dataBlocks;
+                break;
+            case FillBlock:
+                ++result.fillBlocks;
+                break;
+            case UnusedBlock:
+                ++result.unusedBlocks;
+                break;
+            }
+
+            // 相邻同类块合并为一个chunk（填充值不同则拆分）
+            if (kind != lastKind || (kind == FillBlock && fill != lastFill)) {
+                ++result.chunkCount;
+            }
+            lastKind = kind;
+            lastFill = fill;
+        }
+    }
+
+    result.totalBlocks = blockIndex;
+    return true;
+}
+
+bool FlashPayloadScanner::isZeroBlock(const char* data, qint64 length)
+{
+    quint32 value = 0;
+    return isUniformBlock(data, length, value) && value == 0;
+}
+
+bool FlashPayloadScanner::isUniformBlock(const char* data, qint64 length, quint32& value)
+{
+    if (length < static_cast<qint64>(sizeof(quint32))) {
+        value = 0;
+        for (qint64 i = 0; i < length; ++i) {
+            if (data[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::memcpy(&value, data, sizeof(value));
+    qint64 pos = 0;
+
+#if defined(__SSE2__)
+    // 每次比较64字节，四路异或结果合并后统一判断
+    const __m128i pattern = _mm_set1_epi32(static_cast<int>(value));
+    for (; pos + 64 <= length; pos += 64) {
+        __m128i a = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)), pattern);
+        __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 16)), pattern);
+        __m128i c = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 32)), pattern);
+        __m128i d = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 48)), pattern);
+        __m128i diff = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF) {
+            return false;
+        }
+    }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    const uint32x4_t pattern = vdupq_n_u32(value);
+    for (; pos + 64 <= length; pos += 64) {
+        const uint32_t* p = reinterpret_cast<const uint32_t*>(data + pos);
+        uint32x4_t a = veorq_u32(vld1q_u32(p), pattern);
+        uint32x4_t b = veorq_u32(vld1q_u32(p + 4), pattern);
+        uint32x4_t c = veorq_u32(vld1q_u32(p + 8), pattern);
+        uint32x4_t d = veorq_u32(vld1q_u32(p + 12), pattern);
+        if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) != 0) {
+            return false;
+        }
+    }
+#endif
+
+    // 剩余部分按8字节比较，尾部逐个32位值比较
+    const quint64 pattern64 = (static_cast<quint64>(value) << 32) | value;
+    for (; pos + 8 <= length; pos += 8) {
+        quint64 word;
+        std::memcpy(&word, data + pos, sizeof(word));
+        if (word != pattern64) {
+            return false;
+        }
+    }
+    for (; pos + 4 <= length; pos += 4) {
+        quint32 word;
+        std::memcpy(&word, data + pos, sizeof(word));
+        if (word != value) {
+            return false;
+        }
+    }
+    // 不足4字节的尾部只接受全零
+    for (; pos < length; ++pos) {
+        if (data[pos] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef FLASHPAYLOADSCANNER_H
+#define FLASHPAYLOADSCANNER_H
+
+#include <QString>
+#include <QBitArray>
+#include <atomic>
+
+// 分区数据文件的块统计（块大小与sparse格式一致，4KB）
+struct PayloadScanResult {
+    QString filePath;
+    quint64 fileBytes;
+    quint32 totalBlocks;
+    quint32 dataBlocks;       // 需要实际写入的数据块
+    quint32 fillBlocks;       // 整块为同一个32位值（含全零），用FILL chunk描述
+    quint32 unusedBlocks;     // ext4 位图中未分配的块，用DONT_CARE chunk描述
+    int chunkCount;           // 生成sparse描述时的chunk数量
+    bool ext4;
+
+    double dataRatio() const;     // 有效数据占比（百分比）
+    quint64 sparseBytes() const;  // 以sparse格式下载时需要传输的字节数
+    QString summary() const;
+};
+
+// 分区数据扫描：ext4 镜像按块位图识别未分配块，其余按块检测全零/重复填充
+class FlashPayloadScanner
+{
+public:
+    enum BlockKind {
+        DataBlock = 0,
+        FillBlock,
+        UnusedBlock
+    };
+
+    FlashPayloadScanner();
+
+    // 打开数据文件；若为ext4镜像则读取块位图
+    bool open(const QString& filePath, QString& errorMessage);
+
+    bool isExt4() const;
+    quint64 fileBytes() const;
+
+    // data 为第 blockIndex 块的完整内容（BLOCK_SIZE字节，末块已补零）
+    BlockKind classify(quint32 blockIndex, const char* data, quint32& fillValue) const;
+
+    // 扫描整个文件并统计各类块
+    static bool scan(const QString& filePath, PayloadScanResult& result, QString& errorMessage,
+                     const std::atomic<bool>* canceled = nullptr);
+
+    static bool isZeroBlock(const char* data, qint64 length);
+    // 整块是否为同一个32位值，value 返回该值（按内存字节序）
+    static bool isUniformBlock(const char* data, qint64 length, quint32& value);
+
+    static constexpr quint32 BLOCK_SIZE = 4096;
+    static constexpr qint64 SCAN_BUFFER_SIZE = 4 * 1024 * 1024;
+
+private:
+    bool loadExt4Bitmap(const QString& filePath);
+
+    quint64 m_fileBytes;
+    bool m_ext4;
+    QBitArray m_unusedBlocks;   // 按4KB块索引，置位表示ext4未分配
+};
+
+#endif // FLASHPAYLOADSCANNER_H
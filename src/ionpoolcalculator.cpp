@@ -0,0 +1,243 @@
+#include "ionpoolcalculator.h"
+#include <QSettings>
+#include <QStringList>
+#include <algorithm>
+
+VideoPipelineConfig VideoPipelineConfig::defaultConfig()
+{
+    // 默认：单路 1080p30 RAW12，主码流 H265 + 子码流 H264
+    VideoPipelineConfig config;
+    config.sensorWidth = 1920;
+    config.sensorHeight = 1080;
+    config.rawBits = 12;
+    config.fps = 30;
+    config.viChannels = 1;
+    config.viBufferDepth = 3;
+    config.ispNr3d = true;
+    config.ispLdc = false;
+    config.vpssChannels = 2;
+    config.vpssWidth = 1920;
+    config.vpssHeight = 1080;
+    config.vpssBufferDepth = 2;
+    config.encoders = {
+        {"H265", 1920, 1080, 30, 2048, 1},
+        {"H264", 720, 576, 30, 512, 1}
+    };
+    config.marginPercent = 10;
+    config.runOnRtos = false;
+    return config;
+}
+
+VideoPipelineConfig VideoPipelineConfig::load()
+{
+    VideoPipelineConfig defaults = defaultConfig();
+    VideoPipelineConfig config = defaults;
+
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.beginGroup("IonCalculator");
+    config.sensorWidth = settings.value("sensorWidth", defaults.sensorWidth).toInt();
+    config.sensorHeight = settings.value("sensorHeight", defaults.sensorHeight).toInt();
+    config.rawBits = settings.value("rawBits", defaults.rawBits).toInt();
+    config.fps = settings.value("fps", defaults.fps).toInt();
+    config.viChannels = settings.value("viChannels", defaults.viChannels).toInt();
+    config.viBufferDepth = settings.value("viBufferDepth", defaults.viBufferDepth).toInt();
+    config.ispNr3d = settings.value("ispNr3d", defaults.ispNr3d).toBool();
+    config.ispLdc = settings.value("ispLdc", defaults.ispLdc).toBool();
+    config.vpssChannels = settings.value("vpssChannels", defaults.vpssChannels).toInt();
+    config.vpssWidth = settings.value("vpssWidth", defaults.vpssWidth).toInt();
+    config.vpssHeight = settings.value("vpssHeight", defaults.vpssHeight).toInt();
+    config.vpssBufferDepth = settings.value("vpssBufferDepth", defaults.vpssBufferDepth).toInt();
+    config.marginPercent = settings.value("marginPercent", defaults.marginPercent).toInt();
+    config.runOnRtos = settings.value("runOnRtos", defaults.runOnRtos).toBool();
+
+    if (settings.contains("encoders/size")) {
+        config.encoders.clear();
+        int count = settings.beginReadArray("encoders");
+        for (int i = 0; i < count; ++i) {
+            settings.setArrayIndex(i);
+            VideoEncoderProfile profile;
+            profile.codec = settings.value("codec", "H264").toString();
+            profile.width = settings.value("width", 1920).toInt();
+            profile.height = settings.value("height", 1080).toInt();
+            profile.fps = settings.value("fps", 30).toInt();
+            profile.bitrateKbps = settings.value("bitrateKbps", 2048).toInt();
+            profile.refFrames = settings.value("refFrames", 1).toInt();
+            config.encoders.append(profile);
+        }
+        settings.endArray();
+    }
+    settings.endGroup();
+
+    return config;
+}
+
+void VideoPipelineConfig::save() const
+{
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.beginGroup("IonCalculator");
+    settings.setValue("sensorWidth", sensorWidth);
+    settings.setValue("sensorHeight", sensorHeight);
+    settings.setValue("rawBits", rawBits);
+    settings.setValue("fps", fps);
+    settings.setValue("viChannels", viChannels);
+    settings.setValue("viBufferDepth", viBufferDepth);
+    settings.setValue("ispNr3d", ispNr3d);
+    settings.setValue("ispLdc", ispLdc);
+    settings.setValue("vpssChannels", vpssChannels);
+    settings.setValue("vpssWidth", vpssWidth);
+    settings.setValue("vpssHeight", vpssHeight);
+    settings.setValue("vpssBufferDepth", vpssBufferDepth);
+    settings.setValue("marginPercent", marginPercent);
+    settings.setValue("runOnRtos", runOnRtos);
+
+    settings.remove("encoders");
+    settings.beginWriteArray("encoders", encoders.size());
+    for (int i = 0; i < encoders.size(); ++i) {
+        settings.setArrayIndex(i);
+        const VideoEncoderProfile& profile = encoders[i];
+        settings.setValue("codec", profile.codec);
+        settings.setValue("width", profile.width);
+        settings.setValue("height", profile.height);
+        settings.setValue("fps", profile.fps);
+        settings.setValue("bitrateKbps", profile.bitrateKbps);
+        settings.setValue("refFrames", profile.refFrames);
+    }
+    settings.endArray();
+    settings.endGroup();
+}
+
+quint64 IonPoolRequirement::ispRegionSize() const
+{
+    return IonPoolCalculator::alignUp(ispBytes, IonPoolCalculator::STREAM_ALIGN);
+}
+
+quint64 IonPoolRequirement::bitstreamRegionSize() const
+{
+    return IonPoolCalculator::alignUp(bitstreamBytes, IonPoolCalculator::STREAM_ALIGN);
+}
+
+quint64 IonPoolRequirement::encBuffRegionSize() const
+{
+    return IonPoolCalculator::alignUp(encBuffBytes, IonPoolCalculator::STREAM_ALIGN);
+}
+
+QString IonPoolRequirement::breakdown() const
+{
+    QStringList lines;
+    lines << QString("VI RAW缓冲:     %1").arg(IonPoolCalculator::formatBytes(viBytes));
+    lines << QString("ISP工作缓冲:    %1").arg(IonPoolCalculator::formatBytes(ispBytes));
+    lines << QString("VPSS输出缓冲:   %1").arg(IonPoolCalculator::formatBytes(vpssBytes));
+    lines << QString("编码码流缓冲:   %1").arg(IonPoolCalculator::formatBytes(bitstreamBytes));
+    lines << QString("编码参考帧缓冲: %1").arg(IonPoolCalculator::formatBytes(encBuffBytes));
+    lines << QString("预留余量:       %1").arg(IonPoolCalculator::formatBytes(marginBytes));
+    lines << QString("ION总需求(1M对齐): %1 (0x%2)")
+                 .arg(IonPoolCalculator::formatBytes(totalBytes))
+                 .arg(totalBytes, 0, 16);
+    return lines.join("\n");
+}
+
+quint64 IonPoolCalculator::alignUp(quint64 value, quint64 alignment)
+{
+    if (alignment == 0) {
+        return value;
+    }
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+quint64 IonPoolCalculator::yuv420FrameSize(int width, int height)
+{
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+    // Y 平面 stride*h，UV 平面 stride*h/2
+    quint64 stride = alignUp(static_cast<quint64>(width), VB_ALIGN);
+    return stride * static_cast<quint64>(height) * 3 / 2;
+}
+
+quint64 IonPoolCalculator::rawFrameSize(int width, int height, int bits)
+{
+    if (width <= 0 || height <= 0 || bits <= 0) {
+        return 0;
+    }
+    // RAW 数据紧凑排列，行跨度按 VB_ALIGN 对齐
+    quint64 lineBytes = (static_cast<quint64>(width) * bits + 7) / 8;
+    return alignUp(lineBytes, VB_ALIGN) * static_cast<quint64>(height);
+}
+
+int IonPoolCalculator::framesInFlight(int fps, int latencyMs)
+{
+    if (fps <= 0 || latencyMs <= 0) {
+        return 0;
+    }
+    return (fps * latencyMs + 999) / 1000;
+}
+
+IonPoolRequirement IonPoolCalculator::calculate(const VideoPipelineConfig& config)
+{
+    IonPoolRequirement result = {0, 0, 0, 0, 0, 0, 0};
+
+    const int viChannels = std::max(0, config.viChannels);
+
+    // VI：每路sensor的RAW缓冲块，至少覆盖ISP处理延迟内到达的帧再加一块正在写入的
+    const int viDepth = std::max(std::max(0, config.viBufferDepth), framesInFlight(config.fps, ISP_LATENCY_MS) + 1);
+    result.viBytes = rawFrameSize(config.sensorWidth, config.sensorHeight, config.rawBits) *
+                     viChannels * viDepth;
+
+    // ISP：统计缓冲 + 3DNR 参考帧/运动信息 + LDC 工作帧
+    quint64 sensorYuv = yuv420FrameSize(config.sensorWidth, config.sensorHeight);
+    quint64 ispPerChannel = ISP_STATS_PER_CHANNEL;
+    if (config.ispNr3d) {
+        quint64 motionBytes = static_cast<quint64>(std::max(0, config.sensorWidth)) *
+                              std::max(0, config.sensorHeight) / 4;
+        ispPerChannel += sensorYuv + motionBytes;
+    }
+    if (config.ispLdc) {
+        ispPerChannel += sensorYuv;
+    }
+    result.ispBytes = ispPerChannel * viChannels;
+
+    // VPSS：每个输出通道的YUV缓冲块
+    result.vpssBytes = yuv420FrameSize(config.vpssWidth, config.vpssHeight) *
+                       std::max(0, config.vpssChannels) * std::max(0, config.vpssBufferDepth);
+
+    // VENC：码流缓冲 + 重构/参考帧缓冲
+    for (const VideoEncoderProfile& profile : config.encoders) {
+        quint64 frameBytes = yuv420FrameSize(profile.width, profile.height);
+        bool isJpeg = profile.codec.compare("JPEG", Qt::CaseInsensitive) == 0;
+
+        // JPEG 每帧独立输出，码流缓冲需容纳应用取流间隔内编出的帧
+        quint64 streamBytes = frameBytes / 2 * std::max(1, framesInFlight(profile.fps, STREAM_DRAIN_MS));
+        if (!isJpeg) {
+            quint64 rateBytes = static_cast<quint64>(std::max(0, profile.bitrateKbps)) * 1000 / 8 *
+                                BITSTREAM_SECONDS;
+            streamBytes = std::max(streamBytes, rateBytes);
+        }
+        result.bitstreamBytes += alignUp(streamBytes, STREAM_ALIGN);
+
+        if (!isJpeg) {
+            // H.265 CTU 为64x64，H.264 宏块为16x16，统一按64对齐宽高
+            quint64 alignedFrame = yuv420FrameSize(static_cast<int>(alignUp(profile.width, 64)),
+                                                   static_cast<int>(alignUp(profile.height, 64)));
+            // 重构帧 + 参考帧，另加约1/4帧的MV/压缩信息
+            quint64 frames = static_cast<quint64>(std::max(0, profile.refFrames)) + 1;
+            result.encBuffBytes += frames * (alignedFrame + alignedFrame / 4);
+        }
+    }
+
+    quint64 subtotal = result.viBytes + result.ispBytes + result.vpssBytes +
+                       result.bitstreamBytes + result.encBuffBytes;
+    result.marginBytes = subtotal * static_cast<quint64>(std::max(0, config.marginPercent)) / 100;
+    result.totalBytes = alignUp(subtotal + result.marginBytes, ION_ALIGN);
+
+    return result;
+}
+
+QString IonPoolCalculator::formatBytes(quint64 bytes)
+{
+    if (bytes >= 1024 * 1024) {
+        return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 2);
+    } else if (bytes >= 1024) {
+        return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+    }
+    return QString("%1 B").arg(bytes);
+}
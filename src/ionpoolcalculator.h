@@ -0,0 +1,81 @@
+#ifndef IONPOOLCALCULATOR_H
+#define IONPOOLCALCULATOR_H
+
+#include <QString>
+#include <QList>
+
+// 编码通道配置
+struct VideoEncoderProfile {
+    QString codec;          // H264 / H265 / JPEG
+    int width;
+    int height;
+    int fps;
+    int bitrateKbps;
+    int refFrames;          // 参考帧数量（JPEG忽略）
+};
+
+// 视频管线配置：VI -> ISP -> VPSS -> VENC
+struct VideoPipelineConfig {
+    int sensorWidth;
+    int sensorHeight;
+    int rawBits;            // RAW10 / RAW12
+    int fps;
+    int viChannels;         // 接入的sensor数量
+    int viBufferDepth;      // 每个VI通道的RAW缓冲块数
+    bool ispNr3d;           // 3DNR 需要额外的参考帧与运动信息
+    bool ispLdc;            // LDC 需要一帧YUV工作缓冲
+    int vpssChannels;       // 所有VPSS输出通道总数
+    int vpssWidth;
+    int vpssHeight;
+    int vpssBufferDepth;
+    QList<VideoEncoderProfile> encoders;
+    int marginPercent;      // 碎片/对齐预留
+    bool runOnRtos;         // 管线运行在小核RTOS上时，结果写入RTOS_ION
+
+    static VideoPipelineConfig defaultConfig();
+    // 从 QSettings 的 "IonCalculator" 分组读写
+    static VideoPipelineConfig load();
+    void save() const;
+};
+
+// ION 缓冲池需求计算结果（字节）
+struct IonPoolRequirement {
+    quint64 viBytes;
+    quint64 ispBytes;
+    quint64 vpssBytes;
+    quint64 bitstreamBytes;
+    quint64 encBuffBytes;
+    quint64 marginBytes;
+    quint64 totalBytes;     // 已按1M对齐，直接作为 ION/RTOS_ION 大小
+
+    quint64 ispRegionSize() const;        // ISP_MEM_BASE 对应大小
+    quint64 bitstreamRegionSize() const;  // H26X_BITSTREAM 对应大小
+    quint64 encBuffRegionSize() const;    // H26X_ENC_BUFF 对应大小
+    QString breakdown() const;
+};
+
+// 按 CVI VB 公共池的计算方式估算各模块需要的缓冲块
+class IonPoolCalculator
+{
+public:
+    static IonPoolRequirement calculate(const VideoPipelineConfig& config);
+
+    // 单帧大小（行跨度按 VB_ALIGN 对齐）
+    static quint64 yuv420FrameSize(int width, int height);
+    static quint64 rawFrameSize(int width, int height, int bits);
+    static quint64 alignUp(quint64 value, quint64 alignment);
+    // 给定帧率下，latencyMs 时间内到达的帧数（向上取整）
+    static int framesInFlight(int fps, int latencyMs);
+
+    static QString formatBytes(quint64 bytes);
+
+    static constexpr quint64 VB_ALIGN = 64;                   // VB 默认行跨度对齐
+    static constexpr quint64 ION_ALIGN = 0x100000;            // ION 大小按1M对齐
+    static constexpr quint64 STREAM_ALIGN = 0x1000;           // 码流缓冲按4K对齐
+    static constexpr quint64 ISP_STATS_PER_CHANNEL = 0x100000; // AE/AWB/AF统计及参数
+    static constexpr int BITSTREAM_SECONDS = 2;               // 码流缓冲至少容纳2秒数据
+    static constexpr int ISP_LATENCY_MS = 50;                 // ISP处理延迟，决定VI缓冲块下限
+    static constexpr int STREAM_DRAIN_MS = 100;               // 应用取流间隔，决定JPEG码流缓冲帧数
+};
+
+#endif // IONPOOLCALCULATOR_H
@@ -0,0 +1,341 @@
+#include "ionpooldialog.h"
+#include <QHeaderView>
+#include <QFont>
+#include <QDebug>
+
+IonPoolCalculatorDialog::IonPoolCalculatorDialog(const VideoPipelineConfig& config, QWidget *parent)
+    : QDialog(parent)
+    , m_sensorWidthSpin(nullptr)
+    , m_sensorHeightSpin(nullptr)
+    , m_rawBitsCombo(nullptr)
+    , m_fpsSpin(nullptr)
+    , m_viChannelsSpin(nullptr)
+    , m_viDepthSpin(nullptr)
+    , m_nr3dCheck(nullptr)
+    , m_ldcCheck(nullptr)
+    , m_vpssChannelsSpin(nullptr)
+    , m_vpssWidthSpin(nullptr)
+    , m_vpssHeightSpin(nullptr)
+    , m_vpssDepthSpin(nullptr)
+    , m_encoderTable(nullptr)
+    , m_addEncoderButton(nullptr)
+    , m_removeEncoderButton(nullptr)
+    , m_marginSpin(nullptr)
+    , m_rtosCheck(nullptr)
+    , m_resultText(nullptr)
+    , m_resetButton(nullptr)
+    , m_applyButton(nullptr)
+    , m_cancelButton(nullptr)
+    , m_loading(false)
+{
+    setupUI();
+    loadConfig(config);
+}
+
+QSpinBox* IonPoolCalculatorDialog::createSpinBox(int minimum, int maximum, int step)
+{
+    QSpinBox* spinBox = new QSpinBox(this);
+    spinBox->setRange(minimum, maximum);
+    spinBox->setSingleStep(step);
+    connect(spinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &IonPoolCalculatorDialog::onInputChanged);
+    return spinBox;
+}
+
+void IonPoolCalculatorDialog::setupUI()
+{
+    setWindowTitle("ION 容量计算");
+    setMinimumSize(640, 640);
+    setModal(true);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    // VI / ISP 配置
+    QGroupBox* viGroup = new QGroupBox("Sensor / VI / ISP", this);
+    QGridLayout* viLayout = new QGridLayout(viGroup);
+
+    m_sensorWidthSpin = createSpinBox(64, 8192, 2);
+    m_sensorHeightSpin = createSpinBox(64, 8192, 2);
+    m_rawBitsCombo = new QComboBox(this);
+    m_rawBitsCombo->addItem("RAW10", 10);
+    m_rawBitsCombo->addItem("RAW12", 12);
+    connect(m_rawBitsCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &IonPoolCalculatorDialog::onInputChanged);
+    m_fpsSpin = createSpinBox(1, 240);
+    m_viChannelsSpin = createSpinBox(0, 4);
+    m_viDepthSpin = createSpinBox(1, 16);
+    m_nr3dCheck = new QCheckBox("3DNR", this);
+    m_ldcCheck = new QCheckBox("LDC 畸变校正", this);
+    connect(m_nr3dCheck, &QCheckBox::toggled, this, &IonPoolCalculatorDialog::onInputChanged);
+    connect(m_ldcCheck, &QCheckBox::toggled, this, &IonPoolCalculatorDialog::onInputChanged);
+
+    viLayout->addWidget(new QLabel("分辨率:", this), 0, 0);
+    QHBoxLayout* sensorSizeLayout = new QHBoxLayout();
+    sensorSizeLayout->addWidget(m_sensorWidthSpin);
+    sensorSizeLayout->addWidget(new QLabel("x", this));
+    sensorSizeLayout->addWidget(m_sensorHeightSpin);
+    viLayout->addLayout(sensorSizeLayout, 0, 1);
+    viLayout->addWidget(new QLabel("RAW格式:", this), 1, 0);
+    viLayout->addWidget(m_rawBitsCombo, 1, 1);
+    viLayout->addWidget(new QLabel("帧率:", this), 2, 0);
+    viLayout->addWidget(m_fpsSpin, 2, 1);
+    viLayout->addWidget(new QLabel("VI通道数:", this), 3, 0);
+    viLayout->addWidget(m_viChannelsSpin, 3, 1);
+    viLayout->addWidget(new QLabel("VI缓冲块数:", this), 4, 0);
+    viLayout->addWidget(m_viDepthSpin, 4, 1);
+    QHBoxLayout* ispLayout = new QHBoxLayout();
+    ispLayout->addWidget(m_nr3dCheck);
+    ispLayout->addWidget(m_ldcCheck);
+    viLayout->addWidget(new QLabel("ISP:", this), 5, 0);
+    viLayout->addLayout(ispLayout, 5, 1);
+
+    // VPSS 配置
+    QGroupBox* vpssGroup = new QGroupBox("VPSS", this);
+    QGridLayout* vpssLayout = new QGridLayout(vpssGroup);
+
+    m_vpssChannelsSpin = createSpinBox(0, 16);
+    m_vpssWidthSpin = createSpinBox(64, 8192, 2);
+    m_vpssHeightSpin = createSpinBox(64, 8192, 2);
+    m_vpssDepthSpin = createSpinBox(1, 16);
+
+    vpssLayout->addWidget(new QLabel("输出通道数:", this), 0, 0);
+    vpssLayout->addWidget(m_vpssChannelsSpin, 0, 1);
+    vpssLayout->addWidget(new QLabel("输出分辨率:", this), 1, 0);
+    QHBoxLayout* vpssSizeLayout = new QHBoxLayout();
+    vpssSizeLayout->addWidget(m_vpssWidthSpin);
+    vpssSizeLayout->addWidget(new QLabel("x", this));
+    vpssSizeLayout->addWidget(m_vpssHeightSpin);
+    vpssLayout->addLayout(vpssSizeLayout, 1, 1);
+    vpssLayout->addWidget(new QLabel("每通道缓冲块数:", this), 2, 0);
+    vpssLayout->addWidget(m_vpssDepthSpin, 2, 1);
+
+    // VENC 配置
+    QGroupBox* vencGroup = new QGroupBox("编码通道", this);
+    QVBoxLayout* vencLayout = new QVBoxLayout(vencGroup);
+
+    m_encoderTable = new QTableWidget(0, 6, this);
+    m_encoderTable->setHorizontalHeaderLabels({"编码类型", "宽", "高", "帧率", "码率(kbps)", "参考帧"});
+    m_encoderTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_encoderTable->verticalHeader()->setVisible(false);
+    m_encoderTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_encoderTable->setSelectionMode(QAbstractItemView::SingleSelection);
+
+    QHBoxLayout* encoderButtonLayout = new QHBoxLayout();
+    m_addEncoderButton = new QPushButton("添加编码通道", this);
+    m_removeEncoderButton = new QPushButton("删除编码通道", this);
+    encoderButtonLayout->addWidget(m_addEncoderButton);
+    encoderButtonLayout->addWidget(m_removeEncoderButton);
+    encoderButtonLayout->addStretch();
+
+    vencLayout->addWidget(m_encoderTable);
+    vencLayout->addLayout(encoderButtonLayout);
+
+    // 其他选项
+    QGroupBox* optionGroup = new QGroupBox("选项", this);
+    QGridLayout* optionLayout = new QGridLayout(optionGroup);
+    m_marginSpin = createSpinBox(0, 100);
+    m_marginSpin->setSuffix(" %");
+    m_rtosCheck = new QCheckBox("视频管线运行在小核RTOS上（结果写入 RTOS_ION）", this);
+    connect(m_rtosCheck, &QCheckBox::toggled, this, &IonPoolCalculatorDialog::onInputChanged);
+    optionLayout->addWidget(new QLabel("预留余量:", this), 0, 0);
+    optionLayout->addWidget(m_marginSpin, 0, 1);
+    optionLayout->addWidget(m_rtosCheck, 1, 0, 1, 2);
+
+    // 计算结果
+    m_resultText = new QTextEdit(this);
+    m_resultText->setReadOnly(true);
+    m_resultText->setFont(QFont("Consolas", 9));
+    m_resultText->setMaximumHeight(150);
+
+    // 按钮
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    m_resetButton = new QPushButton("恢复默认", this);
+    m_applyButton = new QPushButton("应用到内存布局", this);
+    m_cancelButton = new QPushButton("取消", this);
+    buttonLayout->addWidget(m_resetButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_applyButton);
+    buttonLayout->addWidget(m_cancelButton);
+
+    QHBoxLayout* topLayout = new QHBoxLayout();
+    topLayout->addWidget(viGroup);
+    topLayout->addWidget(vpssGroup);
+
+    mainLayout->addLayout(topLayout);
+    mainLayout->addWidget(vencGroup);
+    mainLayout->addWidget(optionGroup);
+    mainLayout->addWidget(new QLabel("计算结果:", this));
+    mainLayout->addWidget(m_resultText);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(m_addEncoderButton, &QPushButton::clicked, this, &IonPoolCalculatorDialog::onAddEncoder);
+    connect(m_removeEncoderButton, &QPushButton::clicked, this, &IonPoolCalculatorDialog::onRemoveEncoder);
+    connect(m_resetButton, &QPushButton::clicked, this, &IonPoolCalculatorDialog::onResetDefaults);
+    connect(m_applyButton, &QPushButton::clicked, this, &IonPoolCalculatorDialog::onApply);
+    connect(m_cancelButton, &QPushButton::clicked, this, &QDialog::reject);
+}
+
+void IonPoolCalculatorDialog::loadConfig(const VideoPipelineConfig& config)
+{
+    m_loading = true;
+
+    m_sensorWidthSpin->setValue(config.sensorWidth);
+    m_sensorHeightSpin->setValue(config.sensorHeight);
+    int rawIndex = m_rawBitsCombo->findData(config.rawBits);
+    m_rawBitsCombo->setCurrentIndex(rawIndex >= 0 ? rawIndex : 1);
+    m_fpsSpin->setValue(config.fps);
+    m_viChannelsSpin->setValue(config.viChannels);
+    m_viDepthSpin->setValue(config.viBufferDepth);
+    m_nr3dCheck->setChecked(config.ispNr3d);
+    m_ldcCheck->setChecked(config.ispLdc);
+    m_vpssChannelsSpin->setValue(config.vpssChannels);
+    m_vpssWidthSpin->setValue(config.vpssWidth);
+    m_vpssHeightSpin->setValue(config.vpssHeight);
+    m_vpssDepthSpin->setValue(config.vpssBufferDepth);
+    m_marginSpin->setValue(config.marginPercent);
+    m_rtosCheck->setChecked(config.runOnRtos);
+
+    m_encoderTable->setRowCount(0);
+    for (const VideoEncoderProfile& profile : config.encoders) {
+        addEncoderRow(profile);
+    }
+
+    m_loading = false;
+    onInputChanged();
+}
+
+void IonPoolCalculatorDialog::addEncoderRow(const VideoEncoderProfile& profile)
+{
+    int row = m_encoderTable->rowCount();
+    m_encoderTable->insertRow(row);
+
+    QComboBox* codecCombo = new QComboBox(m_encoderTable);
+    codecCombo->addItems({"H264", "H265", "JPEG"});
+    int codecIndex = codecCombo->findText(profile.codec.toUpper());
+    codecCombo->setCurrentIndex(codecIndex >= 0 ? codecIndex : 0);
+    connect(codecCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &IonPoolCalculatorDialog::onInputChanged);
+    m_encoderTable->setCellWidget(row, 0, codecCombo);
+
+    struct Column {
+        int value;
+        int minimum;
+        int maximum;
+    };
+    const Column columns[] = {
+        {profile.width, 64, 8192},
+        {profile.height, 64, 8192},
+        {profile.fps, 1, 240},
+        {profile.bitrateKbps, 1, 100000},
+        {profile.refFrames, 0, 4}
+    };
+    for (int i = 0; i < 5; ++i) {
+        QSpinBox* spinBox = new QSpinBox(m_encoderTable);
+        spinBox->setRange(columns[i].minimum, columns[i].maximum);
+        spinBox->setValue(columns[i].value);
+        spinBox->setFrame(false);
+        connect(spinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+                this, &IonPoolCalculatorDialog::onInputChanged);
+        m_encoderTable->setCellWidget(row, i + 1, spinBox);
+    }
+}
+
+VideoPipelineConfig IonPoolCalculatorDialog::getConfig() const
+{
+    VideoPipelineConfig config;
+    config.sensorWidth = m_sensorWidthSpin->value();
+    config.sensorHeight = m_sensorHeightSpin->value();
+    config.rawBits = m_rawBitsCombo->currentData().toInt();
+    config.fps = m_fpsSpin->value();
+    config.viChannels = m_viChannelsSpin->value();
+    config.viBufferDepth = m_viDepthSpin->value();
+    config.ispNr3d = m_nr3dCheck->isChecked();
+    config.ispLdc = m_ldcCheck->isChecked();
+    config.vpssChannels = m_vpssChannelsSpin->value();
+    config.vpssWidth = m_vpssWidthSpin->value();
+    config.vpssHeight = m_vpssHeightSpin->value();
+    config.vpssBufferDepth = m_vpssDepthSpin->value();
+    config.marginPercent = m_marginSpin->value();
+    config.runOnRtos = m_rtosCheck->isChecked();
+
+    for (int row = 0; row < m_encoderTable->rowCount(); ++row) {
+        QComboBox* codecCombo = qobject_cast<QComboBox*>(m_encoderTable->cellWidget(row, 0));
+        auto spinValue = [this, row](int column) {
+            QSpinBox* spinBox = qobject_cast<QSpinBox*>(m_encoderTable->cellWidget(row, column));
+            return spinBox ? spinBox->value() : 0;
+        };
+
+        VideoEncoderProfile profile;
+        profile.codec = codecCombo ? codecCombo->currentText() : "H264";
+        profile.width = spinValue(1);
+        profile.height = spinValue(2);
+        profile.fps = spinValue(3);
+        profile.bitrateKbps = spinValue(4);
+        profile.refFrames = spinValue(5);
+        config.encoders.append(profile);
+    }
+
+    return config;
+}
+
+IonPoolRequirement IonPoolCalculatorDialog::getRequirement() const
+{
+    return IonPoolCalculator::calculate(getConfig());
+}
+
+void IonPoolCalculatorDialog::onInputChanged()
+{
+    if (m_loading) {
+        return;
+    }
+
+    IonPoolRequirement requirement = getRequirement();
+    QString target = m_rtosCheck->isChecked() ? "RTOS_ION" : "ION";
+
+    QString text = requirement.breakdown();
+    if (m_rtosCheck->isChecked()) {
+        // H26X/ISP 预留区固定在 ION 起始处，小核管线的缓冲全部从 RTOS_ION 分配
+        text += QString("\n\n应用后: %1 = %2（H26X/ISP 预留区需为0，否则拒绝应用）")
+                    .arg(target)
+                    .arg(IonPoolCalculator::formatBytes(requirement.totalBytes));
+    } else {
+        text += QString("\n\n应用后: %1 = %2，H26X_BITSTREAM = %3，H26X_ENC_BUFF = %4，ISP_MEM_BASE = %5")
+                    .arg(target)
+                    .arg(IonPoolCalculator::formatBytes(requirement.totalBytes))
+                    .arg(IonPoolCalculator::formatBytes(requirement.bitstreamRegionSize()))
+                    .arg(IonPoolCalculator::formatBytes(requirement.encBuffRegionSize()))
+                    .arg(IonPoolCalculator::formatBytes(requirement.ispRegionSize()));
+    }
+    m_resultText->setPlainText(text);
+}
+
+void IonPoolCalculatorDialog::onAddEncoder()
+{
+    addEncoderRow({"H264", m_vpssWidthSpin->value(), m_vpssHeightSpin->value(),
+                   m_fpsSpin->value(), 1024, 1});
+    onInputChanged();
+}
+
+void IonPoolCalculatorDialog::onRemoveEncoder()
+{
+    int row = m_encoderTable->currentRow();
+    if (row < 0) {
+        row = m_encoderTable->rowCount() - 1;
+    }
+    if (row >= 0) {
+        m_encoderTable->removeRow(row);
+        onInputChanged();
+    }
+}
+
+void IonPoolCalculatorDialog::onResetDefaults()
+{
+    loadConfig(VideoPipelineConfig::defaultConfig());
+}
+
+void IonPoolCalculatorDialog::onApply()
+{
+    getConfig().save();
+    qDebug() << "ION容量计算结果已应用:" << getRequirement().totalBytes;
+    accept();
+}
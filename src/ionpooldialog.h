@@ -0,0 +1,74 @@
+#ifndef IONPOOLDIALOG_H
+#define IONPOOLDIALOG_H
+
+#include <QDialog>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QLabel>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTextEdit>
+#include "ionpoolcalculator.h"
+
+// ION 容量计算对话框：根据视频管线配置实时计算 ION 缓冲池需求
+class IonPoolCalculatorDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit IonPoolCalculatorDialog(const VideoPipelineConfig& config, QWidget *parent = nullptr);
+
+    VideoPipelineConfig getConfig() const;
+    IonPoolRequirement getRequirement() const;
+
+private slots:
+    void onInputChanged();
+    void onAddEncoder();
+    void onRemoveEncoder();
+    void onResetDefaults();
+    void onApply();
+
+private:
+    void setupUI();
+    void loadConfig(const VideoPipelineConfig& config);
+    void addEncoderRow(const VideoEncoderProfile& profile);
+    QSpinBox* createSpinBox(int minimum, int maximum, int step = 1);
+
+    // VI / ISP
+    QSpinBox* m_sensorWidthSpin;
+    QSpinBox* m_sensorHeightSpin;
+    QComboBox* m_rawBitsCombo;
+    QSpinBox* m_fpsSpin;
+    QSpinBox* m_viChannelsSpin;
+    QSpinBox* m_viDepthSpin;
+    QCheckBox* m_nr3dCheck;
+    QCheckBox* m_ldcCheck;
+
+    // VPSS
+    QSpinBox* m_vpssChannelsSpin;
+    QSpinBox* m_vpssWidthSpin;
+    QSpinBox* m_vpssHeightSpin;
+    QSpinBox* m_vpssDepthSpin;
+
+    // VENC
+    QTableWidget* m_encoderTable;
+    QPushButton* m_addEncoderButton;
+    QPushButton* m_removeEncoderButton;
+
+    QSpinBox* m_marginSpin;
+    QCheckBox* m_rtosCheck;
+    QTextEdit* m_resultText;
+
+    QPushButton* m_resetButton;
+    QPushButton* m_applyButton;
+    QPushButton* m_cancelButton;
+
+    bool m_loading;
+};
+
+#endif // IONPOOLDIALOG_H
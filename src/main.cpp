@@ -1,12 +1,53 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <cstring>
 #include "mainwindow.h"
+#include "configdaemon.h"
+
+// 守护进程模式：CviCubeMX --daemon [--source <SDK路径>] [--board <板子>] [--socket <名称>]
+static int runDaemon(QApplication &app)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CviCubeMX 配置守护进程，通过本地套接字提供 JSON-RPC 查询");
+    parser.addHelpOption();
+    QCommandLineOption daemonOption("daemon", "以守护进程模式运行");
+    QCommandLineOption sourceOption("source", "SDK源码路径（默认使用界面上次打开的路径）", "path");
+    QCommandLineOption boardOption("board", "板子名称", "board");
+    QCommandLineOption socketOption("socket", "本地套接字名称", "name");
+    parser.addOptions({daemonOption, sourceOption, boardOption, socketOption});
+    parser.process(app);
+
+    ConfigDaemon daemon;
+    if (!daemon.start(parser.value(sourceOption), parser.value(boardOption), parser.value(socketOption))) {
+        QTextStream(stderr) << "无法启动守护进程：本地套接字已被占用或无法创建\n";
+        return 1;
+    }
+    return app.exec();
+}
 
 int main(int argc, char *argv[])
 {
+    bool daemonMode = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--daemon") == 0) {
+            daemonMode = true;
+        }
+    }
+
+    // 守护进程不显示窗口，无显示环境下也能运行
+    if (daemonMode && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication app(argc, argv);
-    
+
+    if (daemonMode) {
+        return runDaemon(app);
+    }
+
     MainWindow window;
     window.show();
-    
+
     return app.exec();
 }
@@ -1,6 +1,9 @@
 #include "mainwindow.h"
 #include "peripheralconfigdialog.h"
 #include "aichatdialog.h"
+#include "artifactcache.h"
+#include "defconfigindex.h"
+#include "rpcserver.h"
 #include <QApplication>
 #include <QScreen>
 #include <QTimer>
@@ -11,12 +14,13 @@
 #include <QMenu>
 #include <QAction>
 #include <QCheckBox>
-#include <QFile>
-#include <QTextStream>
 #include <QDir>
+#include <QFileInfo>
 #include <QDebug>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QInputDialog>
+#include <QStatusBar>
 #include <cmath>
 
 MainWindow::MainWindow(QWidget *parent)
@@ -28,6 +32,9 @@ MainWindow::MainWindow(QWidget *parent)
     , m_menuBar(nullptr)
     , m_toolsMenu(nullptr)
     , m_aiChatAction(nullptr)
+    , m_bootTimeBudgetAction(nullptr)
+    , m_ddrBandwidthAction(nullptr)
+    , m_daemonClientAction(nullptr)
     , m_configTabWidget(nullptr)
     , m_pinoutTab(nullptr)
     , m_clockTab(nullptr)
@@ -43,6 +50,11 @@ MainWindow::MainWindow(QWidget *parent)
     , m_chipComboBox(nullptr)
     , m_startProjectButton(nullptr)
     , m_generateCodeButton(nullptr)
+    , m_bootTimeLabel(nullptr)
+    , m_ddrBandwidthLabel(nullptr)
+    , m_clockGatingLabel(nullptr)
+    , m_ioProgressBar(nullptr)
+    , m_ioCancelButton(nullptr)
     , m_stackedWidget(nullptr)
     , m_welcomePage(nullptr)
     , m_chipViewPage(nullptr)
@@ -57,9 +69,28 @@ MainWindow::MainWindow(QWidget *parent)
     , m_blinkTimer(nullptr)
     , m_highlightedPin(nullptr)
     , m_blinkState(false)
+    , m_peripheralStatesLoading(false)
     , m_dtsConfig(nullptr)
+    , m_sdkIndexer(nullptr)
+    , m_artifactWatcher(nullptr)
     , m_aiChatDialog(nullptr)
+    , m_aiKnowledge(nullptr)
+    , m_aiKnowledgeTimer(nullptr)
+    , m_daemonClient(nullptr)
 {
+    m_sdkIndexer = new SdkIndexer(this);
+    m_artifactWatcher = new ArtifactWatcher(this);
+    connect(m_artifactWatcher, &ArtifactWatcher::fileChanged, this, &MainWindow::onArtifactChanged);
+
+    // AI助手知识库：内置文档在后台建立索引，工程状态变化后延迟更新
+    m_aiKnowledge = new AIKnowledgeBase(this);
+    m_aiKnowledge->setDocuments("docs", AIKnowledgeBase::builtinDocuments());
+    m_aiKnowledgeTimer = new QTimer(this);
+    m_aiKnowledgeTimer->setSingleShot(true);
+    m_aiKnowledgeTimer->setInterval(1000);
+    connect(m_aiKnowledgeTimer, &QTimer::timeout, this, &MainWindow::updateAIKnowledge);
+    setupAITools();
+
     // 首先显示路径选择对话框（会自动加载上次的路径供用户确认）
     if (!selectSourcePath()) {
         // 如果用户取消选择路径，关闭应用程序
@@ -105,6 +136,9 @@ void MainWindow::setupUI()
 {
     // 设置菜单栏
     setupMenuBar();
+
+    // 设置状态栏（后台文件读写进度）
+    setupStatusBar();
     
     // 创建中央部件
     m_centralWidget = new QWidget(this);
@@ -168,6 +202,9 @@ void MainWindow::setupUI()
     // 连接信号和槽
     connect(m_chipComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::onChipSelectionChanged);
+    connect(m_sdkIndexer, &SdkIndexer::catalogChanged, this, [this]() {
+        populateBoardList(m_chipComboBox, true);
+    });
     connect(m_startProjectButton, &QPushButton::clicked, this, &MainWindow::onStartProject);
     connect(m_generateCodeButton, &QPushButton::clicked, this, &MainWindow::onGenerateCode);
     connect(m_searchLineEdit, &QLineEdit::textChanged, this, &MainWindow::onSearchTextChanged);
@@ -176,6 +213,27 @@ void MainWindow::setupUI()
 
     // 连接时钟配置信号
     connect(m_clockConfigPage, &ClockConfigWidget::configChanged, this, &MainWindow::onClockConfigChanged);
+    connect(m_clockConfigPage, &ClockConfigWidget::operatingPointsGenerated, this,
+            [this](const QMap<QString, QString>& nodes) {
+        if (!m_dtsConfig || !m_dtsConfig->isLoaded()) {
+            QMessageBox::warning(this, "警告", "设备树配置未初始化，OPP表未写入设备树！");
+            return;
+        }
+        // CPU/TPU/VIP节点引用对应的OPP表，表被删除时一并去掉引用
+        const QMap<QString, QString> consumers = DvfsPlanner::operatingPointConsumers();
+        for (auto it = consumers.constBegin(); it != consumers.constEnd(); ++it) {
+            const bool hasTable = !nodes.value(it.value()).isEmpty();
+            m_dtsConfig->setOverrideProperty(it.key(), "operating-points-v2",
+                                             hasTable ? QString("<&%1>").arg(it.value()) : QString());
+        }
+        m_dtsConfig->saveGeneratedNodes(nodes).then(this, [this](FileIoResult result) {
+            if (result.ok) {
+                statusBar()->showMessage("性能档位OPP表已写入设备树", 5000);
+            } else {
+                QMessageBox::critical(this, "错误", QString("OPP表写入设备树失败！\n%1").arg(result.errorMessage));
+            }
+        });
+    });
 
     // 连接内存配置信号
     connect(m_memoryConfigPage, &MemoryConfigWidget::configChanged, this, &MainWindow::onMemoryConfigChanged);
@@ -184,6 +242,47 @@ void MainWindow::setupUI()
     connect(m_flashConfigPage, &FlashConfigWidget::configChanged, this, &MainWindow::onFlashConfigChanged);
 }
 
+void MainWindow::setupStatusBar()
+{
+    m_ioProgressBar = new QProgressBar(this);
+    m_ioProgressBar->setMaximumWidth(160);
+    m_ioProgressBar->setMaximumHeight(16);
+    m_ioProgressBar->setTextVisible(false);
+    m_ioProgressBar->hide();
+
+    m_ioCancelButton = new QToolButton(this);
+    m_ioCancelButton->setText("取消");
+    m_ioCancelButton->setToolTip("取消尚未完成的文件读写");
+    m_ioCancelButton->hide();
+
+    statusBar()->addPermanentWidget(m_ioProgressBar);
+    statusBar()->addPermanentWidget(m_ioCancelButton);
+
+    FileIoService *io = FileIoService::instance();
+    connect(io, &FileIoService::activityChanged, this, [this](const QString& description, int percent) {
+        statusBar()->showMessage(description);
+        if (percent < 0) {
+            m_ioProgressBar->setRange(0, 0);
+        } else {
+            m_ioProgressBar->setRange(0, 100);
+            m_ioProgressBar->setValue(percent);
+        }
+        m_ioProgressBar->show();
+        m_ioCancelButton->show();
+    });
+    connect(io, &FileIoService::taskFailed, this, [this](const QString& description, const QString& errorMessage) {
+        statusBar()->showMessage(QString("%1 失败: %2").arg(description).arg(errorMessage), 5000);
+    });
+    connect(io, &FileIoService::idle, this, [this]() {
+        m_ioProgressBar->hide();
+        m_ioCancelButton->hide();
+        if (statusBar()->currentMessage().startsWith("正在")) {
+            statusBar()->clearMessage();
+        }
+    });
+    connect(m_ioCancelButton, &QToolButton::clicked, io, &FileIoService::cancelAll);
+}
+
 void MainWindow::setupMenuBar()
 {
     // 创建菜单栏
@@ -202,6 +301,34 @@ void MainWindow::setupMenuBar()
     
     // 添加分隔符
     m_toolsMenu->addSeparator();
+
+    // 启动耗时预算
+    m_bootTimeBudgetAction = new QAction("启动耗时预算(&B)...", this);
+    m_bootTimeBudgetAction->setStatusTip("设置板级初始化序列允许的最大耗时，生成代码前进行检查");
+    connect(m_bootTimeBudgetAction, &QAction::triggered, this, &MainWindow::onSetBootTimeBudget);
+    m_toolsMenu->addAction(m_bootTimeBudgetAction);
+
+    // DDR带宽分析
+    m_ddrBandwidthAction = new QAction("DDR带宽分析(&D)...", this);
+    m_ddrBandwidthAction->setStatusTip("根据时钟树和视频管线配置估算各主设备的DDR带宽需求");
+    connect(m_ddrBandwidthAction, &QAction::triggered, this, &MainWindow::onShowDdrBandwidth);
+    m_toolsMenu->addAction(m_ddrBandwidthAction);
+
+    m_toolsMenu->addSeparator();
+
+    // 连接配置守护进程，向IDE插件等其他客户端发布界面上的配置
+    m_daemonClientAction = new QAction("连接配置守护进程(&S)", this);
+    m_daemonClientAction->setCheckable(true);
+    m_daemonClientAction->setStatusTip("连接 CviCubeMX --daemon，发布当前的引脚和时钟配置");
+    m_toolsMenu->addAction(m_daemonClientAction);
+    {
+        QSettings settings("CviTek", "CviCubeMX");
+        m_daemonClientAction->setChecked(settings.value("daemonClientEnabled", false).toBool());
+    }
+    connect(m_daemonClientAction, &QAction::toggled, this, &MainWindow::onToggleDaemonClient);
+    if (m_daemonClientAction->isChecked()) {
+        onToggleDaemonClient(true);
+    }
     
     // 可以在这里添加其他工具菜单项
 }
@@ -229,21 +356,7 @@ void MainWindow::setupPinoutTab()
 
     // 芯片选择下拉框
     m_chipComboBox = new QComboBox(m_pinoutTab);
-    m_chipComboBox->addItems({
-        "请选择芯片型号",
-        "cv1840cp_wevb_0015a_spinor",
-        "cv1841cp_wevb_0015a_emmc",
-        "cv1841cp_wevb_0015a_spinand",
-        "cv1841cp_wevb_0015a_spinor",
-        "cv1842cp_wevb_0015a_spinand",
-        "cv1842cp_wevb_0015a_spinor",
-        "cv1842hp_wevb_0014a_emmc",
-        "cv1842hp_wevb_0014a_spinand",
-        "cv1842hp_wevb_0014a_spinor",
-        "cv1843hp_wevb_0014a_emmc",
-        "cv1843hp_wevb_0014a_spinand",
-        "cv1843hp_wevb_0014a_spinor"
-    });
+    populateBoardList(m_chipComboBox, true);
     // 如果已经选择了芯片，设置为当前选择
     if (!m_selectedChip.isEmpty()) {
         int index = m_chipComboBox->findText(m_selectedChip);
@@ -298,11 +411,29 @@ void MainWindow::setupPinoutTab()
         "}"
     );
 
+    // 启动耗时估算标签（鼠标悬停显示分段明细）
+    m_bootTimeLabel = new QLabel("board init ≈ -- µs", m_pinoutTab);
+    m_bootTimeLabel->setStyleSheet("font-size: 12px; color: #7f8c8d; padding: 0 6px;");
+    m_bootTimeLabel->setToolTip("生成代码后的板级初始化耗时估算");
+
+    // DDR带宽利用率标签（详细分析见 工具 -> DDR带宽分析）
+    m_ddrBandwidthLabel = new QLabel("DDR -- %", m_pinoutTab);
+    m_ddrBandwidthLabel->setStyleSheet("font-size: 12px; color: #7f8c8d; padding: 0 6px;");
+    m_ddrBandwidthLabel->setToolTip("当前时钟与视频管线配置下的DDR带宽利用率");
+
+    // 时钟门控标签：禁用外设后可关闭的时钟及估算的功耗节省
+    m_clockGatingLabel = new QLabel("时钟门控: --", m_pinoutTab);
+    m_clockGatingLabel->setStyleSheet("font-size: 12px; color: #7f8c8d; padding: 0 6px;");
+    m_clockGatingLabel->setToolTip("根据设备树和defconfig中禁用的外设分析可在启动时关闭的时钟");
+
     // 添加到控制布局
     m_controlLayout->addWidget(chipLabel);
     m_controlLayout->addWidget(m_chipComboBox);
     m_controlLayout->addWidget(m_startProjectButton);
     m_controlLayout->addWidget(m_generateCodeButton);
+    m_controlLayout->addWidget(m_bootTimeLabel);
+    m_controlLayout->addWidget(m_ddrBandwidthLabel);
+    m_controlLayout->addWidget(m_clockGatingLabel);
 
     // // 添加选择路径按钮
     // QPushButton *selectPathButton = new QPushButton("选择源码路径", m_pinoutTab);
@@ -442,6 +573,7 @@ void MainWindow::setupPinoutConfigPanel()
         QCheckBox *checkBox = new QCheckBox();
         checkBox->setText(peripheral);
         checkBox->setChecked(m_peripheralStates.value(peripheral, false));
+        checkBox->setEnabled(!m_peripheralStatesLoading);
 
         // 连接复选框信号
         connect(checkBox, &QCheckBox::toggled, this, [this, peripheral](bool checked) {
@@ -525,6 +657,9 @@ void MainWindow::setupFlashTab()
     QVBoxLayout* flashLayout = new QVBoxLayout(m_flashTab);
     flashLayout->setContentsMargins(0, 0, 0, 0);
     flashLayout->addWidget(m_flashConfigPage);
+
+    // 启动读取耗时估算使用时钟树中的存储控制器时钟
+    updateFlashBootClocks();
 }
 
 void MainWindow::setupSearchBox()
@@ -587,8 +722,10 @@ void MainWindow::onChipSelectionChanged()
     // 重新加载外设状态（基于新选择的芯片类型）
     if (selectedChip != "请选择芯片型号" && !m_sourcePath.isEmpty()) {
         loadPeripheralStates();
-        updatePeripheralCheckBoxes();
     }
+
+    // 守护进程切换到新的板子，避免新配置叠加在旧工程上
+    publishToDaemon();
 }
 
 void MainWindow::onStartProject()
@@ -612,6 +749,10 @@ void MainWindow::onStartProject()
 
     // 启用生成代码按钮
     m_generateCodeButton->setEnabled(true);
+
+    updateClockGating();
+    updateDdrBandwidthStatus();
+    publishToDaemon();
 }
 
 void MainWindow::setupChipView()
@@ -866,6 +1007,11 @@ void MainWindow::onPinFunctionChanged(const QString& pinName, const QString& fun
 {
     // 更新引脚功能映射
     m_chipConfig.setPinFunction(pinName, function);
+    updateBootTimeEstimate();
+
+    if (m_daemonClient && m_daemonClient->isConnected()) {
+        m_daemonClient->call("pin.set", {{"pad", pinName}, {"function", function}});
+    }
 
     // 检查是否有高亮的引脚被配置了
     bool shouldClearHighlight = false;
@@ -909,44 +1055,77 @@ void MainWindow::onPinFunctionChanged(const QString& pinName, const QString& fun
 
 void MainWindow::onGenerateCode()
 {
-    // 首先保存DTS配置
-    if (m_dtsConfig && m_dtsConfig->saveDtsFile()) {
-        qDebug() << "DTS配置已保存";
-    } else {
-        qDebug() << "DTS配置保存失败或未加载DTS文件";
+    // 检查启动耗时预算
+    int budgetUs = loadBootTimeBudget();
+    if (budgetUs > 0) {
+        BootTimeEstimate estimate = computeBootTimeEstimate();
+        if (estimate.totalUs() > budgetUs) {
+            QMessageBox::StandardButton reply = QMessageBox::question(this, "超出启动耗时预算",
+                QString("%1 超出预算 %2 µs。\n\n%3\n\n是否仍然生成代码？")
+                    .arg(estimate.summary())
+                    .arg(budgetUs)
+                    .arg(estimate.breakdown()),
+                QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+            if (reply != QMessageBox::Yes) {
+                return;
+            }
+        }
     }
 
-    // 直接更新或生成代码到默认位置
-    QString result = m_codeGenerator.generateCode(m_chipConfig);
-
-    // 检查结果是否为错误信息
-    if (result.startsWith("Error:")) {
-        QMessageBox::critical(this, "错误", result);
-    } else if (result == "File updated successfully") {
-        QMessageBox::information(this, "成功", "已成功更新 cvi_board_init.c 文件的 PINMUX 配置！");
-    } else if (result == "Existing generated configurations removed") {
-        QMessageBox::information(this, "信息", "已移除原有的生成配置（当前无新配置需要添加）。");
-    } else if (result == "No pin configurations to add") {
-        QMessageBox::information(this, "信息", "当前没有引脚配置需要生成。");
-    } else {
-        // 如果返回的是生成的代码内容（文件不存在的情况）
-        QString fileName = QFileDialog::getSaveFileName(this,
-            "保存代码文件",
-            "cvi_board_init.c",
-            "C Files (*.c);;All Files (*)");
-
-        if (!fileName.isEmpty()) {
-            QFile file(fileName);
-            if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                QTextStream stream(&file);
-                stream << result;
-                file.close();
-                QMessageBox::information(this, "成功", "代码文件已生成: " + fileName);
+    // 首先保存DTS配置
+    if (m_dtsConfig) {
+        m_dtsConfig->saveDtsFile().then(this, [](FileIoResult result) {
+            if (result.ok) {
+                qDebug() << "DTS配置已保存";
             } else {
-                QMessageBox::critical(this, "错误", "无法保存文件!");
+                qDebug() << "DTS配置保存失败或未加载DTS文件：" << result.errorMessage;
             }
+        });
+    }
+
+    // 配置内容在界面线程生成，默认位置 cvi_board_init.c 的读取和更新在后台完成
+    QString boardInitPath = m_codeGenerator.getDefaultBoardInitFilePath(m_chipConfig);
+    if (boardInitPath.isEmpty()) {
+        saveStandaloneCode();
+        return;
+    }
+
+    QString body = m_codeGenerator.generateBoardInitBody(m_chipConfig);
+    FileIoService::instance()->modifyText(boardInitPath, [body](QString& content, QString& errorMessage) {
+        return CodeGenerator::updateBoardInitContent(content, body, errorMessage);
+    }, "cvi_board_init.c").then(this, [this, hasBody = !body.isEmpty()](FileIoResult result) {
+        if (result.missing) {
+            // 默认文件不存在，生成完整代码由用户选择保存位置
+            saveStandaloneCode();
+        } else if (!result.ok) {
+            QMessageBox::critical(this, "错误", "Error: " + result.errorMessage);
+        } else if (hasBody) {
+            QMessageBox::information(this, "成功", "已成功更新 cvi_board_init.c 文件的 PINMUX 配置！");
+        } else {
+            QMessageBox::information(this, "信息", "已移除原有的生成配置（当前无新配置需要添加）。");
         }
+    });
+}
+
+void MainWindow::saveStandaloneCode()
+{
+    QString fileName = QFileDialog::getSaveFileName(this,
+        "保存代码文件",
+        "cvi_board_init.c",
+        "C Files (*.c);;All Files (*)");
+
+    if (fileName.isEmpty()) {
+        return;
     }
+
+    QString code = m_codeGenerator.generateStandaloneCode(m_chipConfig);
+    FileIoService::instance()->writeText(fileName, code).then(this, [this](FileIoResult result) {
+        if (result.ok) {
+            QMessageBox::information(this, "成功", "代码文件已生成: " + result.filePath);
+        } else {
+            QMessageBox::critical(this, "错误", "无法保存文件!");
+        }
+    });
 }
 
 void MainWindow::initializePinNameMappings()
@@ -1181,26 +1360,7 @@ void MainWindow::onSearchTextChanged(const QString& text)
             continue;
         }
 
-        bool isMatched = false;
-
-        // 1. 检查是否匹配引脚号或显示名称
-        if (pinKey.contains(m_currentSearchText, Qt::CaseInsensitive) ||
-            pinWidget->getDisplayName().contains(m_currentSearchText, Qt::CaseInsensitive)) {
-            isMatched = true;
-        }
-
-        // 2. 检查是否匹配引脚支持的功能
-        if (!isMatched) {
-            QStringList supportedFunctions = pinWidget->getSupportedFunctions();
-            for (const QString& func : supportedFunctions) {
-                if (func.contains(m_currentSearchText, Qt::CaseInsensitive)) {
-                    isMatched = true;
-                    break;
-                }
-            }
-        }
-
-        if (isMatched) {
+        if (pinWidget->matchesSearch(pinKey, m_currentSearchText)) {
             matchedPins.append(pinWidget);
         }
     }
@@ -1452,29 +1612,42 @@ void MainWindow::onPeripheralItemClicked(QTreeWidgetItem* item, int column)
 
 void MainWindow::onPeripheralCheckBoxChanged(const QString& peripheral, bool enabled)
 {
-    // 更新状态
+    // 更新状态（读取defconfig期间复选框已禁用，不会与读取结果冲突）
     m_peripheralStates[peripheral] = enabled;
+    updateClockGating();
+
+    // 只把该外设的配置项写入defconfig文件
+    savePeripheralState(peripheral, enabled).then(this, [this, peripheral, enabled](FileIoResult result) {
+        if (result.ok) {
+            qDebug() << QString("外设 %1 已%2").arg(peripheral).arg(enabled ? "启用" : "禁用");
+            return;
+        }
 
-    // 保存到defconfig文件
-    if (savePeripheralStates()) {
-        qDebug() << QString("外设 %1 已%2").arg(peripheral).arg(enabled ? "启用" : "禁用");
-    } else {
         // 如果保存失败，恢复复选框状态
-        QMessageBox::warning(this, "警告", "无法更新defconfig文件配置");
-
-        // 恢复复选框状态
-        m_peripheralStates[peripheral] = !enabled;
-
-        // 找到对应的复选框并恢复状态
-        QTreeWidgetItem *peripheralItem = m_pinoutConfigTree->topLevelItem(0);
-        if (peripheralItem) {
-            for (int i = 0; i < peripheralItem->childCount(); ++i) {
-                QTreeWidgetItem *subItem = peripheralItem->child(i);
-                QCheckBox *checkBox = qobject_cast<QCheckBox*>(m_pinoutConfigTree->itemWidget(subItem, 0));
-                if (checkBox && checkBox->text() == peripheral) {
-                    checkBox->setChecked(!enabled);
-                    break;
-                }
+        QMessageBox::warning(this, "警告", QString("无法更新defconfig文件配置\n%1").arg(result.errorMessage));
+        revertPeripheralCheckBox(peripheral, enabled);
+    }).onCanceled(this, [this, peripheral, enabled]() {
+        // 写入被取消（如取消全部I/O）时文件未改动，界面同样恢复
+        revertPeripheralCheckBox(peripheral, enabled);
+    });
+}
+
+void MainWindow::revertPeripheralCheckBox(const QString& peripheral, bool enabled)
+{
+    m_peripheralStates[peripheral] = !enabled;
+    updateClockGating();
+
+    // 找到对应的复选框并恢复状态
+    QTreeWidgetItem *peripheralItem = m_pinoutConfigTree ? m_pinoutConfigTree->topLevelItem(0) : nullptr;
+    if (peripheralItem) {
+        for (int i = 0; i < peripheralItem->childCount(); ++i) {
+            QTreeWidgetItem *subItem = peripheralItem->child(i);
+            QCheckBox *checkBox = qobject_cast<QCheckBox*>(m_pinoutConfigTree->itemWidget(subItem, 0));
+            if (checkBox && checkBox->text() == peripheral) {
+                checkBox->blockSignals(true);
+                checkBox->setChecked(!enabled);
+                checkBox->blockSignals(false);
+                break;
             }
         }
     }
@@ -1488,6 +1661,12 @@ QString MainWindow::getDefconfigPath() const
         chipType = "cv1842hp_wevb_0014a_emmc"; // 默认使用cv1842hp_wevb_0014a_emmc
     }
 
+    // 已索引的板子直接使用实际文件位置
+    const SdkBoard *board = m_sdkIndexer->catalog().findBoard(chipType);
+    if (board && !board->linuxDefconfig.isEmpty()) {
+        return m_sdkIndexer->catalog().absolutePath(board->linuxDefconfig);
+    }
+
     QString defconfigPath = QString("build/boards/cv184x/%1/linux/cvitek_%1_defconfig")
                            .arg(chipType);
 
@@ -1512,27 +1691,13 @@ QMap<QString, QStringList> MainWindow::getPeripheralConfigs() const
     return configs;
 }
 
-bool MainWindow::loadPeripheralStates()
-{
-    QString defconfigPath = getDefconfigPath();
-    QFile file(defconfigPath);
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "无法打开defconfig文件：" << defconfigPath;
+// defconfig 索引缓存；DefconfigIndex::parse() 的规则变化时递增版本号
+static const QString kDefconfigCacheKind = "defconfig-index/1";
 
-        // 如果文件不存在，设置默认状态（所有外设都禁用）
-        QStringList peripherals = {"PWM", "I2C", "SPI", "UART", "GPIO", "ADC", "SYSDMA"};
-        for (const QString &peripheral : peripherals) {
-            m_peripheralStates[peripheral] = false;
-        }
-        return false;
-    }
-
-    QTextStream in(&file);
-    QString content = in.readAll();
-    file.close();
-
-    QMap<QString, QStringList> peripheralConfigs = getPeripheralConfigs();
+// 外设全部CONFIG项均为=y才视为启用
+static QMap<QString, bool> parsePeripheralStates(const DefconfigIndex& index, const QMap<QString, QStringList>& peripheralConfigs)
+{
+    QMap<QString, bool> states;
 
     // 检查每个外设的CONFIG项
     for (auto it = peripheralConfigs.begin(); it != peripheralConfigs.end(); ++it) {
@@ -1543,42 +1708,27 @@ bool MainWindow::loadPeripheralStates()
 
         // 检查所有相关的CONFIG项是否都启用
         for (const QString &configItem : configItems) {
-            QString enabledPattern = configItem + "=y";
-            QString disabledPattern = "# " + configItem + " is not set";
-
-            if (content.contains(disabledPattern) || !content.contains(enabledPattern)) {
+            if (!index.isEnabled(configItem)) {
                 isEnabled = false;
                 break;
             }
         }
 
-        m_peripheralStates[peripheral] = isEnabled;
+        states[peripheral] = isEnabled;
     }
 
-    return true;
+    return states;
 }
 
-bool MainWindow::savePeripheralStates()
+// 纯文本修改，在后台I/O线程中执行
+static void applyPeripheralStates(QString& content, const QMap<QString, QStringList>& peripheralConfigs,
+                                  const QMap<QString, bool>& peripheralStates)
 {
-    QString defconfigPath = getDefconfigPath();
-    QFile file(defconfigPath);
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "无法打开defconfig文件：" << defconfigPath;
-        return false;
-    }
-
-    QTextStream in(&file);
-    QString content = in.readAll();
-    file.close();
-
-    QMap<QString, QStringList> peripheralConfigs = getPeripheralConfigs();
-
     // 更新每个外设的CONFIG项
     for (auto it = peripheralConfigs.begin(); it != peripheralConfigs.end(); ++it) {
         const QString &peripheral = it.key();
         const QStringList &configItems = it.value();
-        bool isEnabled = m_peripheralStates.value(peripheral, false);
+        bool isEnabled = peripheralStates.value(peripheral, false);
 
         for (const QString &configItem : configItems) {
             QString enabledPattern = configItem + "=y";
@@ -1603,22 +1753,101 @@ bool MainWindow::savePeripheralStates()
             }
         }
     }
+}
 
-    // 写回文件
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "无法写入defconfig文件：" << defconfigPath;
-        return false;
-    }
+void MainWindow::loadPeripheralStates()
+{
+    // 切换芯片后之前未完成的读取已无意义
+    m_peripheralStatesLoad.cancel();
+    updateWatchedArtifacts();
+
+    m_peripheralStatesLoad = FileIoService::instance()->readText(getDefconfigPath(), "外设defconfig");
+    m_peripheralStatesLoading = true;
+    updatePeripheralCheckBoxes();
+    m_peripheralStatesLoad.then(this, [this](FileIoResult result) {
+        m_peripheralStatesLoading = false;
+
+        // 换了板子时界面上的状态属于另一个文件，不参与合并
+        if (result.filePath != m_peripheralStatesPath) {
+            m_peripheralStatesBase.clear();
+            m_peripheralStatesPath = result.filePath;
+        }
+
+        if (!result.ok) {
+            qDebug() << "无法打开defconfig文件：" << result.filePath;
 
-    QTextStream out(&file);
-    out << content;
-    file.close();
+            // 如果文件不存在，设置默认状态（所有外设都禁用）
+            QStringList peripherals = {"PWM", "I2C", "SPI", "UART", "GPIO", "ADC", "SYSDMA"};
+            for (const QString &peripheral : peripherals) {
+                m_peripheralStates[peripheral] = false;
+            }
+            m_peripheralStatesBase = m_peripheralStates;
+        } else {
+            // 文件内容未变时直接使用上次建立的索引
+            DefconfigIndex index;
+            ArtifactStamp stamp = ArtifactStamp::fromResult(result);
+            if (!ArtifactCache::load(kDefconfigCacheKind, stamp, [&index](QDataStream &in) {
+                    in >> index;
+                    return true;
+                })) {
+                index = DefconfigIndex::parse(result.content);
+                ArtifactCache::store(kDefconfigCacheKind, stamp, [index](QDataStream &out) {
+                    out << index;
+                });
+            }
+            // 按外设合并：界面上尚未写入的修改保留，其余取文件中的最新状态
+            const QMap<QString, bool> fileStates = parsePeripheralStates(index, getPeripheralConfigs());
+            QMap<QString, bool> states = fileStates;
+            for (auto it = m_peripheralStates.constBegin(); it != m_peripheralStates.constEnd(); ++it) {
+                if (m_peripheralStatesBase.contains(it.key()) && m_peripheralStatesBase.value(it.key()) != it.value()) {
+                    states[it.key()] = it.value();
+                }
+            }
+            m_peripheralStatesBase = fileStates;
+            m_peripheralStates = states;
+
+            m_aiKnowledge->setDocuments("defconfig", {{QFileInfo(result.filePath).fileName(), result.content, false}});
+        }
+
+        updatePeripheralCheckBoxes();
+        updateClockGating();
+    }).onCanceled(this, [this]() {
+        // 被新的读取替换时等待新的结果，否则（如取消全部I/O）恢复可用
+        if (m_peripheralStatesLoad.isCanceled()) {
+            m_peripheralStatesLoading = false;
+            updatePeripheralCheckBoxes();
+        }
+    });
+}
 
-    return true;
+QFuture<FileIoResult> MainWindow::savePeripheralState(const QString& peripheral, bool enabled)
+{
+    // 只写入本次切换的外设，其他外设（包括文件中的外部修改）保持不变
+    QMap<QString, QStringList> peripheralConfigs;
+    peripheralConfigs.insert(peripheral, getPeripheralConfigs().value(peripheral));
+    QMap<QString, bool> peripheralStates;
+    peripheralStates.insert(peripheral, enabled);
+
+    return FileIoService::instance()->modifyText(getDefconfigPath(),
+        [peripheralConfigs, peripheralStates](QString& content, QString&) {
+            applyPeripheralStates(content, peripheralConfigs, peripheralStates);
+            return true;
+        }, "外设defconfig")
+        .then(this, [this, peripheral, enabled](FileIoResult result) {
+            if (result.ok) {
+                m_peripheralStatesBase[peripheral] = enabled;
+            }
+            return result;
+        });
 }
 
 void MainWindow::updatePeripheralCheckBoxes()
 {
+    // 外设状态可能在配置树创建前读取完成
+    if (!m_pinoutConfigTree) {
+        return;
+    }
+
     // 更新UI中外设复选框的状态
     QTreeWidgetItem *peripheralItem = m_pinoutConfigTree->topLevelItem(0);
     if (!peripheralItem) {
@@ -1637,6 +1866,7 @@ void MainWindow::updatePeripheralCheckBoxes()
             checkBox->blockSignals(true);
             checkBox->setChecked(isEnabled);
             checkBox->blockSignals(false);
+            checkBox->setEnabled(!m_peripheralStatesLoading);
             
             qDebug() << QString("更新外设 %1 的复选框状态为: %2").arg(peripheralType).arg(isEnabled ? "启用" : "禁用");
         }
@@ -1649,10 +1879,69 @@ void MainWindow::initializeDtsConfig()
 
     // 使用用户选择的源代码路径加载设备树文件
     QString dtsFilePath = QDir(m_sourcePath).absoluteFilePath("build/boards/default/dts/cv184x/cv184x_base.dtsi");
-    if (!m_dtsConfig->loadDtsFile(dtsFilePath)) {
-        qDebug() << "警告：无法加载设备树文件，外设配置功能将不可用";
-        qDebug() << "尝试加载的路径：" << dtsFilePath;
+    connect(m_dtsConfig, &DtsConfig::externallyChanged, this,
+            [this](const QStringList& changedNodes, const QStringList& conflicts) {
+        if (!changedNodes.isEmpty()) {
+            statusBar()->showMessage(QString("设备树文件已在外部修改，已更新节点: %1").arg(changedNodes.join(", ")), 5000);
+        }
+        if (!conflicts.isEmpty()) {
+            QMessageBox::warning(this, "设备树修改冲突",
+                QString("以下节点同时被外部修改，已保留外部版本，请重新检查配置：\n%1").arg(conflicts.join(", ")));
+        }
+        updateClockGating();
+        m_aiKnowledgeTimer->start();
+    });
+    connect(m_dtsConfig, &DtsConfig::loaded, m_aiKnowledgeTimer, qOverload<>(&QTimer::start));
+    connect(m_dtsConfig, &DtsConfig::loaded, this, &MainWindow::updateClockGating);
+
+    m_dtsConfig->loadDtsFile(dtsFilePath).then(this, [this](FileIoResult result) {
+        if (!result.ok) {
+            qDebug() << "警告：无法加载设备树文件，外设配置功能将不可用";
+            qDebug() << "尝试加载的路径：" << result.filePath;
+        }
+        updateWatchedArtifacts();
+    });
+}
+
+void MainWindow::updateWatchedArtifacts()
+{
+    QStringList files;
+    if (m_dtsConfig && m_dtsConfig->isLoaded()) {
+        files << m_dtsConfig->filePath();
+    }
+
+    if (!m_sourcePath.isEmpty() && !m_selectedChip.isEmpty() && m_selectedChip != "请选择芯片型号") {
+        const SdkCatalog& catalog = m_sdkIndexer->catalog();
+        const SdkBoard *board = catalog.findBoard(m_selectedChip);
+        QDir sourceDir(m_sourcePath);
+
+        files << getDefconfigPath();
+        files << (board && !board->boardDefconfig.isEmpty()
+                  ? catalog.absolutePath(board->boardDefconfig)
+                  : sourceDir.absoluteFilePath(QString("build/boards/cv184x/%1/%1_defconfig").arg(m_selectedChip)));
+        files << (board && !board->boardInit.isEmpty()
+                  ? catalog.absolutePath(board->boardInit)
+                  : sourceDir.absoluteFilePath(QString("build/boards/cv184x/%1/u-boot/cvi_board_init.c").arg(m_selectedChip)));
+    }
+
+    m_artifactWatcher->setFiles(files);
+}
+
+void MainWindow::onArtifactChanged(const QString& filePath)
+{
+    // 只重新读取发生变化的文件
+    if (m_dtsConfig && filePath == QDir::cleanPath(m_dtsConfig->filePath())) {
+        m_dtsConfig->reloadFromDisk();
+        return;
+    }
+    if (filePath == QDir::cleanPath(getDefconfigPath())) {
+        loadPeripheralStates();
+        return;
     }
+
+    // 板级defconfig与cvi_board_init.c只在导出/生成时读改写，界面上没有需要刷新的内容
+    statusBar()->showMessage(QString("%1 已在外部修改，下次导出/生成时将在其最新内容上更新")
+                             .arg(QFileInfo(filePath).fileName()), 5000);
 }
 
 void MainWindow::showPeripheralConfig(const QString& peripheralType)
@@ -1662,8 +1951,19 @@ void MainWindow::showPeripheralConfig(const QString& peripheralType)
         return;
     }
 
+    if (!m_dtsConfig->isLoaded()) {
+        QMessageBox::warning(this, "警告", "设备树文件尚未加载完成或加载失败，暂时无法配置外设！");
+        return;
+    }
+
     PeripheralConfigDialog dialog(peripheralType, m_dtsConfig, this);
+    if (m_clockConfigPage) {
+        dialog.setClockFrequencies(m_clockConfigPage->getClockFrequencies());
+    }
     dialog.exec();
+
+    updateClockGating();
+    m_aiKnowledgeTimer->start();
 }
 
 void MainWindow::onClockConfigChanged()
@@ -1671,6 +1971,14 @@ void MainWindow::onClockConfigChanged()
     // 时钟配置更改时的处理
     qDebug() << "时钟配置已更改";
 
+    publishClocksToDaemon();
+
+    // 总线频率变化会影响启动耗时估算（随时钟门控一起更新）、DDR带宽预算和启动读取耗时
+    updateClockGating();
+    updateDdrBandwidthStatus();
+    updateFlashBootClocks();
+    m_aiKnowledgeTimer->start();
+
     // 可以在这里添加保存配置或其他处理逻辑
     // 比如自动保存时钟配置到文件
     // m_clockConfigPage->saveConfig("clock_config.json");
@@ -1681,6 +1989,10 @@ void MainWindow::onMemoryConfigChanged()
     // 内存配置更改时的处理
     qDebug() << "内存配置已更改";
 
+    // ION容量计算会更新视频管线配置
+    updateDdrBandwidthStatus();
+    m_aiKnowledgeTimer->start();
+
     // 可以在这里添加保存配置或其他处理逻辑
     // 比如自动保存内存配置到文件
     // m_memoryConfigPage->exportToJson("memory_config.json");
@@ -1746,6 +2058,7 @@ void MainWindow::showPathSelectionDialog()
         if (ret == QMessageBox::Ok) {
             // 用户确认使用上次的路径
             m_sourcePath = lastPath;
+            m_sdkIndexer->setRootPath(m_sourcePath);
             
             // 更新CodeGenerator的路径
             m_codeGenerator.setSourcePath(m_sourcePath);
@@ -1798,6 +2111,7 @@ void MainWindow::showPathSelectionDialog()
         
         // 保存到历史记录
         saveLastSourcePath(m_sourcePath);
+        m_sdkIndexer->setRootPath(m_sourcePath);
         
         // 更新CodeGenerator的路径
         m_codeGenerator.setSourcePath(m_sourcePath);
@@ -1836,37 +2150,17 @@ void MainWindow::showPathSelectionDialog()
 
 bool MainWindow::validateSourcePath(const QString& path)
 {
-    QDir dir(path);
-
-    // 检查必要的目录结构
-    QStringList requiredDirs = {"build"};
-
-    for (const QString& reqDir : requiredDirs) {
-        if (!dir.exists(reqDir)) {
-            qDebug() << "缺少目录：" << reqDir;
-            return false;
-        }
-    }
-
-    // 检查关键文件是否存在
-    QStringList criticalPaths = {
-        "build/boards/cv184x",
-        "build/boards/default/dts/cv184x"
-    };
-
-    for (const QString& criticalPath : criticalPaths) {
-        if (!dir.exists(criticalPath)) {
-            qDebug() << "缺少关键路径：" << criticalPath;
-            return false;
-        }
-    }
-
-    return true;
+    // 只检查关键目录（几次stat），不信任保存的目录索引，索引随后在后台校验刷新
+    return SdkIndexer::looksLikeSdk(path);
 }
 
 void MainWindow::onSelectSourcePath()
 {
+    const QString previousPath = m_sourcePath;
     showPathSelectionDialog();
+    if (m_sourcePath != previousPath) {
+        publishToDaemon();
+    }
 
     // 更新UI中的路径显示
     if (!m_sourcePath.isEmpty()) {
@@ -1889,6 +2183,10 @@ void MainWindow::onShowAIChat()
     // 如果对话窗口还没有创建，创建一个新的
     if (!m_aiChatDialog) {
         m_aiChatDialog = new AIChatDialog(this);
+        m_aiChatDialog->setContextProvider([this](const QString& question) {
+            return buildAIContext(question);
+        });
+        m_aiChatDialog->setToolBridge(&m_aiTools);
     }
     
     // 显示对话窗口
@@ -1897,6 +2195,552 @@ void MainWindow::onShowAIChat()
     m_aiChatDialog->activateWindow();
 }
 
+void MainWindow::updateAIKnowledge()
+{
+    // 设备树使用解析后的外设属性，比原文紧凑
+    QList<KnowledgeDocument> dtsDocuments;
+    if (m_dtsConfig && m_dtsConfig->isLoaded()) {
+        QString text;
+        const QMap<QString, PeripheralInfo> infos = m_dtsConfig->getPeripheralInfos();
+        for (auto it = infos.constBegin(); it != infos.constEnd(); ++it) {
+            const PeripheralInfo& info = it.value();
+            QString line = QString("设备树节点 %1: status=%2").arg(it.key(), info.status);
+            if (info.hasClock) {
+                line += QString(" clocks=%1").arg(info.clockName);
+            }
+            if (info.hasClockFreq) {
+                line += QString(" clock-frequency=%1").arg(info.clockFrequency);
+            }
+            if (info.hasCurrentSpeed) {
+                line += QString(" current-speed=%1").arg(info.currentSpeed);
+            }
+            if (info.hasPwmCells) {
+                line += QString(" #pwm-cells=%1").arg(info.pwmCells);
+            }
+            if (info.hasSysdmaChannels) {
+                line += QString(" dma-channels=<%1>").arg(info.sysdmaChannels.join(" "));
+            }
+            text += line + '\n';
+        }
+        dtsDocuments.append({QFileInfo(m_dtsConfig->filePath()).fileName(), text, false});
+    }
+
+    QList<KnowledgeDocument> clockDocuments;
+    if (m_clockConfigPage) {
+        QString text;
+        const QMap<QString, double> frequencies = m_clockConfigPage->getClockFrequencies();
+        for (auto it = frequencies.constBegin(); it != frequencies.constEnd(); ++it) {
+            text += QString("时钟 %1 = %2 MHz\n").arg(it.key()).arg(it.value());
+        }
+        clockDocuments.append({"时钟树", text, false});
+    }
+
+    QList<KnowledgeDocument> memoryDocuments;
+    if (m_memoryConfigPage) {
+        QString text;
+        const QList<MemoryRegion> regions = m_memoryConfigPage->getMemoryRegions();
+        for (const MemoryRegion& region : regions) {
+            text += QString("内存区域 %1: 0x%2 - 0x%3 大小 %4 %5\n")
+                        .arg(region.name)
+                        .arg(region.startAddress, 8, 16, QChar('0'))
+                        .arg(region.endAddress, 8, 16, QChar('0'))
+                        .arg(region.sizeString, region.description);
+        }
+        memoryDocuments.append({"内存布局", text, false});
+    }
+
+    // 三组文档一起替换，只重建一次索引
+    QMap<QString, QList<KnowledgeDocument>> groups;
+    groups.insert("dts", dtsDocuments);
+    groups.insert("clock", clockDocuments);
+    groups.insert("memory", memoryDocuments);
+    m_aiKnowledge->setDocuments(groups);
+}
+
+QString MainWindow::buildAIContext(const QString& question) const
+{
+    // 只附加相关度最高的几个片段，控制请求长度
+    static constexpr int kAIContextTopK = 4;
+
+    QStringList summary;
+    summary << QString("芯片型号: %1").arg(m_selectedChip);
+
+    QStringList enabledPeripherals;
+    for (auto it = m_peripheralStates.constBegin(); it != m_peripheralStates.constEnd(); ++it) {
+        if (it.value()) {
+            enabledPeripherals << it.key();
+        }
+    }
+    summary << QString("已启用外设: %1").arg(enabledPeripherals.isEmpty() ? "无" : enabledPeripherals.join(", "));
+
+    const QList<RetrievalHit> hits = m_aiKnowledge->search(question, kAIContextTopK);
+
+    // 只列出问题或检索片段中提到的引脚/功能，避免把全部引脚分配塞进请求
+    QStringList pins;
+    const QMap<QString, QString> pinFunctions = m_chipConfig.getAllPinFunctions();
+    for (auto it = pinFunctions.constBegin(); it != pinFunctions.constEnd(); ++it) {
+        bool relevant = question.contains(it.key(), Qt::CaseInsensitive)
+                        || (!it.value().isEmpty() && question.contains(it.value(), Qt::CaseInsensitive));
+        for (int i = 0; i < hits.size() && !relevant; ++i) {
+            relevant = hits[i].text.contains(it.key(), Qt::CaseInsensitive);
+        }
+        if (relevant) {
+            pins << QString("%1=%2").arg(it.key(), it.value());
+        }
+    }
+    summary << QString("相关引脚配置: %1 (共 %2 个引脚已分配)")
+                   .arg(pins.isEmpty() ? "无" : pins.join("; "))
+                   .arg(pinFunctions.size());
+
+    QString context = "当前工程:\n" + summary.join('\n');
+
+    if (!hits.isEmpty()) {
+        context += "\n\n相关资料:";
+        for (const RetrievalHit& hit : hits) {
+            context += QString("\n[%1]\n%2").arg(hit.source, hit.text);
+        }
+    }
+    return context;
+}
+
+// 二分图增广路径（Kuhn算法）：为 signal 找到空闲焊盘，必要时让已匹配的信号改用其他焊盘
+static bool augmentAssignment(int signal, const QList<QList<int>>& candidates,
+                              QVector<int>& padOwner, QVector<bool>& visited)
+{
+    for (int pad : candidates[signal]) {
+        if (visited[pad]) {
+            continue;
+        }
+        visited[pad] = true;
+        if (padOwner[pad] < 0 || augmentAssignment(padOwner[pad], candidates, padOwner, visited)) {
+            padOwner[pad] = signal;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MainWindow::setupAITools()
+{
+    // 当前封装上可用的焊盘 -> 显示位置；芯片视图尚未创建时为空，表示不限制
+    auto packagePads = [this]() {
+        QMap<QString, QString> pads;
+        for (auto it = m_pinWidgets.constBegin(); it != m_pinWidgets.constEnd(); ++it) {
+            if (it.value()->isEnabled()) {
+                pads.insert(it.value()->getPinName(), it.key());
+            }
+        }
+        return pads;
+    };
+    // 焊盘当前功能，未配置时为默认功能
+    auto currentFunction = [this](const QString& pad) {
+        QString function = m_chipConfig.getPinFunction(pad);
+        return function.isEmpty() ? m_pinFunction.getDefaultFunction(pad) : function;
+    };
+
+    m_aiTools.registerTool("list_pad_functions",
+        "列出焊盘（如 PAD_MIPI_TXM4）支持的全部复用功能、默认功能和当前配置的功能",
+        AIToolBridge::objectSchema({{"pad", AIToolBridge::property("string", "焊盘名称")}}, {"pad"}),
+        [this, packagePads, currentFunction](const QJsonObject& args) {
+            const QString pad = args["pad"].toString().trimmed().toUpper();
+            QJsonObject result;
+            const QStringList functions = m_pinFunction.getSupportedFunctions(pad);
+            if (functions.isEmpty()) {
+                result["error"] = QString("引脚数据库中没有焊盘 %1").arg(pad);
+                return result;
+            }
+            const QMap<QString, QString> pads = packagePads();
+            result["pad"] = pad;
+            result["functions"] = QJsonArray::fromStringList(functions);
+            result["default"] = m_pinFunction.getDefaultFunction(pad);
+            result["current"] = currentFunction(pad);
+            result["on_package"] = pads.isEmpty() || pads.contains(pad);
+            if (pads.contains(pad)) {
+                result["position"] = pads.value(pad);
+            }
+            return result;
+        });
+
+    m_aiTools.registerTool("find_pads_for_signal",
+        "查找可以复用为某个信号（如 UART2_TX、IIC0_SDA，可只给前缀如 UART2）的焊盘及其当前功能",
+        AIToolBridge::objectSchema({{"signal", AIToolBridge::property("string", "信号名称或前缀")}}, {"signal"}),
+        [this, packagePads, currentFunction](const QJsonObject& args) {
+            const QString signal = args["signal"].toString().trimmed();
+            QJsonObject result;
+            if (signal.isEmpty()) {
+                result["error"] = "缺少 signal 参数";
+                return result;
+            }
+            const QMap<QString, QString> pads = packagePads();
+            QJsonArray matches;
+            const QStringList pinNames = m_pinFunction.getPinNames();
+            for (const QString& pad : pinNames) {
+                if (!pads.isEmpty() && !pads.contains(pad)) {
+                    continue;
+                }
+                const QStringList functions = m_pinFunction.getSupportedFunctions(pad);
+                for (const QString& function : functions) {
+                    if (function.contains(signal, Qt::CaseInsensitive)) {
+                        QJsonObject match;
+                        match["pad"] = pad;
+                        match["function"] = function;
+                        match["current"] = currentFunction(pad);
+                        if (pads.contains(pad)) {
+                            match["position"] = pads.value(pad);
+                        }
+                        matches.append(match);
+                    }
+                }
+            }
+            result["signal"] = signal;
+            result["matches"] = matches;
+            return result;
+        });
+
+    m_aiTools.registerTool("get_clock_frequency",
+        "查询时钟树中某个时钟节点（如 clk_bus、clk_uart、clk_fpll）当前的频率",
+        AIToolBridge::objectSchema({{"clock", AIToolBridge::property("string", "时钟节点名称")}}, {"clock"}),
+        [this](const QJsonObject& args) {
+            const QString clock = args["clock"].toString().trimmed();
+            QJsonObject result;
+            if (!m_clockConfigPage) {
+                result["error"] = "时钟配置尚未初始化";
+                return result;
+            }
+            const QMap<QString, double> frequencies = m_clockConfigPage->getClockFrequencies();
+            if (frequencies.contains(clock)) {
+                result["clock"] = clock;
+                result["frequency_mhz"] = frequencies.value(clock);
+                return result;
+            }
+            // 名称不完全匹配时给出相近的节点
+            QStringList similar;
+            for (auto it = frequencies.constBegin(); it != frequencies.constEnd() && similar.size() < 10; ++it) {
+                if (it.key().contains(clock, Qt::CaseInsensitive)) {
+                    similar << it.key();
+                }
+            }
+            result["error"] = QString("时钟 %1 不存在或未启用").arg(clock);
+            result["similar"] = QJsonArray::fromStringList(similar);
+            return result;
+        });
+
+    m_aiTools.registerTool("check_memory_constraints",
+        "检查当前内存布局是否满足地址约束，并列出所有内存区域",
+        AIToolBridge::objectSchema({}, {}),
+        [this](const QJsonObject&) {
+            QJsonObject result;
+            if (!m_memoryConfigPage) {
+                result["error"] = "内存配置尚未初始化";
+                return result;
+            }
+            QString errorMessage;
+            result["ok"] = m_memoryConfigPage->checkMemoryConstraints(errorMessage);
+            if (!errorMessage.isEmpty()) {
+                result["violation"] = errorMessage;
+            }
+            QJsonArray regions;
+            const QList<MemoryRegion> memoryRegions = m_memoryConfigPage->getMemoryRegions();
+            for (const MemoryRegion& region : memoryRegions) {
+                QJsonObject item;
+                item["name"] = region.name;
+                item["start"] = MemoryRegionModel::formatAddress(region.startAddress);
+                item["end"] = MemoryRegionModel::formatAddress(region.endAddress);
+                item["size"] = region.sizeString;
+                regions.append(item);
+            }
+            result["regions"] = regions;
+            return result;
+        });
+
+    QJsonObject signalList = AIToolBridge::property("array", "需要分配的信号名称，如 [\"UART2_TX\", \"UART2_RX\"]");
+    signalList["items"] = QJsonObject{{"type", "string"}};
+    m_aiTools.registerTool("propose_pin_assignment",
+        "为一组信号提出焊盘分配方案：只使用当前未被占用（仍为默认功能）的焊盘，尽量让所有信号都分配到；不修改配置",
+        AIToolBridge::objectSchema({{"signals", signalList}}, {"signals"}),
+        [this, packagePads, currentFunction](const QJsonObject& args) {
+            QStringList signalNames;
+            const QJsonArray requested = args["signals"].toArray();
+            for (const QJsonValue& value : requested) {
+                QString name = value.toString().trimmed().toUpper();
+                if (!name.isEmpty() && !signalNames.contains(name)) {
+                    signalNames << name;
+                }
+            }
+
+            // 候选：支持该信号且空闲（或已配置为该信号）的焊盘
+            const QMap<QString, QString> pads = packagePads();
+            QStringList padNames;
+            QHash<QString, int> padIndex;
+            QList<QList<int>> candidates(signalNames.size());
+            const QStringList pinNames = m_pinFunction.getPinNames();
+            for (const QString& pad : pinNames) {
+                if (!pads.isEmpty() && !pads.contains(pad)) {
+                    continue;
+                }
+                const QString current = currentFunction(pad);
+                const bool isFree = current == m_pinFunction.getDefaultFunction(pad);
+                const QStringList functions = m_pinFunction.getSupportedFunctions(pad);
+                for (int i = 0; i < signalNames.size(); ++i) {
+                    if (!functions.contains(signalNames[i], Qt::CaseInsensitive)
+                            || (!isFree && current.compare(signalNames[i], Qt::CaseInsensitive) != 0)) {
+                        continue;
+                    }
+                    if (!padIndex.contains(pad)) {
+                        padIndex.insert(pad, padNames.size());
+                        padNames << pad;
+                    }
+                    candidates[i].append(padIndex.value(pad));
+                }
+            }
+
+            QVector<int> padOwner(padNames.size(), -1);
+            for (int i = 0; i < signalNames.size(); ++i) {
+                QVector<bool> visited(padNames.size(), false);
+                augmentAssignment(i, candidates, padOwner, visited);
+            }
+
+            QJsonArray assignments;
+            QStringList assigned;
+            for (int pad = 0; pad < padNames.size(); ++pad) {
+                if (padOwner[pad] < 0) {
+                    continue;
+                }
+                QJsonObject item;
+                item["signal"] = signalNames[padOwner[pad]];
+                item["pad"] = padNames[pad];
+                if (pads.contains(padNames[pad])) {
+                    item["position"] = pads.value(padNames[pad]);
+                }
+                assignments.append(item);
+                assigned << signalNames[padOwner[pad]];
+            }
+            QStringList unassigned;
+            for (const QString& name : signalNames) {
+                if (!assigned.contains(name)) {
+                    unassigned << name;
+                }
+            }
+
+            QJsonObject result;
+            result["assignments"] = assignments;
+            result["unassigned"] = QJsonArray::fromStringList(unassigned);
+            return result;
+        });
+}
+
+BootTimeEstimate MainWindow::computeBootTimeEstimate()
+{
+    // 从时钟树读取当前APB(clk_x2p/clk_fab_100M)与AXI(clk_bus)频率
+    double apbFreq = 0.0;
+    double axiFreq = 0.0;
+    if (m_clockConfigPage) {
+        apbFreq = m_clockConfigPage->getClockFrequency("clk_x2p");
+        if (apbFreq <= 0) {
+            apbFreq = m_clockConfigPage->getClockFrequency("clk_fab_100M");
+        }
+        axiFreq = m_clockConfigPage->getClockFrequency("clk_bus");
+    }
+    m_bootTimeEstimator.setBusFrequencies(apbFreq, axiFreq);
+
+    return m_bootTimeEstimator.estimate(m_codeGenerator.generateBoardInitBody(m_chipConfig));
+}
+
+void MainWindow::updateBootTimeEstimate()
+{
+    if (!m_bootTimeLabel || m_chipConfig.getChipType().isEmpty()) {
+        return;
+    }
+
+    BootTimeEstimate estimate = computeBootTimeEstimate();
+    int budgetUs = loadBootTimeBudget();
+    bool overBudget = budgetUs > 0 && estimate.totalUs() > budgetUs;
+
+    m_bootTimeLabel->setText(estimate.summary());
+    m_bootTimeLabel->setStyleSheet(QString("font-size: 12px; color: %1; padding: 0 6px;")
+                                       .arg(overBudget ? "#e74c3c" : "#2c3e50"));
+
+    QString tooltip = estimate.breakdown();
+    if (budgetUs > 0) {
+        tooltip += QString("\n预算: %1 µs%2").arg(budgetUs).arg(overBudget ? "（已超出）" : "");
+    }
+    m_bootTimeLabel->setToolTip(tooltip);
+}
+
+int MainWindow::loadBootTimeBudget() const
+{
+    QSettings settings("CviTek", "CviCubeMX");
+    return settings.value("bootTimeBudgetUs", 0).toInt();
+}
+
+void MainWindow::onSetBootTimeBudget()
+{
+    bool ok = false;
+    int budgetUs = QInputDialog::getInt(this, "启动耗时预算",
+                                        "板级初始化允许的最大耗时 (µs，0 表示不检查):",
+                                        loadBootTimeBudget(), 0, 10000000, 10, &ok);
+    if (!ok) {
+        return;
+    }
+
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.setValue("bootTimeBudgetUs", budgetUs);
+    settings.sync();
+
+    updateBootTimeEstimate();
+}
+
+QMap<QString, double> MainWindow::collectBandwidthClocks() const
+{
+    QMap<QString, double> clocks;
+    if (m_clockConfigPage) {
+        for (const QString& clockName : DdrBandwidthModel::requiredClocks()) {
+            clocks[clockName] = m_clockConfigPage->getClockFrequency(clockName);
+        }
+    }
+    return clocks;
+}
+
+void MainWindow::updateFlashBootClocks()
+{
+    if (!m_flashConfigPage || !m_clockConfigPage) {
+        return;
+    }
+
+    QMap<QString, double> clocks;
+    for (const QString& clockName : FlashBootEstimator::requiredClocks()) {
+        clocks[clockName] = m_clockConfigPage->getClockFrequency(clockName);
+    }
+    m_flashConfigPage->setClockFrequencies(clocks);
+}
+
+void MainWindow::updateDdrBandwidthStatus()
+{
+    if (!m_ddrBandwidthLabel || m_chipConfig.getChipType().isEmpty()) {
+        return;
+    }
+
+    DdrBandwidthReport report = DdrBandwidthModel::analyze(VideoPipelineConfig::load(),
+                                                           DdrBandwidthSettings::load(),
+                                                           collectBandwidthClocks());
+
+    QString color = "#2c3e50";
+    if (report.hasErrors()) {
+        color = "#e74c3c";
+    } else if (!report.notices.isEmpty()) {
+        color = "#d35400";
+    }
+
+    m_ddrBandwidthLabel->setText(QString("DDR %1%").arg(report.ddrUtilization(), 0, 'f', 0));
+    m_ddrBandwidthLabel->setStyleSheet(QString("font-size: 12px; color: %1; padding: 0 6px;").arg(color));
+
+    QStringList tooltip;
+    tooltip << report.summary();
+    tooltip << report.warnings;
+    tooltip << report.notices;
+    m_ddrBandwidthLabel->setToolTip(tooltip.join("\n"));
+}
+
+void MainWindow::updateClockGating()
+{
+    if (!m_clockGatingLabel || !m_clockConfigPage || m_chipConfig.getChipType().isEmpty()) {
+        return;
+    }
+
+    QMap<QString, PeripheralInfo> peripherals;
+    if (m_dtsConfig && m_dtsConfig->isLoaded()) {
+        peripherals = m_dtsConfig->getPeripheralInfos();
+    }
+    ClockGatingPlan plan = ClockGatingPlanner::plan(peripherals, m_peripheralStates,
+                                                    m_clockConfigPage->getClockFrequencies(),
+                                                    m_clockConfigPage->getClockParents());
+
+    // 门控序列写入生成的 cvi_board_init()，启动耗时估算随之变化
+    m_codeGenerator.setClockGatingSequence(plan.bootSequence());
+    updateBootTimeEstimate();
+
+    m_clockGatingLabel->setText(plan.summary());
+    m_clockGatingLabel->setStyleSheet(QString("font-size: 12px; color: %1; padding: 0 6px;")
+                                          .arg(plan.gates.isEmpty() ? "#7f8c8d" : "#27ae60"));
+    m_clockGatingLabel->setToolTip(plan.breakdown());
+}
+
+void MainWindow::onShowDdrBandwidth()
+{
+    DdrBandwidthDialog dialog(VideoPipelineConfig::load(), collectBandwidthClocks(), this);
+    dialog.exec();
+
+    updateDdrBandwidthStatus();
+}
+
+void MainWindow::onToggleDaemonClient(bool enabled)
+{
+    QSettings settings("CviTek", "CviCubeMX");
+    settings.setValue("daemonClientEnabled", enabled);
+
+    if (!enabled) {
+        if (m_daemonClient) {
+            m_daemonClient->disconnectFromServer();
+        }
+        return;
+    }
+
+    if (!m_daemonClient) {
+        m_daemonClient = new RpcClient(this);
+        connect(m_daemonClient, &RpcClient::connected, this, [this]() {
+            statusBar()->showMessage("已连接配置守护进程", 3000);
+            publishToDaemon();
+        });
+        connect(m_daemonClient, &RpcClient::disconnected, this, [this]() {
+            if (m_daemonClientAction && m_daemonClientAction->isChecked()) {
+                statusBar()->showMessage("配置守护进程未运行或已退出（CviCubeMX --daemon）", 5000);
+            }
+        });
+    }
+    m_daemonClient->connectToServer(RpcServer::defaultSocketName());
+}
+
+void MainWindow::publishToDaemon()
+{
+    if (!m_daemonClient || !m_daemonClient->isConnected()) {
+        return;
+    }
+
+    // 守护进程与界面打开的应为同一工程
+    if (!m_sourcePath.isEmpty()) {
+        QString board = m_selectedChip;
+        if (board == "请选择芯片型号") {
+            board.clear();
+        }
+        m_daemonClient->call("project.load", {{"source", m_sourcePath}, {"board", board}});
+    }
+
+    QJsonObject assignments;
+    const QMap<QString, QString> pins = m_chipConfig.getAllPinFunctions();
+    for (auto it = pins.constBegin(); it != pins.constEnd(); ++it) {
+        assignments[it.key()] = it.value();
+    }
+    if (!assignments.isEmpty()) {
+        m_daemonClient->call("pin.set", {{"assignments", assignments}});
+    }
+
+    publishClocksToDaemon();
+}
+
+void MainWindow::publishClocksToDaemon()
+{
+    if (!m_daemonClient || !m_daemonClient->isConnected() || !m_clockConfigPage) {
+        return;
+    }
+
+    QJsonObject frequencies;
+    const QMap<QString, double> clocks = m_clockConfigPage->getClockFrequencies();
+    for (auto it = clocks.constBegin(); it != clocks.constEnd(); ++it) {
+        frequencies[it.key()] = it.value();
+    }
+    m_daemonClient->call("clock.update", {{"frequencies", frequencies}, {"replace", true}});
+}
+
 QString MainWindow::loadLastSourcePath()
 {
     QSettings settings("CviTek", "CviCubeMX");
@@ -1937,22 +2781,13 @@ bool MainWindow::selectChipType()
 
     // 芯片选择下拉框
     QComboBox *chipCombo = new QComboBox(&chipDialog);
-    chipCombo->addItems({
-        "cv1840cp_wevb_0015a_spinor",
-        "cv1841cp_wevb_0015a_emmc",
-        "cv1841cp_wevb_0015a_spinand",
-        "cv1841cp_wevb_0015a_spinor",
-        "cv1842cp_wevb_0015a_spinand",
-        "cv1842cp_wevb_0015a_spinor",
-        "cv1842hp_wevb_0014a_emmc",
-        "cv1842hp_wevb_0014a_spinand",
-        "cv1842hp_wevb_0014a_spinor",
-        "cv1843hp_wevb_0014a_emmc",
-        "cv1843hp_wevb_0014a_spinand",
-        "cv1843hp_wevb_0014a_spinor"
-    });
-    // 设置默认选择为 cv1842hp_wevb_0014a_emmc
+    populateBoardList(chipCombo, false);
+    // 设置默认选择为 cv1842hp_wevb_0014a_emmc（SDK中存在时）
     chipCombo->setCurrentText("cv1842hp_wevb_0014a_emmc");
+    // 首次打开某个SDK时索引在后台生成，完成后刷新列表
+    connect(m_sdkIndexer, &SdkIndexer::catalogChanged, &chipDialog, [this, chipCombo]() {
+        populateBoardList(chipCombo, false);
+    });
     chipCombo->setStyleSheet(
         "QComboBox { "
         "font-size: 12px; "
@@ -2046,9 +2881,6 @@ bool MainWindow::selectChipType()
         // 加载外设状态
         if (!m_sourcePath.isEmpty()) {
             loadPeripheralStates();
-            if (m_pinoutConfigTree) {
-                updatePeripheralCheckBoxes();
-            }
         }
         
         return true;
@@ -2056,3 +2888,38 @@ bool MainWindow::selectChipType()
     
     return false;
 }
+
+void MainWindow::populateBoardList(QComboBox *combo, bool withPlaceholder)
+{
+    if (!combo) {
+        return;
+    }
+
+    const SdkCatalog& catalog = m_sdkIndexer->catalog();
+    QStringList boardNames = catalog.boardNames();
+    if (boardNames.isEmpty()) {
+        boardNames = SdkCatalog::defaultBoardNames();
+    }
+
+    // 重新填充时保持当前选择，不触发选择变化
+    const QString current = combo->currentText();
+    combo->blockSignals(true);
+    combo->clear();
+    if (withPlaceholder) {
+        combo->addItem("请选择芯片型号");
+    }
+    for (const QString& name : boardNames) {
+        combo->addItem(name);
+        const SdkBoard *board = catalog.findBoard(name);
+        if (board && !board->missingArtifacts().isEmpty()) {
+            combo->setItemData(combo->count() - 1,
+                               QString("缺少: %1").arg(board->missingArtifacts().join(", ")),
+                               Qt::ToolTipRole);
+        }
+    }
+    int index = combo->findText(current);
+    if (index >= 0) {
+        combo->setCurrentIndex(index);
+    }
+    combo->blockSignals(false);
+}
@@ -21,6 +21,8 @@
 #include <QTabWidget>
 #include <QMenuBar>
 #include <QSettings>
+#include <QProgressBar>
+#include <QToolButton>
 #include "chipconfig.h"
 #include "pinwidget.h"
 #include "codegenerator.h"
@@ -29,6 +31,16 @@
 #include "memoryconfig.h"
 #include "flashconfig.h"
 #include "aichatdialog.h"
+#include "boottimeestimator.h"
+#include "ddrbandwidthdialog.h"
+#include "clockgatingplanner.h"
+#include "fileioservice.h"
+#include "sdkindexer.h"
+#include "artifactwatcher.h"
+#include "aiknowledgebase.h"
+#include "aitoolbridge.h"
+#include "rpcclient.h"
+#include "pinfunction.h"
 
 QT_BEGIN_NAMESPACE
 QT_END_NAMESPACE
@@ -43,6 +55,7 @@ public:
 
 private slots:
     void onChipSelectionChanged();
+    void onArtifactChanged(const QString& filePath);
     void onStartProject();
     void onGenerateCode();
     void onPinFunctionChanged(const QString& pinName, const QString& function);
@@ -56,10 +69,15 @@ private slots:
     void onConfigTabChanged(int index);
     void onSelectSourcePath();
     void onShowAIChat();
+    void updateAIKnowledge();
+    void onSetBootTimeBudget();
+    void onShowDdrBandwidth();
+    void onToggleDaemonClient(bool enabled);
 
 private:
     void setupUI();
     void setupMenuBar();
+    void setupStatusBar();
     void setupPinoutTab();
     void setupPinoutConfigPanel();
     void setupClockTab();
@@ -79,14 +97,20 @@ private:
     void highlightPin(const QString& pinName, bool highlight);
     
     // defconfig文件处理
-    bool loadPeripheralStates();
-    bool savePeripheralStates();
+    void loadPeripheralStates();
+    QFuture<FileIoResult> savePeripheralState(const QString& peripheral, bool enabled);
     void updatePeripheralCheckBoxes();
+    void revertPeripheralCheckBox(const QString& peripheral, bool enabled);
     QString getDefconfigPath() const;
     QMap<QString, QStringList> getPeripheralConfigs() const;
     
+    // 默认 cvi_board_init.c 不存在时另存生成的完整代码
+    void saveStandaloneCode();
+    
     // 设备树配置处理
     void initializeDtsConfig();
+    // 监视当前板子的设备树、defconfig 和 cvi_board_init.c
+    void updateWatchedArtifacts();
     void showPeripheralConfig(const QString& peripheralType);
     
     // 路径选择和验证
@@ -100,6 +124,25 @@ private:
     
     // 芯片选型
     bool selectChipType();
+    // 用SDK目录索引中的板子填充下拉框，索引为空时使用内置列表
+    void populateBoardList(QComboBox *combo, bool withPlaceholder);
+
+    // 启动耗时估算
+    BootTimeEstimate computeBootTimeEstimate();
+    void updateBootTimeEstimate();
+    int loadBootTimeBudget() const;
+    QMap<QString, double> collectBandwidthClocks() const;
+    // AI助手：当前工程摘要 + 与问题相关的知识库片段
+    QString buildAIContext(const QString& question) const;
+    // 注册AI助手可调用的本地工具（引脚/时钟/内存查询）
+    void setupAITools();
+    void updateDdrBandwidthStatus();
+    void updateFlashBootClocks();
+    // 按禁用的外设分析可关闭的时钟，更新生成代码中的门控序列和功耗估算
+    void updateClockGating();
+    // 作为守护进程的客户端发布当前的引脚和时钟配置
+    void publishToDaemon();
+    void publishClocksToDaemon();
 
     // UI Components
     QWidget *m_centralWidget;
@@ -111,6 +154,9 @@ private:
     QMenuBar *m_menuBar;
     QMenu *m_toolsMenu;
     QAction *m_aiChatAction;
+    QAction *m_bootTimeBudgetAction;
+    QAction *m_ddrBandwidthAction;
+    QAction *m_daemonClientAction;
     
     // 顶部配置标签页
     QTabWidget *m_configTabWidget;
@@ -133,6 +179,13 @@ private:
     QComboBox *m_chipComboBox;
     QPushButton *m_startProjectButton;
     QPushButton *m_generateCodeButton;
+    QLabel *m_bootTimeLabel;
+    QLabel *m_ddrBandwidthLabel;
+    QLabel *m_clockGatingLabel;
+
+    // 状态栏：后台文件读写进度
+    QProgressBar *m_ioProgressBar;
+    QToolButton *m_ioCancelButton;
     
     QStackedWidget *m_stackedWidget;
     QWidget *m_welcomePage;
@@ -160,6 +213,8 @@ private:
     QString m_selectedChip;
     QMap<QString, PinWidget*> m_pinWidgets;
     CodeGenerator m_codeGenerator;
+    PinFunction m_pinFunction;      // 引脚功能数据库
+    BootTimeEstimator m_bootTimeEstimator;
     
     // BGA位置到PAD名称的映射表
     QMap<QString, QString> m_pinNameMappings;
@@ -172,15 +227,31 @@ private:
     
     // 外设配置状态
     QMap<QString, bool> m_peripheralStates;
+    QMap<QString, bool> m_peripheralStatesBase;     // 上次读取/写入defconfig时的状态，用于与外部修改合并
+    QString m_peripheralStatesPath;                 // m_peripheralStatesBase 对应的defconfig
+    QFuture<FileIoResult> m_peripheralStatesLoad;
+    bool m_peripheralStatesLoading;                 // 读取完成前禁用复选框，避免修改被读取结果覆盖
     
     // 设备树配置管理器
     DtsConfig *m_dtsConfig;
     
     // 源代码路径
     QString m_sourcePath;
+
+    // SDK板级目录索引
+    SdkIndexer *m_sdkIndexer;
+
+    // 外部修改检测
+    ArtifactWatcher *m_artifactWatcher;
     
     // AI 对话窗口
     AIChatDialog *m_aiChatDialog;
+    AIKnowledgeBase *m_aiKnowledge;
+    AIToolBridge m_aiTools;
+    QTimer *m_aiKnowledgeTimer;     // 合并工程状态的连续变化后再更新知识库
+
+    // 配置守护进程（CviCubeMX --daemon）的连接
+    RpcClient *m_daemonClient;
 };
 
 #endif // MAINWINDOW_H
@@ -20,6 +20,7 @@ MemoryConfigWidget::MemoryConfigWidget(QWidget *parent)
     , m_tableWidget(nullptr)
     , m_tableLayout(nullptr)
     , m_memoryTable(nullptr)
+    , m_regionModel(nullptr)
     , m_tableTitle(nullptr)
     , m_controlPanel(nullptr)
     , m_controlLayout(nullptr)
@@ -30,6 +31,7 @@ MemoryConfigWidget::MemoryConfigWidget(QWidget *parent)
     , m_resetButton(nullptr)
     , m_exportButton(nullptr)
     , m_importButton(nullptr)
+    , m_ionCalcButton(nullptr)
     , m_searchGroup(nullptr)
     , m_searchLayout(nullptr)
     , m_searchEdit(nullptr)
@@ -48,14 +50,15 @@ MemoryConfigWidget::MemoryConfigWidget(QWidget *parent)
     , m_configExpanded(false)
     , m_visualizationGroup(nullptr)
     , m_visualizationLayout(nullptr)
-    , m_memoryMapText(nullptr)
+    , m_memoryMapView(nullptr)
     , m_sourcePath("")
     , m_chipType("")
 {
+    m_layoutEngine.loadDefaultConstraints(MEMORY_BASE_ADDRESS, TOTAL_MEMORY_SIZE);
     setupUI();
     initializeMemoryRegions();
-    populateTable();
     updateMemoryVisualization();
+    validateMemoryLayout();
 }
 
 MemoryConfigWidget::~MemoryConfigWidget()
@@ -112,13 +115,10 @@ void MemoryConfigWidget::setupMemoryTable()
         "border-radius: 4px;"
     );
     
-    // 创建内存表格
-    m_memoryTable = new QTableWidget(0, COL_COUNT, m_tableWidget);
-    
-    // 设置表头
-    QStringList headers;
-    headers << "Name" << "Start Address" << "End Address" << "Size" << "Size(M/K/B)";
-    m_memoryTable->setHorizontalHeaderLabels(headers);
+    // 创建内存表格（区域数据与表头由模型提供）
+    m_regionModel = new MemoryRegionModel(this);
+    m_memoryTable = new QTableView(m_tableWidget);
+    m_memoryTable->setModel(m_regionModel);
     
     // 设置表格属性
     m_memoryTable->setAlternatingRowColors(true);
@@ -128,17 +128,17 @@ void MemoryConfigWidget::setupMemoryTable()
     
     // 设置表格样式
     m_memoryTable->setStyleSheet(
-        "QTableWidget { "
+        "QTableView { "
         "gridline-color: #bdc3c7; "
         "background-color: #ffffff; "
         "border: 1px solid #bdc3c7; "
         "border-radius: 4px; "
         "} "
-        "QTableWidget::item { "
+        "QTableView::item { "
         "padding: 8px; "
         "border-bottom: 1px solid #ecf0f1; "
         "} "
-        "QTableWidget::item:selected { "
+        "QTableView::item:selected { "
         "background-color: #3498db; "
         "color: white; "
         "} "
@@ -154,19 +154,15 @@ void MemoryConfigWidget::setupMemoryTable()
     // 设置列宽
     QHeaderView* header = m_memoryTable->horizontalHeader();
     header->setStretchLastSection(true);
-    header->resizeSection(COL_NAME, 150);
-    header->resizeSection(COL_START_ADDRESS, 120);
-    header->resizeSection(COL_END_ADDRESS, 120);
-    header->resizeSection(COL_SIZE_HEX, 100);
-    header->resizeSection(COL_SIZE_FORMATTED, 100);
-    
-    // 连接信号 - 移除itemChanged信号连接，因为表格现在不可编辑
-    // connect(m_memoryTable, &QTableWidget::itemChanged, 
-    //         this, &MemoryConfigWidget::onTableItemChanged);
+    header->resizeSection(MemoryRegionModel::COL_NAME, 150);
+    header->resizeSection(MemoryRegionModel::COL_START_ADDRESS, 120);
+    header->resizeSection(MemoryRegionModel::COL_END_ADDRESS, 120);
+    header->resizeSection(MemoryRegionModel::COL_SIZE_HEX, 100);
+    header->resizeSection(MemoryRegionModel::COL_SIZE_FORMATTED, 100);
     
     // 连接双击信号，用于展开配置面板
-    connect(m_memoryTable, &QTableWidget::itemDoubleClicked, 
-            this, &MemoryConfigWidget::onTableItemDoubleClicked);
+    connect(m_memoryTable, &QTableView::doubleClicked, 
+            this, &MemoryConfigWidget::onTableDoubleClicked);
     
     // 添加到布局
     m_tableLayout->addWidget(m_tableTitle);
@@ -191,6 +187,7 @@ void MemoryConfigWidget::setupControlPanel()
     m_resetButton = new QPushButton("重置配置", m_operationGroup);
     m_exportButton = new QPushButton("导出配置", m_operationGroup);
     m_importButton = new QPushButton("导入配置", m_operationGroup);
+    m_ionCalcButton = new QPushButton("ION容量计算", m_operationGroup);
     
     // 设置按钮样式
     QString buttonStyle = 
@@ -214,12 +211,14 @@ void MemoryConfigWidget::setupControlPanel()
     m_resetButton->setStyleSheet(buttonStyle.replace("#e74c3c", "#f39c12").replace("#c0392b", "#e67e22").replace("#a93226", "#d35400"));
     m_exportButton->setStyleSheet(buttonStyle.replace("#f39c12", "#27ae60").replace("#e67e22", "#229954").replace("#d35400", "#1e8449"));
     m_importButton->setStyleSheet(buttonStyle.replace("#27ae60", "#8e44ad").replace("#229954", "#7d3c98").replace("#1e8449", "#6c3483"));
+    m_ionCalcButton->setStyleSheet(buttonStyle.replace("#8e44ad", "#16a085").replace("#7d3c98", "#138d75").replace("#6c3483", "#117a65"));
     
     m_operationLayout->addWidget(m_addButton);
     m_operationLayout->addWidget(m_removeButton);
     m_operationLayout->addWidget(m_resetButton);
     m_operationLayout->addWidget(m_exportButton);
     m_operationLayout->addWidget(m_importButton);
+    m_operationLayout->addWidget(m_ionCalcButton);
     
     // 地址区域搜索组
     m_searchGroup = new QGroupBox("地址区域搜索", m_controlPanel);
@@ -371,21 +370,12 @@ void MemoryConfigWidget::setupControlPanel()
     m_visualizationGroup = new QGroupBox("内存映射", m_controlPanel);
     m_visualizationLayout = new QVBoxLayout(m_visualizationGroup);
     
-    m_memoryMapText = new QTextEdit(m_visualizationGroup);
-    m_memoryMapText->setReadOnly(true);
-    m_memoryMapText->setMaximumHeight(150);
-    m_memoryMapText->setStyleSheet(
-        "QTextEdit { "
-        "background-color: #2c3e50; "
-        "color: #ecf0f1; "
-        "border: 1px solid #34495e; "
-        "border-radius: 4px; "
-        "font-family: 'Courier New', monospace; "
-        "font-size: 10px; "
-        "}"
-    );
+    m_memoryMapView = new MemoryMapView(m_visualizationGroup);
+    m_memoryMapView->setMinimumHeight(260);
+    m_memoryMapView->setAddressRange(MEMORY_BASE_ADDRESS, TOTAL_MEMORY_SIZE);
+    m_memoryMapView->setBackgroundRegions(m_layoutEngine.backgroundRegions());
     
-    m_visualizationLayout->addWidget(m_memoryMapText);
+    m_visualizationLayout->addWidget(m_memoryMapView);
     
     // 添加到控制面板布局
     m_controlLayout->addWidget(m_operationGroup);
@@ -400,12 +390,16 @@ void MemoryConfigWidget::setupControlPanel()
     connect(m_resetButton, &QPushButton::clicked, this, &MemoryConfigWidget::onResetRegions);
     connect(m_exportButton, &QPushButton::clicked, this, &MemoryConfigWidget::onExportConfig);
     connect(m_importButton, &QPushButton::clicked, this, &MemoryConfigWidget::onImportConfig);
+    connect(m_ionCalcButton, &QPushButton::clicked, this, &MemoryConfigWidget::onIonPoolCalculator);
     
     // 连接搜索和配置字段信号
     connect(m_searchEdit, &QLineEdit::textChanged, this, &MemoryConfigWidget::onSearchTextChanged);
     connect(m_searchEdit, &QLineEdit::returnPressed, this, &MemoryConfigWidget::onSearchEnterPressed);
     connect(m_configToggleButton, &QToolButton::clicked, this, &MemoryConfigWidget::onToggleConfigPanel);
-    connect(m_memoryTable, &QTableWidget::itemSelectionChanged, 
+    connect(m_memoryMapView, &MemoryMapView::regionSelected, this, &MemoryConfigWidget::onMapRegionSelected);
+    connect(m_memoryMapView, &MemoryMapView::regionGeometryChanged,
+            this, &MemoryConfigWidget::onMapRegionGeometryChanged);
+    connect(m_memoryTable->selectionModel(), &QItemSelectionModel::selectionChanged, 
             this, &MemoryConfigWidget::onTableSelectionChanged);
     
     // 配置字段只在编辑完成时更新（使用editingFinished信号而不是textChanged）
@@ -450,9 +444,7 @@ void MemoryConfigWidget::initializeMemoryRegions()
         {"RTOS_ION", 0x8a000000, 0x6000000, true, "RTOS ION", 18}                // 96MB
     };
     
-    m_memoryRegions.clear();
-    m_regionOrder.clear();  // 清空顺序列表
-    
+    QList<MemoryRegion> regions;
     for (const auto& data : regionData) {
         MemoryRegion region;
         region.name = data.name;
@@ -463,136 +455,25 @@ void MemoryConfigWidget::initializeMemoryRegions()
         region.isEditable = data.isEditable;
         region.description = data.description;
         
-        m_memoryRegions[region.name] = region;
-        m_regionOrder.append(region.name);  // 保存顺序
+        regions.append(region);  // 按原始顺序
     }
-}
-
-void MemoryConfigWidget::populateTable()
-{
-    // 暂时断开信号，避免在填充过程中触发itemChanged
-    m_memoryTable->blockSignals(true);
-    
-    // 清空表格
-    m_memoryTable->setRowCount(0);
     
-    // 按照原始顺序填充表格
-    for (int i = 0; i < m_regionOrder.size(); ++i) {
-        const QString& regionName = m_regionOrder[i];
-        if (!m_memoryRegions.contains(regionName)) continue;
-        
-        const MemoryRegion& region = m_memoryRegions[regionName];
-        
-        m_memoryTable->insertRow(i);
-        
-        // 名称列 - 设置为只读，只能通过配置面板修改
-        QTableWidgetItem* nameItem = new QTableWidgetItem(region.name);
-        nameItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);  // 移除 ItemIsEditable 标志
-        m_memoryTable->setItem(i, COL_NAME, nameItem);
-        
-        // 起始地址列 - 设置为只读，只能通过配置面板修改
-        QTableWidgetItem* startItem = new QTableWidgetItem(formatAddress(region.startAddress));
-        startItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);  // 移除 ItemIsEditable 标志
-        m_memoryTable->setItem(i, COL_START_ADDRESS, startItem);
-        
-        // 结束地址列 - 设置为只读，只能通过配置面板修改
-        QTableWidgetItem* endItem = new QTableWidgetItem(formatAddress(region.endAddress));
-        endItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);  // 移除 ItemIsEditable 标志
-        m_memoryTable->setItem(i, COL_END_ADDRESS, endItem);
-        
-        // 大小（十六进制）列
-        QTableWidgetItem* sizeItem = new QTableWidgetItem(QString("0x%1").arg(region.size, 0, 16));
-        sizeItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        sizeItem->setBackground(QBrush(QColor("#f8f9fa")));
-        m_memoryTable->setItem(i, COL_SIZE_HEX, sizeItem);
-        
-        // 大小（格式化）列
-        QTableWidgetItem* sizeFormattedItem = new QTableWidgetItem(region.sizeString);
-        sizeFormattedItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        sizeFormattedItem->setBackground(QBrush(QColor("#f8f9fa")));
-        m_memoryTable->setItem(i, COL_SIZE_FORMATTED, sizeFormattedItem);
-    }
-    
-    // 重新启用信号
-    m_memoryTable->blockSignals(false);
+    m_regionModel->setRegions(regions);
 }
 
-void MemoryConfigWidget::onTableItemChanged(QTableWidgetItem* item)
+QString MemoryConfigWidget::currentRegionName() const
 {
-    if (!item) return;
-    
-    int row = item->row();
-    int col = item->column();
-    
-    // 确保行号在有效范围内
-    if (row < 0 || row >= m_regionOrder.size()) return;
-    
-    // 从顺序列表获取正确的区域名称
-    QString regionName = m_regionOrder[row];
-    if (!m_memoryRegions.contains(regionName)) return;
-    
-    MemoryRegion& region = m_memoryRegions[regionName];
-    
-    // 根据修改的列更新数据
-    switch (col) {
-        case COL_NAME:
-            // 名称更改，需要更新映射
-            if (item->text() != regionName) {
-                // 更新顺序列表中的名称
-                m_regionOrder[row] = item->text();
-                
-                m_memoryRegions.remove(regionName);
-                region.name = item->text();
-                m_memoryRegions[region.name] = region;
-            }
-            break;
-            
-        case COL_START_ADDRESS:
-            region.startAddress = parseAddress(item->text());
-            // 基于size重新计算endAddress
-            region.endAddress = region.startAddress + region.size;
-            break;
-            
-        case COL_END_ADDRESS:
-            // 当endAddress改变时，重新计算size
-            {
-                quint64 newEndAddress = parseAddress(item->text());
-                if (newEndAddress > region.startAddress) {
-                    region.size = newEndAddress - region.startAddress;
-                    region.endAddress = newEndAddress;
-                    region.sizeString = formatSize(region.size);
-                } else {
-                    // 如果输入的结束地址无效，恢复原值
-                    item->setText(formatAddress(region.endAddress));
-                }
-            }
-            break;
-    }
-    
-    // 更新表格中的计算列
-    updateSizeString(row);
-    
-    // 更新内存可视化
-    updateMemoryVisualization();
-    validateMemoryLayout();
-    
-    // 发送信号
-    emit configChanged();
-    emit memoryRegionChanged(region.name);
+    QModelIndex current = m_memoryTable->currentIndex();
+    return current.isValid() ? m_regionModel->nameAt(current.row()) : QString();
 }
 
-void MemoryConfigWidget::onTableItemDoubleClicked(QTableWidgetItem* item)
+void MemoryConfigWidget::onTableDoubleClicked(const QModelIndex& index)
 {
-    if (!item) return;
-    
-    int row = item->row();
-    
-    // 确保行号在有效范围内
-    if (row < 0 || row >= m_regionOrder.size()) return;
+    if (!index.isValid()) return;
     
     // 选择整行
-    m_memoryTable->selectRow(row);
-    m_memoryTable->setCurrentItem(item);
+    m_memoryTable->selectRow(index.row());
+    m_memoryTable->setCurrentIndex(index);
     
     // 展开配置面板
     setConfigPanelExpanded(true);
@@ -607,39 +488,10 @@ void MemoryConfigWidget::onTableItemDoubleClicked(QTableWidgetItem* item)
     onTableSelectionChanged();
 }
 
-void MemoryConfigWidget::updateSizeString(int row)
-{
-    // 确保行号在有效范围内
-    if (row < 0 || row >= m_regionOrder.size()) return;
-    
-    // 从顺序列表获取正确的区域名称
-    QString regionName = m_regionOrder[row];
-    if (!m_memoryRegions.contains(regionName)) return;
-    
-    const MemoryRegion& region = m_memoryRegions[regionName];
-    
-    // 更新大小列
-    QTableWidgetItem* sizeItem = m_memoryTable->item(row, COL_SIZE_HEX);
-    if (sizeItem) {
-        sizeItem->setText(QString("0x%1").arg(region.size, 0, 16));
-    }
-    
-    QTableWidgetItem* sizeFormattedItem = m_memoryTable->item(row, COL_SIZE_FORMATTED);
-    if (sizeFormattedItem) {
-        sizeFormattedItem->setText(region.sizeString);
-    }
-    
-    // 更新结束地址列
-    QTableWidgetItem* endItem = m_memoryTable->item(row, COL_END_ADDRESS);
-    if (endItem) {
-        endItem->setText(formatAddress(region.endAddress));
-    }
-}
-
 void MemoryConfigWidget::onAddRegion()
 {
     // 添加新的内存区域
-    QString newName = QString("NEW_REGION_%1").arg(m_memoryRegions.size() + 1);
+    QString newName = QString("NEW_REGION_%1").arg(m_regionModel->rowCount() + 1);
     
     MemoryRegion region;
     region.name = newName;
@@ -650,11 +502,7 @@ void MemoryConfigWidget::onAddRegion()
     region.isEditable = true;
     region.description = "用户自定义区域";
     
-    m_memoryRegions[region.name] = region;
-    m_regionOrder.append(region.name);  // 添加到顺序列表
-    
-    // 重新填充表格
-    populateTable();
+    m_regionModel->appendRegion(region);  // 追加到表格末尾
     updateMemoryVisualization();
     
     emit configChanged();
@@ -663,27 +511,19 @@ void MemoryConfigWidget::onAddRegion()
 void MemoryConfigWidget::onRemoveRegion()
 {
     // 删除选中的内存区域
-    QTableWidgetItem* currentItem = m_memoryTable->currentItem();
-    if (!currentItem) {
+    QString regionName = currentRegionName();
+    if (regionName.isEmpty()) {
         QMessageBox::warning(this, "警告", "请选择要删除的内存区域！");
         return;
     }
     
-    int currentRow = currentItem->row();
-    QTableWidgetItem* nameItem = m_memoryTable->item(currentRow, COL_NAME);
-    if (!nameItem) return;
-    
-    QString regionName = nameItem->text();
-    
     // 确认删除
     int ret = QMessageBox::question(this, "确认删除", 
                                    QString("确定要删除内存区域 \"%1\" 吗？").arg(regionName),
                                    QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        m_memoryRegions.remove(regionName);
-        m_regionOrder.removeAll(regionName);  // 从顺序列表中移除
-        populateTable();
+        m_regionModel->removeRegion(regionName);
         updateMemoryVisualization();
         
         emit configChanged();
@@ -699,7 +539,6 @@ void MemoryConfigWidget::onResetRegions()
     
     if (ret == QMessageBox::Yes) {
         initializeMemoryRegions();
-        populateTable();
         updateMemoryVisualization();
         
         emit configChanged();
@@ -716,14 +555,17 @@ void MemoryConfigWidget::onExportConfig()
     }
     
     // 导出到defconfig文件
-    if (exportToDefconfig(m_sourcePath, m_chipType)) {
-        QString defconfigPath = QString("build/boards/cv184x/%1/%1_defconfig")
-                               .arg(m_chipType);
-        QMessageBox::information(this, "成功", 
-                               QString("内存配置已导出到: %1").arg(defconfigPath));
-    } else {
-        QMessageBox::critical(this, "错误", "导出内存配置失败！");
-    }
+    QString defconfigPath = QString("build/boards/cv184x/%1/%1_defconfig")
+                           .arg(m_chipType);
+    exportToDefconfig(m_sourcePath, m_chipType).then(this, [this, defconfigPath](FileIoResult result) {
+        if (result.ok) {
+            QMessageBox::information(this, "成功", 
+                                   QString("内存配置已导出到: %1").arg(defconfigPath));
+        } else {
+            QMessageBox::critical(this, "错误",
+                                QString("导出内存配置失败！\n%1").arg(result.errorMessage));
+        }
+    });
 }
 
 void MemoryConfigWidget::onImportConfig()
@@ -735,7 +577,6 @@ void MemoryConfigWidget::onImportConfig()
     
     if (!fileName.isEmpty()) {
         if (importFromJson(fileName)) {
-            populateTable();
             updateMemoryVisualization();
             QMessageBox::information(this, "成功", "内存配置已导入: " + fileName);
             emit configChanged();
@@ -760,28 +601,26 @@ void MemoryConfigWidget::onToggleConfigPanel()
 
 void MemoryConfigWidget::searchAndSelectRegion(const QString& searchText)
 {
-    // 精确匹配搜索文本与内存区域名称
-    for (int row = 0; row < m_memoryTable->rowCount(); ++row) {
-        QTableWidgetItem* nameItem = m_memoryTable->item(row, COL_NAME);
-        if (nameItem && nameItem->text().compare(searchText, Qt::CaseInsensitive) == 0) {
-            // 找到匹配的区域 - 选择整行并设置当前项
-            m_memoryTable->selectRow(row);
-            m_memoryTable->setCurrentItem(nameItem);
-            
-            // 展开配置面板
-            setConfigPanelExpanded(true);
-            
-            // 启用配置字段
-            m_nameEdit->setEnabled(true);
-            m_startAddressEdit->setEnabled(true);
-            m_sizeEdit->setEnabled(true);
-            m_sizeUnitCombo->setEnabled(true);
-            
-            // 更新配置字段内容
-            onTableSelectionChanged();
-            
-            return;
-        }
+    // 精确匹配搜索文本与内存区域名称（按名称索引查找）
+    int row = m_regionModel->findName(searchText);
+    if (row >= 0) {
+        // 找到匹配的区域 - 选择整行并设置当前项
+        m_memoryTable->selectRow(row);
+        m_memoryTable->setCurrentIndex(m_regionModel->index(row, MemoryRegionModel::COL_NAME));
+        
+        // 展开配置面板
+        setConfigPanelExpanded(true);
+        
+        // 启用配置字段
+        m_nameEdit->setEnabled(true);
+        m_startAddressEdit->setEnabled(true);
+        m_sizeEdit->setEnabled(true);
+        m_sizeUnitCombo->setEnabled(true);
+        
+        // 更新配置字段内容
+        onTableSelectionChanged();
+        
+        return;
     }
     
     // 如果没有找到精确匹配，显示提示
@@ -813,36 +652,26 @@ void MemoryConfigWidget::setConfigPanelExpanded(bool expanded)
 void MemoryConfigWidget::onSearchTextChanged(const QString& searchText)
 {
     // 实现搜索过滤功能（实时过滤，但不自动选择）
-    for (int row = 0; row < m_memoryTable->rowCount(); ++row) {
-        QTableWidgetItem* nameItem = m_memoryTable->item(row, COL_NAME);
-        if (nameItem) {
-            bool visible = searchText.isEmpty() || 
-                          nameItem->text().contains(searchText, Qt::CaseInsensitive);
-            m_memoryTable->setRowHidden(row, !visible);
-        }
+    for (int row = 0; row < m_regionModel->rowCount(); ++row) {
+        m_memoryTable->setRowHidden(row, !m_regionModel->nameContains(row, searchText));
     }
 }
 
 void MemoryConfigWidget::onTableSelectionChanged()
 {
+    // 同步内存映射图中的选中区域
+    QString regionName = currentRegionName();
+    if (!regionName.isEmpty()) {
+        m_memoryMapView->setSelectedRegion(regionName);
+    }
+    
     // 只有在配置面板展开时才更新配置字段
     if (!m_configExpanded) {
         return;
     }
     
     // 当表格选择改变时，更新配置字段
-    QTableWidgetItem* currentItem = m_memoryTable->currentItem();
-    if (!currentItem) {
-        // 清空配置字段
-        m_nameEdit->clear();
-        m_startAddressEdit->clear();
-        m_sizeEdit->clear();
-        m_sizeUnitCombo->setCurrentText("M");
-        return;
-    }
-    
-    int currentRow = currentItem->row();
-    if (currentRow < 0 || currentRow >= m_regionOrder.size()) {
+    if (regionName.isEmpty()) {
         // 清空配置字段
         m_nameEdit->clear();
         m_startAddressEdit->clear();
@@ -852,63 +681,60 @@ void MemoryConfigWidget::onTableSelectionChanged()
     }
     
     // 获取选中区域的数据
-    QString regionName = m_regionOrder[currentRow];
-    if (m_memoryRegions.contains(regionName)) {
-        const MemoryRegion& region = m_memoryRegions[regionName];
-        
-        // 暂时断开信号，避免在填充过程中触发onConfigFieldChanged
-        m_nameEdit->blockSignals(true);
-        m_startAddressEdit->blockSignals(true);
-        m_sizeEdit->blockSignals(true);
-        m_sizeUnitCombo->blockSignals(true);
-        
-        // 填充配置字段
-        m_nameEdit->setText(region.name);
-        m_startAddressEdit->setText(formatAddress(region.startAddress));
-        
-        // 对于ION区域，Start Address是基于End Address和Size计算的，设置为只读
-        if (regionName == "ION") {
-            m_startAddressEdit->setReadOnly(true);
-            m_startAddressEdit->setToolTip("ION的起始地址由结束地址和大小自动计算");
-            m_startAddressEdit->setStyleSheet(
-                "QLineEdit { "
-                "padding: 6px; "
-                "border: 1px solid #bdc3c7; "
-                "border-radius: 4px; "
-                "background-color: #f0f0f0; "
-                "color: #7f8c8d; "
-                "}"
-            );
-        } else {
-            m_startAddressEdit->setReadOnly(false);
-            m_startAddressEdit->setToolTip("");
-            m_startAddressEdit->setStyleSheet(
-                "QLineEdit { "
-                "padding: 6px; "
-                "border: 1px solid #bdc3c7; "
-                "border-radius: 4px; "
-                "background-color: #ffffff; "
-                "} "
-                "QLineEdit:focus { "
-                "border: 2px solid #3498db; "
-                "}"
-            );
-        }
-        
-        // 自动选择合适的单位显示大小
-        QString sizeText;
-        QString unit;
-        formatSizeForInput(region.size, sizeText, unit);
-        
-        m_sizeEdit->setText(sizeText);
-        m_sizeUnitCombo->setCurrentText(unit);
-        
-        // 重新连接信号
-        m_nameEdit->blockSignals(false);
-        m_startAddressEdit->blockSignals(false);
-        m_sizeEdit->blockSignals(false);
-        m_sizeUnitCombo->blockSignals(false);
+    const MemoryRegion region = m_regionModel->region(regionName);
+    
+    // 暂时断开信号，避免在填充过程中触发onConfigFieldChanged
+    m_nameEdit->blockSignals(true);
+    m_startAddressEdit->blockSignals(true);
+    m_sizeEdit->blockSignals(true);
+    m_sizeUnitCombo->blockSignals(true);
+    
+    // 填充配置字段
+    m_nameEdit->setText(region.name);
+    m_startAddressEdit->setText(formatAddress(region.startAddress));
+    
+    // 对于ION等由约束推导地址的区域，Start Address是基于其他区域和Size计算的，设置为只读
+    if (m_layoutEngine.isAddressDerived(regionName)) {
+        m_startAddressEdit->setReadOnly(true);
+        m_startAddressEdit->setToolTip(QString("%1的起始地址由布局约束和大小自动计算").arg(regionName));
+        m_startAddressEdit->setStyleSheet(
+            "QLineEdit { "
+            "padding: 6px; "
+            "border: 1px solid #bdc3c7; "
+            "border-radius: 4px; "
+            "background-color: #f0f0f0; "
+            "color: #7f8c8d; "
+            "}"
+        );
+    } else {
+        m_startAddressEdit->setReadOnly(false);
+        m_startAddressEdit->setToolTip("");
+        m_startAddressEdit->setStyleSheet(
+            "QLineEdit { "
+            "padding: 6px; "
+            "border: 1px solid #bdc3c7; "
+            "border-radius: 4px; "
+            "background-color: #ffffff; "
+            "} "
+            "QLineEdit:focus { "
+            "border: 2px solid #3498db; "
+            "}"
+        );
     }
+    
+    // 自动选择合适的单位显示大小
+    QString sizeText;
+    QString unit;
+    formatSizeForInput(region.size, sizeText, unit);
+    
+    m_sizeEdit->setText(sizeText);
+    m_sizeUnitCombo->setCurrentText(unit);
+    
+    // 重新连接信号
+    m_nameEdit->blockSignals(false);
+    m_startAddressEdit->blockSignals(false);
+    m_sizeEdit->blockSignals(false);
+    m_sizeUnitCombo->blockSignals(false);
 }
 
 void MemoryConfigWidget::onConfigFieldChanged()
@@ -919,44 +745,31 @@ void MemoryConfigWidget::onConfigFieldChanged()
     }
     
     // 当配置字段改变时，更新对应的内存区域
-    QTableWidgetItem* currentItem = m_memoryTable->currentItem();
-    if (!currentItem) {
+    QString regionName = currentRegionName();
+    if (regionName.isEmpty()) {
         return;
     }
     
-    int currentRow = currentItem->row();
-    if (currentRow < 0 || currentRow >= m_regionOrder.size()) {
-        return;
-    }
-    
-    QString regionName = m_regionOrder[currentRow];
-    if (!m_memoryRegions.contains(regionName)) {
-        return;
-    }
+    // 在副本上修改，布局引擎重排并通过约束校验后才写回模型
+    QMap<QString, MemoryRegion> regions = m_regionModel->regions();
+    MemoryRegion region = regions.value(regionName);
     
-    MemoryRegion& region = m_memoryRegions[regionName];
-    
-    // 保存所有旧值，用于验证失败时回滚
+    // 保存旧值，用于验证失败时恢复配置面板
     MemoryRegion oldRegion = region;
     QString oldRegionName = regionName;
-    QMap<QString, MemoryRegion> oldMemoryRegions = m_memoryRegions;
-    
-    // 保存旧的size值，用于判断是否有变化
-    quint64 oldSize = region.size;
     
     // 更新区域数据
     QString newName = m_nameEdit->text().trimmed();
-    if (!newName.isEmpty() && newName != region.name) {
+    if (!newName.isEmpty() && newName != region.name && !regions.contains(newName)) {
         // 更新名称映射
-        m_memoryRegions.remove(regionName);
-        m_regionOrder[currentRow] = newName;
+        regions.remove(regionName);
         region.name = newName;
-        m_memoryRegions[newName] = region;
+        m_layoutEngine.renameRegion(regionName, newName);
         regionName = newName;
     }
     
-    // 更新起始地址（ION区域除外，因为ION的Start Address需要基于End Address和Size计算）
-    if (regionName != "ION") {
+    // 更新起始地址（由约束推导地址的区域除外，如ION的Start Address基于RTOS_ION和Size计算）
+    if (!m_layoutEngine.isAddressDerived(regionName)) {
         region.startAddress = parseAddress(m_startAddressEdit->text());
     }
     
@@ -978,124 +791,27 @@ void MemoryConfigWidget::onConfigFieldChanged()
         }
         
         region.size = actualSize;
-        
-        // 特殊处理：ION和RTOS_ION区域在size改变时需要调整Start Address
-        if (regionName == "ION") {
-            // ION区域：End Address基于RTOS_ION的Start Address
-            // 根据 memmap.py 第67行：ION_ADDR = RTOS_ION_ADDR - ION_SIZE
-            // 这意味着 ION 的 End Address = RTOS_ION 的 Start Address
-            if (m_memoryRegions.contains("RTOS_ION")) {
-                region.endAddress = m_memoryRegions["RTOS_ION"].startAddress;
-            } else {
-                // 如果没有RTOS_ION，使用默认的256M边界计算
-                const quint64 FIXED_256M_BOUNDARY = MEMORY_BASE_ADDRESS + 256 * 1024 * 1024;
-                quint64 defaultRtosIonSize = 96 * 1024 * 1024;  // 默认96M
-                region.endAddress = FIXED_256M_BOUNDARY - defaultRtosIonSize;
-            }
-            // 基于End Address和新的size计算Start Address
-            region.startAddress = region.endAddress - actualSize;
-            
-            // 同步更新H26X_BITSTREAM、H26X_ENC_BUFF、ISP_MEM_BASE的Start Address
-            // 这些区域与ION共享起始地址
-            QStringList relatedRegions = {"H26X_BITSTREAM", "H26X_ENC_BUFF", "ISP_MEM_BASE"};
-            for (const QString& relatedName : relatedRegions) {
-                if (m_memoryRegions.contains(relatedName)) {
-                    m_memoryRegions[relatedName].startAddress = region.startAddress;
-                    m_memoryRegions[relatedName].endAddress = m_memoryRegions[relatedName].startAddress + m_memoryRegions[relatedName].size;
-                    // 更新相关区域的sizeString
-                    m_memoryRegions[relatedName].sizeString = formatSize(m_memoryRegions[relatedName].size);
-                }
-            }
-        } else if (regionName == "RTOS_ION" && actualSize != oldSize) {
-            // RTOS_ION区域：调整Start Address，End Address固定在256M边界
-            // 根据 memmap.py 第56行：RTOS_ION_ADDR = DRAM_BASE + 256 * SIZE_1M - RTOS_ION_SIZE
-            // 这意味着 RTOS_ION 的结束地址固定在 256M 处，起始地址向前调整
-            const quint64 FIXED_256M_BOUNDARY = MEMORY_BASE_ADDRESS + 256 * 1024 * 1024;  // 0x90000000
-            region.endAddress = FIXED_256M_BOUNDARY;
-            region.startAddress = region.endAddress - actualSize;
-            
-            // 当RTOS_ION改变时，需要调整ION及相关区域的Start Address
-            // 计算新的ION起始地址：RTOS_ION的Start Address之前
-            quint64 newIonStartAddress = region.startAddress;
-            
-            if (m_memoryRegions.contains("ION")) {
-                quint64 ionSize = m_memoryRegions["ION"].size;
-                m_memoryRegions["ION"].startAddress = newIonStartAddress - ionSize;
-                m_memoryRegions["ION"].endAddress = m_memoryRegions["ION"].startAddress + ionSize;
-                // 更新ION的sizeString
-                m_memoryRegions["ION"].sizeString = formatSize(ionSize);
-                
-                // H26X_BITSTREAM、H26X_ENC_BUFF、ISP_MEM_BASE与ION共享Start Address
-                QStringList relatedRegions = {"H26X_BITSTREAM", "H26X_ENC_BUFF", "ISP_MEM_BASE"};
-                for (const QString& relatedName : relatedRegions) {
-                    if (m_memoryRegions.contains(relatedName)) {
-                        m_memoryRegions[relatedName].startAddress = m_memoryRegions["ION"].startAddress;
-                        m_memoryRegions[relatedName].endAddress = m_memoryRegions[relatedName].startAddress + m_memoryRegions[relatedName].size;
-                        // 更新相关区域的sizeString
-                        m_memoryRegions[relatedName].sizeString = formatSize(m_memoryRegions[relatedName].size);
-                    }
-                }
-            }
-        } else {
-            // 其他区域：基于start address + size计算end address
-            region.endAddress = region.startAddress + region.size;
-        }
+        region.endAddress = region.startAddress + region.size;
         
         // 确保sizeString使用实际的size值更新
         region.sizeString = formatSize(actualSize);
     }
     
-    // 先更新内存区域映射中的数据
-    m_memoryRegions[regionName] = region;
-    
-    // 更新表格显示
-    updateSizeString(currentRow);
-    
-    // 如果是ION或RTOS_ION，需要更新相关区域的表格显示
-    if (regionName == "ION" || regionName == "RTOS_ION") {
-        QStringList relatedRegions;
-        if (regionName == "ION") {
-            relatedRegions = {"H26X_BITSTREAM", "H26X_ENC_BUFF", "ISP_MEM_BASE"};
-        } else {
-            relatedRegions = {"ION", "H26X_BITSTREAM", "H26X_ENC_BUFF", "ISP_MEM_BASE"};
-        }
-        
-        for (const QString& relatedName : relatedRegions) {
-            int relatedRow = m_regionOrder.indexOf(relatedName);
-            if (relatedRow >= 0) {
-                updateSizeString(relatedRow);
-                
-                // 更新表格中的地址
-                if (QTableWidgetItem* startItem = m_memoryTable->item(relatedRow, COL_START_ADDRESS)) {
-                    startItem->setText(formatAddress(m_memoryRegions[relatedName].startAddress));
-                }
-                if (QTableWidgetItem* endItem = m_memoryTable->item(relatedRow, COL_END_ADDRESS)) {
-                    endItem->setText(formatAddress(m_memoryRegions[relatedName].endAddress));
-                }
-            }
-        }
-    }
+    regions[regionName] = region;
     
-    // 更新表格中的名称和地址
-    if (QTableWidgetItem* nameItem = m_memoryTable->item(currentRow, COL_NAME)) {
-        nameItem->setText(region.name);
-    }
-    if (QTableWidgetItem* startItem = m_memoryTable->item(currentRow, COL_START_ADDRESS)) {
-        startItem->setText(formatAddress(region.startAddress));
-    }
-    if (QTableWidgetItem* endItem = m_memoryTable->item(currentRow, COL_END_ADDRESS)) {
-        endItem->setText(formatAddress(region.endAddress));
+    // 由布局引擎根据大小重新推导依赖区域的地址（如ION随RTOS_ION移动，H26X/ISP与ION共享起始地址）
+    QString errorMessage;
+    bool layoutValid = m_layoutEngine.pack(regions, errorMessage);
+    for (auto it = regions.begin(); it != regions.end(); ++it) {
+        it.value().sizeString = formatSize(it.value().size);
     }
+    region = regions.value(regionName);
     
     // 验证内存约束
-    QString errorMessage;
-    if (!validateMemoryConstraints(errorMessage)) {
-        // 验证失败，回滚所有修改
-        m_memoryRegions = oldMemoryRegions;
-        
-        // 如果名称改变了，需要恢复顺序列表
-        if (oldRegionName != region.name) {
-            m_regionOrder[currentRow] = oldRegionName;
+    if (!layoutValid || !validateMemoryConstraints(regions, errorMessage)) {
+        // 验证失败，模型未被修改，只需恢复约束中的名称
+        if (oldRegionName != regionName) {
+            m_layoutEngine.renameRegion(regionName, oldRegionName);
         }
         
         // 显示错误信息
@@ -1123,57 +839,16 @@ void MemoryConfigWidget::onConfigFieldChanged()
         m_sizeEdit->blockSignals(false);
         m_sizeUnitCombo->blockSignals(false);
         
-        // 确保恢复后的数据sizeString是正确的
-        for (auto it = m_memoryRegions.begin(); it != m_memoryRegions.end(); ++it) {
-            it.value().sizeString = formatSize(it.value().size);
-        }
-        
-        // 恢复表格显示
-        updateSizeString(currentRow);
-        
-        // 如果是ION或RTOS_ION，需要恢复相关区域的表格显示
-        if (oldRegionName == "ION" || oldRegionName == "RTOS_ION") {
-            QStringList relatedRegions;
-            if (oldRegionName == "ION") {
-                relatedRegions = {"H26X_BITSTREAM", "H26X_ENC_BUFF", "ISP_MEM_BASE"};
-            } else {
-                relatedRegions = {"ION", "H26X_BITSTREAM", "H26X_ENC_BUFF", "ISP_MEM_BASE"};
-            }
-            
-            for (const QString& relatedName : relatedRegions) {
-                int relatedRow = m_regionOrder.indexOf(relatedName);
-                if (relatedRow >= 0) {
-                    updateSizeString(relatedRow);
-                    
-                    // 更新表格中的地址
-                    if (QTableWidgetItem* startItem = m_memoryTable->item(relatedRow, COL_START_ADDRESS)) {
-                        startItem->setText(formatAddress(m_memoryRegions[relatedName].startAddress));
-                    }
-                    if (QTableWidgetItem* endItem = m_memoryTable->item(relatedRow, COL_END_ADDRESS)) {
-                        endItem->setText(formatAddress(m_memoryRegions[relatedName].endAddress));
-                    }
-                }
-            }
-        }
-        
-        // 更新表格中的名称和地址
-        if (QTableWidgetItem* nameItem = m_memoryTable->item(currentRow, COL_NAME)) {
-            nameItem->setText(oldRegionName);
-        }
-        if (QTableWidgetItem* startItem = m_memoryTable->item(currentRow, COL_START_ADDRESS)) {
-            startItem->setText(formatAddress(oldRegion.startAddress));
-        }
-        if (QTableWidgetItem* endItem = m_memoryTable->item(currentRow, COL_END_ADDRESS)) {
-            endItem->setText(formatAddress(oldRegion.endAddress));
-        }
-        
-        // 更新内存可视化（使用回滚后的数据）
-        updateMemoryVisualization();
-        
         return;  // 不发送信号，因为修改被撤销了
     }
     
-    // 验证通过，更新内存可视化
+    // 验证通过，写回模型（布局引擎可能同时移动了多个区域）
+    if (oldRegionName != regionName) {
+        m_regionModel->renameRegion(oldRegionName, regionName);
+    }
+    m_regionModel->updateRegions(regions);
+    
+    // 更新内存可视化
     updateMemoryVisualization();
     validateMemoryLayout();
     
@@ -1229,178 +904,174 @@ void MemoryConfigWidget::formatSizeForInput(quint64 sizeInBytes, QString& sizeTe
 
 void MemoryConfigWidget::updateMemoryVisualization()
 {
-    QString memoryMap;
-    
-    // 创建内存映射文本
-    memoryMap += "内存布局可视化:\n";
-    memoryMap += "========================================\n";
-    
-    // 按地址排序的区域列表
-    QList<MemoryRegion> sortedRegions;
-    for (const auto& region : m_memoryRegions) {
-        if (region.size > 0) {
-            sortedRegions.append(region);
+    // 起始地址由约束推导的区域在图中只允许调整大小
+    const QMap<QString, MemoryRegion>& regions = m_regionModel->regions();
+    QStringList lockedRegions;
+    for (auto it = regions.constBegin(); it != regions.constEnd(); ++it) {
+        if (m_layoutEngine.isAddressDerived(it.key())) {
+            lockedRegions.append(it.key());
         }
     }
-    
-    std::sort(sortedRegions.begin(), sortedRegions.end(), 
-              [](const MemoryRegion& a, const MemoryRegion& b) {
-                  return a.startAddress < b.startAddress;
-              });
-    
-    // 显示每个区域
-    for (const auto& region : sortedRegions) {
-        memoryMap += QString("%1: %2 - %3 (%4)\n")
-                    .arg(region.name, -20)
-                    .arg(formatAddress(region.startAddress))
-                    .arg(formatAddress(region.endAddress))
-                    .arg(region.sizeString);
-    }
-    
-    m_memoryMapText->setPlainText(memoryMap);
+    m_memoryMapView->setLockedRegions(lockedRegions);
+    m_memoryMapView->setRegions(regions, m_layoutEngine.findOverlaps(regions));
 }
 
-void MemoryConfigWidget::validateMemoryLayout()
+void MemoryConfigWidget::onMapRegionSelected(const QString& regionName)
 {
-    // 检查内存重叠
-    checkMemoryOverlap();
+    int row = m_regionModel->rowOf(regionName);
+    if (row >= 0) {
+        m_memoryTable->selectRow(row);
+        m_memoryTable->scrollTo(m_regionModel->index(row, MemoryRegionModel::COL_NAME));
+    }
 }
 
-void MemoryConfigWidget::checkMemoryOverlap()
+void MemoryConfigWidget::onMapRegionGeometryChanged(const QString& regionName, quint64 startAddress, quint64 size)
 {
-    // 按地址排序的区域列表
-    QList<MemoryRegion> sortedRegions;
-    for (const auto& region : m_memoryRegions) {
-        if (region.size > 0) {
-            sortedRegions.append(region);
-        }
+    if (!m_regionModel->contains(regionName)) {
+        return;
     }
     
-    std::sort(sortedRegions.begin(), sortedRegions.end(), 
-              [](const MemoryRegion& a, const MemoryRegion& b) {
-                  return a.startAddress < b.startAddress;
-              });
+    QMap<QString, MemoryRegion> regions = m_regionModel->regions();
     
-    // 检查重叠
-    for (int i = 0; i < sortedRegions.size() - 1; ++i) {
-        const MemoryRegion& current = sortedRegions[i];
-        const MemoryRegion& next = sortedRegions[i + 1];
-        
-        if (current.endAddress > next.startAddress) {
-            qDebug() << "内存重叠检测：" << current.name << "与" << next.name << "存在重叠";
-            // 可以在这里添加UI提示
-        }
+    MemoryRegion& region = regions[regionName];
+    region.startAddress = startAddress;
+    region.size = size;
+    region.endAddress = startAddress + size;
+    
+    // 与配置面板相同：由布局引擎推导依赖区域地址，再校验约束，通过后才写回模型
+    QString errorMessage;
+    if (!m_layoutEngine.pack(regions, errorMessage) || !validateMemoryConstraints(regions, errorMessage)) {
+        // 恢复映射图中被拖动的区域
+        updateMemoryVisualization();
+        QMessageBox::warning(this, "内存配置约束错误",
+                           QString("当前配置违反了内存约束条件:\n\n%1\n\n"
+                                  "修改已被撤销。").arg(errorMessage));
+        return;
+    }
+    
+    for (auto it = regions.begin(); it != regions.end(); ++it) {
+        it.value().sizeString = formatSize(it.value().size);
     }
+    
+    m_regionModel->updateRegions(regions);
+    onTableSelectionChanged();
+    updateMemoryVisualization();
+    validateMemoryLayout();
+    
+    emit configChanged();
+    emit memoryRegionChanged(regionName);
 }
 
-bool MemoryConfigWidget::validateMemoryConstraints(QString& errorMessage)
+void MemoryConfigWidget::onIonPoolCalculator()
 {
-    // 辅助函数：获取区域的起始地址
-    auto getAddr = [this](const QString& name) -> quint64 {
-        if (m_memoryRegions.contains(name)) {
-            return m_memoryRegions[name].startAddress;
-        }
-        return 0;
-    };
+    IonPoolCalculatorDialog dialog(VideoPipelineConfig::load(), this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
     
-    // 辅助函数：获取区域的大小
-    auto getSize = [this](const QString& name) -> quint64 {
-        if (m_memoryRegions.contains(name)) {
-            return m_memoryRegions[name].size;
-        }
-        return 0;
-    };
+    VideoPipelineConfig pipeline = dialog.getConfig();
+    IonPoolRequirement requirement = dialog.getRequirement();
     
-    // 获取相关区域的大小和地址
-    quint64 rtosLogSize = getSize("RTOS_LOG");
-    quint64 shareMemSize = getSize("SHARE_MEM");
-    quint64 shareParamSize = getSize("SHARE_PARAM");
-    quint64 pqbinSize = getSize("PQBIN");
-    quint64 rtosLogoSize = getSize("RTOS_LOGO");
-    quint64 cviUpdateHeaderSize = getSize("CVI_UPDATE_HEADER");
-    quint64 fsblUnzipSize = getSize("FSBL_UNZIP");
-    quint64 uimagSize = getSize("UIMAG");
-    
-    quint64 fsblC906lStartAddr = getAddr("FSBL_C906L_START");
-    quint64 rtosCompressBinAddr = getAddr("RTOS_COMPRESS_BIN");
-    
-    // RTOS_SYS_SIZE：固定为 4M（参考 memmap.py 第37行）
-    // 注意：虽然可以从 .config 读取覆盖，但默认值和大多数情况下都是 4M
-    const quint64 DEFAULT_RTOS_SYS_SIZE = 4 * 1024 * 1024;  // 4M
-    quint64 rtosSysSize = DEFAULT_RTOS_SYS_SIZE;
-    
-    // 如果配置了RTOS_SYS区域，使用配置值
-    if (m_memoryRegions.contains("RTOS_SYS") && getSize("RTOS_SYS") > 0) {
-        rtosSysSize = getSize("RTOS_SYS");
+    // 视频缓冲池所在区域；H26X/ISP 预留区按 memmap.py 固定在 ION 起始处，只属于大核管线
+    QString poolRegion = pipeline.runOnRtos ? "RTOS_ION" : "ION";
+    const QStringList carveOuts = {"H26X_BITSTREAM", "H26X_ENC_BUFF", "ISP_MEM_BASE"};
+    QMap<QString, MemoryRegion> regions = m_regionModel->regions();
+    
+    if (pipeline.runOnRtos) {
+        // 预留区无法随 RTOS_ION 移动，小核管线与非零预留区的组合直接拒绝
+        QStringList inUse;
+        for (const QString& name : carveOuts) {
+            if (regions.contains(name) && regions[name].size > 0) {
+                inUse << name;
+            }
+        }
+        if (!inUse.isEmpty()) {
+            QMessageBox::warning(this, "ION容量计算",
+                               QString("%1 与 ION 共享起始地址，无法移入 RTOS_ION。\n\n"
+                                      "视频管线运行在小核RTOS上时请先将这些区域大小设为0，"
+                                      "或取消\"运行在小核RTOS上\"选项。")
+                                   .arg(inUse.join("、")));
+            return;
+        }
     }
     
-    // 约束1: RTOS_ION_ADDR >= FSBL_C906L_START_ADDR + RTOS_SYS_SIZE
-    // 注意：memmap.py 中此约束只在 RTOS_SYS_SIZE > 0 时检查（第186行）
-    quint64 rtosIonAddr = getAddr("RTOS_ION");
-    if (rtosSysSize > 0 && rtosIonAddr < fsblC906lStartAddr + rtosSysSize) {
-        errorMessage = QString("约束违反: RTOS_ION地址(0x%1) 必须 >= FSBL_C906L_START地址(0x%2) + RTOS_SYS_SIZE(0x%3)")
-                      .arg(rtosIonAddr, 0, 16)
-                      .arg(fsblC906lStartAddr, 0, 16)
-                      .arg(rtosSysSize, 0, 16);
-        return false;
+    QMap<QString, quint64> newSizes;
+    newSizes[poolRegion] = requirement.totalBytes;
+    if (!pipeline.runOnRtos) {
+        newSizes["H26X_BITSTREAM"] = requirement.bitstreamRegionSize();
+        newSizes["H26X_ENC_BUFF"] = requirement.encBuffRegionSize();
+        newSizes["ISP_MEM_BASE"] = requirement.ispRegionSize();
     }
     
-    // 约束2: RTOS_COMPRESS_BIN_ADDR >= UIMAG_ADDR + UIMAG_SIZE
-    // 注意：memmap.py 中此约束只在 RTOS_SYS_SIZE > 0 时检查（第189行）
-    quint64 uimagAddr = getAddr("UIMAG");
-    if (rtosSysSize > 0 && rtosCompressBinAddr < uimagAddr + uimagSize) {
-        errorMessage = QString("约束违反: RTOS_COMPRESS_BIN地址(0x%1) 必须 >= UIMAG地址(0x%2) + UIMAG大小(0x%3)")
-                      .arg(rtosCompressBinAddr, 0, 16)
-                      .arg(uimagAddr, 0, 16)
-                      .arg(uimagSize, 0, 16);
-        return false;
+    for (auto it = newSizes.constBegin(); it != newSizes.constEnd(); ++it) {
+        if (!regions.contains(it.key())) {
+            continue;
+        }
+        MemoryRegion& region = regions[it.key()];
+        region.size = it.value();
+        region.endAddress = region.startAddress + region.size;
+        region.sizeString = formatSize(region.size);
     }
     
-    // 约束3: ION_ADDR >= FSBL_C906L_START_ADDR + RTOS_SYS_SIZE
-    // 注意：memmap.py 中此约束只在 enable_alios == 'y' 时检查（第199行）
-    // 并且 ION_ADDR 在 memmap.py 中是通过公式计算的：
-    // RTOS_ION_ADDR = DRAM_BASE + 256M - RTOS_ION_SIZE (第56行)
-    // ION_ADDR = RTOS_ION_ADDR - ION_SIZE (第67行)
-    quint64 ionSize = getSize("ION");
-    quint64 rtosIonSize = getSize("RTOS_ION");
-    
-    // 按照 memmap.py 的公式计算 RTOS_ION_ADDR 和 ION_ADDR
-    // RTOS_ION 的结束地址固定在 256M 边界处
-    const quint64 FIXED_256M_BOUNDARY = MEMORY_BASE_ADDRESS + 256 * 1024 * 1024;  // 0x90000000
-    quint64 calculatedRtosIonAddr = FIXED_256M_BOUNDARY - rtosIonSize;
-    quint64 calculatedIonAddr = calculatedRtosIonAddr - ionSize;
-    
-    // 假设默认启用 ALIOS（enable_alios == 'y'）
-    // TODO: 如果需要支持动态配置，应从配置文件读取 enable_alios 标志
-    bool enableAlios = true;  // 默认启用
-    
-    if (enableAlios && calculatedIonAddr < fsblC906lStartAddr + rtosSysSize) {
-        errorMessage = QString("约束违反: ION地址计算不符合要求\n"
-                              "计算过程:\n"
-                              "  256M边界 = 0x%1\n"
-                              "  RTOS_ION地址 = 256M边界 - RTOS_ION_SIZE = 0x%1 - 0x%2 = 0x%3\n"
-                              "  ION地址 = RTOS_ION地址 - ION_SIZE = 0x%3 - 0x%4 = 0x%5\n"
-                              "约束要求: ION地址(0x%5) >= FSBL_C906L_START(0x%6) + RTOS_SYS_SIZE(0x%7) = 0x%8\n"
-                              "提示: 尝试减小 ION_SIZE 或 RTOS_ION_SIZE")
-                      .arg(FIXED_256M_BOUNDARY, 0, 16)
-                      .arg(rtosIonSize, 0, 16)
-                      .arg(calculatedRtosIonAddr, 0, 16)
-                      .arg(ionSize, 0, 16)
-                      .arg(calculatedIonAddr, 0, 16)
-                      .arg(fsblC906lStartAddr, 0, 16)
-                      .arg(rtosSysSize, 0, 16)
-                      .arg(fsblC906lStartAddr + rtosSysSize, 0, 16);
-        return false;
+    // 由布局引擎重新推导 ION 及共享起始地址区域的位置，再校验约束
+    QString errorMessage;
+    if (!m_layoutEngine.pack(regions, errorMessage) || !validateMemoryConstraints(regions, errorMessage)) {
+        QMessageBox::warning(this, "内存配置约束错误",
+                           QString("计算得到的%1大小为 %2，超出了当前内存布局的容量:\n\n%3\n\n"
+                                  "修改已被撤销，请减少缓冲块数量或编码通道。")
+                               .arg(poolRegion)
+                               .arg(formatSize(requirement.totalBytes))
+                               .arg(errorMessage));
+        return;
     }
     
-    // 注意：CONFIG_SYS_TEXT_BASE和CONFIG_SYS_INIT_SP_ADDR不在当前的内存区域列表中
-    // 如果需要检查这些约束，需要添加这些区域到配置中
-    // 或者假设它们与UIMAG有关联
+    quint64 oldPoolSize = m_regionModel->contains(poolRegion) ? m_regionModel->region(poolRegion).size : 0;
     
-    // 约束4和5暂时跳过，因为CONFIG_SYS_TEXT_BASE和CONFIG_SYS_INIT_SP_ADDR未定义
-    // 如果这些是固定值或需要添加到配置中，请告知
+    m_regionModel->updateRegions(regions);
+    onTableSelectionChanged();
+    updateMemoryVisualization();
+    validateMemoryLayout();
     
-    return true;
+    emit configChanged();
+    emit memoryRegionChanged(poolRegion);
+    
+    QMessageBox::information(this, "ION容量计算",
+                           QString("%1 已由 %2 调整为 %3\n\n%4")
+                               .arg(poolRegion)
+                               .arg(formatSize(oldPoolSize))
+                               .arg(formatSize(requirement.totalBytes))
+                               .arg(requirement.breakdown()));
+}
+
+void MemoryConfigWidget::validateMemoryLayout()
+{
+    // 检查内存重叠
+    checkMemoryOverlap();
+}
+
+void MemoryConfigWidget::checkMemoryOverlap()
+{
+    // 使用区间树查找未被约束允许的重叠
+    QList<QPair<QString, QString>> overlaps = m_layoutEngine.findOverlaps(m_regionModel->regions());
+    
+    for (const auto& pair : overlaps) {
+        qDebug() << "内存重叠检测：" << pair.first << "与" << pair.second << "存在重叠";
+    }
+    
+    // 在表格中标记重叠区域
+    m_regionModel->setOverlaps(overlaps);
+}
+
+bool MemoryConfigWidget::checkMemoryConstraints(QString& errorMessage) const
+{
+    return m_layoutEngine.validate(m_regionModel->regions(), errorMessage);
+}
+
+bool MemoryConfigWidget::validateMemoryConstraints(const QMap<QString, MemoryRegion>& regions, QString& errorMessage)
+{
+    // memmap.py 中的地址约束（RTOS_ION/ION/RTOS_COMPRESS_BIN 等）已声明在布局引擎中
+    // 注意：CONFIG_SYS_TEXT_BASE和CONFIG_SYS_INIT_SP_ADDR不在当前的内存区域列表中，相关约束暂不检查
+    return m_layoutEngine.validate(regions, errorMessage);
 }
 
 QString MemoryConfigWidget::formatSize(quint64 sizeInBytes)
@@ -1441,18 +1112,29 @@ quint64 MemoryConfigWidget::parseAddress(const QString& addressStr)
 
 QString MemoryConfigWidget::formatAddress(quint64 address)
 {
-    return QString("0x%1").arg(address, 8, 16, QChar('0')).toUpper();
+    return MemoryRegionModel::formatAddress(address);
 }
 
 MemoryRegion MemoryConfigWidget::getMemoryRegion(const QString& name) const
 {
-    return m_memoryRegions.value(name, MemoryRegion());
+    return m_regionModel->region(name);
+}
+
+QList<MemoryRegion> MemoryConfigWidget::getMemoryRegions() const
+{
+    QList<MemoryRegion> regions;
+    const QStringList& order = m_regionModel->regionOrder();
+    for (const QString& name : order) {
+        regions.append(m_regionModel->region(name));
+    }
+    return regions;
 }
 
 void MemoryConfigWidget::setMemoryRegion(const QString& name, const MemoryRegion& region)
 {
-    m_memoryRegions[name] = region;
-    populateTable();
+    MemoryRegion stored = region;
+    stored.name = name;
+    m_regionModel->appendRegion(stored);  // 已存在时只刷新该区域
     updateMemoryVisualization();
     emit configChanged();
 }
@@ -1462,7 +1144,7 @@ bool MemoryConfigWidget::exportToJson(const QString& filePath)
     QJsonObject root;
     QJsonArray regionsArray;
     
-    for (const auto& region : m_memoryRegions) {
+    for (const auto& region : m_regionModel->regions()) {
         QJsonObject regionObj;
         regionObj["name"] = region.name;
         regionObj["startAddress"] = QString("0x%1").arg(region.startAddress, 0, 16);
@@ -1512,8 +1194,7 @@ bool MemoryConfigWidget::importFromJson(const QString& filePath)
     QJsonObject root = doc.object();
     QJsonArray regionsArray = root["memoryRegions"].toArray();
     
-    m_memoryRegions.clear();
-    
+    QList<MemoryRegion> regions;
     for (const auto& value : regionsArray) {
         QJsonObject regionObj = value.toObject();
         
@@ -1526,8 +1207,9 @@ bool MemoryConfigWidget::importFromJson(const QString& filePath)
         region.isEditable = regionObj["isEditable"].toBool();
         region.description = regionObj["description"].toString();
         
-        m_memoryRegions[region.name] = region;
+        regions.append(region);
     }
+    m_regionModel->setRegions(regions);
     
     return true;
 }
@@ -1542,87 +1224,54 @@ void MemoryConfigWidget::setChipType(const QString& chipType)
     m_chipType = chipType;
 }
 
-bool MemoryConfigWidget::exportToDefconfig(const QString& sourcePath, const QString& chipType)
+QFuture<FileIoResult> MemoryConfigWidget::exportToDefconfig(const QString& sourcePath, const QString& chipType)
 {
     // 构建defconfig文件路径
     QString defconfigPath = QString("%1/build/boards/cv184x/%2/%2_defconfig")
                            .arg(sourcePath)
                            .arg(chipType);
     
-    // 检查文件是否存在
-    QFile defconfigFile(defconfigPath);
-    if (!defconfigFile.exists()) {
-        QMessageBox::critical(nullptr, "错误", 
-                            QString("Defconfig文件不存在: %1").arg(defconfigPath));
-        return false;
-    }
-    
-    // 读取现有文件内容
-    if (!defconfigFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::critical(nullptr, "错误", 
-                            QString("无法读取defconfig文件: %1").arg(defconfigPath));
-        return false;
-    }
-    
-    QTextStream in(&defconfigFile);
-    QStringList lines;
-    while (!in.atEnd()) {
-        lines.append(in.readLine());
-    }
-    defconfigFile.close();
-    
     // 获取相关内存区域的大小
     quint64 ionSize = 0;
     quint64 rtosIonSize = 0;
     
     // 从内存区域映射中获取大小
-    if (m_memoryRegions.contains("ION")) {
-        ionSize = m_memoryRegions["ION"].size;
+    if (m_regionModel->contains("ION")) {
+        ionSize = m_regionModel->region("ION").size;
     }
-    if (m_memoryRegions.contains("RTOS_ION")) {
-        rtosIonSize = m_memoryRegions["RTOS_ION"].size;
+    if (m_regionModel->contains("RTOS_ION")) {
+        rtosIonSize = m_regionModel->region("RTOS_ION").size;
     }
     
     // 转换为十六进制字符串（不包含0x前缀）
     QString ionSizeHex = QString("%1").arg(ionSize, 0, 16);
     QString rtosIonSizeHex = QString("%1").arg(rtosIonSize, 0, 16);
     
-    // 更新配置行
-    bool foundIonSize = false;
-    bool foundRtosIonSize = false;
-    
-    for (int i = 0; i < lines.size(); ++i) {
-        QString& line = lines[i];
-        
-        if (line.startsWith("CONFIG_ION_SIZE=")) {
-            line = QString("CONFIG_ION_SIZE=0x%1").arg(ionSizeHex);
-            foundIonSize = true;
-        } else if (line.startsWith("CONFIG_RTOS_ION_SIZE=")) {
-            line = QString("CONFIG_RTOS_ION_SIZE=0x%1").arg(rtosIonSizeHex);
-            foundRtosIonSize = true;
-        }
-    }
-    
-    // 如果没有找到配置项，则添加到文件末尾
-    if (!foundIonSize) {
-        lines.append(QString("CONFIG_ION_SIZE=0x%1").arg(ionSizeHex));
-    }
-    if (!foundRtosIonSize) {
-        lines.append(QString("CONFIG_RTOS_ION_SIZE=0x%1").arg(rtosIonSizeHex));
-    }
-    
-    // 写回文件
-    if (!defconfigFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(nullptr, "错误", 
-                            QString("无法写入defconfig文件: %1").arg(defconfigPath));
-        return false;
-    }
-    
-    QTextStream out(&defconfigFile);
-    for (const QString& line : lines) {
-        out << line << "\n";
-    }
-    defconfigFile.close();
-    
-    return true;
+    // 读取、更新配置行并写回在I/O线程中完成
+    return FileIoService::instance()->modifyLines(defconfigPath,
+        [ionSizeHex, rtosIonSizeHex](QStringList& lines, QString&) {
+            bool foundIonSize = false;
+            bool foundRtosIonSize = false;
+            
+            for (int i = 0; i < lines.size(); ++i) {
+                QString& line = lines[i];
+                
+                if (line.startsWith("CONFIG_ION_SIZE=")) {
+                    line = QString("CONFIG_ION_SIZE=0x%1").arg(ionSizeHex);
+                    foundIonSize = true;
+                } else if (line.startsWith("CONFIG_RTOS_ION_SIZE=")) {
+                    line = QString("CONFIG_RTOS_ION_SIZE=0x%1").arg(rtosIonSizeHex);
+                    foundRtosIonSize = true;
+                }
+            }
+            
+            // 如果没有找到配置项，则添加到文件末尾
+            if (!foundIonSize) {
+                lines.append(QString("CONFIG_ION_SIZE=0x%1").arg(ionSizeHex));
+            }
+            if (!foundRtosIonSize) {
+                lines.append(QString("CONFIG_RTOS_ION_SIZE=0x%1").arg(rtosIonSizeHex));
+            }
+            return true;
+        }, "内存defconfig");
 }
\ No newline at end of file
@@ -4,8 +4,7 @@
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QTableWidget>
-#include <QTableWidgetItem>
+#include <QTableView>
 #include <QHeaderView>
 #include <QPushButton>
 #include <QGroupBox>
@@ -28,17 +27,11 @@
 #include <QPropertyAnimation>
 #include <QGraphicsOpacityEffect>
 #include <QKeyEvent>
-
-// 内存区域配置结构
-struct MemoryRegion {
-    QString name;           // 区域名称
-    quint64 startAddress;   // 起始地址
-    quint64 endAddress;     // 结束地址
-    quint64 size;          // 大小（字节）
-    QString sizeString;    // 大小字符串（M/K/B格式）
-    bool isEditable;       // 是否可编辑
-    QString description;   // 描述
-};
+#include "memorylayoutengine.h"
+#include "memoryregionmodel.h"
+#include "fileioservice.h"
+#include "memorymapview.h"
+#include "ionpooldialog.h"
 
 class MemoryConfigWidget : public QWidget
 {
@@ -50,6 +43,9 @@ public:
 
     // 获取和设置内存区域配置
     MemoryRegion getMemoryRegion(const QString& name) const;
+    QList<MemoryRegion> getMemoryRegions() const;     // 按表格顺序
+    // 用布局引擎检查当前配置是否满足地址约束
+    bool checkMemoryConstraints(QString& errorMessage) const;
     void setMemoryRegion(const QString& name, const MemoryRegion& region);
     
     // 保存和加载配置
@@ -60,8 +56,8 @@ public:
     bool exportToJson(const QString& filePath);
     bool importFromJson(const QString& filePath);
     
-    // 导出到defconfig文件
-    bool exportToDefconfig(const QString& sourcePath, const QString& chipType);
+    // 导出到defconfig文件（后台读写，结果通过future在界面线程处理）
+    QFuture<FileIoResult> exportToDefconfig(const QString& sourcePath, const QString& chipType);
     
     // 设置源代码路径和芯片类型
     void setSourcePath(const QString& sourcePath);
@@ -72,8 +68,7 @@ signals:
     void memoryRegionChanged(const QString& regionName);
 
 private slots:
-    void onTableItemChanged(QTableWidgetItem* item);
-    void onTableItemDoubleClicked(QTableWidgetItem* item);
+    void onTableDoubleClicked(const QModelIndex& index);
     void onAddRegion();
     void onRemoveRegion();
     void onResetRegions();
@@ -84,14 +79,16 @@ private slots:
     void onTableSelectionChanged();
     void onConfigFieldChanged();
     void onToggleConfigPanel();
+    void onMapRegionSelected(const QString& regionName);
+    void onMapRegionGeometryChanged(const QString& regionName, quint64 startAddress, quint64 size);
+    void onIonPoolCalculator();
 
 private:
     void setupUI();
     void setupMemoryTable();
     void setupControlPanel();
     void initializeMemoryRegions();
-    void populateTable();
-    void updateSizeString(int row);
+    QString currentRegionName() const;
     void updateMemoryVisualization();
     void validateMemoryLayout();
     QString formatSize(quint64 sizeInBytes);
@@ -102,7 +99,7 @@ private:
     void formatSizeForInput(quint64 sizeInBytes, QString& sizeText, QString& unit);
     void searchAndSelectRegion(const QString& searchText);
     void setConfigPanelExpanded(bool expanded);
-    bool validateMemoryConstraints(QString& errorMessage);
+    bool validateMemoryConstraints(const QMap<QString, MemoryRegion>& regions, QString& errorMessage);
     
     // UI组件
     QVBoxLayout* m_mainLayout;
@@ -111,7 +108,8 @@ private:
     // 内存表格区域
     QWidget* m_tableWidget;
     QVBoxLayout* m_tableLayout;
-    QTableWidget* m_memoryTable;
+    QTableView* m_memoryTable;
+    MemoryRegionModel* m_regionModel;
     QLabel* m_tableTitle;
     
     // 控制面板
@@ -126,6 +124,7 @@ private:
     QPushButton* m_resetButton;
     QPushButton* m_exportButton;
     QPushButton* m_importButton;
+    QPushButton* m_ionCalcButton;
     
     // 地址区域搜索组
     QGroupBox* m_searchGroup;
@@ -150,11 +149,10 @@ private:
     // 内存可视化区域
     QGroupBox* m_visualizationGroup;
     QVBoxLayout* m_visualizationLayout;
-    QTextEdit* m_memoryMapText;
+    MemoryMapView* m_memoryMapView;
     
-    // 数据存储
-    QMap<QString, MemoryRegion> m_memoryRegions;
-    QStringList m_regionOrder;  // 用于保持原始顺序
+    // 内存布局引擎（区间树 + 声明式约束）
+    MemoryLayoutEngine m_layoutEngine;
     
     // 源代码路径和芯片类型
     QString m_sourcePath;
@@ -163,16 +161,6 @@ private:
     // 常量
     static const quint64 TOTAL_MEMORY_SIZE;  // 总内存大小 (256MB)
     static const quint64 MEMORY_BASE_ADDRESS; // 内存基地址 (0x80000000)
-    
-    // 表格列索引
-    enum TableColumns {
-        COL_NAME = 0,
-        COL_START_ADDRESS,
-        COL_END_ADDRESS,
-        COL_SIZE_HEX,
-        COL_SIZE_FORMATTED,
-        COL_COUNT
-    };
 };
 
 #endif // MEMORYCONFIG_H
\ No newline at end of file
@@ -0,0 +1,481 @@
+#include "memorylayoutengine.h"
+#include <algorithm>
+
+// ==================== MemoryIntervalTree ====================
+
+MemoryIntervalTree::MemoryIntervalTree()
+    : m_root(-1)
+{
+}
+
+void MemoryIntervalTree::build(const QList<Interval>& intervals)
+{
+    clear();
+
+    QVector<Interval> sorted;
+    sorted.reserve(intervals.size());
+    for (const Interval& interval : intervals) {
+        // 空区间不参与重叠判断
+        if (interval.end > interval.start) {
+            sorted.append(interval);
+        }
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const Interval& a, const Interval& b) {
+        return a.start < b.start || (a.start == b.start && a.end < b.end);
+    });
+
+    m_nodes.reserve(sorted.size());
+    m_root = buildRange(sorted, 0, sorted.size() - 1);
+}
+
+void MemoryIntervalTree::clear()
+{
+    m_nodes.clear();
+    m_root = -1;
+}
+
+int MemoryIntervalTree::size() const
+{
+    return m_nodes.size();
+}
+
+int MemoryIntervalTree::buildRange(QVector<Interval>& sorted, int lo, int hi)
+{
+    if (lo > hi) {
+        return -1;
+    }
+
+    // 取中点作为根，保证树高为 O(log n)
+    int mid = lo + (hi - lo) / 2;
+    int index = m_nodes.size();
+    m_nodes.append(Node{sorted[mid], sorted[mid].end, -1, -1});
+
+    int left = buildRange(sorted, lo, mid - 1);
+    int right = buildRange(sorted, mid + 1, hi);
+
+    Node& node = m_nodes[index];
+    node.left = left;
+    node.right = right;
+    if (left >= 0) {
+        node.maxEnd = std::max(node.maxEnd, m_nodes[left].maxEnd);
+    }
+    if (right >= 0) {
+        node.maxEnd = std::max(node.maxEnd, m_nodes[right].maxEnd);
+    }
+    return index;
+}
+
+void MemoryIntervalTree::query(int nodeIndex, quint64 start, quint64 end, QList<Interval>& result) const
+{
+    if (nodeIndex < 0) {
+        return;
+    }
+
+    const Node& node = m_nodes[nodeIndex];
+    // 子树中所有区间都在查询范围之前结束
+    if (node.maxEnd <= start) {
+        return;
+    }
+
+    query(node.left, start, end, result);
+
+    if (node.interval.start < end && node.interval.end > start) {
+        result.append(node.interval);
+    }
+
+    // 右子树的起始地址都不小于当前节点，超出查询范围时无需继续
+    if (node.interval.start >= end) {
+        return;
+    }
+
+    query(node.right, start, end, result);
+}
+
+QList<MemoryIntervalTree::Interval> MemoryIntervalTree::overlapping(quint64 start, quint64 end) const
+{
+    QList<Interval> result;
+    if (end > start) {
+        query(m_root, start, end, result);
+    }
+    return result;
+}
+
+QList<MemoryIntervalTree::Interval> MemoryIntervalTree::containing(quint64 address) const
+{
+    return overlapping(address, address + 1);
+}
+
+// ==================== MemoryLayoutEngine ====================
+
+MemoryLayoutEngine::MemoryLayoutEngine()
+    : m_baseAddress(0)
+    , m_totalSize(0)
+{
+}
+
+void MemoryLayoutEngine::loadDefaultConstraints(quint64 baseAddress, quint64 totalSize)
+{
+    m_baseAddress = baseAddress;
+    m_totalSize = totalSize;
+    m_constraints.clear();
+
+    const quint64 defaultRtosSysSize = 4 * 1024 * 1024;  // RTOS_SYS_SIZE 默认 4M（memmap.py 第37行）
+    const quint64 boundary256M = baseAddress + 256 * 1024 * 1024;
+
+    // RTOS_ION_ADDR = DRAM_BASE + 256M - RTOS_ION_SIZE（memmap.py 第56行）
+    addConstraint({MemoryLayoutConstraint::FixedEnd, "RTOS_ION", "", boundary256M, "",
+                   "RTOS_ION 结束地址固定在256M边界"});
+    // ION_ADDR = RTOS_ION_ADDR - ION_SIZE（memmap.py 第67行）
+    addConstraint({MemoryLayoutConstraint::PlaceBelow, "ION", "RTOS_ION", 0, "",
+                   "ION 紧贴在 RTOS_ION 下方"});
+    // H26X/ISP 缓冲与 ION 共享起始地址
+    addConstraint({MemoryLayoutConstraint::ShareStart, "H26X_BITSTREAM", "ION", 0, "", "与 ION 共享起始地址"});
+    addConstraint({MemoryLayoutConstraint::ShareStart, "H26X_ENC_BUFF", "ION", 0, "", "与 ION 共享起始地址"});
+    addConstraint({MemoryLayoutConstraint::ShareStart, "ISP_MEM_BASE", "ION", 0, "", "与 ION 共享起始地址"});
+    // 启动Logo位于 ION 末尾
+    addConstraint({MemoryLayoutConstraint::AlignEnd, "BOOTLOGO", "ION", 0, "", "BOOTLOGO 位于 ION 末尾"});
+    // CVI_UPDATE_HEADER 紧贴 UIMAG 之前，FSBL_UNZIP 复用 UIMAG 区域
+    addConstraint({MemoryLayoutConstraint::PlaceBelow, "CVI_UPDATE_HEADER", "UIMAG", 0, "",
+                   "CVI_UPDATE_HEADER 紧贴在 UIMAG 下方"});
+    addConstraint({MemoryLayoutConstraint::ShareStart, "FSBL_UNZIP", "UIMAG", 0, "", "FSBL_UNZIP 复用 UIMAG 区域"});
+
+    // ION 与 RTOS_ION 需按页对齐
+    addConstraint({MemoryLayoutConstraint::Alignment, "ION", "", 0x1000, "", "ION 需按 4K 对齐"});
+    addConstraint({MemoryLayoutConstraint::Alignment, "RTOS_ION", "", 0x1000, "", "RTOS_ION 需按 4K 对齐"});
+
+    // 约束1: RTOS_ION_ADDR >= FSBL_C906L_START_ADDR + RTOS_SYS_SIZE（memmap.py 第186行）
+    addConstraint({MemoryLayoutConstraint::MinStartOffset, "RTOS_ION", "FSBL_C906L_START", defaultRtosSysSize,
+                   "RTOS_SYS", "提示: 尝试减小 RTOS_ION_SIZE"});
+    // 约束2: RTOS_COMPRESS_BIN_ADDR >= UIMAG_ADDR + UIMAG_SIZE（memmap.py 第189行）
+    addConstraint({MemoryLayoutConstraint::MinStartAfterEnd, "RTOS_COMPRESS_BIN", "UIMAG", 0, "",
+                   "提示: 尝试减小 UIMAG 大小"});
+    // 约束3: ION_ADDR >= FSBL_C906L_START_ADDR + RTOS_SYS_SIZE（memmap.py 第199行，enable_alios == 'y'）
+    addConstraint({MemoryLayoutConstraint::MinStartOffset, "ION", "FSBL_C906L_START", defaultRtosSysSize,
+                   "RTOS_SYS", "提示: 尝试减小 ION_SIZE 或 RTOS_ION_SIZE"});
+
+    // 内核内存覆盖整个DRAM，允许与其他区域重叠
+    addConstraint({MemoryLayoutConstraint::Contains, "KERNEL_MEMORY", "", 0, "", "内核内存覆盖全部区域"});
+}
+
+void MemoryLayoutEngine::addConstraint(const MemoryLayoutConstraint& constraint)
+{
+    m_constraints.append(constraint);
+}
+
+void MemoryLayoutEngine::clearConstraints()
+{
+    m_constraints.clear();
+}
+
+QList<MemoryLayoutConstraint> MemoryLayoutEngine::getConstraints() const
+{
+    return m_constraints;
+}
+
+void MemoryLayoutEngine::renameRegion(const QString& oldName, const QString& newName)
+{
+    for (MemoryLayoutConstraint& constraint : m_constraints) {
+        if (constraint.region == oldName) {
+            constraint.region = newName;
+        }
+        if (constraint.reference == oldName) {
+            constraint.reference = newName;
+        }
+        if (constraint.offsetRegion == oldName) {
+            constraint.offsetRegion = newName;
+        }
+    }
+}
+
+bool MemoryLayoutEngine::isDerivedType(MemoryLayoutConstraint::Type type)
+{
+    return type == MemoryLayoutConstraint::FixedStart ||
+           type == MemoryLayoutConstraint::FixedEnd ||
+           type == MemoryLayoutConstraint::PlaceBelow ||
+           type == MemoryLayoutConstraint::ShareStart ||
+           type == MemoryLayoutConstraint::AlignEnd;
+}
+
+const MemoryLayoutConstraint* MemoryLayoutEngine::derivedConstraint(const QString& regionName) const
+{
+    // 每个区域只取第一条地址推导约束
+    for (const MemoryLayoutConstraint& constraint : m_constraints) {
+        if (constraint.region == regionName && isDerivedType(constraint.type)) {
+            return &constraint;
+        }
+    }
+    return nullptr;
+}
+
+bool MemoryLayoutEngine::isAddressDerived(const QString& regionName) const
+{
+    return derivedConstraint(regionName) != nullptr;
+}
+
+QStringList MemoryLayoutEngine::backgroundRegions() const
+{
+    QStringList result;
+    for (const MemoryLayoutConstraint& constraint : m_constraints) {
+        if (constraint.type == MemoryLayoutConstraint::Contains && constraint.reference.isEmpty()) {
+            result.append(constraint.region);
+        }
+    }
+    return result;
+}
+
+QStringList MemoryLayoutEngine::dependentRegions(const QString& regionName) const
+{
+    QStringList result;
+    QStringList pending = {regionName};
+
+    while (!pending.isEmpty()) {
+        QString current = pending.takeFirst();
+        for (const MemoryLayoutConstraint& constraint : m_constraints) {
+            if (isDerivedType(constraint.type) && constraint.reference == current &&
+                !result.contains(constraint.region) && constraint.region != regionName) {
+                result.append(constraint.region);
+                pending.append(constraint.region);
+            }
+        }
+    }
+
+    return result;
+}
+
+bool MemoryLayoutEngine::resolveRegion(const QString& name, QMap<QString, MemoryRegion>& regions,
+                                       QStringList& resolved, QStringList& visiting, QString& errorMessage) const
+{
+    if (resolved.contains(name) || !regions.contains(name)) {
+        return true;
+    }
+    if (visiting.contains(name)) {
+        errorMessage = QString("内存布局约束存在循环依赖: %1 -> %2").arg(visiting.join(" -> "), name);
+        return false;
+    }
+
+    const MemoryLayoutConstraint* constraint = derivedConstraint(name);
+    if (!constraint) {
+        resolved.append(name);
+        return true;
+    }
+
+    visiting.append(name);
+    if (!constraint->reference.isEmpty() &&
+        !resolveRegion(constraint->reference, regions, resolved, visiting, errorMessage)) {
+        return false;
+    }
+    visiting.removeLast();
+
+    MemoryRegion& region = regions[name];
+    bool hasReference = regions.contains(constraint->reference);
+    const MemoryRegion reference = hasReference ? regions[constraint->reference] : MemoryRegion();
+
+    // 参考区域不存在时保持原地址
+    if (!hasReference && constraint->type != MemoryLayoutConstraint::FixedStart &&
+        constraint->type != MemoryLayoutConstraint::FixedEnd) {
+        resolved.append(name);
+        return true;
+    }
+
+    // 先确定锚点，再由大小推导另一端
+    switch (constraint->type) {
+    case MemoryLayoutConstraint::FixedStart:
+        region.startAddress = constraint->value;
+        break;
+    case MemoryLayoutConstraint::ShareStart:
+        region.startAddress = reference.startAddress;
+        break;
+    case MemoryLayoutConstraint::FixedEnd:
+    case MemoryLayoutConstraint::PlaceBelow:
+    case MemoryLayoutConstraint::AlignEnd: {
+        quint64 anchorEnd = constraint->value;
+        if (constraint->type == MemoryLayoutConstraint::PlaceBelow) {
+            anchorEnd = reference.startAddress;
+        } else if (constraint->type == MemoryLayoutConstraint::AlignEnd) {
+            anchorEnd = reference.endAddress;
+        }
+        if (region.size > anchorEnd || anchorEnd - region.size < m_baseAddress) {
+            errorMessage = QString("区域 %1 大小(%2)超出可用空间，无法放置在 %3 之下")
+                           .arg(name, hex(region.size), hex(anchorEnd));
+            return false;
+        }
+        region.startAddress = anchorEnd - region.size;
+        break;
+    }
+    default:
+        break;
+    }
+
+    region.endAddress = region.startAddress + region.size;
+    resolved.append(name);
+    return true;
+}
+
+bool MemoryLayoutEngine::pack(QMap<QString, MemoryRegion>& regions, QString& errorMessage) const
+{
+    QMap<QString, MemoryRegion> packed = regions;
+    QStringList resolved;
+
+    for (auto it = packed.begin(); it != packed.end(); ++it) {
+        // 非派生区域以用户输入为准，仅同步结束地址
+        it.value().endAddress = it.value().startAddress + it.value().size;
+    }
+
+    for (const QString& name : regions.keys()) {
+        QStringList visiting;
+        if (!resolveRegion(name, packed, resolved, visiting, errorMessage)) {
+            return false;
+        }
+    }
+
+    regions = packed;
+    return true;
+}
+
+bool MemoryLayoutEngine::validate(const QMap<QString, MemoryRegion>& regions, QString& errorMessage) const
+{
+    // 地址范围检查
+    if (m_totalSize > 0) {
+        const quint64 limit = m_baseAddress + m_totalSize;
+        for (const MemoryRegion& region : regions) {
+            if (region.size > 0 && (region.startAddress < m_baseAddress || region.endAddress > limit)) {
+                errorMessage = QString("区域 %1 (%2 - %3) 超出DRAM范围 (%4 - %5)")
+                               .arg(region.name, hex(region.startAddress), hex(region.endAddress),
+                                    hex(m_baseAddress), hex(limit));
+                return false;
+            }
+        }
+    }
+
+    for (const MemoryLayoutConstraint& constraint : m_constraints) {
+        if (!regions.contains(constraint.region)) {
+            continue;
+        }
+        const MemoryRegion& region = regions[constraint.region];
+        bool hasReference = regions.contains(constraint.reference);
+        const MemoryRegion reference = hasReference ? regions[constraint.reference] : MemoryRegion();
+
+        switch (constraint.type) {
+        case MemoryLayoutConstraint::Alignment:
+            if (constraint.value > 0 &&
+                (region.startAddress % constraint.value != 0 || region.size % constraint.value != 0)) {
+                errorMessage = QString("约束违反: %1 起始地址(%2)和大小(%3)必须按 %4 对齐\n%5")
+                               .arg(region.name, hex(region.startAddress), hex(region.size),
+                                    hex(constraint.value), constraint.description);
+                return false;
+            }
+            break;
+
+        case MemoryLayoutConstraint::MinStartOffset: {
+            if (!hasReference) {
+                break;
+            }
+            quint64 offset = constraint.value;
+            if (!constraint.offsetRegion.isEmpty() && regions.contains(constraint.offsetRegion) &&
+                regions[constraint.offsetRegion].size > 0) {
+                offset = regions[constraint.offsetRegion].size;
+            }
+            // memmap.py 中偏移为0时不检查
+            if (offset > 0 && region.startAddress < reference.startAddress + offset) {
+                errorMessage = QString("约束违反: %1地址(%2) 必须 >= %3地址(%4) + %5 = %6\n%7")
+                               .arg(region.name, hex(region.startAddress), reference.name,
+                                    hex(reference.startAddress), hex(offset),
+                                    hex(reference.startAddress + offset), constraint.description);
+                return false;
+            }
+            break;
+        }
+
+        case MemoryLayoutConstraint::MinStartAfterEnd:
+            if (hasReference && region.startAddress < reference.endAddress) {
+                errorMessage = QString("约束违反: %1地址(%2) 必须 >= %3地址(%4) + %3大小(%5)\n%6")
+                               .arg(region.name, hex(region.startAddress), reference.name,
+                                    hex(reference.startAddress), hex(reference.size), constraint.description);
+                return false;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool MemoryLayoutEngine::isOverlapAllowed(const QString& a, const QString& b) const
+{
+    for (const MemoryLayoutConstraint& constraint : m_constraints) {
+        bool pairMatches = (constraint.region == a && constraint.reference == b) ||
+                           (constraint.region == b && constraint.reference == a);
+
+        switch (constraint.type) {
+        case MemoryLayoutConstraint::Contains:
+            if ((constraint.region == a || constraint.region == b) &&
+                (constraint.reference.isEmpty() || pairMatches)) {
+                return true;
+            }
+            break;
+        case MemoryLayoutConstraint::ShareStart:
+        case MemoryLayoutConstraint::AlignEnd:
+            if (pairMatches) {
+                return true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // 与同一区域共享起始地址的区域之间也允许重叠（如 H26X_* 与 ISP_MEM_BASE）
+    const MemoryLayoutConstraint* ca = derivedConstraint(a);
+    const MemoryLayoutConstraint* cb = derivedConstraint(b);
+    if (ca && cb && ca->type == MemoryLayoutConstraint::ShareStart &&
+        cb->type == MemoryLayoutConstraint::ShareStart && ca->reference == cb->reference) {
+        return true;
+    }
+
+    return false;
+}
+
+QList<QPair<QString, QString>> MemoryLayoutEngine::findOverlaps(const QMap<QString, MemoryRegion>& regions) const
+{
+    QList<QPair<QString, QString>> overlaps;
+    MemoryIntervalTree tree = buildTree(regions);
+
+    for (const MemoryRegion& region : regions) {
+        if (region.size == 0) {
+            continue;
+        }
+        const QList<MemoryIntervalTree::Interval> hits = tree.overlapping(region.startAddress, region.endAddress);
+        for (const MemoryIntervalTree::Interval& hit : hits) {
+            // 每对只报告一次
+            if (hit.name <= region.name) {
+                continue;
+            }
+            if (!isOverlapAllowed(region.name, hit.name)) {
+                overlaps.append(qMakePair(region.name, hit.name));
+            }
+        }
+    }
+
+    return overlaps;
+}
+
+MemoryIntervalTree MemoryLayoutEngine::buildTree(const QMap<QString, MemoryRegion>& regions)
+{
+    QList<MemoryIntervalTree::Interval> intervals;
+    for (const MemoryRegion& region : regions) {
+        intervals.append({region.startAddress, region.endAddress, region.name});
+    }
+
+    MemoryIntervalTree tree;
+    tree.build(intervals);
+    return tree;
+}
+
+QString MemoryLayoutEngine::hex(quint64 value)
+{
+    return QString("0x%1").arg(value, 0, 16);
+}
@@ -0,0 +1,125 @@
+#ifndef MEMORYLAYOUTENGINE_H
+#define MEMORYLAYOUTENGINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QVector>
+
+// 内存区域配置结构
+struct MemoryRegion {
+    QString name;           // 区域名称
+    quint64 startAddress;   // 起始地址
+    quint64 endAddress;     // 结束地址
+    quint64 size;          // 大小（字节）
+    QString sizeString;    // 大小字符串（M/K/B格式）
+    bool isEditable;       // 是否可编辑
+    QString description;   // 描述
+};
+
+// 区间树：按起始地址构建的平衡二叉树，每个节点记录子树最大结束地址
+// 区间均为左闭右开 [start, end)，重叠查询复杂度 O(log n + k)
+class MemoryIntervalTree
+{
+public:
+    struct Interval {
+        quint64 start;
+        quint64 end;
+        QString name;
+    };
+
+    MemoryIntervalTree();
+
+    void build(const QList<Interval>& intervals);
+    void clear();
+    int size() const;
+
+    // 查询与 [start, end) 有交集的所有区间
+    QList<Interval> overlapping(quint64 start, quint64 end) const;
+    // 查询包含某地址的所有区间
+    QList<Interval> containing(quint64 address) const;
+
+private:
+    struct Node {
+        Interval interval;
+        quint64 maxEnd;
+        int left;
+        int right;
+    };
+
+    int buildRange(QVector<Interval>& sorted, int lo, int hi);
+    void query(int nodeIndex, quint64 start, quint64 end, QList<Interval>& result) const;
+
+    QVector<Node> m_nodes;
+    int m_root;
+};
+
+// 声明式内存布局约束
+struct MemoryLayoutConstraint {
+    enum Type {
+        FixedStart,         // region 起始地址固定为 value
+        FixedEnd,           // region 结束地址固定为 value（如 RTOS_ION 固定在256M边界）
+        PlaceBelow,         // region 紧贴在 reference 下方：region.end = reference.start
+        ShareStart,         // region 与 reference 共享起始地址
+        AlignEnd,           // region 结束地址与 reference 结束地址对齐
+        Alignment,          // region 起始地址和大小按 value 字节对齐
+        MinStartOffset,     // region.start >= reference.start + 偏移（offsetRegion 大小或 value）
+        MinStartAfterEnd,   // region.start >= reference.end
+        Contains            // region 包含 reference，reference 为空表示包含所有区域
+    };
+
+    Type type;
+    QString region;
+    QString reference;
+    quint64 value;
+    QString offsetRegion;   // MinStartOffset 使用：若该区域存在且大小>0，则以其大小作为偏移
+    QString description;    // 违反约束时给出的提示
+};
+
+class MemoryLayoutEngine
+{
+public:
+    MemoryLayoutEngine();
+
+    // 加载 memmap.py 对应的默认约束
+    void loadDefaultConstraints(quint64 baseAddress, quint64 totalSize);
+
+    void addConstraint(const MemoryLayoutConstraint& constraint);
+    void clearConstraints();
+    QList<MemoryLayoutConstraint> getConstraints() const;
+
+    // 区域重命名时同步更新约束
+    void renameRegion(const QString& oldName, const QString& newName);
+
+    // 地址由其他区域推导出来的区域（用户输入的起始地址会被忽略）
+    bool isAddressDerived(const QString& regionName) const;
+    // 覆盖全部区域的背景区域（如KERNEL_MEMORY）
+    QStringList backgroundRegions() const;
+    // 直接或间接依赖于指定区域地址的区域
+    QStringList dependentRegions(const QString& regionName) const;
+
+    // 仅根据区域大小重新计算所有派生地址
+    bool pack(QMap<QString, MemoryRegion>& regions, QString& errorMessage) const;
+    // 校验所有约束及地址范围
+    bool validate(const QMap<QString, MemoryRegion>& regions, QString& errorMessage) const;
+    // 查找未被约束允许的区域重叠
+    QList<QPair<QString, QString>> findOverlaps(const QMap<QString, MemoryRegion>& regions) const;
+
+    static MemoryIntervalTree buildTree(const QMap<QString, MemoryRegion>& regions);
+
+private:
+    const MemoryLayoutConstraint* derivedConstraint(const QString& regionName) const;
+    bool resolveRegion(const QString& name, QMap<QString, MemoryRegion>& regions,
+                       QStringList& resolved, QStringList& visiting, QString& errorMessage) const;
+    bool isOverlapAllowed(const QString& a, const QString& b) const;
+    static bool isDerivedType(MemoryLayoutConstraint::Type type);
+    static QString hex(quint64 value);
+
+    QList<MemoryLayoutConstraint> m_constraints;
+    quint64 m_baseAddress;
+    quint64 m_totalSize;
+};
+
+#endif // MEMORYLAYOUTENGINE_H
@@ -0,0 +1,582 @@
+#include "memorymapview.h"
+#include <QPainter>
+#include <QToolTip>
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MemoryMapView::MemoryMapView(QWidget *parent)
+    : QWidget(parent)
+    , m_baseAddress(0x80000000)
+    , m_totalSize(0x10000000)
+    , m_laneCount(1)
+    , m_viewStart(0x80000000)
+    , m_viewEnd(0x90000000)
+    , m_dragMode(DragNone)
+    , m_dragBlock(-1)
+    , m_dragOriginStart(0)
+    , m_dragOriginEnd(0)
+    , m_dragOriginViewStart(0)
+{
+    setMouseTracking(true);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setToolTip("滚轮缩放，拖动空白处平移，拖动区域移动，拖动上下边缘调整大小，双击区域放大/双击空白复位");
+}
+
+QSize MemoryMapView::sizeHint() const
+{
+    return QSize(300, 320);
+}
+
+QSize MemoryMapView::minimumSizeHint() const
+{
+    return QSize(200, 200);
+}
+
+void MemoryMapView::setAddressRange(quint64 baseAddress, quint64 totalSize)
+{
+    m_baseAddress = baseAddress;
+    m_totalSize = totalSize;
+    resetZoom();
+    rebuildLayout();
+}
+
+void MemoryMapView::setRegions(const QMap<QString, MemoryRegion>& regions, const QList<QPair<QString, QString>>& overlaps)
+{
+    // 拖拽过程中数据被外部刷新时取消拖拽
+    m_dragMode = DragNone;
+    m_dragBlock = -1;
+
+    QSet<QString> overlapped;
+    for (const auto& pair : overlaps) {
+        overlapped.insert(pair.first);
+        overlapped.insert(pair.second);
+    }
+
+    m_blocks.clear();
+    m_backgroundBlocks.clear();
+    for (const MemoryRegion& region : regions) {
+        if (region.size == 0) {
+            continue;
+        }
+        Block block{region.name, region.startAddress, region.endAddress, 0, overlapped.contains(region.name)};
+        if (m_backgroundNames.contains(region.name)) {
+            m_backgroundBlocks.append(block);
+        } else {
+            m_blocks.append(block);
+        }
+    }
+
+    rebuildLayout();
+}
+
+void MemoryMapView::setBackgroundRegions(const QStringList& names)
+{
+    m_backgroundNames = names;
+}
+
+void MemoryMapView::setLockedRegions(const QStringList& names)
+{
+    m_lockedNames = names;
+}
+
+void MemoryMapView::setSelectedRegion(const QString& name)
+{
+    if (m_selectedName == name) {
+        return;
+    }
+    m_selectedName = name;
+    update();
+}
+
+void MemoryMapView::zoomToRegion(const QString& name)
+{
+    int index = m_blockIndex.value(name, -1);
+    if (index < 0) {
+        return;
+    }
+    const Block& block = m_blocks[index];
+    quint64 span = block.end - block.start;
+    quint64 margin = std::max<quint64>(span / 4, MIN_VIEW_SPAN);
+    quint64 start = block.start > m_baseAddress + margin ? block.start - margin : m_baseAddress;
+    setViewRange(start, block.end + margin);
+}
+
+void MemoryMapView::resetZoom()
+{
+    m_viewStart = m_baseAddress;
+    m_viewEnd = m_baseAddress + m_totalSize;
+    update();
+}
+
+void MemoryMapView::rebuildLayout()
+{
+    // 按起始地址排序，相同起始地址时大区域在前，贪心分配泳道
+    std::sort(m_blocks.begin(), m_blocks.end(), [](const Block& a, const Block& b) {
+        if (a.start != b.start) {
+            return a.start < b.start;
+        }
+        return (a.end - a.start) > (b.end - b.start);
+    });
+
+    QVector<quint64> laneEnds;
+    m_blockIndex.clear();
+    QList<MemoryIntervalTree::Interval> intervals;
+    for (int i = 0; i < m_blocks.size(); ++i) {
+        Block& block = m_blocks[i];
+        int lane = 0;
+        while (lane < laneEnds.size() && laneEnds[lane] > block.start) {
+            ++lane;
+        }
+        if (lane == laneEnds.size()) {
+            laneEnds.append(block.end);
+        } else {
+            laneEnds[lane] = block.end;
+        }
+        block.lane = lane;
+        m_blockIndex.insert(block.name, i);
+        intervals.append({block.start, block.end, block.name});
+    }
+    m_laneCount = std::max(1, static_cast<int>(laneEnds.size()));
+    m_tree.build(intervals);
+
+    // 计算空闲区间（已排序，合并覆盖范围）
+    m_gaps.clear();
+    quint64 cursor = m_baseAddress;
+    const quint64 limit = m_baseAddress + m_totalSize;
+    for (const Block& block : m_blocks) {
+        if (block.start > cursor && cursor < limit) {
+            m_gaps.append(qMakePair(cursor, std::min(block.start, limit)));
+        }
+        cursor = std::max(cursor, block.end);
+    }
+    if (cursor < limit) {
+        m_gaps.append(qMakePair(cursor, limit));
+    }
+
+    update();
+}
+
+QRect MemoryMapView::mapArea() const
+{
+    return rect().adjusted(RULER_WIDTH, 4, -4, -4);
+}
+
+double MemoryMapView::addressToY(quint64 address) const
+{
+    const QRect area = mapArea();
+    const double span = static_cast<double>(m_viewEnd - m_viewStart);
+    const double offset = static_cast<double>(address) - static_cast<double>(m_viewStart);
+    return area.top() + offset * area.height() / span;
+}
+
+quint64 MemoryMapView::yToAddress(double y) const
+{
+    const QRect area = mapArea();
+    const double span = static_cast<double>(m_viewEnd - m_viewStart);
+    double offset = (y - area.top()) * span / std::max(1, area.height());
+    double address = static_cast<double>(m_viewStart) + offset;
+    address = std::max(address, static_cast<double>(m_baseAddress));
+    address = std::min(address, static_cast<double>(m_baseAddress + m_totalSize));
+    return static_cast<quint64>(address);
+}
+
+QRect MemoryMapView::blockRect(const Block& block) const
+{
+    const QRect area = mapArea();
+    const int laneWidth = area.width() / m_laneCount;
+    double top = addressToY(block.start);
+    double bottom = addressToY(block.end);
+
+    // 限制在可见区域内，避免超大坐标；小区域至少保留2像素
+    top = std::max(top, static_cast<double>(area.top() - 1));
+    bottom = std::min(bottom, static_cast<double>(area.bottom() + 1));
+    if (bottom - top < 2.0) {
+        bottom = top + 2.0;
+    }
+
+    return QRect(area.left() + block.lane * laneWidth + 1,
+                 static_cast<int>(std::floor(top)),
+                 laneWidth - 2,
+                 static_cast<int>(std::ceil(bottom - top)));
+}
+
+void MemoryMapView::setViewRange(quint64 start, quint64 end)
+{
+    const quint64 limit = m_baseAddress + m_totalSize;
+    quint64 span = std::max<quint64>(end > start ? end - start : MIN_VIEW_SPAN, MIN_VIEW_SPAN);
+    span = std::min(span, m_totalSize);
+
+    start = std::max(start, m_baseAddress);
+    if (start + span > limit) {
+        start = limit - span;
+    }
+
+    m_viewStart = start;
+    m_viewEnd = start + span;
+    update();
+}
+
+quint64 MemoryMapView::snapAddress(quint64 address) const
+{
+    // 对齐粒度取不小于单像素字节数的2的幂
+    const QRect area = mapArea();
+    quint64 bytesPerPixel = (m_viewEnd - m_viewStart) / std::max(1, area.height());
+    quint64 granularity = MIN_SNAP;
+    while (granularity < bytesPerPixel) {
+        granularity <<= 1;
+    }
+    return ((address + granularity / 2) / granularity) * granularity;
+}
+
+QString MemoryMapView::formatAddress(quint64 address) const
+{
+    return QString("0x%1").arg(address, 8, 16, QChar('0')).toUpper();
+}
+
+QString MemoryMapView::formatSize(quint64 size) const
+{
+    const quint64 KB = 1024;
+    const quint64 MB = KB * 1024;
+    if (size >= MB && size % MB == 0) {
+        return QString("%1M").arg(size / MB);
+    } else if (size >= MB) {
+        return QString("%1M").arg(static_cast<double>(size) / MB, 0, 'f', 2);
+    } else if (size >= KB) {
+        return QString("%1K").arg(static_cast<double>(size) / KB, 0, 'g', 4);
+    }
+    return QString("%1B").arg(size);
+}
+
+void MemoryMapView::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(event->rect(), QColor("#2c3e50"));
+
+    const QRect area = mapArea();
+    painter.fillRect(area, QColor("#34495e"));
+
+    // 背景区域（如KERNEL_MEMORY）只绘制名称标注
+    for (const Block& block : m_backgroundBlocks) {
+        if (block.end <= m_viewStart || block.start >= m_viewEnd) {
+            continue;
+        }
+        painter.setPen(QColor("#5d6d7e"));
+        painter.drawText(area.adjusted(4, 2, -4, -2), Qt::AlignRight | Qt::AlignTop, block.name);
+    }
+
+    drawGaps(painter, area);
+
+    // 只绘制与视图窗口相交的区域：O(log n + 可见数量)
+    const QList<MemoryIntervalTree::Interval> visible = m_tree.overlapping(m_viewStart, m_viewEnd);
+    painter.save();
+    painter.setClipRect(area);
+    for (const MemoryIntervalTree::Interval& interval : visible) {
+        int index = m_blockIndex.value(interval.name, -1);
+        if (index < 0) {
+            continue;
+        }
+        const Block& block = m_blocks[index];
+        if (!blockRect(block).intersects(event->rect())) {
+            continue;
+        }
+        drawBlock(painter, block);
+    }
+    painter.restore();
+
+    drawRuler(painter, area);
+}
+
+void MemoryMapView::drawRuler(QPainter& painter, const QRect& area)
+{
+    // 刻度间距取2的幂，保证相邻刻度至少间隔28像素
+    const quint64 span = m_viewEnd - m_viewStart;
+    const int minSpacing = 28;
+    quint64 step = 1;
+    while (step < span && static_cast<double>(step) * area.height() / span < minSpacing) {
+        step <<= 1;
+    }
+
+    QFont font = painter.font();
+    font.setFamily("Courier New");
+    font.setPointSize(8);
+    painter.setFont(font);
+
+    quint64 tick = (m_viewStart / step) * step;
+    if (tick < m_viewStart) {
+        tick += step;
+    }
+    for (; tick <= m_viewEnd; tick += step) {
+        int y = static_cast<int>(addressToY(tick));
+        painter.setPen(QColor("#7f8c8d"));
+        painter.drawLine(area.left() - 6, y, area.left(), y);
+        painter.setPen(QColor("#ecf0f1"));
+        painter.drawText(QRect(2, y - 7, RULER_WIDTH - 10, 14), Qt::AlignRight | Qt::AlignVCenter,
+                         formatAddress(tick));
+        if (step == 0 || tick > std::numeric_limits<quint64>::max() - step) {
+            break;
+        }
+    }
+}
+
+void MemoryMapView::drawGaps(QPainter& painter, const QRect& area)
+{
+    // 空闲区间已排序且互不相交，二分定位第一个可见区间
+    auto it = std::lower_bound(m_gaps.constBegin(), m_gaps.constEnd(), m_viewStart,
+                               [](const QPair<quint64, quint64>& gap, quint64 address) {
+                                   return gap.second <= address;
+                               });
+
+    painter.save();
+    painter.setClipRect(area);
+    for (; it != m_gaps.constEnd() && it->first < m_viewEnd; ++it) {
+        double top = std::max(addressToY(it->first), static_cast<double>(area.top()));
+        double bottom = std::min(addressToY(it->second), static_cast<double>(area.bottom()));
+        QRect gapRect(area.left(), static_cast<int>(top), area.width(), static_cast<int>(bottom - top) + 1);
+        painter.fillRect(gapRect, QBrush(QColor("#566573"), Qt::BDiagPattern));
+        if (gapRect.height() >= 14) {
+            painter.setPen(QColor("#abb2b9"));
+            painter.drawText(gapRect.adjusted(4, 0, -4, 0), Qt::AlignCenter,
+                             QString("空闲 %1").arg(formatSize(it->second - it->first)));
+        }
+    }
+    painter.restore();
+}
+
+void MemoryMapView::drawBlock(QPainter& painter, const Block& block)
+{
+    const QRect r = blockRect(block);
+    const bool selected = (block.name == m_selectedName);
+    const bool hovered = (block.name == m_hoverName);
+
+    // 按名称生成稳定的颜色
+    QColor fill = QColor::fromHsv(static_cast<int>(qHash(block.name) % 360), 110, 200);
+    if (hovered) {
+        fill = fill.lighter(115);
+    }
+    painter.fillRect(r, fill);
+
+    if (block.overlapped) {
+        painter.fillRect(r, QBrush(QColor("#e74c3c"), Qt::DiagCrossPattern));
+    }
+
+    QPen pen(block.overlapped ? QColor("#e74c3c") : QColor("#1b2631"));
+    pen.setWidth(selected ? 2 : 1);
+    if (selected) {
+        pen.setColor(QColor("#f1c40f"));
+    }
+    painter.setPen(pen);
+    painter.drawRect(r.adjusted(0, 0, -1, -1));
+
+    if (r.height() >= 12) {
+        painter.setPen(QColor("#1b2631"));
+        QString text = block.name;
+        if (r.height() >= 26) {
+            text += "\n" + formatSize(block.end - block.start);
+        }
+        painter.drawText(r.adjusted(3, 0, -3, 0), Qt::AlignCenter | Qt::TextWordWrap, text);
+    }
+}
+
+int MemoryMapView::blockAt(const QPoint& pos) const
+{
+    const QRect area = mapArea();
+    if (!area.contains(pos)) {
+        return -1;
+    }
+
+    // 以像素对应的地址窗口查询区间树，再按泳道精确命中
+    quint64 address = yToAddress(pos.y());
+    quint64 slack = (m_viewEnd - m_viewStart) / std::max(1, area.height()) * EDGE_GRIP + 1;
+    quint64 from = address > slack ? address - slack : 0;
+    const QList<MemoryIntervalTree::Interval> hits = m_tree.overlapping(from, address + slack);
+    for (const MemoryIntervalTree::Interval& hit : hits) {
+        int index = m_blockIndex.value(hit.name, -1);
+        if (index >= 0 && blockRect(m_blocks[index]).adjusted(0, -1, 0, 1).contains(pos)) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+MemoryMapView::DragMode MemoryMapView::hitTest(int blockIndex, const QPoint& pos) const
+{
+    if (blockIndex < 0) {
+        return DragPan;
+    }
+    const QRect r = blockRect(m_blocks[blockIndex]);
+    if (r.height() > EDGE_GRIP * 3) {
+        if (pos.y() - r.top() <= EDGE_GRIP) {
+            return DragResizeTop;
+        }
+        if (r.bottom() - pos.y() <= EDGE_GRIP) {
+            return DragResizeBottom;
+        }
+    }
+    // 起始地址由约束推导的区域（如ION、RTOS_ION）只能拖动边缘调整大小，不能整体移动
+    if (m_lockedNames.contains(m_blocks[blockIndex].name)) {
+        return DragNone;
+    }
+    return DragMove;
+}
+
+void MemoryMapView::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+
+    int index = blockAt(event->pos());
+    m_dragBlock = index;
+    m_dragMode = hitTest(index, event->pos());
+    m_dragOrigin = event->pos();
+    m_dragOriginViewStart = m_viewStart;
+
+    if (index >= 0) {
+        m_dragOriginStart = m_blocks[index].start;
+        m_dragOriginEnd = m_blocks[index].end;
+        m_selectedName = m_blocks[index].name;
+        emit regionSelected(m_selectedName);
+        update();
+    }
+}
+
+void MemoryMapView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_dragMode == DragNone || !(event->buttons() & Qt::LeftButton)) {
+        // 悬停：更新光标和提示
+        int index = blockAt(event->pos());
+        QString name = index >= 0 ? m_blocks[index].name : QString();
+        DragMode mode = hitTest(index, event->pos());
+        if (mode == DragResizeTop || mode == DragResizeBottom) {
+            setCursor(Qt::SizeVerCursor);
+        } else if (mode == DragMove) {
+            setCursor(Qt::OpenHandCursor);
+        } else {
+            setCursor(Qt::ArrowCursor);
+        }
+        if (name != m_hoverName) {
+            QString oldHover = m_hoverName;
+            m_hoverName = name;
+            // 只重绘悬停状态变化的区域
+            if (m_blockIndex.contains(oldHover)) {
+                update(blockRect(m_blocks[m_blockIndex[oldHover]]).adjusted(-2, -2, 2, 2));
+            }
+            if (index >= 0) {
+                const Block& block = m_blocks[index];
+                update(blockRect(block).adjusted(-2, -2, 2, 2));
+                QToolTip::showText(event->globalPosition().toPoint(),
+                                   QString("%1\n%2 - %3\n%4")
+                                       .arg(block.name, formatAddress(block.start), formatAddress(block.end),
+                                            formatSize(block.end - block.start)),
+                                   this);
+            }
+        }
+        return;
+    }
+
+    const QRect area = mapArea();
+    const double bytesPerPixel = static_cast<double>(m_viewEnd - m_viewStart) / std::max(1, area.height());
+    const qint64 delta = static_cast<qint64>((event->pos().y() - m_dragOrigin.y()) * bytesPerPixel);
+
+    if (m_dragMode == DragPan) {
+        qint64 newStart = static_cast<qint64>(m_dragOriginViewStart) - delta;
+        newStart = std::max<qint64>(newStart, static_cast<qint64>(m_baseAddress));
+        setViewRange(static_cast<quint64>(newStart), static_cast<quint64>(newStart) + (m_viewEnd - m_viewStart));
+        return;
+    }
+
+    if (m_dragBlock < 0) {
+        return;
+    }
+
+    Block& block = m_blocks[m_dragBlock];
+    const QRect oldRect = blockRect(block);
+    const qint64 low = static_cast<qint64>(m_baseAddress);
+    const qint64 high = static_cast<qint64>(m_baseAddress + m_totalSize);
+    const qint64 originStart = static_cast<qint64>(m_dragOriginStart);
+    const qint64 originEnd = static_cast<qint64>(m_dragOriginEnd);
+
+    if (m_dragMode == DragMove) {
+        qint64 size = originEnd - originStart;
+        qint64 newStart = std::clamp<qint64>(originStart + delta, low, high - size);
+        block.start = snapAddress(static_cast<quint64>(newStart));
+        block.end = block.start + static_cast<quint64>(size);
+    } else if (m_dragMode == DragResizeTop) {
+        qint64 newStart = std::clamp<qint64>(originStart + delta, low, originEnd - 1);
+        block.start = std::min<quint64>(snapAddress(static_cast<quint64>(newStart)), m_dragOriginEnd - MIN_SNAP);
+    } else if (m_dragMode == DragResizeBottom) {
+        qint64 newEnd = std::clamp<qint64>(originEnd + delta, originStart + 1, high);
+        block.end = std::max<quint64>(snapAddress(static_cast<quint64>(newEnd)), m_dragOriginStart + MIN_SNAP);
+    }
+
+    // 拖拽过程中只更新该区域并重绘新旧位置，区间树、空闲区间和泳道在松开鼠标时重建
+    update(oldRect.united(blockRect(block)).adjusted(-2, -2, 2, 2));
+}
+
+void MemoryMapView::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mouseReleaseEvent(event);
+        return;
+    }
+
+    DragMode mode = m_dragMode;
+    int index = m_dragBlock;
+    m_dragMode = DragNone;
+    m_dragBlock = -1;
+
+    if (index < 0 || mode == DragPan || mode == DragNone) {
+        return;
+    }
+
+    const Block block = m_blocks[index];
+    if (block.start != m_dragOriginStart || block.end != m_dragOriginEnd) {
+        rebuildLayout();
+        // 由外部应用修改并校验约束，随后通过setRegions刷新
+        emit regionGeometryChanged(block.name, block.start, block.end - block.start);
+    }
+}
+
+void MemoryMapView::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    int index = blockAt(event->pos());
+    if (index >= 0) {
+        zoomToRegion(m_blocks[index].name);
+    } else {
+        resetZoom();
+    }
+}
+
+void MemoryMapView::wheelEvent(QWheelEvent *event)
+{
+    const int steps = event->angleDelta().y() / 120;
+    if (steps == 0) {
+        event->ignore();
+        return;
+    }
+
+    // 以鼠标位置为中心缩放
+    const double factor = std::pow(1.25, -steps);
+    const quint64 anchor = yToAddress(event->position().y());
+    const double span = static_cast<double>(m_viewEnd - m_viewStart);
+    const double newSpan = std::clamp(span * factor, static_cast<double>(MIN_VIEW_SPAN),
+                                      static_cast<double>(m_totalSize));
+    const double ratio = (static_cast<double>(anchor) - m_viewStart) / span;
+    const double newStart = static_cast<double>(anchor) - ratio * newSpan;
+
+    quint64 start = newStart > m_baseAddress ? static_cast<quint64>(newStart) : m_baseAddress;
+    setViewRange(start, start + static_cast<quint64>(newSpan));
+    event->accept();
+}
+
+void MemoryMapView::leaveEvent(QEvent *event)
+{
+    if (!m_hoverName.isEmpty() && m_blockIndex.contains(m_hoverName)) {
+        update(blockRect(m_blocks[m_blockIndex[m_hoverName]]).adjusted(-2, -2, 2, 2));
+    }
+    m_hoverName.clear();
+    QWidget::leaveEvent(event);
+}
@@ -0,0 +1,118 @@
+#ifndef MEMORYMAPVIEW_H
+#define MEMORYMAPVIEW_H
+
+#include <QWidget>
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include <QStringList>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include "memorylayoutengine.h"
+
+// DRAM地址空间图形视图：按比例绘制内存区域，支持缩放、重叠/空隙高亮以及拖拽调整
+class MemoryMapView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryMapView(QWidget *parent = nullptr);
+
+    // 设置DRAM地址范围
+    void setAddressRange(quint64 baseAddress, quint64 totalSize);
+    // 更新区域数据及重叠结果（只在数据变化时调用，绘制时不再遍历全部区域）
+    void setRegions(const QMap<QString, MemoryRegion>& regions, const QList<QPair<QString, QString>>& overlaps);
+    // 覆盖整个DRAM的背景区域（如KERNEL_MEMORY），作为底色绘制，不参与空隙计算
+    void setBackgroundRegions(const QStringList& names);
+    // 起始地址由约束推导的区域只允许调整大小，不允许整体移动
+    void setLockedRegions(const QStringList& names);
+
+    void setSelectedRegion(const QString& name);
+    void zoomToRegion(const QString& name);
+    void resetZoom();
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+signals:
+    void regionSelected(const QString& name);
+    void regionGeometryChanged(const QString& name, quint64 startAddress, quint64 size);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+
+private:
+    struct Block {
+        QString name;
+        quint64 start;
+        quint64 end;
+        int lane;
+        bool overlapped;
+    };
+
+    enum DragMode {
+        DragNone = 0,
+        DragMove,
+        DragResizeTop,
+        DragResizeBottom,
+        DragPan
+    };
+
+    void rebuildLayout();
+    QRect mapArea() const;
+    double addressToY(quint64 address) const;
+    quint64 yToAddress(double y) const;
+    QRect blockRect(const Block& block) const;
+    int blockAt(const QPoint& pos) const;
+    DragMode hitTest(int blockIndex, const QPoint& pos) const;
+    void setViewRange(quint64 start, quint64 end);
+    quint64 snapAddress(quint64 address) const;
+    QString formatAddress(quint64 address) const;
+    QString formatSize(quint64 size) const;
+
+    void drawRuler(QPainter& painter, const QRect& area);
+    void drawGaps(QPainter& painter, const QRect& area);
+    void drawBlock(QPainter& painter, const Block& block);
+
+    // 数据
+    quint64 m_baseAddress;
+    quint64 m_totalSize;
+    QVector<Block> m_blocks;
+    QHash<QString, int> m_blockIndex;
+    QList<Block> m_backgroundBlocks;
+    QVector<QPair<quint64, quint64>> m_gaps;   // 按地址排序、互不相交的空闲区间
+    MemoryIntervalTree m_tree;
+    QStringList m_backgroundNames;
+    QStringList m_lockedNames;
+    int m_laneCount;
+
+    // 视图窗口 [m_viewStart, m_viewEnd)
+    quint64 m_viewStart;
+    quint64 m_viewEnd;
+
+    // 交互状态
+    QString m_selectedName;
+    QString m_hoverName;
+    DragMode m_dragMode;
+    int m_dragBlock;
+    QPoint m_dragOrigin;
+    quint64 m_dragOriginStart;
+    quint64 m_dragOriginEnd;
+    quint64 m_dragOriginViewStart;
+
+    static constexpr int RULER_WIDTH = 78;
+    static constexpr int EDGE_GRIP = 4;
+    static constexpr quint64 MIN_VIEW_SPAN = 0x400;    // 最大放大到1K，便于查看CVI_UPDATE_HEADER
+    static constexpr quint64 MIN_SNAP = 0x1000;       // 拖拽对齐粒度下限（4K页），随缩放级别增大
+};
+
+#endif // MEMORYMAPVIEW_H
@@ -0,0 +1,250 @@
+#include "memoryregionmodel.h"
+#include <QBrush>
+#include <QColor>
+
+MemoryRegionModel::MemoryRegionModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int MemoryRegionModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_regionOrder.size();
+}
+
+int MemoryRegionModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : COL_COUNT;
+}
+
+QVariant MemoryRegionModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_regionOrder.size()) {
+        return QVariant();
+    }
+
+    const QString& regionName = m_regionOrder[index.row()];
+    auto it = m_memoryRegions.constFind(regionName);
+    if (it == m_memoryRegions.constEnd()) {
+        return QVariant();
+    }
+    const MemoryRegion& region = it.value();
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case COL_NAME:              return region.name;
+        case COL_START_ADDRESS:     return formatAddress(region.startAddress);
+        case COL_END_ADDRESS:       return formatAddress(region.endAddress);
+        case COL_SIZE_HEX:          return QString("0x%1").arg(region.size, 0, 16);
+        case COL_SIZE_FORMATTED:    return region.sizeString;
+        default:                    return QVariant();
+        }
+
+    case Qt::BackgroundRole:
+        if (index.column() == COL_NAME && m_overlaps.contains(regionName)) {
+            return QBrush(QColor("#fadbd8"));
+        }
+        if (index.column() == COL_SIZE_HEX || index.column() == COL_SIZE_FORMATTED) {
+            return QBrush(QColor("#f8f9fa"));
+        }
+        return QVariant();
+
+    case Qt::ToolTipRole:
+        if (index.column() == COL_NAME && m_overlaps.contains(regionName)) {
+            return QString("与以下区域重叠: %1").arg(m_overlaps[regionName].join(", "));
+        }
+        return QVariant();
+
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags MemoryRegionModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    // 表格只读，只能通过配置面板或内存映射图修改
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+QVariant MemoryRegionModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    static const QStringList headers = {
+        "Name", "Start Address", "End Address", "Size", "Size(M/K/B)"
+    };
+    return section >= 0 && section < headers.size() ? headers[section] : QVariant();
+}
+
+void MemoryRegionModel::setRegions(const QList<MemoryRegion>& regions)
+{
+    beginResetModel();
+    m_memoryRegions.clear();
+    m_regionOrder.clear();
+    for (const MemoryRegion& region : regions) {
+        if (!m_memoryRegions.contains(region.name)) {
+            m_regionOrder.append(region.name);
+        }
+        m_memoryRegions[region.name] = region;
+    }
+    m_overlaps.clear();
+    rebuildIndex();
+    endResetModel();
+}
+
+void MemoryRegionModel::appendRegion(const MemoryRegion& region)
+{
+    if (m_memoryRegions.contains(region.name)) {
+        QMap<QString, MemoryRegion> updated;
+        updated[region.name] = region;
+        updateRegions(updated);
+        return;
+    }
+
+    int row = m_regionOrder.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_memoryRegions[region.name] = region;
+    m_regionOrder.append(region.name);
+    m_rowIndex.insert(region.name, row);
+    QString nameKey = region.name.toLower();
+    if (!m_nameIndex.contains(nameKey)) {
+        m_nameIndex.insert(nameKey, row);
+    }
+    endInsertRows();
+}
+
+bool MemoryRegionModel::removeRegion(const QString& name)
+{
+    int row = rowOf(name);
+    if (row < 0) {
+        return false;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_memoryRegions.remove(name);
+    m_regionOrder.removeAt(row);
+    m_overlaps.remove(name);
+    rebuildIndex();
+    endRemoveRows();
+    return true;
+}
+
+bool MemoryRegionModel::renameRegion(const QString& oldName, const QString& newName)
+{
+    int row = rowOf(oldName);
+    if (row < 0 || newName.isEmpty() || (newName != oldName && m_memoryRegions.contains(newName))) {
+        return false;
+    }
+    if (newName == oldName) {
+        return true;
+    }
+
+    MemoryRegion region = m_memoryRegions.take(oldName);
+    region.name = newName;
+    m_memoryRegions[newName] = region;
+    m_regionOrder[row] = newName;
+    if (m_overlaps.contains(oldName)) {
+        m_overlaps[newName] = m_overlaps.take(oldName);
+    }
+    rebuildIndex();
+
+    emit dataChanged(index(row, 0), index(row, COL_COUNT - 1));
+    return true;
+}
+
+void MemoryRegionModel::updateRegions(const QMap<QString, MemoryRegion>& regions)
+{
+    for (auto it = regions.constBegin(); it != regions.constEnd(); ++it) {
+        auto stored = m_memoryRegions.find(it.key());
+        if (stored != m_memoryRegions.end()) {
+            stored.value() = it.value();
+            stored.value().name = it.key();
+        }
+    }
+
+    if (!m_regionOrder.isEmpty()) {
+        emit dataChanged(index(0, 0), index(m_regionOrder.size() - 1, COL_COUNT - 1));
+    }
+}
+
+bool MemoryRegionModel::contains(const QString& name) const
+{
+    return m_rowIndex.contains(name);
+}
+
+MemoryRegion MemoryRegionModel::region(const QString& name) const
+{
+    return m_memoryRegions.value(name, MemoryRegion());
+}
+
+int MemoryRegionModel::rowOf(const QString& name) const
+{
+    return m_rowIndex.value(name, -1);
+}
+
+QString MemoryRegionModel::nameAt(int row) const
+{
+    return row >= 0 && row < m_regionOrder.size() ? m_regionOrder[row] : QString();
+}
+
+int MemoryRegionModel::findName(const QString& name) const
+{
+    return m_nameIndex.value(name.toLower(), -1);
+}
+
+bool MemoryRegionModel::nameContains(int row, const QString& text) const
+{
+    if (row < 0 || row >= m_regionOrder.size()) {
+        return false;
+    }
+    return text.isEmpty() || m_regionOrder[row].contains(text, Qt::CaseInsensitive);
+}
+
+const QMap<QString, MemoryRegion>& MemoryRegionModel::regions() const
+{
+    return m_memoryRegions;
+}
+
+const QStringList& MemoryRegionModel::regionOrder() const
+{
+    return m_regionOrder;
+}
+
+void MemoryRegionModel::setOverlaps(const QList<QPair<QString, QString>>& overlaps)
+{
+    m_overlaps.clear();
+    for (const auto& pair : overlaps) {
+        m_overlaps[pair.first].append(pair.second);
+        m_overlaps[pair.second].append(pair.first);
+    }
+
+    if (!m_regionOrder.isEmpty()) {
+        emit dataChanged(index(0, COL_NAME), index(m_regionOrder.size() - 1, COL_NAME),
+                         {Qt::BackgroundRole, Qt::ToolTipRole});
+    }
+}
+
+QString MemoryRegionModel::formatAddress(quint64 address)
+{
+    return QString("0x%1").arg(address, 8, 16, QChar('0')).toUpper();
+}
+
+void MemoryRegionModel::rebuildIndex()
+{
+    m_rowIndex.clear();
+    m_nameIndex.clear();
+    for (int row = 0; row < m_regionOrder.size(); ++row) {
+        m_rowIndex.insert(m_regionOrder[row], row);
+        QString nameKey = m_regionOrder[row].toLower();
+        if (!m_nameIndex.contains(nameKey)) {
+            m_nameIndex.insert(nameKey, row);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef MEMORYREGIONMODEL_H
+#define MEMORYREGIONMODEL_H
+
+#include <QAbstractTableModel>
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include "memorylayoutengine.h"
+
+// 内存区域表模型：区域数据的唯一来源，按区域名O(1)定位行
+// 不依赖任何控件，布局计算、导出等逻辑可在无界面时直接使用
+class MemoryRegionModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        COL_NAME = 0,
+        COL_START_ADDRESS,
+        COL_END_ADDRESS,
+        COL_SIZE_HEX,
+        COL_SIZE_FORMATTED,
+        COL_COUNT
+    };
+
+    explicit MemoryRegionModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // 区域数据（按列表顺序显示）
+    void setRegions(const QList<MemoryRegion>& regions);
+    void appendRegion(const MemoryRegion& region);
+    bool removeRegion(const QString& name);
+    bool renameRegion(const QString& oldName, const QString& newName);
+    // 布局引擎可能同时移动多个区域：按名称整体替换已有区域的数据，不改变行顺序
+    void updateRegions(const QMap<QString, MemoryRegion>& regions);
+
+    bool contains(const QString& name) const;
+    MemoryRegion region(const QString& name) const;
+    int rowOf(const QString& name) const;               // 不存在返回-1
+    QString nameAt(int row) const;                      // 越界返回空
+    int findName(const QString& name) const;            // 名称精确匹配（不区分大小写）的行，-1表示无
+    bool nameContains(int row, const QString& text) const;
+
+    const QMap<QString, MemoryRegion>& regions() const;
+    const QStringList& regionOrder() const;
+
+    // 名称列标记未被约束允许的重叠
+    void setOverlaps(const QList<QPair<QString, QString>>& overlaps);
+
+    static QString formatAddress(quint64 address);
+
+private:
+    void rebuildIndex();
+
+    // 数据存储
+    QMap<QString, MemoryRegion> m_memoryRegions;
+    QStringList m_regionOrder;                  // 用于保持原始顺序
+    QHash<QString, int> m_rowIndex;             // 区域名 -> 行
+    QHash<QString, int> m_nameIndex;            // 小写区域名 -> 行
+
+    QMap<QString, QStringList> m_overlaps;      // 区域名 -> 与之重叠的区域
+};
+
+#endif // MEMORYREGIONMODEL_H
@@ -5,6 +5,9 @@
 #include <QDoubleSpinBox>
 #include <QAbstractSpinBox>
 #include <QRegularExpression>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDialogButtonBox>
 
 PeripheralConfigDialog::PeripheralConfigDialog(const QString &peripheralType, DtsConfig *dtsConfig, QWidget *parent)
     : QDialog(parent)
@@ -32,6 +35,9 @@ PeripheralConfigDialog::PeripheralConfigDialog(const QString &peripheralType, Dt
     , m_cancelButton(nullptr)
     , m_baudRateComboBox(nullptr)
     , m_customBaudLineEdit(nullptr)
+    , m_rateLabel(nullptr)
+    , m_syncClockButton(nullptr)
+    , m_autoDmaButton(nullptr)
 {
     // 初始化SYSDMA通道控件指针为nullptr
     for (int i = 0; i < 8; i++) {
@@ -45,7 +51,7 @@ PeripheralConfigDialog::PeripheralConfigDialog(const QString &peripheralType, Dt
 void PeripheralConfigDialog::setupUI()
 {
     setWindowTitle(QString("%1 外设配置").arg(m_peripheralType.toUpper()));
-    setFixedSize(400, 400);
+    setFixedSize(400, 460);
     setModal(true);
 
     // 创建主布局
@@ -149,6 +155,11 @@ void PeripheralConfigDialog::setupPeripheralSpecificUI(int &currentRow)
         m_peripheralLayout->addWidget(m_freqSpinBox, currentRow, 1);
         currentRow++;
 
+        m_rateLabel = new QLabel(this);
+        m_peripheralLayout->addWidget(new QLabel("实际速率:", this), currentRow, 0);
+        m_peripheralLayout->addWidget(m_rateLabel, currentRow, 1);
+        currentRow++;
+
     } else if (m_peripheralType == "uart") {
         // UART: 时钟频率只填写数字，单位为 MHz（无需选择单位）
         m_freqLabel = new QLabel("时钟频率:", this);
@@ -163,13 +174,20 @@ void PeripheralConfigDialog::setupPeripheralSpecificUI(int &currentRow)
         m_peripheralLayout->addWidget(m_freqDoubleSpinBox, currentRow, 1);
         currentRow++;
 
+        // clock-frequency 必须与实际的UART时钟一致，否则内核计算出的分频是错的
+        m_syncClockButton = new QPushButton("使用时钟树频率", this);
+        m_syncClockButton->setEnabled(false);
+        m_peripheralLayout->addWidget(m_syncClockButton, currentRow, 1);
+        currentRow++;
+
         m_currentSpeedLabel = new QLabel("波特率:", this);
 
         // 下拉框：固定选项 + 自定义
         m_baudRateComboBox = new QComboBox(this);
         QStringList baudItems = {
             "1200","2400","4800","9600","19200","38400","57600",
-            "115200","230400","460800","921600","自定义"
+            "115200","230400","460800","921600",
+            "1000000","1500000","2000000","3000000","自定义"
         };
         m_baudRateComboBox->addItems(baudItems);
         m_baudRateComboBox->setCurrentText("115200");
@@ -188,6 +206,11 @@ void PeripheralConfigDialog::setupPeripheralSpecificUI(int &currentRow)
         m_peripheralLayout->addWidget(m_customBaudLineEdit, currentRow, 1);
         currentRow++;
 
+        m_rateLabel = new QLabel(this);
+        m_peripheralLayout->addWidget(new QLabel("实际波特率:", this), currentRow, 0);
+        m_peripheralLayout->addWidget(m_rateLabel, currentRow, 1);
+        currentRow++;
+
     } else if (m_peripheralType == "pwm") {
         // PWM: 显示时钟名称和PWM cells
         m_clockLabel = new QLabel("时钟名称:", this);
@@ -214,6 +237,12 @@ void PeripheralConfigDialog::setupPeripheralSpecificUI(int &currentRow)
         m_peripheralLayout->addWidget(m_clockLineEdit, currentRow, 1);
         currentRow++;
 
+        // SPI速率由从设备的 spi-max-frequency 决定，这里列出源时钟下可达的最高几档SCK
+        m_rateLabel = new QLabel(this);
+        m_peripheralLayout->addWidget(new QLabel("可达SCK:", this), currentRow, 0);
+        m_peripheralLayout->addWidget(m_rateLabel, currentRow, 1);
+        currentRow++;
+
     } else if (m_peripheralType == "sysdma") {
         // SYSDMA: 显示8个通道的映射配置
         QStringList channelOptions = {
@@ -254,6 +283,10 @@ void PeripheralConfigDialog::setupPeripheralSpecificUI(int &currentRow)
             currentRow++;
         }
 
+        m_autoDmaButton = new QPushButton("按吞吐量自动分配...", this);
+        m_peripheralLayout->addWidget(m_autoDmaButton, currentRow, 1);
+        currentRow++;
+
     } else if (m_peripheralType == "gpio" || m_peripheralType == "saradc") {
         // GPIO和SARADC: 只有状态配置，不需要额外控件
         // 这里不添加任何额外控件
@@ -303,6 +336,19 @@ void PeripheralConfigDialog::setupConnections()
         connect(m_customBaudLineEdit, &QLineEdit::textChanged, this, &PeripheralConfigDialog::onCurrentSpeedChanged);
     }
 
+    if (m_autoDmaButton) {
+        connect(m_autoDmaButton, &QPushButton::clicked, this, &PeripheralConfigDialog::onAutoAllocateDmaClicked);
+    }
+
+    if (m_syncClockButton) {
+        connect(m_syncClockButton, &QPushButton::clicked, this, [this]() {
+            const double mhz = m_clocksMHz.value(sourceClockName(), 0.0);
+            if (mhz > 0.0 && m_freqDoubleSpinBox) {
+                m_freqDoubleSpinBox->setValue(mhz);
+            }
+        });
+    }
+
     // SYSDMA通道变化连接
     for (int i = 0; i < 8; i++) {
         if (m_sysdmaChannelComboBoxes[i]) {
@@ -442,6 +488,8 @@ void PeripheralConfigDialog::loadPeripheralConfig()
     for (QObject* o : toBlock) {
         if (o) o->blockSignals(false);
     }
+
+    updateRateCheck();
 }
 
 void PeripheralConfigDialog::savePeripheralConfig()
@@ -542,6 +590,7 @@ void PeripheralConfigDialog::onClockChanged()
     if (!m_currentPeripheral.isEmpty()) {
         savePeripheralConfig();
     }
+    updateRateCheck();
 }
 
 void PeripheralConfigDialog::onFreqChanged()
@@ -550,6 +599,7 @@ void PeripheralConfigDialog::onFreqChanged()
     if (!m_currentPeripheral.isEmpty()) {
         savePeripheralConfig();
     }
+    updateRateCheck();
 }
 
 void PeripheralConfigDialog::onPwmCellsChanged()
@@ -566,6 +616,7 @@ void PeripheralConfigDialog::onCurrentSpeedChanged()
     if (!m_currentPeripheral.isEmpty()) {
         savePeripheralConfig();
     }
+    updateRateCheck();
 }
 
 void PeripheralConfigDialog::onSysdmaChannelChanged()
@@ -577,16 +628,243 @@ void PeripheralConfigDialog::onSysdmaChannelChanged()
 }
 
 void PeripheralConfigDialog::onApplyClicked()
+{
+    // 会导致数据错误的速率需要确认
+    if (m_rateLabel && m_peripheralType != "spi") {
+        RateEvaluation eval = evaluateCurrentRate();
+        if (eval.verdict == RateVerdict::Invalid && eval.sourceHz > 0.0) {
+            QMessageBox::StandardButton reply = QMessageBox::question(this, "速率无法实现",
+                QString("%1\n\n是否仍然保存？").arg(eval.summary()),
+                QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+            if (reply != QMessageBox::Yes) {
+                return;
+            }
+        }
+    }
+
+    savePeripheralConfig();
+
+    // 只保存当前外设的配置，而不是整个文件；写入完成前禁止重复提交
+    m_applyButton->setEnabled(false);
+    m_dtsConfig->savePeripheralConfig(m_currentPeripheral).then(this, [this](FileIoResult result) {
+        m_applyButton->setEnabled(true);
+        if (result.ok) {
+            QMessageBox::information(this, "成功", QString("外设 %1 配置已保存到设备树文件！").arg(m_currentPeripheral));
+            accept();
+        } else {
+            QMessageBox::critical(this, "错误", QString("无法保存设备树文件！\n%1").arg(result.errorMessage));
+        }
+    });
+}
+
+void PeripheralConfigDialog::onAutoAllocateDmaClicked()
 {
     savePeripheralConfig();
+    const QStringList currentChannels = m_dtsConfig->getPeripheralInfo(m_currentPeripheral).sysdmaChannels;
+    QList<DmaDemand> demands = SysdmaAllocator::candidates(m_dtsConfig->getPeripheralInfos(), currentChannels, m_clocksMHz);
+
+    // 由用户确认需要DMA的外设及预期吞吐量
+    QDialog demandDialog(this);
+    demandDialog.setWindowTitle("SYSDMA 通道需求");
+    QVBoxLayout *layout = new QVBoxLayout(&demandDialog);
+    layout->addWidget(new QLabel("勾选需要DMA的外设并填写预期吞吐量 (KB/s)：", &demandDialog));
+
+    QTableWidget *table = new QTableWidget(demands.size(), 3, &demandDialog);
+    table->setHorizontalHeaderLabels({"外设", "RX KB/s", "TX KB/s"});
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int row = 0; row < demands.size(); ++row) {
+        const DmaDemand &demand = demands[row];
+        QTableWidgetItem *nameItem = new QTableWidgetItem(demand.peripheral);
+        nameItem->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
+        nameItem->setCheckState(demand.enabled ? Qt::Checked : Qt::Unchecked);
+        table->setItem(row, 0, nameItem);
+
+        const QList<QPair<QString, double>> directions = {
+            {demand.rxChannel, demand.rxBytesPerSec}, {demand.txChannel, demand.txBytesPerSec}
+        };
+        for (int col = 0; col < directions.size(); ++col) {
+            QTableWidgetItem *rateItem = new QTableWidgetItem();
+            if (directions[col].first.isEmpty()) {
+                rateItem->setText("-");
+                rateItem->setFlags(Qt::ItemIsEnabled);
+            } else {
+                rateItem->setText(QString::number(directions[col].second / 1000.0, 'f', 1));
+            }
+            table->setItem(row, col + 1, rateItem);
+        }
+    }
+    layout->addWidget(table);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &demandDialog);
+    connect(buttons, &QDialogButtonBox::accepted, &demandDialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &demandDialog, &QDialog::reject);
+    layout->addWidget(buttons);
+    demandDialog.resize(420, 520);
+    if (demandDialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    for (int row = 0; row < demands.size(); ++row) {
+        DmaDemand &demand = demands[row];
+        demand.enabled = table->item(row, 0)->checkState() == Qt::Checked;
+        demand.rxBytesPerSec = demand.rxChannel.isEmpty() ? 0.0 : qMax(0.0, table->item(row, 1)->text().toDouble() * 1000.0);
+        demand.txBytesPerSec = demand.txChannel.isEmpty() ? 0.0 : qMax(0.0, table->item(row, 2)->text().toDouble() * 1000.0);
+    }
+
+    DmaAllocation allocation = SysdmaAllocator::allocate(demands, currentChannels);
+    if (allocation.assignments.isEmpty()) {
+        QMessageBox::information(this, "SYSDMA 通道分配", "没有需要DMA的外设，保持当前通道映射。");
+        return;
+    }
+
+    QMessageBox::StandardButton reply = QMessageBox::question(this, "SYSDMA 通道分配",
+        QString("%1\n\n%2\n\n应用此通道映射并保存到设备树？").arg(allocation.summary(), allocation.breakdown()),
+        QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
+    if (reply != QMessageBox::Yes) {
+        return;
+    }
+
+    // 一次写入 ch-remap 及各外设的 dmas 属性
+    for (int i = 0; i < 8 && i < allocation.channels.size(); i++) {
+        if (m_sysdmaChannelComboBoxes[i]) {
+            m_sysdmaChannelComboBoxes[i]->blockSignals(true);
+            int index = m_sysdmaChannelComboBoxes[i]->findText(QString("(%1)").arg(allocation.channels[i]), Qt::MatchContains);
+            if (index >= 0) {
+                m_sysdmaChannelComboBoxes[i]->setCurrentIndex(index);
+            }
+            m_sysdmaChannelComboBoxes[i]->blockSignals(false);
+        }
+    }
+    onApplyClicked();
+}
+
+void PeripheralConfigDialog::setClockFrequencies(const QMap<QString, double> &clocksMHz)
+{
+    m_clocksMHz = clocksMHz;
+    updateRateCheck();
+}
+
+QString PeripheralConfigDialog::sourceClockName() const
+{
+    // 设备树中的时钟名优先，其次按外设类型使用默认的功能时钟
+    if (m_clockLineEdit && !m_clockLineEdit->text().isEmpty()) {
+        QString name = "clk_" + m_clockLineEdit->text().trimmed().toLower();
+        if (m_clocksMHz.contains(name)) {
+            return name;
+        }
+    }
+
+    QRegularExpression indexRegex("(\\d+)$");
+    QString index = indexRegex.match(m_currentPeripheral).captured(1);
+    if (m_peripheralType == "uart") {
+        return "clk_uart" + index;
+    } else if (m_peripheralType == "i2c") {
+        return "clk_i2c";
+    } else if (m_peripheralType == "spi") {
+        return "clk_spi";
+    }
+    return QString();
+}
+
+int PeripheralConfigDialog::currentBaudRate() const
+{
+    if (!m_baudRateComboBox) {
+        return 0;
+    }
+    if (m_baudRateComboBox->currentText() == "自定义") {
+        return m_customBaudLineEdit ? m_customBaudLineEdit->text().toInt() : 0;
+    }
+    return m_baudRateComboBox->currentText().toInt();
+}
+
+RateEvaluation PeripheralConfigDialog::evaluateCurrentRate() const
+{
+    const QString clock = sourceClockName();
+    const double sourceHz = m_clocksMHz.value(clock, 0.0) * 1e6;
+
+    if (m_peripheralType == "uart") {
+        // 时钟树不可用时按设备树中的 clock-frequency 计算
+        if (m_clocksMHz.isEmpty() && m_freqDoubleSpinBox) {
+            return BusRateCalculator::evaluateUart("clock-frequency", m_freqDoubleSpinBox->value() * 1e6, currentBaudRate());
+        }
+        return BusRateCalculator::evaluateUart(clock, sourceHz, currentBaudRate());
+    } else if (m_peripheralType == "i2c" && m_freqSpinBox) {
+        return BusRateCalculator::evaluateI2c(clock, sourceHz, m_freqSpinBox->value() * 1000);
+    }
+
+    RateEvaluation eval;
+    eval.sourceClock = clock;
+    eval.sourceHz = sourceHz;
+    return eval;
+}
+
+void PeripheralConfigDialog::updateRateCheck()
+{
+    if (!m_rateLabel) {
+        return;
+    }
+
+    m_rateLabel->setWordWrap(true);
+    if (m_clocksMHz.isEmpty() && m_peripheralType != "uart") {
+        m_rateLabel->setText("时钟树不可用");
+        m_rateLabel->setStyleSheet("color: #7f8c8d;");
+        return;
+    }
+
+    if (m_peripheralType == "spi") {
+        const QString clock = sourceClockName();
+        const double sourceHz = m_clocksMHz.value(clock, 0.0) * 1e6;
+        if (sourceHz <= 0.0) {
+            m_rateLabel->setText(QString("源时钟 %1 未启用").arg(clock));
+            m_rateLabel->setStyleSheet("color: #e74c3c;");
+            return;
+        }
+        QStringList rates;
+        for (const RateCandidate& rate : BusRateCalculator::spiRates(sourceHz, 4)) {
+            rates << QString("%1 MHz").arg(rate.actualHz / 1e6, 0, 'f', 2);
+        }
+        m_rateLabel->setText(QString("%1 = %2 MHz\n%3")
+                             .arg(clock).arg(sourceHz / 1e6, 0, 'f', 1).arg(rates.join(" / ")));
+        m_rateLabel->setStyleSheet("color: #2c3e50;");
+        return;
+    }
+
+    RateEvaluation eval = evaluateCurrentRate();
+    QString text = eval.summary();
+
+    // UART: 设备树 clock-frequency 与时钟树不一致时内核会按错误的时钟计算分频
+    if (m_syncClockButton && m_freqDoubleSpinBox) {
+        const double treeMHz = m_clocksMHz.value(sourceClockName(), 0.0);
+        const bool mismatch = treeMHz > 0.0 && qAbs(m_freqDoubleSpinBox->value() - treeMHz) > treeMHz * 0.005;
+        m_syncClockButton->setEnabled(mismatch);
+        if (mismatch) {
+            text += QString("\n设备树 clock-frequency 与 %1 (%2 MHz) 不一致")
+                    .arg(sourceClockName()).arg(treeMHz, 0, 'f', 3);
+        }
+    }
+
+    // 常用波特率的可达情况放在提示中
+    if (m_peripheralType == "uart" && eval.sourceHz > 0.0) {
+        QStringList lines;
+        for (const auto& rate : BusRateCalculator::standardUartRates(eval.sourceClock, eval.sourceHz)) {
+            lines << QString("%1: %2%3%")
+                     .arg(rate.first, 8)
+                     .arg(rate.second.best.errorPercent >= 0 ? "+" : "")
+                     .arg(rate.second.best.errorPercent, 0, 'f', 2)
+                     + (rate.second.verdict == RateVerdict::Invalid ? " ✗" : "");
+        }
+        m_rateLabel->setToolTip(lines.join("\n"));
+    }
 
-    // 只保存当前外设的配置，而不是整个文件
-    if (m_dtsConfig->savePeripheralConfig(m_currentPeripheral)) {
-        QMessageBox::information(this, "成功", QString("外设 %1 配置已保存到设备树文件！").arg(m_currentPeripheral));
-        accept();
-    } else {
-        QMessageBox::critical(this, "错误", "无法保存设备树文件！");
+    QString color = "#27ae60";
+    if (eval.verdict == RateVerdict::Marginal) {
+        color = "#d35400";
+    } else if (eval.verdict == RateVerdict::Invalid) {
+        color = "#e74c3c";
     }
+    m_rateLabel->setText(text);
+    m_rateLabel->setStyleSheet(QString("color: %1;").arg(color));
 }
 
 void PeripheralConfigDialog::onCancelClicked()
@@ -14,6 +14,8 @@
 #include <QCheckBox>
 #include <QSpinBox>
 #include "dtsconfig.h"
+#include "busratecalculator.h"
+#include "sysdmaallocator.h"
 
 class PeripheralConfigDialog : public QDialog
 {
@@ -22,6 +24,9 @@ class PeripheralConfigDialog : public QDialog
 public:
     explicit PeripheralConfigDialog(const QString &peripheralType, DtsConfig *dtsConfig, QWidget *parent = nullptr);
 
+    // 时钟树中各时钟的当前频率(MHz)，用于校验波特率/总线速率能否实现
+    void setClockFrequencies(const QMap<QString, double> &clocksMHz);
+
 private slots:
     void onApplyClicked();
     void onCancelClicked();
@@ -32,6 +37,7 @@ private slots:
     void onPwmCellsChanged();
     void onCurrentSpeedChanged();
     void onSysdmaChannelChanged();
+    void onAutoAllocateDmaClicked();
 
 private:
     void setupUI();
@@ -42,6 +48,12 @@ private:
     void loadPeripheralConfig();
     void savePeripheralConfig();
 
+    // 速率校验：源时钟取自时钟树
+    QString sourceClockName() const;
+    int currentBaudRate() const;
+    RateEvaluation evaluateCurrentRate() const;
+    void updateRateCheck();
+
 private:
     QString m_peripheralType;
     DtsConfig *m_dtsConfig;
@@ -65,15 +77,19 @@ private:
     QSpinBox *m_currentSpeedSpinBox;
     QComboBox *m_baudRateComboBox;       // 新增：波特率下拉
     QLineEdit *m_customBaudLineEdit;     // 新增：自定义波特率输入
+    QLabel *m_rateLabel;                 // 速率校验结果
+    QPushButton *m_syncClockButton;      // UART: 用时钟树频率更新 clock-frequency
     // SYSDMA 通道控件
     QLabel *m_sysdmaChannelLabels[8];    // 8个通道的标签
     QComboBox *m_sysdmaChannelComboBoxes[8]; // 8个通道的下拉框
+    QPushButton *m_autoDmaButton;        // 按吞吐量自动分配通道
     QHBoxLayout *m_buttonLayout;
     QPushButton *m_applyButton;
     QPushButton *m_cancelButton;
     // 当前选中的外设信息
     QString m_currentPeripheral;
     PeripheralInfo m_currentInfo;
+    QMap<QString, double> m_clocksMHz;
 };
 
 #endif // PERIPHERALCONFIGDIALOG_H
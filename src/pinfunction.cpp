@@ -10,6 +10,11 @@ QStringList PinFunction::getSupportedFunctions(const QString& pinName) const
     return m_pinFunctions.value(pinName, QStringList() << "GPIO");
 }
 
+QStringList PinFunction::getPinNames() const
+{
+    return m_pinFunctions.keys();
+}
+
 QString PinFunction::getDefaultFunction(const QString& pinName) const
 {
     return m_defaultFunctions.value(pinName, "GPIO");
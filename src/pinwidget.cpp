@@ -88,6 +88,23 @@ QStringList PinWidget::getSupportedFunctions() const
     return m_functions;
 }
 
+bool PinWidget::matchesSearch(const QString& position, const QString& text) const
+{
+    // 1. 检查是否匹配引脚号或显示名称
+    if (position.contains(text, Qt::CaseInsensitive) ||
+        m_displayName.contains(text, Qt::CaseInsensitive)) {
+        return true;
+    }
+
+    // 2. 检查是否匹配引脚支持的功能
+    for (const QString& func : m_functions) {
+        if (func.contains(text, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void PinWidget::setHighlight(bool highlight, bool blinkState)
 {
     m_isHighlighted = highlight;
@@ -45,6 +45,14 @@ public:
      */
     QStringList getSupportedFunctions() const;
 
+    /**
+     * @brief 检查引脚是否匹配搜索文本（不区分大小写）
+     * @param position 引脚在封装上的位置，如"12"或"A2"
+     * @param text 搜索文本，匹配位置、显示名称或支持的功能
+     * @return 是否匹配
+     */
+    bool matchesSearch(const QString& position, const QString& text) const;
+
     /**
      * @brief 设置引脚是否闪烁高亮
      * @param highlight 是否高亮
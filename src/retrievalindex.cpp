@@ -0,0 +1,198 @@
+#include "retrievalindex.h"
+#include <algorithm>
+#include <cmath>
+
+// 片段长度上限（字符）
+static constexpr int kChunkChars = 800;
+// BM25 参数
+static constexpr double kK1 = 1.2;
+static constexpr double kB = 0.75;
+
+static bool isMarkdownHeading(const QString& line)
+{
+    int level = 0;
+    while (level < line.size() && line.at(level) == '#') {
+        ++level;
+    }
+    return level >= 1 && level <= 6 && level < line.size() && line.at(level) == ' ';
+}
+
+static bool isHan(QChar ch)
+{
+    return ch.script() == QChar::Script_Han;
+}
+
+RetrievalIndex::RetrievalIndex()
+    : m_totalLength(0)
+{
+}
+
+void RetrievalIndex::addDocument(const QString& source, const QString& text, bool markdown)
+{
+    QString heading;
+    QString current;
+    bool inFence = false;
+
+    auto flush = [&]() {
+        const QString body = current.trimmed();
+        if (!body.isEmpty()) {
+            addChunk(source, heading.isEmpty() || body.startsWith(heading) ? body : heading + "\n" + body);
+        }
+        current.clear();
+    };
+
+    const QStringList lines = text.split('\n');
+    for (const QString& line : lines) {
+        const QString trimmed = line.trimmed();
+
+        if (markdown && (trimmed.startsWith("```") || trimmed.startsWith("~~~"))) {
+            inFence = !inFence;
+        } else if (markdown && !inFence && isMarkdownHeading(trimmed)) {
+            flush();
+            heading = trimmed;
+            current = trimmed + '\n';
+            continue;
+        }
+
+        if (trimmed.isEmpty() && !inFence) {
+            // 段落边界：片段已足够长时在此处切开
+            if (current.size() >= kChunkChars / 2) {
+                flush();
+            } else if (!current.isEmpty()) {
+                current += '\n';
+            }
+            continue;
+        }
+
+        if (current.size() + line.size() > kChunkChars) {
+            flush();
+        }
+        current += line + '\n';
+    }
+    flush();
+}
+
+void RetrievalIndex::addChunk(const QString& source, const QString& text)
+{
+    const QStringList tokens = tokenize(text);
+    if (tokens.isEmpty()) {
+        return;
+    }
+
+    QHash<QString, int> termFrequency;
+    for (const QString& token : tokens) {
+        ++termFrequency[token];
+    }
+
+    const int chunk = m_chunks.size();
+    for (auto it = termFrequency.constBegin(); it != termFrequency.constEnd(); ++it) {
+        m_postings[it.key()].append(qMakePair(chunk, it.value()));
+    }
+    m_chunks.append({source, text, int(tokens.size())});
+    m_totalLength += tokens.size();
+}
+
+QList<RetrievalHit> RetrievalIndex::search(const QString& query, int topK) const
+{
+    QList<RetrievalHit> hits;
+    if (m_chunks.isEmpty() || topK <= 0) {
+        return hits;
+    }
+
+    QStringList terms = tokenize(query);
+    terms.removeDuplicates();
+
+    const double chunkCount = m_chunks.size();
+    const double averageLength = m_totalLength / chunkCount;
+
+    QHash<int, double> scores;
+    for (const QString& term : terms) {
+        auto postings = m_postings.constFind(term);
+        if (postings == m_postings.constEnd()) {
+            continue;
+        }
+        const double df = postings->size();
+        const double idf = std::log(1.0 + (chunkCount - df + 0.5) / (df + 0.5));
+        for (const QPair<int, int>& posting : *postings) {
+            const double tf = posting.second;
+            const double norm = kK1 * (1.0 - kB + kB * m_chunks[posting.first].length / averageLength);
+            scores[posting.first] += idf * tf * (kK1 + 1.0) / (tf + norm);
+        }
+    }
+
+    QList<QPair<double, int>> ranked;
+    ranked.reserve(scores.size());
+    for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) {
+        ranked.append(qMakePair(it.value(), it.key()));
+    }
+
+    const int count = qMin(topK, int(ranked.size()));
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(),
+                      [](const QPair<double, int>& a, const QPair<double, int>& b) {
+                          return a.first > b.first || (a.first == b.first && a.second < b.second);
+                      });
+
+    for (int i = 0; i < count; ++i) {
+        const Chunk& chunk = m_chunks[ranked[i].second];
+        hits.append({chunk.source, chunk.text, ranked[i].first});
+    }
+    return hits;
+}
+
+int RetrievalIndex::chunkCount() const
+{
+    return m_chunks.size();
+}
+
+QStringList RetrievalIndex::tokenize(const QString& text)
+{
+    QStringList tokens;
+    QString word;
+    QChar previousHan;
+    int hanRun = 0;
+
+    auto flushWord = [&]() {
+        if (word.size() >= 2) {
+            tokens.append(word);
+            if (word.contains('_')) {
+                const QStringList parts = word.split('_', Qt::SkipEmptyParts);
+                for (const QString& part : parts) {
+                    if (part.size() >= 2 && part.size() < word.size()) {
+                        tokens.append(part);
+                    }
+                }
+            }
+        }
+        word.clear();
+    };
+    // 单个汉字不成二元词时按单字记录
+    auto endHanRun = [&]() {
+        if (hanRun == 1) {
+            tokens.append(QString(previousHan));
+        }
+        hanRun = 0;
+        previousHan = QChar();
+    };
+
+    for (const QChar ch : text) {
+        if (ch.unicode() < 128 && (ch.isLetterOrNumber() || ch == '_')) {
+            endHanRun();
+            word += ch.toLower();
+            continue;
+        }
+        flushWord();
+
+        if (isHan(ch)) {
+            if (hanRun > 0) {
+                tokens.append(QString(previousHan) + ch);
+            }
+            previousHan = ch;
+            ++hanRun;
+        } else {
+            endHanRun();
+        }
+    }
+    flushWord();
+    endHanRun();
+    return tokens;
+}
@@ -0,0 +1,45 @@
+#ifndef RETRIEVALINDEX_H
+#define RETRIEVALINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+struct RetrievalHit {
+    QString source;     // 片段来源（文档名）
+    QString text;       // 片段原文
+    double score = 0.0;
+};
+
+// 离线 BM25 检索索引
+// 文档按段落切成不超过约800字符的片段；英文/标识符按单词、中文按相邻两字切词，
+// 带下划线的标识符（如 CONFIG_SPI_NOR）同时按各段切词
+class RetrievalIndex
+{
+public:
+    RetrievalIndex();
+
+    // markdown 为 true 时以标题分段，并把所属标题附在片段开头
+    void addDocument(const QString& source, const QString& text, bool markdown);
+    QList<RetrievalHit> search(const QString& query, int topK) const;
+    int chunkCount() const;
+
+    static QStringList tokenize(const QString& text);
+
+private:
+    struct Chunk {
+        QString source;
+        QString text;
+        int length;     // 词数
+    };
+
+    void addChunk(const QString& source, const QString& text);
+
+    QList<Chunk> m_chunks;
+    QHash<QString, QList<QPair<int, int>>> m_postings;   // 词 -> (片段序号, 词频)
+    qint64 m_totalLength;
+};
+
+#endif // RETRIEVALINDEX_H
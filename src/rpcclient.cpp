@@ -0,0 +1,91 @@
+#include "rpcclient.h"
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QDebug>
+
+RpcClient::RpcClient(QObject *parent)
+    : QObject(parent)
+    , m_socket(new QLocalSocket(this))
+    , m_nextId(1)
+{
+    connect(m_socket, &QLocalSocket::connected, this, &RpcClient::connected);
+    connect(m_socket, &QLocalSocket::readyRead, this, &RpcClient::onReadyRead);
+    // 连接断开和连接失败都会回到未连接状态，只在这里通知一次
+    connect(m_socket, &QLocalSocket::stateChanged, this, [this](QLocalSocket::LocalSocketState state) {
+        if (state == QLocalSocket::UnconnectedState) {
+            m_buffer.clear();
+            m_pending.clear();
+            emit disconnected();
+        }
+    });
+    connect(m_socket, &QLocalSocket::errorOccurred, this, [this](QLocalSocket::LocalSocketError) {
+        qDebug() << "连接本地RPC服务失败：" << m_socket->errorString();
+    });
+}
+
+void RpcClient::connectToServer(const QString &name)
+{
+    if (m_socket->state() != QLocalSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+    m_socket->connectToServer(name);
+}
+
+void RpcClient::disconnectFromServer()
+{
+    m_socket->disconnectFromServer();
+}
+
+bool RpcClient::isConnected() const
+{
+    return m_socket->state() == QLocalSocket::ConnectedState;
+}
+
+void RpcClient::call(const QString &method, const QJsonObject &params, const Callback &callback)
+{
+    if (!isConnected()) {
+        return;
+    }
+
+    QJsonObject request;
+    request["jsonrpc"] = "2.0";
+    request["method"] = method;
+    request["params"] = params;
+    if (callback) {
+        const qint64 id = m_nextId++;
+        request["id"] = id;
+        m_pending.insert(id, callback);
+    }
+
+    QByteArray data = QJsonDocument(request).toJson(QJsonDocument::Compact);
+    data.append('\n');
+    m_socket->write(data);
+}
+
+void RpcClient::onReadyRead()
+{
+    m_buffer.append(m_socket->readAll());
+
+    int newline;
+    while ((newline = m_buffer.indexOf('\n')) >= 0) {
+        const QByteArray line = m_buffer.left(newline);
+        m_buffer.remove(0, newline + 1);
+
+        const QJsonObject message = QJsonDocument::fromJson(line).object();
+        if (message.isEmpty()) {
+            continue;
+        }
+
+        // 没有 id 的是服务端推送的通知
+        if (!message.contains("id")) {
+            emit notificationReceived(message.value("method").toString(), message.value("params").toObject());
+            continue;
+        }
+
+        const qint64 id = message.value("id").toInteger();
+        Callback callback = m_pending.take(id);
+        if (callback) {
+            callback(message.value("result").toObject(), message.value("error").toObject());
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef RPCCLIENT_H
+#define RPCCLIENT_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <functional>
+
+class QLocalSocket;
+
+// 连接 RpcServer 的客户端（界面作为守护进程的一个客户端使用）
+class RpcClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void(const QJsonObject& result, const QJsonObject& error)>;
+
+    explicit RpcClient(QObject *parent = nullptr);
+
+    // 非阻塞连接，结果通过 connected()/disconnected() 通知
+    void connectToServer(const QString &name);
+    void disconnectFromServer();
+    bool isConnected() const;
+
+    // callback 为空时只发送不关心结果
+    void call(const QString &method, const QJsonObject &params = QJsonObject(), const Callback &callback = Callback());
+
+signals:
+    void connected();
+    void disconnected();
+    void notificationReceived(const QString &event, const QJsonObject &params);
+
+private slots:
+    void onReadyRead();
+
+private:
+    QLocalSocket *m_socket;
+    QByteArray m_buffer;
+    qint64 m_nextId;
+    QHash<qint64, Callback> m_pending;
+};
+
+#endif // RPCCLIENT_H
@@ -0,0 +1,215 @@
+#include "rpcserver.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// JSON-RPC 2.0 错误码
+static const int kParseError = -32700;
+static const int kInvalidRequest = -32600;
+static const int kMethodNotFound = -32601;
+static const int kInvalidParams = -32602;
+static const int kHandlerError = -32000;
+
+RpcServer::RpcServer(const AIToolBridge *methods, QObject *parent)
+    : QObject(parent)
+    , m_methods(methods)
+    , m_server(new QLocalServer(this))
+{
+    // 套接字只允许当前用户访问
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &RpcServer::onNewConnection);
+}
+
+bool RpcServer::listen(const QString &name)
+{
+    // 先确认没有其他实例在服务，再清理上次异常退出留下的套接字文件
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(100)) {
+        probe.disconnectFromServer();
+        qDebug() << "本地RPC服务已在运行：" << name;
+        return false;
+    }
+    QLocalServer::removeServer(name);
+
+    if (!m_server->listen(name)) {
+        qDebug() << "本地RPC服务启动失败：" << m_server->errorString();
+        return false;
+    }
+    qDebug() << "本地RPC服务已启动：" << m_server->fullServerName();
+    return true;
+}
+
+bool RpcServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+QString RpcServer::serverName() const
+{
+    return m_server->fullServerName();
+}
+
+QString RpcServer::errorString() const
+{
+    return m_server->errorString();
+}
+
+QString RpcServer::defaultSocketName()
+{
+    QString user = qEnvironmentVariable("USER");
+    if (user.isEmpty()) {
+        user = qEnvironmentVariable("USERNAME");
+    }
+    return user.isEmpty() ? QString("cvicubemx") : QString("cvicubemx-%1").arg(user);
+}
+
+void RpcServer::notify(const QString &event, const QJsonObject &params)
+{
+    if (m_subscribers.isEmpty()) {
+        return;
+    }
+    QJsonObject message;
+    message["jsonrpc"] = "2.0";
+    message["method"] = event;
+    message["params"] = params;
+    for (QLocalSocket *socket : std::as_const(m_subscribers)) {
+        writeMessage(socket, message);
+    }
+}
+
+void RpcServer::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QLocalSocket::readyRead, this, &RpcServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &RpcServer::onDisconnected);
+        emit clientCountChanged(m_buffers.size());
+    }
+}
+
+void RpcServer::onReadyRead()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket || !m_buffers.contains(socket)) {
+        return;
+    }
+
+    QByteArray &buffer = m_buffers[socket];
+    buffer.append(socket->readAll());
+
+    int newline;
+    while ((newline = buffer.indexOf('\n')) >= 0) {
+        const QByteArray line = buffer.left(newline).trimmed();
+        buffer.remove(0, newline + 1);
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        bool isNotification = false;
+        const QJsonObject response = handleRequest(socket, line, isNotification);
+        if (!isNotification) {
+            writeMessage(socket, response);
+        }
+    }
+
+    // 没有换行的超长数据视为错误的客户端
+    if (buffer.size() > kMaxRequestBytes) {
+        writeMessage(socket, errorResponse(QJsonValue(), kInvalidRequest, "请求过长"));
+        socket->disconnectFromServer();
+    }
+}
+
+void RpcServer::onDisconnected()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+    m_buffers.remove(socket);
+    m_subscribers.remove(socket);
+    socket->deleteLater();
+    emit clientCountChanged(m_buffers.size());
+}
+
+QJsonObject RpcServer::handleRequest(QLocalSocket *socket, const QByteArray &line, bool &isNotification)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        return errorResponse(QJsonValue(), kParseError, parseError.errorString());
+    }
+    if (!doc.isObject()) {
+        return errorResponse(QJsonValue(), kInvalidRequest, "请求必须是JSON对象");
+    }
+
+    const QJsonObject request = doc.object();
+    const QJsonValue id = request.value("id");
+    const QString method = request.value("method").toString();
+    isNotification = !request.contains("id");
+    if (method.isEmpty()) {
+        return errorResponse(id, kInvalidRequest, "缺少 method");
+    }
+
+    const QJsonValue paramsValue = request.value("params");
+    if (!paramsValue.isUndefined() && !paramsValue.isNull() && !paramsValue.isObject()) {
+        return errorResponse(id, kInvalidParams, "params 必须是对象");
+    }
+    const QJsonObject params = paramsValue.toObject();
+
+    QJsonObject result;
+    if (method == "rpc.ping") {
+        result["pong"] = true;
+    } else if (method == "rpc.discover") {
+        result["methods"] = m_methods->toolDefinitions();
+    } else if (method == "rpc.subscribe") {
+        m_subscribers.insert(socket);
+        result["subscribed"] = true;
+    } else if (m_methods->hasTool(method)) {
+        QElapsedTimer timer;
+        timer.start();
+        result = m_methods->invoke(method, params);
+        const qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+        if (elapsedUs > 1000) {
+            qDebug() << "RPC调用较慢:" << method << "耗时(us):" << elapsedUs;
+        }
+        if (result.contains("error")) {
+            return errorResponse(id, kHandlerError, result.value("error").toString(), result);
+        }
+    } else {
+        return errorResponse(id, kMethodNotFound, QString("未知方法: %1").arg(method));
+    }
+
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = id;
+    response["result"] = result;
+    return response;
+}
+
+QJsonObject RpcServer::errorResponse(const QJsonValue &id, int code, const QString &message, const QJsonValue &data)
+{
+    QJsonObject error;
+    error["code"] = code;
+    error["message"] = message;
+    if (!data.isUndefined() && !data.isNull()) {
+        error["data"] = data;
+    }
+
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = id.isUndefined() ? QJsonValue() : id;
+    response["error"] = error;
+    return response;
+}
+
+void RpcServer::writeMessage(QLocalSocket *socket, const QJsonObject &message)
+{
+    QByteArray data = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    data.append('\n');
+    socket->write(data);
+    socket->flush();
+}
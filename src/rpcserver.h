@@ -0,0 +1,63 @@
+#ifndef RPCSERVER_H
+#define RPCSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QJsonObject>
+#include <QJsonValue>
+#include "aitoolbridge.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+// 本地套接字上的 JSON-RPC 2.0 服务，每行一个请求/响应（换行分隔的JSON）
+// 方法表使用 AIToolBridge，与AI助手的工具共用同一套处理函数；处理函数返回的对象中
+// 含有 error 字段时作为 JSON-RPC 错误返回
+//
+// 内置方法：
+//   rpc.discover   列出全部方法及参数 schema
+//   rpc.subscribe  订阅变化通知，之后服务端推送 {"method": "<事件>", "params": {...}}
+//   rpc.ping       连通性检查
+class RpcServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RpcServer(const AIToolBridge *methods, QObject *parent = nullptr);
+
+    // 同名服务已在运行时返回false；残留的套接字文件会被清理
+    bool listen(const QString &name = defaultSocketName());
+    bool isListening() const;
+    QString serverName() const;
+    QString errorString() const;
+
+    // 向所有订阅者推送通知
+    void notify(const QString &event, const QJsonObject &params = QJsonObject());
+
+    // 按用户区分，避免多个用户共用一台机器时互相连接
+    static QString defaultSocketName();
+
+    static constexpr int kMaxRequestBytes = 1024 * 1024;
+
+signals:
+    void clientCountChanged(int count);
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    QJsonObject handleRequest(QLocalSocket *socket, const QByteArray &line, bool &isNotification);
+    static QJsonObject errorResponse(const QJsonValue &id, int code, const QString &message,
+                                     const QJsonValue &data = QJsonValue());
+    static void writeMessage(QLocalSocket *socket, const QJsonObject &message);
+
+    const AIToolBridge *m_methods;
+    QLocalServer *m_server;
+    QHash<QLocalSocket*, QByteArray> m_buffers;
+    QSet<QLocalSocket*> m_subscribers;
+};
+
+#endif // RPCSERVER_H
@@ -0,0 +1,412 @@
+#include "sdkindexer.h"
+#include "artifactcache.h"
+#include "fileioservice.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QVector>
+#include <QDebug>
+
+static const QString kFamilyDir = "build/boards/cv184x";
+static const QString kBaseDtsDir = "build/boards/default/dts/cv184x";
+
+static constexpr quint32 kCatalogMagic = 0x43565349;     // "CVSI"
+static constexpr quint32 kCatalogVersion = 1;
+
+static qint64 modifiedMs(const QFileInfo& info)
+{
+    return info.lastModified().toMSecsSinceEpoch();
+}
+
+QStringList SdkBoard::missingArtifacts() const
+{
+    QStringList missing;
+    if (boardDefconfig.isEmpty()) {
+        missing << QString("%1_defconfig").arg(name);
+    }
+    if (linuxDefconfig.isEmpty()) {
+        missing << QString("linux/cvitek_%1_defconfig").arg(name);
+    }
+    if (boardInit.isEmpty()) {
+        missing << "u-boot/cvi_board_init.c";
+    }
+    return missing;
+}
+
+QStringList SdkCatalog::chips() const
+{
+    QStringList result;
+    for (const SdkBoard& board : boards) {
+        if (!result.contains(board.chip)) {
+            result.append(board.chip);
+        }
+    }
+    return result;
+}
+
+const SdkBoard* SdkCatalog::findBoard(const QString& name) const
+{
+    auto it = boards.constFind(name);
+    return it != boards.constEnd() ? &it.value() : nullptr;
+}
+
+QString SdkCatalog::absolutePath(const QString& relativePath) const
+{
+    return relativePath.isEmpty() ? QString() : QDir(rootPath).absoluteFilePath(relativePath);
+}
+
+QStringList SdkCatalog::defaultBoardNames()
+{
+    return {
+        "cv1840cp_wevb_0015a_spinor",
+        "cv1841cp_wevb_0015a_emmc",
+        "cv1841cp_wevb_0015a_spinand",
+        "cv1841cp_wevb_0015a_spinor",
+        "cv1842cp_wevb_0015a_spinand",
+        "cv1842cp_wevb_0015a_spinor",
+        "cv1842hp_wevb_0014a_emmc",
+        "cv1842hp_wevb_0014a_spinand",
+        "cv1842hp_wevb_0014a_spinor",
+        "cv1843hp_wevb_0014a_emmc",
+        "cv1843hp_wevb_0014a_spinand",
+        "cv1843hp_wevb_0014a_spinor"
+    };
+}
+
+QDataStream& operator<<(QDataStream& out, const SdkBoard& board)
+{
+    out << board.name << board.chip << board.boardDefconfig << board.linuxDefconfig
+        << board.boardInit << board.dtsFiles << board.dirStamps;
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, SdkBoard& board)
+{
+    in >> board.name >> board.chip >> board.boardDefconfig >> board.linuxDefconfig
+       >> board.boardInit >> board.dtsFiles >> board.dirStamps;
+    return in;
+}
+
+QDataStream& operator<<(QDataStream& out, const SdkCatalog& catalog)
+{
+    out << catalog.rootPath << catalog.hasFamilyDir << catalog.hasBaseDtsDir
+        << catalog.baseDtsFiles << static_cast<quint32>(catalog.boards.size());
+    for (const SdkBoard& board : catalog.boards) {
+        out << board;
+    }
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, SdkCatalog& catalog)
+{
+    quint32 count = 0;
+    in >> catalog.rootPath >> catalog.hasFamilyDir >> catalog.hasBaseDtsDir
+       >> catalog.baseDtsFiles >> count;
+    catalog.boards.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        SdkBoard board;
+        in >> board;
+        catalog.boards.insert(board.name, board);
+    }
+    return in;
+}
+
+SdkIndexer::SdkIndexer(QObject *parent)
+    : QObject(parent)
+    , m_watcher(nullptr)
+    , m_refreshTimer(nullptr)
+    , m_generation(0)
+    , m_scanning(false)
+    , m_rescanPending(false)
+{
+    m_scanPool.setMaxThreadCount(1);
+
+    m_watcher = new QFileSystemWatcher(this);
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(500);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_refreshTimer, qOverload<>(&QTimer::start));
+    connect(m_refreshTimer, &QTimer::timeout, this, &SdkIndexer::refresh);
+}
+
+SdkIndexer::~SdkIndexer()
+{
+    m_scanPool.waitForDone();
+}
+
+void SdkIndexer::setRootPath(const QString& rootPath)
+{
+    QString root = QDir::cleanPath(rootPath);
+    if (root == m_catalog.rootPath) {
+        return;
+    }
+
+    ++m_generation;
+    m_catalog = SdkCatalog();
+    if (!loadCatalog(root, m_catalog)) {
+        m_catalog = SdkCatalog();
+        m_catalog.rootPath = root;
+    }
+
+    updateWatches();
+    emit catalogChanged();
+    refresh();
+}
+
+QString SdkIndexer::rootPath() const
+{
+    return m_catalog.rootPath;
+}
+
+const SdkCatalog& SdkIndexer::catalog() const
+{
+    return m_catalog;
+}
+
+bool SdkIndexer::isScanning() const
+{
+    return m_scanning;
+}
+
+bool SdkIndexer::loadCatalog(const QString& rootPath, SdkCatalog& catalog)
+{
+    QFile file(persistPath(rootPath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    SdkCatalog loaded;
+    in >> magic >> version;
+    if (magic != kCatalogMagic || version != kCatalogVersion) {
+        return false;
+    }
+    in >> loaded;
+    if (in.status() != QDataStream::Ok || loaded.rootPath != QDir::cleanPath(rootPath)) {
+        return false;
+    }
+
+    catalog = loaded;
+    return true;
+}
+
+bool SdkIndexer::looksLikeSdk(const QString& rootPath)
+{
+    QDir dir(rootPath);
+
+    // 检查必要的目录结构
+    if (!dir.exists("build")) {
+        qDebug() << "缺少目录：" << "build";
+        return false;
+    }
+
+    // 检查关键路径是否存在
+    for (const QString& criticalPath : {kFamilyDir, kBaseDtsDir}) {
+        if (!dir.exists(criticalPath)) {
+            qDebug() << "缺少关键路径：" << criticalPath;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SdkIndexer::refresh()
+{
+    if (m_catalog.rootPath.isEmpty()) {
+        return;
+    }
+    if (m_scanning) {
+        m_rescanPending = true;
+        return;
+    }
+
+    m_scanning = true;
+    m_rescanPending = false;
+
+    const quint64 generation = m_generation;
+    const SdkCatalog previous = m_catalog;
+    m_scanPool.start([this, previous, generation]() {
+        SdkCatalog catalog = scan(previous.rootPath, previous);
+        QMetaObject::invokeMethod(this, [this, catalog, generation]() {
+            applyCatalog(catalog, generation);
+        }, Qt::QueuedConnection);
+    });
+}
+
+SdkCatalog SdkIndexer::scan(const QString& rootPath, const SdkCatalog& previous)
+{
+    SdkCatalog catalog;
+    catalog.rootPath = rootPath;
+
+    QDir root(rootPath);
+    const QString familyDir = root.absoluteFilePath(kFamilyDir);
+    const QString baseDtsDir = root.absoluteFilePath(kBaseDtsDir);
+    catalog.hasFamilyDir = QFileInfo(familyDir).isDir();
+    catalog.hasBaseDtsDir = QFileInfo(baseDtsDir).isDir();
+
+    if (catalog.hasBaseDtsDir) {
+        const QStringList dtsNames = QDir(baseDtsDir).entryList({"*.dts", "*.dtsi"}, QDir::Files, QDir::Name);
+        for (const QString& name : dtsNames) {
+            catalog.baseDtsFiles.append(QString("%1/%2").arg(kBaseDtsDir, name));
+        }
+    }
+    if (!catalog.hasFamilyDir) {
+        return catalog;
+    }
+
+    // 每个板子目录由线程池独立扫描，目录修改时间未变的直接复用上次结果
+    const QStringList boardNames = QDir(familyDir).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    QVector<SdkBoard> boards(boardNames.size());
+    SdkBoard *results = boards.data();
+
+    QThreadPool boardPool;
+    for (int i = 0; i < boardNames.size(); ++i) {
+        const QString name = boardNames[i];
+        const SdkBoard *cached = previous.rootPath == rootPath ? previous.findBoard(name) : nullptr;
+        const SdkBoard cachedBoard = cached ? *cached : SdkBoard();
+        const bool hasCached = cached != nullptr;
+
+        boardPool.start([results, i, rootPath, name, cachedBoard, hasCached]() {
+            if (hasCached && boardUnchanged(cachedBoard, rootPath)) {
+                results[i] = cachedBoard;
+            } else {
+                results[i] = scanBoard(rootPath, name);
+            }
+        });
+    }
+    boardPool.waitForDone();
+
+    for (const SdkBoard& board : boards) {
+        catalog.boards.insert(board.name, board);
+    }
+    return catalog;
+}
+
+SdkBoard SdkIndexer::scanBoard(const QString& rootPath, const QString& name)
+{
+    SdkBoard board;
+    board.name = name;
+    board.chip = name.section('_', 0, 0);
+
+    const QString boardRel = QString("%1/%2").arg(kFamilyDir, name);
+    const QDir boardDir(QDir(rootPath).absoluteFilePath(boardRel));
+    board.dirStamps.insert(boardRel, modifiedMs(QFileInfo(boardDir.absolutePath())));
+
+    const QString defconfigName = QString("%1_defconfig").arg(name);
+    const QString linuxDefconfigName = QString("cvitek_%1_defconfig").arg(name);
+
+    QDirIterator it(boardDir.absolutePath(), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QString rel = boardRel + '/' + boardDir.relativeFilePath(info.absoluteFilePath());
+
+        if (info.isDir()) {
+            board.dirStamps.insert(rel, modifiedMs(info));
+            continue;
+        }
+
+        const QString fileName = info.fileName();
+        if (fileName == defconfigName) {
+            board.boardDefconfig = rel;
+        } else if (fileName == linuxDefconfigName) {
+            board.linuxDefconfig = rel;
+        } else if (fileName == "cvi_board_init.c") {
+            // 多处存在时优先 u-boot/ 下的文件
+            if (board.boardInit.isEmpty() || rel.contains("/u-boot/")) {
+                board.boardInit = rel;
+            }
+        } else if (info.suffix() == "dts" || info.suffix() == "dtsi") {
+            board.dtsFiles.append(rel);
+        }
+    }
+
+    board.dtsFiles.sort();
+    return board;
+}
+
+bool SdkIndexer::boardUnchanged(const SdkBoard& board, const QString& rootPath)
+{
+    // 增删文件会改变所在目录的修改时间
+    QDir root(rootPath);
+    for (auto it = board.dirStamps.constBegin(); it != board.dirStamps.constEnd(); ++it) {
+        QFileInfo info(root.absoluteFilePath(it.key()));
+        if (!info.isDir() || modifiedMs(info) != it.value()) {
+            return false;
+        }
+    }
+    return !board.dirStamps.isEmpty();
+}
+
+QString SdkIndexer::persistPath(const QString& rootPath)
+{
+    QByteArray key = QDir::cleanPath(rootPath).toUtf8();
+    return QDir(ArtifactCache::cacheDirectory()).absoluteFilePath(
+        QString("sdk-catalog-%1.bin").arg(ArtifactCache::hash64(key.constData(), key.size()), 16, 16, QChar('0')));
+}
+
+void SdkIndexer::applyCatalog(const SdkCatalog& catalog, quint64 generation)
+{
+    m_scanning = false;
+
+    // 扫描期间切换了根目录，结果作废
+    if (generation == m_generation) {
+        m_catalog = catalog;
+        updateWatches();
+        persist();
+        emit catalogChanged();
+    }
+
+    if (m_rescanPending) {
+        refresh();
+    }
+}
+
+void SdkIndexer::updateWatches()
+{
+    const QStringList watched = m_watcher->directories();
+    if (!watched.isEmpty()) {
+        m_watcher->removePaths(watched);
+    }
+    if (m_catalog.rootPath.isEmpty()) {
+        return;
+    }
+
+    QDir root(m_catalog.rootPath);
+    QStringList paths;
+    if (m_catalog.hasFamilyDir) {
+        paths << root.absoluteFilePath(kFamilyDir);
+    }
+    if (m_catalog.hasBaseDtsDir) {
+        paths << root.absoluteFilePath(kBaseDtsDir);
+    }
+    for (const SdkBoard& board : m_catalog.boards) {
+        for (auto it = board.dirStamps.constBegin(); it != board.dirStamps.constEnd(); ++it) {
+            paths << root.absoluteFilePath(it.key());
+        }
+    }
+
+    if (!paths.isEmpty()) {
+        m_watcher->addPaths(paths);
+    }
+}
+
+void SdkIndexer::persist()
+{
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << kCatalogMagic << kCatalogVersion << m_catalog;
+    }
+    FileIoService::instance()->writeData(persistPath(m_catalog.rootPath), data, "SDK目录索引");
+}
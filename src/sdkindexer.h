@@ -0,0 +1,96 @@
+#ifndef SDKINDEXER_H
+#define SDKINDEXER_H
+
+#include <QObject>
+#include <QMap>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QDataStream>
+#include <QFileSystemWatcher>
+#include <QThreadPool>
+#include <QTimer>
+
+// SDK中的一个板级目录 build/boards/cv184x/<board>/，路径均相对SDK根目录
+struct SdkBoard {
+    QString name;               // 如 cv1842hp_wevb_0014a_emmc
+    QString chip;               // 板名第一段，如 cv1842hp
+    QString boardDefconfig;     // <board>_defconfig
+    QString linuxDefconfig;     // linux/cvitek_<board>_defconfig
+    QString boardInit;          // u-boot/cvi_board_init.c
+    QStringList dtsFiles;       // 板级目录下的 .dts/.dtsi
+    QHash<QString, qint64> dirStamps;   // 扫描过的目录 -> 修改时间，刷新时未变化的板子直接复用
+
+    QStringList missingArtifacts() const;
+};
+
+struct SdkCatalog {
+    QString rootPath;
+    QMap<QString, SdkBoard> boards;     // 按板名排序
+    QStringList baseDtsFiles;           // build/boards/default/dts/cv184x/ 下的 .dts/.dtsi
+    bool hasFamilyDir = false;
+    bool hasBaseDtsDir = false;
+
+    bool isValidSdk() const { return hasFamilyDir && hasBaseDtsDir; }
+    QStringList boardNames() const { return boards.keys(); }
+    QStringList chips() const;
+    const SdkBoard* findBoard(const QString& name) const;
+    QString absolutePath(const QString& relativePath) const;
+
+    // SDK尚未索引完成时的后备板名列表
+    static QStringList defaultBoardNames();
+};
+
+QDataStream& operator<<(QDataStream& out, const SdkBoard& board);
+QDataStream& operator>>(QDataStream& in, SdkBoard& board);
+QDataStream& operator<<(QDataStream& out, const SdkCatalog& catalog);
+QDataStream& operator>>(QDataStream& in, SdkCatalog& catalog);
+
+// SDK源码树索引：后台并行扫描 build/boards/，目录索引保存到用户缓存目录，下次启动直接可用；
+// 之后由 QFileSystemWatcher 触发刷新，只重新扫描目录修改时间有变化的板子
+class SdkIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SdkIndexer(QObject *parent = nullptr);
+    ~SdkIndexer() override;
+
+    // 切换SDK根目录：立即载入上次保存的目录索引，并在后台校验刷新
+    void setRootPath(const QString& rootPath);
+    QString rootPath() const;
+
+    const SdkCatalog& catalog() const;
+    bool isScanning() const;
+
+    // 读取保存的目录索引（不扫描SDK）
+    static bool loadCatalog(const QString& rootPath, SdkCatalog& catalog);
+    // 只检查关键目录是否存在
+    static bool looksLikeSdk(const QString& rootPath);
+
+public slots:
+    void refresh();
+
+signals:
+    void catalogChanged();
+
+private:
+    static SdkCatalog scan(const QString& rootPath, const SdkCatalog& previous);
+    static SdkBoard scanBoard(const QString& rootPath, const QString& name);
+    static bool boardUnchanged(const SdkBoard& board, const QString& rootPath);
+    static QString persistPath(const QString& rootPath);
+
+    void applyCatalog(const SdkCatalog& catalog, quint64 generation);
+    void updateWatches();
+    void persist();
+
+    SdkCatalog m_catalog;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_refreshTimer;     // 合并短时间内的多次目录变化
+    QThreadPool m_scanPool;     // 扫描协调线程，析构时等待其结束
+    quint64 m_generation;       // 切换根目录后丢弃过期的扫描结果
+    bool m_scanning;
+    bool m_rescanPending;
+};
+
+#endif // SDKINDEXER_H
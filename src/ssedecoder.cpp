@@ -0,0 +1,202 @@
+#include "ssedecoder.h"
+#include <cstring>
+
+SseDecoder::SseDecoder()
+    : m_hasData(false)
+{
+}
+
+QList<SseEvent> SseDecoder::feed(const QByteArray& bytes)
+{
+    QList<SseEvent> events;
+    m_buffer.append(bytes);
+
+    // 行以 "\n" 或 "\r\n" 结束（OpenAI兼容接口不使用单独的 "\r"）
+    const char *data = m_buffer.constData();
+    int lineStart = 0;
+    int newline;
+    while ((newline = m_buffer.indexOf('\n', lineStart)) != -1) {
+        int length = newline - lineStart;
+        if (length > 0 && data[newline - 1] == '\r') {
+            --length;
+        }
+        processLine(data + lineStart, length, events);
+        lineStart = newline + 1;
+    }
+    m_buffer.remove(0, lineStart);
+    return events;
+}
+
+QList<SseEvent> SseDecoder::finish()
+{
+    QList<SseEvent> events;
+    if (!m_buffer.isEmpty()) {
+        int length = m_buffer.size();
+        if (m_buffer.endsWith('\r')) {
+            --length;
+        }
+        processLine(m_buffer.constData(), length, events);
+        m_buffer.clear();
+    }
+    dispatch(events);
+    return events;
+}
+
+void SseDecoder::reset()
+{
+    m_buffer.clear();
+    m_current = SseEvent();
+    m_hasData = false;
+}
+
+void SseDecoder::processLine(const char *line, int length, QList<SseEvent>& events)
+{
+    if (length == 0) {
+        dispatch(events);
+        return;
+    }
+    if (line[0] == ':') {
+        return;     // 注释/心跳
+    }
+
+    const char *colon = static_cast<const char *>(std::memchr(line, ':', length));
+    int fieldLength = colon ? int(colon - line) : length;
+    int valueStart = colon ? fieldLength + 1 : length;
+    if (valueStart < length && line[valueStart] == ' ') {
+        ++valueStart;
+    }
+    const char *value = line + valueStart;
+    int valueLength = length - valueStart;
+
+    auto fieldIs = [&](const char *name) {
+        return fieldLength == int(std::strlen(name)) && std::memcmp(line, name, fieldLength) == 0;
+    };
+
+    if (fieldIs("data")) {
+        if (m_hasData) {
+            m_current.data.append('\n');
+        }
+        m_current.data.append(value, valueLength);
+        m_hasData = true;
+    } else if (fieldIs("event")) {
+        m_current.event = QByteArray(value, valueLength);
+    } else if (fieldIs("id")) {
+        m_current.id = QByteArray(value, valueLength);
+    }
+}
+
+void SseDecoder::dispatch(QList<SseEvent>& events)
+{
+    if (m_hasData) {
+        events.append(m_current);
+    }
+    m_current = SseEvent();
+    m_hasData = false;
+}
+
+static int skipSpace(const char *p, int i, int n)
+{
+    while (i < n && (p[i] == ' ' || p[i] == '\t' || p[i] == '\r' || p[i] == '\n')) {
+        ++i;
+    }
+    return i;
+}
+
+// 查找作为键出现的 "name"（排除字符串内转义的 \"name\"）
+static int findKey(const QByteArray& data, const char *quotedName, int from)
+{
+    int pos = data.indexOf(quotedName, from);
+    while (pos > 0 && data.at(pos - 1) == '\\') {
+        pos = data.indexOf(quotedName, pos + 1);
+    }
+    return pos;
+}
+
+bool SseDecoder::extractDeltaContent(const QByteArray& data, QString *content)
+{
+    static const char kDeltaKey[] = "\"delta\"";
+    static const char kContentKey[] = "\"content\"";
+
+    const char *p = data.constData();
+    const int n = data.size();
+
+    int i = findKey(data, kDeltaKey, 0);
+    if (i < 0) {
+        return false;
+    }
+    i = skipSpace(p, i + int(sizeof(kDeltaKey)) - 1, n);
+    if (i >= n || p[i] != ':') {
+        return false;
+    }
+    i = skipSpace(p, i + 1, n);
+    if (i >= n || p[i] != '{') {
+        return false;
+    }
+
+    // content 必须在 delta 对象内：中间出现 '}' 时交给完整解析
+    int key = findKey(data, kContentKey, i);
+    if (key < 0 || data.indexOf('}', i) < key) {
+        return false;
+    }
+    i = skipSpace(p, key + int(sizeof(kContentKey)) - 1, n);
+    if (i >= n || p[i] != ':') {
+        return false;
+    }
+    i = skipSpace(p, i + 1, n);
+    if (n - i >= 4 && std::memcmp(p + i, "null", 4) == 0) {
+        content->clear();
+        return true;
+    }
+    if (i >= n || p[i] != '"') {
+        return false;
+    }
+
+    QString result;
+    int runStart = ++i;
+    while (i < n) {
+        const char c = p[i];
+        if (c == '"') {
+            result += QString::fromUtf8(p + runStart, i - runStart);
+            *content = result;
+            return true;
+        }
+        if (c != '\\') {
+            ++i;
+            continue;
+        }
+
+        result += QString::fromUtf8(p + runStart, i - runStart);
+        if (i + 1 >= n) {
+            return false;
+        }
+        switch (p[i + 1]) {
+        case '"':  result += QChar('"');  break;
+        case '\\': result += QChar('\\'); break;
+        case '/':  result += QChar('/');  break;
+        case 'b':  result += QChar('\b'); break;
+        case 'f':  result += QChar('\f'); break;
+        case 'n':  result += QChar('\n'); break;
+        case 'r':  result += QChar('\r'); break;
+        case 't':  result += QChar('\t'); break;
+        case 'u': {
+            if (i + 6 > n) {
+                return false;
+            }
+            bool ok = false;
+            ushort code = QByteArray::fromRawData(p + i + 2, 4).toUShort(&ok, 16);
+            if (!ok) {
+                return false;
+            }
+            // 代理对的两半各自是一个 \u 转义，按UTF-16代码单元依次追加即可
+            result += QChar(code);
+            i += 4;
+            break;
+        }
+        default:
+            return false;
+        }
+        i += 2;
+        runStart = i;
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#ifndef SSEDECODER_H
+#define SSEDECODER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// Server-Sent Events 的一条事件，data 为多行 data 字段以 '\n' 连接后的原始字节
+struct SseEvent
+{
+    QByteArray event;
+    QByteArray data;
+    QByteArray id;
+};
+
+// 按字节解析 SSE 流：不完整的行留在缓冲区，等下一块数据到达后再处理，
+// 因此跨TCP分块的行和被截断的UTF-8序列都不会丢失；事件以空行结束
+class SseDecoder
+{
+public:
+    SseDecoder();
+
+    // 追加收到的字节，返回其中已完整的事件
+    QList<SseEvent> feed(const QByteArray& bytes);
+    // 流结束：处理缓冲区中最后一行，并返回末尾缺少空行的事件
+    QList<SseEvent> finish();
+    void reset();
+
+    // 常见的 {"choices":[{"delta":{"content":"..."}}]} 形式的快速提取，不构造 QJsonDocument
+    // 形式不符时返回 false，由调用方按完整JSON解析；content 为 null 时得到空串
+    static bool extractDeltaContent(const QByteArray& data, QString *content);
+
+private:
+    void processLine(const char *line, int length, QList<SseEvent>& events);
+    void dispatch(QList<SseEvent>& events);
+
+    QByteArray m_buffer;        // 尚未处理的字节（最后一行可能不完整）
+    SseEvent m_current;         // 正在累积的事件
+    bool m_hasData;
+};
+
+#endif // SSEDECODER_H
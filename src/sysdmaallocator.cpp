@@ -0,0 +1,350 @@
+#include "sysdmaallocator.h"
+#include <QSet>
+#include <QVector>
+#include <algorithm>
+
+// 空闲通道的原映射与已分配的请求重复时使用的占位映射：CVI_AUDSRC 不对应工具管理的外设节点，不会生成 dmas 属性
+static const QString kIdleChannel = "37";
+
+// 候选外设的SYSDMA请求号，只包含 DtsConfig 能生成 dmas 属性的外设（I2S/UART/SPI）
+struct DmaCandidate {
+    QString peripheral;
+    QString rx;
+    QString tx;
+};
+
+static const QList<DmaCandidate>& dmaCandidates()
+{
+    static const QList<DmaCandidate> list = {
+        {"i2s0", "0", "1"}, {"i2s1", "2", "3"}, {"i2s2", "4", "5"}, {"i2s3", "6", "7"},
+        {"uart0", "8", "9"}, {"uart1", "10", "11"}, {"uart2", "12", "13"}, {"uart3", "14", "15"},
+        {"uart4", "40", "41"},
+        {"spi0", "16", "17"}, {"spi1", "18", "19"}, {"spi2", "20", "21"}, {"spi3", "22", "23"}
+    };
+    return list;
+}
+
+static QString formatRate(double bytesPerSec)
+{
+    if (bytesPerSec >= 1e6) {
+        return QString("%1 MB/s").arg(bytesPerSec / 1e6, 0, 'f', 2);
+    }
+    return QString("%1 KB/s").arg(bytesPerSec / 1e3, 0, 'f', 1);
+}
+
+const QStringList& SysdmaAllocator::defaultChannels()
+{
+    static const QStringList channels = {"0", "5", "2", "3", "42", "42", "4", "7"};
+    return channels;
+}
+
+QString SysdmaAllocator::channelName(const QString& channel)
+{
+    static const QMap<QString, QString> names = {
+        {"0", "CVI_I2S0_RX"}, {"1", "CVI_I2S0_TX"}, {"2", "CVI_I2S1_RX"}, {"3", "CVI_I2S1_TX"},
+        {"4", "CVI_I2S2_RX"}, {"5", "CVI_I2S2_TX"}, {"6", "CVI_I2S3_RX"}, {"7", "CVI_I2S3_TX"},
+        {"8", "CVI_UART0_RX"}, {"9", "CVI_UART0_TX"}, {"10", "CVI_UART1_RX"}, {"11", "CVI_UART1_TX"},
+        {"12", "CVI_UART2_RX"}, {"13", "CVI_UART2_TX"}, {"14", "CVI_UART3_RX"}, {"15", "CVI_UART3_TX"},
+        {"16", "CVI_SPI0_RX"}, {"17", "CVI_SPI0_TX"}, {"18", "CVI_SPI1_RX"}, {"19", "CVI_SPI1_TX"},
+        {"20", "CVI_SPI2_RX"}, {"21", "CVI_SPI2_TX"}, {"22", "CVI_SPI3_RX"}, {"23", "CVI_SPI3_TX"},
+        {"24", "CVI_I2C0_RX"}, {"25", "CVI_I2C0_TX"}, {"26", "CVI_I2C1_RX"}, {"27", "CVI_I2C1_TX"},
+        {"28", "CVI_I2C2_RX"}, {"29", "CVI_I2C2_TX"}, {"30", "CVI_I2C3_RX"}, {"31", "CVI_I2C3_TX"},
+        {"32", "CVI_I2C4_RX"}, {"33", "CVI_I2C4_TX"}, {"34", "CVI_TDM0_RX"}, {"35", "CVI_TDM0_TX"},
+        {"36", "CVI_TDM1_RX"}, {"37", "CVI_AUDSRC"}, {"38", "CVI_SPI_NOR_RX"}, {"39", "CVI_SPI_NOR_TX"},
+        {"40", "CVI_UART4_RX"}, {"41", "CVI_UART4_TX"}, {"42", "CVI_SPI_NAND"}
+    };
+    return names.value(channel, channel);
+}
+
+QString DmaAllocation::summary() const
+{
+    return QString("SYSDMA 卸载 %1 / 需求 %2")
+           .arg(formatRate(offloadedBytesPerSec), formatRate(requestedBytesPerSec));
+}
+
+QString DmaAllocation::breakdown() const
+{
+    QStringList lines;
+    for (int slot = 0; slot < channels.size(); ++slot) {
+        auto it = std::find_if(assignments.begin(), assignments.end(), [slot](const DmaAssignment& a) {
+            return a.slot == slot;
+        });
+        if (it != assignments.end()) {
+            lines << QString("通道 %1: %2 (%3 %4, %5)")
+                     .arg(slot).arg(it->channelName, it->peripheral, it->rx ? "RX" : "TX", formatRate(it->bytesPerSec));
+        } else if (reservedSlots.contains(slot)) {
+            lines << QString("通道 %1: %2 (保留)").arg(slot).arg(SysdmaAllocator::channelName(channels.value(slot)));
+        } else {
+            lines << QString("通道 %1: %2 (空闲)").arg(slot).arg(SysdmaAllocator::channelName(channels.value(slot)));
+        }
+    }
+    if (!unserved.isEmpty()) {
+        lines << QString("未分配（由CPU中断收发）: %1").arg(unserved.join(", "));
+    }
+    return lines.join("\n");
+}
+
+QList<DmaDemand> SysdmaAllocator::candidates(const QMap<QString, PeripheralInfo>& peripherals,
+                                             const QStringList& currentChannels,
+                                             const QMap<QString, double>& clocksMHz)
+{
+    // SPI实际SCK由从设备决定，这里按常见的25MHz估算，且不超过源时钟的一半
+    const double spiSourceHz = clocksMHz.value("clk_spi", 0.0) * 1e6;
+    const double spiSck = spiSourceHz > 0.0 ? std::min(SPI_TYPICAL_SCK_HZ, spiSourceHz / 2) : SPI_TYPICAL_SCK_HZ;
+
+    QList<DmaDemand> demands;
+    for (const DmaCandidate& candidate : dmaCandidates()) {
+        DmaDemand demand;
+        demand.peripheral = candidate.peripheral;
+        demand.rxChannel = candidate.rx;
+        demand.txChannel = candidate.tx;
+
+        const bool inDts = peripherals.contains(candidate.peripheral);
+        const bool dtsEnabled = inDts && peripherals.value(candidate.peripheral).status != "disabled";
+        const bool rxMapped = !candidate.rx.isEmpty() && currentChannels.contains(candidate.rx);
+        const bool txMapped = !candidate.tx.isEmpty() && currentChannels.contains(candidate.tx);
+
+        double bytesPerSec = 0.0;
+        if (candidate.peripheral.startsWith("uart")) {
+            // 8N1 每字节10位
+            const int baud = inDts ? peripherals.value(candidate.peripheral).currentSpeed : 115200;
+            bytesPerSec = baud / 10.0;
+            demand.enabled = dtsEnabled && baud >= HIGH_BAUD;
+        } else if (candidate.peripheral.startsWith("spi")) {
+            bytesPerSec = spiSck / 8.0;
+            demand.enabled = dtsEnabled;
+        } else {
+            bytesPerSec = I2S_BYTES_PER_SEC;
+            demand.enabled = rxMapped || txMapped;
+        }
+
+        demand.rxBytesPerSec = candidate.rx.isEmpty() ? 0.0 : bytesPerSec;
+        demand.txBytesPerSec = candidate.tx.isEmpty() ? 0.0 : bytesPerSec;
+        // 音频接口按当前映射只启用实际使用的方向（如只录音的I2S）
+        if (demand.enabled && candidate.peripheral.startsWith("i2s")) {
+            if (!rxMapped) demand.rxBytesPerSec = 0.0;
+            if (!txMapped) demand.txBytesPerSec = 0.0;
+        }
+        demands << demand;
+    }
+    return demands;
+}
+
+DmaAllocation SysdmaAllocator::allocate(const QList<DmaDemand>& demands, const QStringList& currentChannels)
+{
+    DmaAllocation allocation;
+
+    // 当前映射到非本工具管理请求的通道（如SPI-NAND、TDM、I2C）保持不变，不参与分配；
+    // 占位映射是工具写入的空闲标记，可以重新分配
+    QSet<QString> managedChannels;
+    for (const DmaDemand& demand : demands) {
+        if (!demand.rxChannel.isEmpty()) managedChannels.insert(demand.rxChannel);
+        if (!demand.txChannel.isEmpty()) managedChannels.insert(demand.txChannel);
+    }
+    QVector<bool> reserved(CHANNEL_COUNT, false);
+    for (int slot = 0; slot < CHANNEL_COUNT; ++slot) {
+        const QString channel = currentChannels.value(slot, defaultChannels().at(slot));
+        if (channel != kIdleChannel && !managedChannels.contains(channel)) {
+            reserved[slot] = true;
+            allocation.reservedSlots << slot;
+        }
+    }
+
+    // 拆分为单方向的需求
+    QList<DmaAssignment> items;
+    for (const DmaDemand& demand : demands) {
+        if (!demand.enabled) {
+            continue;
+        }
+        if (!demand.rxChannel.isEmpty() && demand.rxBytesPerSec > 0.0) {
+            DmaAssignment item;
+            item.channel = demand.rxChannel;
+            item.channelName = channelName(demand.rxChannel);
+            item.peripheral = demand.peripheral;
+            item.rx = true;
+            item.bytesPerSec = demand.rxBytesPerSec;
+            items << item;
+            allocation.requestedBytesPerSec += item.bytesPerSec;
+        }
+        if (!demand.txChannel.isEmpty() && demand.txBytesPerSec > 0.0) {
+            DmaAssignment item;
+            item.channel = demand.txChannel;
+            item.channelName = channelName(demand.txChannel);
+            item.peripheral = demand.peripheral;
+            item.rx = false;
+            item.bytesPerSec = demand.txBytesPerSec;
+            items << item;
+            allocation.requestedBytesPerSec += item.bytesPerSec;
+        }
+    }
+
+    // 按吞吐量从大到小贪心选取；吞吐量相同时优先保留当前已映射的通道
+    std::stable_sort(items.begin(), items.end(), [&currentChannels](const DmaAssignment& a, const DmaAssignment& b) {
+        if (a.bytesPerSec != b.bytesPerSec) {
+            return a.bytesPerSec > b.bytesPerSec;
+        }
+        return currentChannels.contains(a.channel) && !currentChannels.contains(b.channel);
+    });
+
+    int freeEven = 0, freeOdd = 0;
+    for (int slot = 0; slot < CHANNEL_COUNT; ++slot) {
+        if (!reserved[slot]) {
+            (slot % 2 == 0 ? freeEven : freeOdd)++;
+        }
+    }
+
+    // DtsConfig 只在外设仅映射一个方向时按通道奇偶判断RX/TX，两个方向都映射时按请求号区分，
+    // 因此只有单方向的外设受奇偶限制：RX放偶数通道、TX放奇数通道
+    auto pairedIn = [](const QList<DmaAssignment>& list, const DmaAssignment& item) {
+        return std::any_of(list.begin(), list.end(), [&item](const DmaAssignment& other) {
+            return other.peripheral == item.peripheral && other.rx != item.rx;
+        });
+    };
+    auto feasible = [&pairedIn, freeEven, freeOdd](const QList<DmaAssignment>& list) {
+        int singleRx = 0, singleTx = 0;
+        for (const DmaAssignment& item : list) {
+            if (!pairedIn(list, item)) {
+                (item.rx ? singleRx : singleTx)++;
+            }
+        }
+        return singleRx <= freeEven && singleTx <= freeOdd && list.size() <= freeEven + freeOdd;
+    };
+
+    QList<DmaAssignment> selected;
+    for (const DmaAssignment& item : items) {
+        selected << item;
+        if (!feasible(selected)) {
+            selected.removeLast();
+            allocation.unserved << QString("%1 %2 %3").arg(item.peripheral, item.rx ? "RX" : "TX",
+                                                          formatRate(item.bytesPerSec));
+        }
+    }
+
+    QVector<bool> used(CHANNEL_COUNT, false);
+    auto place = [&used, &allocation](DmaAssignment& item, int slot) {
+        item.slot = slot;
+        used[slot] = true;
+        allocation.assignments << item;
+        allocation.offloadedBytesPerSec += item.bytesPerSec;
+    };
+    auto isFree = [&used, &reserved](int slot) {
+        return !used[slot] && !reserved[slot];
+    };
+    QVector<bool> single(selected.size(), false);
+    int singleRx = 0, singleTx = 0;
+    for (int i = 0; i < selected.size(); ++i) {
+        single[i] = !pairedIn(selected, selected[i]);
+        if (single[i]) {
+            (selected[i].rx ? singleRx : singleTx)++;
+        }
+    }
+    auto slotMatches = [&single](int index, const DmaAssignment& item, int slot) {
+        return !single[index] || (slot % 2 == 0) == item.rx;
+    };
+    // 双向外设占用某个通道后，剩余的空闲通道仍需放得下尚未放置的单方向需求
+    auto leavesRoomForSingles = [&isFree, &singleRx, &singleTx](int slot) {
+        int even = 0, odd = 0;
+        for (int other = 0; other < CHANNEL_COUNT; ++other) {
+            if (other != slot && isFree(other)) {
+                (other % 2 == 0 ? even : odd)++;
+            }
+        }
+        return singleRx <= even && singleTx <= odd;
+    };
+    auto placeSelected = [&](int index, int slot) {
+        if (single[index]) {
+            (selected[index].rx ? singleRx : singleTx)--;
+        }
+        place(selected[index], slot);
+    };
+
+    // 1. 保留默认位置（基础设备树中已有对应的 dmas），其次保留当前位置，减少设备树改动；单方向需求优先
+    for (bool singlesOnly : {true, false}) {
+        for (const QStringList* layout : {&defaultChannels(), &currentChannels}) {
+            for (int i = 0; i < selected.size(); ++i) {
+                if (selected[i].slot >= 0 || single[i] != singlesOnly) {
+                    continue;
+                }
+                for (int slot = 0; slot < CHANNEL_COUNT && slot < layout->size(); ++slot) {
+                    if (isFree(slot) && slotMatches(i, selected[i], slot) && layout->at(slot) == selected[i].channel
+                        && (singlesOnly || leavesRoomForSingles(slot))) {
+                        placeSelected(i, slot);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // 2. 单方向需求放入奇偶匹配的空闲通道
+    for (int i = 0; i < selected.size(); ++i) {
+        if (selected[i].slot >= 0 || !single[i]) {
+            continue;
+        }
+        for (int slot = selected[i].rx ? 0 : 1; slot < CHANNEL_COUNT; slot += 2) {
+            if (isFree(slot)) {
+                placeSelected(i, slot);
+                break;
+            }
+        }
+    }
+
+    // 3. 双向外设的RX/TX尽量放在相邻的一对通道
+    for (int i = 0; i < selected.size(); ++i) {
+        if (selected[i].slot >= 0 || !selected[i].rx) {
+            continue;
+        }
+        for (int j = 0; j < selected.size(); ++j) {
+            if (selected[j].slot >= 0 || selected[j].rx || selected[j].peripheral != selected[i].peripheral) {
+                continue;
+            }
+            for (int slot = 0; slot + 1 < CHANNEL_COUNT; slot += 2) {
+                if (isFree(slot) && isFree(slot + 1)) {
+                    placeSelected(i, slot);
+                    placeSelected(j, slot + 1);
+                    break;
+                }
+            }
+            break;
+        }
+    }
+
+    // 4. 其余双向外设的通道放入任意空闲通道（选取时已保证放得下）
+    for (int i = 0; i < selected.size(); ++i) {
+        if (selected[i].slot >= 0) {
+            continue;
+        }
+        for (int slot = 0; slot < CHANNEL_COUNT; ++slot) {
+            if (isFree(slot)) {
+                placeSelected(i, slot);
+                break;
+            }
+        }
+    }
+
+    // 空闲及保留通道保持当前映射（没有时取默认映射），与已分配的请求号重复时依次改用默认映射、占位映射，
+    // 避免同一请求出现在多个通道
+    QSet<QString> assignedChannels;
+    for (const DmaAssignment& item : allocation.assignments) {
+        assignedChannels.insert(item.channel);
+    }
+    allocation.channels = defaultChannels();
+    for (int slot = 0; slot < CHANNEL_COUNT; ++slot) {
+        if (used[slot]) {
+            continue;
+        }
+        const QString previous = currentChannels.value(slot, defaultChannels().at(slot));
+        if (!assignedChannels.contains(previous)) {
+            allocation.channels[slot] = previous;
+        } else if (assignedChannels.contains(defaultChannels().at(slot))) {
+            allocation.channels[slot] = kIdleChannel;
+        }
+    }
+    for (const DmaAssignment& item : allocation.assignments) {
+        allocation.channels[item.slot] = item.channel;
+    }
+
+    std::sort(allocation.assignments.begin(), allocation.assignments.end(),
+              [](const DmaAssignment& a, const DmaAssignment& b) { return a.slot < b.slot; });
+    return allocation;
+}
@@ -0,0 +1,65 @@
+#ifndef SYSDMAALLOCATOR_H
+#define SYSDMAALLOCATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include "dtsconfig.h"
+
+// 一个外设的DMA需求
+struct DmaDemand {
+    QString peripheral;         // 外设节点名，如 uart1、i2s0、spi2
+    QString rxChannel;          // SYSDMA请求号，空表示没有该方向
+    QString txChannel;
+    double rxBytesPerSec = 0.0; // 预期吞吐量
+    double txBytesPerSec = 0.0;
+    bool enabled = false;
+};
+
+// 分配到某个SYSDMA通道的一个方向
+struct DmaAssignment {
+    int slot = -1;              // ch-remap 中的通道索引 0..7
+    QString channel;            // SYSDMA请求号
+    QString channelName;        // 如 CVI_UART1_RX
+    QString peripheral;
+    bool rx = true;
+    double bytesPerSec = 0.0;
+};
+
+// 分配结果
+struct DmaAllocation {
+    QStringList channels;       // 8个 ch-remap 值
+    QList<DmaAssignment> assignments;
+    QList<int> reservedSlots;   // 映射到非本工具管理请求的通道，保持不变
+    QStringList unserved;       // 未分到通道的方向，由CPU中断收发
+    double offloadedBytesPerSec = 0.0;
+    double requestedBytesPerSec = 0.0;
+
+    QString summary() const;
+    QString breakdown() const;
+};
+
+// 按吞吐量把8个SYSDMA通道分给高带宽外设（I2S、高波特率UART、SPI）
+class SysdmaAllocator
+{
+public:
+    // 候选外设及预估吞吐量：UART/SPI按设备树状态和速率，I2S按当前通道映射判断是否启用
+    static QList<DmaDemand> candidates(const QMap<QString, PeripheralInfo>& peripherals,
+                                       const QStringList& currentChannels,
+                                       const QMap<QString, double>& clocksMHz);
+
+    // 按吞吐量贪心选取；只映射一个方向的外设RX放偶数通道、TX放奇数通道（与 DtsConfig 生成 dmas 属性时的判断一致），
+    // 双向外设不受奇偶限制；映射到非管理请求的通道保留不动，尽量保留默认/当前通道位置，同一外设的RX/TX放在相邻通道
+    static DmaAllocation allocate(const QList<DmaDemand>& demands, const QStringList& currentChannels);
+
+    static const QStringList& defaultChannels();
+    static QString channelName(const QString& channel);
+
+    static constexpr int CHANNEL_COUNT = 8;
+    static constexpr int HIGH_BAUD = 460800;                    // 低于此波特率的UART默认不占用DMA
+    static constexpr double I2S_BYTES_PER_SEC = 48000 * 2 * 4;  // 48kHz 双声道 32bit
+    static constexpr double SPI_TYPICAL_SCK_HZ = 25000000.0;
+};
+
+#endif // SYSDMAALLOCATOR_H
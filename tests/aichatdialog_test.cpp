@@ -0,0 +1,359 @@
+// AIChatDialog 测试：工具调用、回复缓存、相同请求合并与取消
+//
+// 通过环境变量 CVICUBEMX_AI_BASE_URL 把对话框指向本地的 QTcpServer 桩服务，
+// 桩服务按预设顺序返回 SSE 流（tool_calls 片段或普通回答），记录收到的每个请求体。
+
+#include "aichatdialog.h"
+#include "aitoolbridge.h"
+#include "artifactcache.h"
+#include "fileioservice.h"
+
+#include <QtTest>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QPushButton>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextEdit>
+
+namespace {
+
+// 最小的 /chat/completions 桩：每个连接处理一个请求，响应后关闭连接
+class StubChatServer : public QObject
+{
+public:
+    explicit StubChatServer(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+        connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+    }
+
+    bool listen() { return m_server.listen(QHostAddress::LocalHost); }
+    QString baseUrl() const { return QString("http://127.0.0.1:%1/v1").arg(m_server.serverPort()); }
+
+    // 按顺序使用的响应，用完后重复最后一个
+    void setResponses(const QList<QByteArray>& responses) { m_responses = responses; }
+    const QList<QJsonObject>& requests() const { return m_requests; }
+
+    // 暂缓响应，模拟仍在进行的请求；release() 时统一回复
+    void setHold(bool hold) { m_hold = hold; }
+    void release()
+    {
+        m_hold = false;
+        const QList<QPair<QPointer<QTcpSocket>, int>> held = m_held;
+        m_held.clear();
+        for (const auto& entry : held) {
+            if (entry.first) {
+                respond(entry.first, entry.second);
+            }
+        }
+    }
+
+private:
+    void onReadyRead(QTcpSocket *socket)
+    {
+        QByteArray& buffer = m_buffers[socket];
+        buffer.append(socket->readAll());
+
+        const int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) {
+            return;
+        }
+        qsizetype contentLength = 0;
+        const QList<QByteArray> headers = buffer.left(headerEnd).split('\n');
+        for (const QByteArray& header : headers) {
+            if (header.toLower().startsWith("content-length:")) {
+                contentLength = header.mid(header.indexOf(':') + 1).trimmed().toLongLong();
+            }
+        }
+        if (buffer.size() < headerEnd + 4 + contentLength) {
+            return;
+        }
+
+        m_requests.append(QJsonDocument::fromJson(buffer.mid(headerEnd + 4, contentLength)).object());
+        m_buffers.remove(socket);
+
+        const int requestIndex = int(m_requests.size()) - 1;
+        if (m_hold) {
+            m_held.append(qMakePair(QPointer<QTcpSocket>(socket), requestIndex));
+            return;
+        }
+        respond(socket, requestIndex);
+    }
+
+    void respond(QTcpSocket *socket, int requestIndex)
+    {
+        const QByteArray body = m_responses.isEmpty()
+            ? QByteArray("data: [DONE]\n\n")
+            : m_responses.value(requestIndex, m_responses.last());
+        QByteArray response = "HTTP/1.1 200 OK\r\n"
+                              "Content-Type: text/event-stream\r\n"
+                              "Connection: close\r\n"
+                              "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n";
+        socket->write(response + body);
+        socket->disconnectFromHost();
+    }
+
+    QTcpServer m_server;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+    QList<QByteArray> m_responses;
+    QList<QJsonObject> m_requests;
+    bool m_hold = false;
+    QList<QPair<QPointer<QTcpSocket>, int>> m_held;
+};
+
+QByteArray sseEvent(const QJsonObject& delta)
+{
+    QJsonObject choice;
+    choice["index"] = 0;
+    choice["delta"] = delta;
+    QJsonObject chunk;
+    chunk["choices"] = QJsonArray{choice};
+    return "data: " + QJsonDocument(chunk).toJson(QJsonDocument::Compact) + "\n\n";
+}
+
+// 参数分两个片段到达的 tool_calls 流
+QByteArray toolCallStream(const QString& callId)
+{
+    QJsonObject firstFunction;
+    firstFunction["name"] = "get_pin";
+    firstFunction["arguments"] = "{\"pin\":";
+    QJsonObject firstCall;
+    firstCall["index"] = 0;
+    firstCall["id"] = callId;
+    firstCall["type"] = "function";
+    firstCall["function"] = firstFunction;
+
+    QJsonObject secondFunction;
+    secondFunction["arguments"] = "\"GPIO0\"}";
+    QJsonObject secondCall;
+    secondCall["index"] = 0;
+    secondCall["function"] = secondFunction;
+
+    QJsonObject first;
+    first["tool_calls"] = QJsonArray{firstCall};
+    QJsonObject second;
+    second["tool_calls"] = QJsonArray{secondCall};
+    return sseEvent(first) + sseEvent(second) + "data: [DONE]\n\n";
+}
+
+QByteArray contentStream(const QString& text)
+{
+    QJsonObject delta;
+    delta["content"] = text;
+    return sseEvent(delta) + "data: [DONE]\n\n";
+}
+
+bool hasToolMessage(const QJsonObject& request, const QString& callId, const QString& contentPart)
+{
+    const QJsonArray messages = request["messages"].toArray();
+    for (const QJsonValue& value : messages) {
+        const QJsonObject message = value.toObject();
+        if (message["role"].toString() == "tool" && message["tool_call_id"].toString() == callId
+                && message["content"].toString().contains(contentPart)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+class AIChatDialogTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void toolCallThenAnswer();
+    void toolRoundsAreCapped();
+    void answerIsServedFromCache();
+    void identicalRequestsShareOneReply();
+    void canceledAnswerIsNotCached();
+
+private:
+    void ask(AIChatDialog& dialog, const QString& question);
+    static bool isIdle(AIChatDialog& dialog);
+
+    AIToolBridge m_tools;
+    QStringList m_toolArguments;
+};
+
+void AIChatDialogTest::initTestCase()
+{
+    // 缓存和设置写入测试专用目录，清掉上次运行留下的回复缓存
+    QStandardPaths::setTestModeEnabled(true);
+    QDir(ArtifactCache::cacheDirectory()).removeRecursively();
+
+    m_tools.registerTool("get_pin", "查询引脚功能",
+                         AIToolBridge::objectSchema({{"pin", AIToolBridge::property("string", "引脚名")}}, {"pin"}),
+                         [this](const QJsonObject& arguments) {
+        m_toolArguments << arguments["pin"].toString();
+        QJsonObject result;
+        result["pin"] = arguments["pin"];
+        result["function"] = "UART0_TX";
+        return result;
+    });
+}
+
+void AIChatDialogTest::ask(AIChatDialog& dialog, const QString& question)
+{
+    dialog.findChild<QTextEdit*>("inputLineEdit")->setPlainText(question);
+    QPushButton *sendButton = dialog.findChild<QPushButton*>("sendButton");
+    QVERIFY(sendButton->isEnabled());
+    sendButton->click();
+}
+
+bool AIChatDialogTest::isIdle(AIChatDialog& dialog)
+{
+    return !dialog.findChild<QPushButton*>("cancelButton")->isEnabled();
+}
+
+void AIChatDialogTest::toolCallThenAnswer()
+{
+    StubChatServer server;
+    QVERIFY(server.listen());
+    server.setResponses({toolCallStream("call_1"), contentStream("GPIO0 当前配置为 UART0_TX")});
+    qputenv("CVICUBEMX_AI_BASE_URL", server.baseUrl().toUtf8());
+    m_toolArguments.clear();
+
+    AIChatDialog dialog;
+    dialog.setToolBridge(&m_tools);
+    ask(dialog, "GPIO0 现在是什么功能？");
+
+    QTRY_COMPARE_WITH_TIMEOUT(int(server.requests().size()), 2, 10000);
+    QTRY_VERIFY_WITH_TIMEOUT(isIdle(dialog), 10000);
+
+    // 分片到达的参数拼接完整后才调用工具
+    QCOMPARE(m_toolArguments, QStringList{"GPIO0"});
+    QVERIFY(server.requests()[0].contains("tools"));
+    QVERIFY(hasToolMessage(server.requests()[1], "call_1", "UART0_TX"));
+    QVERIFY(dialog.findChild<QTextEdit*>("chatDisplay")->toPlainText().contains("GPIO0 当前配置为 UART0_TX"));
+}
+
+void AIChatDialogTest::toolRoundsAreCapped()
+{
+    // 服务端无视 tools 缺失，始终要求调用工具
+    StubChatServer server;
+    QVERIFY(server.listen());
+    server.setResponses({toolCallStream("call_loop")});
+    qputenv("CVICUBEMX_AI_BASE_URL", server.baseUrl().toUtf8());
+    m_toolArguments.clear();
+
+    AIChatDialog dialog;
+    dialog.setToolBridge(&m_tools);
+    ask(dialog, "一直调用工具的问题");
+
+    // 4 轮工具调用 + 最后一次不带 tools 的请求
+    QTRY_VERIFY_WITH_TIMEOUT(isIdle(dialog), 10000);
+    QCOMPARE(int(server.requests().size()), 5);
+    QCOMPARE(int(m_toolArguments.size()), 4);
+    QVERIFY(!server.requests().last().contains("tools"));
+    QVERIFY(dialog.findChild<QTextEdit*>("chatDisplay")->toPlainText().contains("已达到上限"));
+
+    // 停止后不再发出请求
+    QTest::qWait(300);
+    QCOMPARE(int(server.requests().size()), 5);
+}
+
+void AIChatDialogTest::answerIsServedFromCache()
+{
+    StubChatServer server;
+    QVERIFY(server.listen());
+    server.setResponses({contentStream("缓存的回答")});
+    qputenv("CVICUBEMX_AI_BASE_URL", server.baseUrl().toUtf8());
+
+    // 未命中不是失败，不应出现在I/O失败提示中
+    QSignalSpy failures(FileIoService::instance(), &FileIoService::taskFailed);
+
+    {
+        AIChatDialog dialog;
+        ask(dialog, "会被缓存的问题");
+        QTRY_VERIFY_WITH_TIMEOUT(isIdle(dialog), 10000);
+        QCOMPARE(int(server.requests().size()), 1);
+    }
+    QCOMPARE(int(failures.size()), 0);
+
+    // 等缓存写入落盘后再问一次，不再访问服务端
+    QTRY_VERIFY_WITH_TIMEOUT(!FileIoService::instance()->isBusy(), 10000);
+    AIChatDialog dialog;
+    ask(dialog, "会被缓存的问题");
+    QTRY_VERIFY_WITH_TIMEOUT(isIdle(dialog), 10000);
+
+    const QString text = dialog.findChild<QTextEdit*>("chatDisplay")->toPlainText();
+    QVERIFY(text.contains("缓存的回答"));
+    QVERIFY(text.contains("本地缓存的回答"));
+    QCOMPARE(int(server.requests().size()), 1);
+}
+
+void AIChatDialogTest::identicalRequestsShareOneReply()
+{
+    StubChatServer server;
+    QVERIFY(server.listen());
+    server.setResponses({contentStream("共用的回答")});
+    server.setHold(true);
+    qputenv("CVICUBEMX_AI_BASE_URL", server.baseUrl().toUtf8());
+
+    AIChatDialog first;
+    AIChatDialog second;
+    ask(first, "同时提出的问题");
+    QTRY_COMPARE_WITH_TIMEOUT(int(server.requests().size()), 1, 10000);
+    ask(second, "同时提出的问题");
+
+    // 第二个对话框等待进行中的请求，不重复发送
+    QTest::qWait(300);
+    QCOMPARE(int(server.requests().size()), 1);
+    QVERIFY(!isIdle(second));
+
+    server.release();
+    QTRY_VERIFY_WITH_TIMEOUT(isIdle(first) && isIdle(second), 10000);
+    QCOMPARE(int(server.requests().size()), 1);
+
+    const QString sharedText = second.findChild<QTextEdit*>("chatDisplay")->toPlainText();
+    QVERIFY(first.findChild<QTextEdit*>("chatDisplay")->toPlainText().contains("共用的回答"));
+    QVERIFY(sharedText.contains("共用的回答"));
+    QVERIFY(sharedText.contains("与进行中的相同请求共用回答"));
+}
+
+void AIChatDialogTest::canceledAnswerIsNotCached()
+{
+    StubChatServer server;
+    QVERIFY(server.listen());
+    server.setResponses({contentStream("取消后重新得到的回答")});
+    server.setHold(true);
+    qputenv("CVICUBEMX_AI_BASE_URL", server.baseUrl().toUtf8());
+
+    AIChatDialog first;
+    AIChatDialog waiting;
+    ask(first, "会被取消的问题");
+    QTRY_COMPARE_WITH_TIMEOUT(int(server.requests().size()), 1, 10000);
+    ask(waiting, "会被取消的问题");
+    QTest::qWait(300);
+
+    // 取消进行中的请求：等待者得到失败结果，发起者显示已停止
+    first.findChild<QPushButton*>("cancelButton")->click();
+    QTRY_VERIFY_WITH_TIMEOUT(isIdle(first) && isIdle(waiting), 10000);
+    QVERIFY(first.findChild<QTextEdit*>("chatDisplay")->toPlainText().contains("已停止生成"));
+    QVERIFY(waiting.findChild<QTextEdit*>("chatDisplay")->toPlainText().contains("相同的请求未能完成"));
+
+    // 取消的回答没有写入缓存，再问一次会重新请求
+    server.setHold(false);
+    AIChatDialog retry;
+    ask(retry, "会被取消的问题");
+    QTRY_VERIFY_WITH_TIMEOUT(isIdle(retry), 10000);
+    QCOMPARE(int(server.requests().size()), 2);
+    QVERIFY(retry.findChild<QTextEdit*>("chatDisplay")->toPlainText().contains("取消后重新得到的回答"));
+}
+
+QTEST_MAIN(AIChatDialogTest)
+#include "aichatdialog_test.moc"